@@ -49,6 +49,13 @@
 
 #define CMDID_BASEBAND_TXRX_COUNT_RESET                    0x000010
 #define CMDID_BASEBAND_TXRX_COUNT_GET                      0x000011
+#define CMDID_BASEBAND_TX_STREAM_STATUS                    0x000012
+#define CMDID_BASEBAND_RX_SEGMENT_CONFIG                   0x000013
+#define CMDID_BASEBAND_RX_SEGMENT_STATUS                   0x000014
+#define CMDID_BASEBAND_RX_ACCUM_CONFIG                     0x000015
+#define CMDID_BASEBAND_RX_ACCUM_STATUS                     0x000016
+#define CMDID_BASEBAND_READ_IQ_SCHEDULE                    0x000017
+#define CMDID_BASEBAND_SAMPLE_BYTE_ORDER                   0x000018
 
 #define CMDID_BASEBAND_AGC_STATE                           0x000100
 #define CMDID_BASEBAND_AGC_DONE_ADDR                       0x000101
@@ -89,6 +96,14 @@
 #define INIT_TX_DELAY                                      0
 #define WL_BUF_DEBUG_4RF_ON_2RF                            0
 
+// RX accumulation
+//   NOTE:  The accumulator holds a 32-bit sum of I and Q for each sample so at most 2^16 receptions
+//       can be accumulated without overflow.  The accumulation is done in the main loop a number of
+//       samples at a time so that Ethernet processing is not blocked (see baseband_service()).
+//
+#define WL_BUF_RX_ACCUM_MAX_COUNT                          0x00010000
+#define WL_BUF_RX_ACCUM_SAMPLES_PER_SERVICE                1024
+
 
 
 // **********************************************************************
@@ -99,6 +114,21 @@
 
 #define CMD_PARAM_BASEBAND_TXRX_COUNT_GET_COUNT_RSVD       0xFFFFFFFF
 
+#define CMD_PARAM_BASEBAND_TX_MODE_NORMAL                  0
+#define CMD_PARAM_BASEBAND_TX_MODE_CONTINUOUS              1
+#define CMD_PARAM_BASEBAND_TX_MODE_STREAM                  2
+
+#define CMD_PARAM_BASEBAND_RX_SEGMENT_MAX                  256
+#define CMD_PARAM_BASEBAND_RX_SEGMENT_STATUS_MAX           64
+
+#define CMD_PARAM_BASEBAND_RX_ACCUM_DISABLE                0
+#define CMD_PARAM_BASEBAND_RX_ACCUM_ENABLE                 1
+
+#define CMD_PARAM_BASEBAND_READ_IQ_RANK_NODE_ID            0xFFFFFFFF
+
+#define CMD_PARAM_BASEBAND_SAMPLE_BYTE_ORDER_BIG           0
+#define CMD_PARAM_BASEBAND_SAMPLE_BYTE_ORDER_LITTLE        1
+
 
 
 
@@ -519,6 +549,110 @@ typedef u32 wl_samp;
 #define SAMPLE_HDR_FLAG_LAST_WRITE                         0x20
 
 
+// Read IQ buffer selection flags
+//   NOTE:  The lower bits of the Read IQ buffer selection argument are a mask of RF_SEL_* values.
+//       All selected buffers are returned in a single request.  By default, all packets of a
+//       buffer are sent before the next buffer; the interleave flag will send one packet of each
+//       selected buffer before moving to the next set of samples.  The stream flag will send
+//       samples during a reception as soon as they are received instead of returning
+//       SAMPLE_HDR_FLAG_IQ_NOT_READY.
+//
+#define READ_IQ_BUFF_SEL_MASK                              0x0000000F
+#define READ_IQ_FLAG_INTERLEAVE                            0x80000000
+#define READ_IQ_FLAG_STREAM                                0x40000000
+
+
+// Read IQ sample formats
+//   NOTE:  Bits [29:28] of the Read IQ buffer selection argument select the format of the samples
+//       on the wire (see read_iq_compress()).  Compressed formats are only supported for Read IQ.
+//
+#define READ_IQ_FORMAT_MASK                                0x30000000
+#define READ_IQ_FORMAT_RAW                                 0x00000000
+#define READ_IQ_FORMAT_12BIT                               0x10000000
+#define READ_IQ_FORMAT_BFP                                 0x20000000
+#define READ_IQ_FORMAT_RSVD                                0x30000000
+
+#define READ_IQ_BFP_BLOCK_SAMPLES                          32
+
+
+// Read IQ capture window
+//   NOTE:  Bits [27:26] of the Read IQ buffer selection argument select the reference of the start
+//       sample.  For READ_IQ_WINDOW_AGC_DONE, the start sample is a signed offset from the sample
+//       where the AGC finished (ie wl_bb_get_agc_done_addr()) and is resolved by the node when the
+//       request is processed.  Since a reception triggered by the trigger manager (eg by the energy
+//       detector) starts at sample 0, trigger relative windows use READ_IQ_WINDOW_ABSOLUTE.
+//
+#define READ_IQ_WINDOW_MASK                                0x0C000000
+#define READ_IQ_WINDOW_ABSOLUTE                            0x00000000
+#define READ_IQ_WINDOW_AGC_DONE                            0x04000000
+
+
+// Read IQ capture metadata
+//   NOTE:  If bit [25] of the Read IQ buffer selection argument is set, then the first packet of the
+//       response is a metadata packet instead of samples.  The sample header of the metadata packet
+//       contains SAMPLE_HDR_FLAG_METADATA and num_samp is zero.  The payload is one wl_bb_read_iq_metadata
+//       (all fields big endian) for each selected buffer so the host does not need separate requests to
+//       get the state of the capture.  The metadata is only supported for Read IQ.
+//
+#define READ_IQ_FLAG_METADATA                              0x02000000
+
+
+// Read IQ deferral
+//   NOTE:  If bit [24] of the Read IQ buffer selection argument is set and a selected buffer is
+//       receiving, then the node parks the request instead of returning SAMPLE_HDR_FLAG_IQ_NOT_READY.
+//       The request is processed as soon as the reception is done (see wl_buffers_core_rx_xfer_done())
+//       or, at the latest, once the deadline in bits [23:16] (in READ_IQ_DEFER_TIMEOUT_UNIT usec) has
+//       passed.  Only one request can be parked at a time; a request that cannot be parked is answered
+//       with SAMPLE_HDR_FLAG_IQ_NOT_READY as before.
+//
+#define READ_IQ_FLAG_DEFER                                 0x01000000
+#define READ_IQ_DEFER_TIMEOUT_MASK                         0x00FF0000
+#define READ_IQ_DEFER_TIMEOUT_SHIFT                        16
+#define READ_IQ_DEFER_TIMEOUT_UNIT                         10000
+
+#define READ_IQ_DEFER_IDLE                                 0
+#define READ_IQ_DEFER_PARKED                               1
+#define READ_IQ_DEFER_READY                                2
+
+
+// Read IQ scheduling
+//   NOTE:  If bit [15] of the Read IQ buffer selection argument is set, then the node waits for its
+//       transmit slot before sending the response and paces the packets to the rate cap (see
+//       CMDID_BASEBAND_READ_IQ_SCHEDULE).  This is used when the host sends the Read IQ requests of many
+//       nodes at once so that the nodes do not all send at the same time.  The slot of a node starts
+//       (rank * slot time) usec after the request is processed.  If the slot time is zero, then it is
+//       the time on the wire of the response at the rate cap (or WL_READ_IQ_SCHEDULE_LINK_RATE if there
+//       is no rate cap) so that every node must read the same number of samples.  The node does not
+//       process Ethernet packets while it waits, so a request whose wait is longer than
+//       WL_READ_IQ_SCHEDULE_MAX_WAIT fails with SAMPLE_HDR_FLAG_IQ_ERROR instead of being limited.
+//
+#define READ_IQ_FLAG_SCHEDULE                              0x00008000
+
+#define WL_READ_IQ_SCHEDULE_MAX_WAIT                       500000              // Maximum slot wait (usec)
+#define WL_READ_IQ_SCHEDULE_LINK_RATE                      1000                // Link rate (Mbps)
+#define WL_READ_IQ_SCHEDULE_PKT_OVERHEAD                   24                  // Ethernet preamble, FCS and inter-frame gap (bytes)
+
+
+// Read IQ sample header flags
+#define SAMPLE_HDR_FLAG_FORMAT_12BIT                       0x04
+#define SAMPLE_HDR_FLAG_FORMAT_BFP                         0x08
+#define SAMPLE_HDR_FLAG_METADATA                           0x40
+#define SAMPLE_HDR_FLAG_LITTLE_ENDIAN                      0x80
+
+
+// Sample byte order
+//   NOTE:  By default, each sample is a big endian u32 (I in [31:16], Q in [15:0]) in the buffers
+//       and on the wire.  A host can select little endian samples with CMDID_BASEBAND_SAMPLE_BYTE_ORDER
+//       so that raw samples are in its native byte order.  The byte order is applied by the buffers
+//       core (WL_BUF_REG_CONFIG_*_BYTE_ORDER) so the samples are still sent "as is".  Raw Read IQ /
+//       Read RSSI packets in little endian have SAMPLE_HDR_FLAG_LITTLE_ENDIAN set.  Compressed
+//       samples and all headers / arguments are big endian regardless of the byte order.  Any code
+//       that interprets samples in the buffers must use these macros.
+//
+#define wl_bb_samp_ntoh(order, samp)                       (((order) == CMD_PARAM_BASEBAND_SAMPLE_BYTE_ORDER_LITTLE) ? (samp) : Xil_Ntohl(samp))
+#define wl_bb_samp_hton(order, samp)                       (((order) == CMD_PARAM_BASEBAND_SAMPLE_BYTE_ORDER_LITTLE) ? (samp) : Xil_Htonl(samp))
+
+
 // Sample header
 typedef struct{
     u16 buff_sel;
@@ -529,6 +663,31 @@ typedef struct{
 } wl_bb_samp_hdr;
 
 
+// Read IQ capture metadata (see READ_IQ_FLAG_METADATA)
+//   NOTE:  The RSSI statistics are computed over the samples of the request that are in the buffer.
+//       Each RSSI value is the 10-bit RSSI stored in the RSSI buffer (ie one value per 4 samples).
+//       The number of values is included so the host can combine the statistics of multiple requests.
+//
+typedef struct{
+    u32 buff_sel;                                          // Buffer of the metadata (RF_SEL_*)
+    u32 rx_count;                                          // RX counter of the buffer
+    u32 capture_timestamp_msb;                             // Time the last reception finished (usec; 0 if not known)
+    u32 capture_timestamp_lsb;
+    u32 read_timestamp_msb;                                // Time the request was processed (usec)
+    u32 read_timestamp_lsb;
+    u32 agc_gains;                                         // [7] RXHP; [6:5] RF gain; [4:0] BB gain
+    u32 agc_done_rssi;                                     // RSSI of the buffer when the AGC finished
+    u32 agc_done_addr;                                     // Sample index where the AGC finished
+    u32 rssi_min;                                          // Minimum RSSI of the requested samples
+    u32 rssi_mean;                                         // Mean RSSI of the requested samples
+    u32 rssi_max;                                          // Maximum RSSI of the requested samples
+    u32 tx_rx_status;                                      // [15:8] Rx status; [7:0] Tx status
+    u32 buffer_en;                                         // [15:8] Rx buffer enable; [7:0] Tx buffer enable
+    u32 rx_length;                                         // Rx length (in samples)
+    u32 rssi_count;                                        // Number of RSSI values in the statistics
+} wl_bb_read_iq_metadata;
+
+
 
 
 /******************************** Functions **********************************/
@@ -542,6 +701,8 @@ u32          wl_bb_get_supported_rx_length();
 u32          baseband_get_checksum();
 u32          baseband_update_checksum(u16 newdata, u8 reset );
 
+void         baseband_service();
+
 // AGC Functions
 void         warplab_agc_init();
 void         warplab_agc_enable_DCO(u32 enable);
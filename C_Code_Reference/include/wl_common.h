@@ -377,6 +377,18 @@ void          print_debug_storage();
 typedef enum {INTERRUPTS_DISABLED, INTERRUPTS_ENABLED} interrupt_state_t;
 
 
+// **********************************************************************
+// WARPLab CDMA Transfer
+//
+typedef struct {
+    u32                 src_address;            // Source address of the transfer
+    u32                 dest_address;           // Destination address of the transfer
+    u32                 length;                 // Length of the transfer in bytes (0 for callback only)
+    wl_function_ptr_t   callback;               // Callback executed when the transfer is done (or NULL)
+    u32                 callback_arg;           // Argument to the callback
+} wl_cdma_xfer;
+
+
 /******************************** Functions **********************************/
 
 // Peripheral Init Functions
@@ -385,7 +397,12 @@ int                          wl_cdma_initialize();
 int                          wl_uart_initialize();
 
 // DMA Functions
-void                         wl_cdma_transfer(u32 src_address, u32 dest_address, u32 length);
+u32                          wl_cdma_transfer(u32 src_address, u32 dest_address, u32 length);
+u32                          wl_cdma_submit_callback(wl_function_ptr_t callback, u32 callback_arg);
+void                         wl_cdma_service();
+int                          wl_cdma_done(u32 transfer_id);
+void                         wl_cdma_wait(u32 transfer_id);
+void                         wl_cdma_wait_all();
 int                          wl_cdma_busy();
 
 // Callbacks
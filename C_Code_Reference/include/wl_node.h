@@ -47,6 +47,13 @@
 
 #define CMDID_NODE_MEM_RW                                  0x000010
 
+#define CMDID_NODE_SEQ_LOAD                                0x000020
+#define CMDID_NODE_SEQ_START                               0x000021
+#define CMDID_NODE_SEQ_STOP                                0x000022
+#define CMDID_NODE_SEQ_STATUS                              0x000023
+
+#define CMDID_NODE_BUNDLE                                  0x000030
+
 
 
 // **********************************************************************
@@ -55,6 +62,70 @@
 #define CMD_PARAM_NODE_MEM_RW_MAX_BYTES                    1400
 
 
+// Node sequencer
+//   NOTE:  The sequencer executes a program of WARPLab commands on the node so that a sweep does not need a
+//       host round trip for every step.  The program is a sequence of instructions.  The first word of each
+//       instruction holds the op code [31:24] and an operand [23:0]:
+//
+//       NODE_SEQ_OP_CMD           - Operand is the number of words (N) of the command that follows the instruction
+//                                   word (ie the command header and arguments in the same format as a command
+//                                   received from the host).  The command is processed by the command group.
+//       NODE_SEQ_OP_LOOP          - Operand is the number of iterations of the instructions up to the matching
+//                                   NODE_SEQ_OP_END_LOOP
+//       NODE_SEQ_OP_END_LOOP      - End of the innermost loop
+//       NODE_SEQ_OP_WAIT_TIME     - Operand is the time to wait (in usec)
+//       NODE_SEQ_OP_WAIT_BUFFERS  - Operand is a buffer selection; waits until the Tx and Rx of the buffers are done
+//       NODE_SEQ_OP_ADD           - Operand is the index of a program word (eg a command argument); the next word
+//                                   is added to it (ie parameter increments).  Since this changes the program, the
+//                                   program must be loaded again before it can be run again.
+//
+//       The program is stored in network byte order (ie as it is received).  Commands that send their own
+//       response (eg Read IQ) send it to the host that started the sequencer.  The responses of other commands
+//       are only sent if NODE_SEQ_FLAG_SEND_RESP is set.  Commands that need data from the packet (ie Write IQ,
+//       payload size test) and commands that change the sequencer (ie load, start, bundle) can not be used in
+//       a program.  They are rejected when the program is loaded / started and the sequencer stops with
+//       NODE_SEQ_STATE_ERROR if the program reaches one (eg because of NODE_SEQ_OP_ADD).
+//
+#define NODE_SEQ_MAX_WORDS                                 4096
+#define NODE_SEQ_MAX_CMD_ARGS                              64
+#define NODE_SEQ_MAX_LOOP_DEPTH                            4
+
+#define NODE_SEQ_OP_MASK                                   0xFF000000
+#define NODE_SEQ_OP_SHIFT                                  24
+#define NODE_SEQ_OPERAND_MASK                              0x00FFFFFF
+
+#define NODE_SEQ_OP_CMD                                    0x01
+#define NODE_SEQ_OP_LOOP                                   0x02
+#define NODE_SEQ_OP_END_LOOP                               0x03
+#define NODE_SEQ_OP_WAIT_TIME                              0x04
+#define NODE_SEQ_OP_WAIT_BUFFERS                           0x05
+#define NODE_SEQ_OP_ADD                                    0x06
+
+#define NODE_SEQ_FLAG_SEND_RESP                            0x00000001
+
+#define NODE_SEQ_STATE_IDLE                                0
+#define NODE_SEQ_STATE_RUNNING                             1
+#define NODE_SEQ_STATE_DONE                                2
+#define NODE_SEQ_STATE_ERROR                               3
+
+
+// Command bundles
+//   NOTE:  A bundle (CMDID_NODE_BUNDLE) carries a sequence of commands (command header and arguments) in one
+//       packet.  The commands are processed in order and their responses are concatenated in the bundle
+//       response.  The responses must fit in one packet of the maximum payload given by the host (at most
+//       NODE_BUNDLE_MAX_PAYLOAD bytes, ie the UDP payload of a 9000 byte jumbo frame).  The response of a
+//       NODE_MEM_RW read is reserved before the command is processed.  Other responses are built in place
+//       (the send buffer must have room for NODE_BUNDLE_MAX_CMD_RESP_LENGTH bytes) and processing stops with
+//       the first response that does not fit; the host sends that command again.  Only read commands have
+//       long responses, so processing them again is harmless.  Commands that send their own responses (ie
+//       Read IQ, identify) or that need data from the packet (ie Write IQ, payload size test) can not be
+//       bundled; they are not processed and their response carries CMD_PARAM_ERROR.
+//
+#define NODE_BUNDLE_MAX_PAYLOAD                            8972
+#define NODE_BUNDLE_MAX_CMD_RESP_LENGTH                    256
+#define NODE_BUNDLE_RESP_OVERHEAD                          (WARP_IP_UDP_DELIM_LEN + sizeof(wl_transport_header) + sizeof(wl_cmd_resp_hdr))
+
+
 
 /*********************** Global Structure Definitions ************************/
 
@@ -63,6 +134,10 @@
 /*************************** Function Prototypes *****************************/
 
 int  node_process_cmd(int socket_index, void * from, wl_cmd_resp * command, wl_cmd_resp * response);
+u32  node_dispatch_cmd(int socket_index, void * from, wl_cmd_resp * command, wl_cmd_resp * response);
+
+// Node sequencer commands
+void node_seq_service();
 
 void node_send_early_resp(int socket_index, void * to, wl_cmd_resp_hdr * resp_hdr, void * buffer);
 
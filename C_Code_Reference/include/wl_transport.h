@@ -112,6 +112,8 @@ int  transport_set_process_hton_msg_callback(void(*handler));
 int  transport_process_cmd(int socket_index, void * from, wl_cmd_resp * command, wl_cmd_resp * response);
 
 void transport_poll(u32 eth_dev_num);
+void transport_set_recv_buffer_xfer(u32 transfer_id);
+int  transport_check_recv(u32 eth_dev_num);
 void transport_send(int socket_index, struct sockaddr * to, warp_ip_udp_buffer ** buffers, u32 num_buffers);
 void transport_close(u32 eth_dev_num);
 
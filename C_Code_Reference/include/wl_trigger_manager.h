@@ -48,6 +48,9 @@
 #define CMDID_TRIG_MNGR_ENERGY_BUSY_MIN_LEN                0x000032
 #define CMDID_TRIG_MNGR_ENERGY_IFC_SEL                     0x000033
 
+#define CMDID_TRIG_MNGR_GET_TIMESTAMP                      0x000040
+#define CMDID_TRIG_MNGR_SCHEDULE_TRIGGER                   0x000041
+
 #define CMDID_TRIG_MNGR_TEST_TRIGGER                       0x000080
 
 
@@ -230,6 +233,19 @@
 #define ODELAY_UPDATE_MASK                                 0x00000002
 
 
+// Scheduled triggers
+//   NOTE:  A scheduled trigger raises the Ethernet trigger of the interface on which it was scheduled
+//       (as a software Ethernet trigger would) when the node timestamp (see get_usec_timestamp()) reaches
+//       the trigger time.  The host converts its own time to node time using the clock offset estimated
+//       from CMDID_TRIG_MNGR_GET_TIMESTAMP round trips.  The schedule is checked by trigmngr_service()
+//       in the main loop, so a trigger whose time passes while the node processes a long command (eg a
+//       Read IQ) is raised late and counted.
+//
+#define TRIG_MNGR_SCHEDULE_MAX                             16
+#define TRIG_MNGR_SCHEDULE_SPIN_TIME                       50                  // Busy wait before the trigger time (usec)
+#define TRIG_MNGR_SCHEDULE_LATE_TIME                       5                   // Later triggers are counted as late (usec)
+
+
 // --------------------------------------------------------
 // Macros
 //
@@ -510,5 +526,7 @@ int  trigmngr_process_cmd(int socket_index, void * from, wl_cmd_resp * command,
 
 void trigmngr_trigger_in(u32 trig_id, u32 eth_dev_num);
 
+void trigmngr_service();
+
 
 #endif /* TRIGCONF_H_ */
@@ -53,8 +53,17 @@
 
 /*************************** Constant Definitions ****************************/
 
+// Reception status returned by wait_rx_samples()
+#define WAIT_RX_SAMPLES_DONE                               0
+#define WAIT_RX_SAMPLES_ONGOING                            1
+#define WAIT_RX_SAMPLES_ABORT                              2
+
+
 /*********************** Global Variable Definitions *************************/
 
+extern u16          node;                         // Node ID (defined in wl_node.c)
+
+
 /*************************** Variable Definitions ****************************/
 
 // Fletcher-32 Checksum variables
@@ -100,6 +109,71 @@ static u32         wl_rssi_buff_d_size;
 static u32         supported_tx_length = 0xFFFFFFFF;
 static u32         supported_rx_length = 0xFFFFFFFF;
 
+// Streaming TX variables
+//     NOTE:  In streaming TX mode, the TX buffer in DDR is used as a ring of tx_stream_length samples that is
+//         transmitted continuously.  The host writes samples using a stream sample index (ie the start sample
+//         of a Write IQ keeps increasing past the TX length) and the node maps the index to the ring.  All
+//         indexes are 32 bits and are compared using signed differences so that they can wrap.
+//
+static u32          tx_stream_en         = 0;
+static u32          tx_stream_length     = 0;         // Length of the ring (in samples)
+static volatile u32 tx_stream_rd_samp    = 0;         // Stream index of the next sample transferred to the temporary TX buffers
+static volatile u32 tx_stream_rd_offset  = 0;         // Ring offset of tx_stream_rd_samp (in samples)
+static u32          tx_stream_wr_samp    = 0;         // Stream index after the last sample written by the host
+static volatile u32 tx_stream_underruns  = 0;         // Number of transfers to the temporary TX buffers with stale samples
+
+// Segmented RX variables
+//     NOTE:  In segmented RX mode, the RX buffers in DDR are partitioned in to rx_seg_num segments of
+//         rx_buffer_size bytes.  The RX interrupt transfers each reception to the current segment and the
+//         segment is advanced at the end of every reception, so receptions can be captured at the trigger
+//         rate.  The host reads all segments with a single Read IQ of (rx_seg_num * rx_buffer_size) bytes.
+//
+static u32          rx_seg_num           = 0;         // Number of segments (0 - segmented RX disabled)
+static volatile u32 rx_seg_base          = 0;         // Byte offset of the current segment in the RX IQ buffers
+static volatile u32 rx_seg_index         = 0;         // Index of the current segment
+static volatile u32 rx_seg_count         = 0;         // Number of receptions captured since the segments were configured
+static u64          rx_seg_timestamp[CMD_PARAM_BASEBAND_RX_SEGMENT_MAX];     // Time the reception of each segment finished (usec)
+static u32          rx_seg_rx_count[CMD_PARAM_BASEBAND_RX_SEGMENT_MAX];      // RX counter of the reception of each segment
+
+// Time the last reception finished (usec; see READ_IQ_FLAG_METADATA)
+static u64          rx_capture_timestamp = 0;
+
+// Deferred Read IQ variables
+//     NOTE:  A parked Read IQ request (see READ_IQ_FLAG_DEFER) is saved with everything needed to process
+//         it again from baseband_service():  the socket / address of the host, the transport header of the
+//         response and the command.  The command header is saved in host byte order and the arguments in
+//         network byte order (ie the same as when the command was received).
+//
+static volatile u32     read_iq_defer_state  = READ_IQ_DEFER_IDLE;
+static u32              read_iq_defer_buff_sel;
+static u64              read_iq_defer_deadline;
+static int              read_iq_defer_socket;
+static struct sockaddr  read_iq_defer_from;
+static wl_transport_header read_iq_defer_hdr;
+static wl_cmd_resp_hdr  read_iq_defer_cmd_hdr;
+static u32              read_iq_defer_args[5];
+
+// Read IQ scheduling variables (see READ_IQ_FLAG_SCHEDULE)
+static u32          read_iq_sched_rank      = CMD_PARAM_BASEBAND_READ_IQ_RANK_NODE_ID;
+static u32          read_iq_sched_slot_time = 0;  // Slot time (usec; 0 - time on the wire of the response)
+static u32          read_iq_sched_rate      = 0;  // Rate cap (Mbps; 0 - no rate cap)
+
+// Sample byte order (see CMDID_BASEBAND_SAMPLE_BYTE_ORDER)
+static u32          samp_byte_order         = CMD_PARAM_BASEBAND_SAMPLE_BYTE_ORDER_BIG;
+
+// RX accumulation variables
+//     NOTE:  In RX accumulation mode, every reception is added sample by sample to an accumulator that is
+//         placed in each RX buffer in DDR after the reception (ie at byte offset rx_buffer_size).  Each sample
+//         of the accumulator is a 32-bit I sum followed by a 32-bit Q sum in network byte order.  The RX
+//         transfer done callback marks the reception as pending and baseband_service() does the additions.
+//
+static u32          rx_accum_en          = 0;
+static u32          rx_accum_length      = 0;         // Number of samples accumulated per reception
+static volatile u32 rx_accum_pending     = 0;         // Buffers of the reception being accumulated
+static volatile u32 rx_accum_samp        = 0;         // Next sample of the pending reception to accumulate
+static volatile u32 rx_accum_count       = 0;         // Number of receptions accumulated
+static volatile u32 rx_accum_overruns    = 0;         // Number of receptions that were not (completely) accumulated
+
 // Bit counting vector
 const u8           one_bits[] = {0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4};
 
@@ -172,15 +246,38 @@ const u8           one_bits[] = {0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4}
 u8                 ETH_IQ_buffer[WL_BASEBAND_ETH_NUM_BUFFER * WL_BASEBAND_ETH_BUFFER_SIZE] __attribute__ ((aligned(WL_BASEBAND_ETH_BUFFER_ALIGNMENT))) __attribute__ ((section (".eth_data")));
 
 
+// Allocate Read IQ compression buffers
+//     NOTE:  Compressed samples cannot be sent directly from the DDR buffers, so they are written to one
+//            buffer per header buffer in DMA accessible BRAM.  A buffer holds the samples of a jumbo frame
+//            so that compressed packets are as large as raw packets (ie 5 x 9 kB of the 128 kB Ethernet BRAM).
+//            Read IQ requests whose compressed packets do not fit in a buffer fail.  This size must match the
+//            maximum compressed packet length used by the host (ie READ_IQ_COMPRESS_MAX_LENGTH in
+//            wl_mex_udp_transport.c).
+//
+#define WL_BASEBAND_ETH_COMPRESS_BUFFER_SIZE               0x2400              // Number of bytes per buffer
+
+u8                 ETH_IQ_compress_buffer[WL_BASEBAND_ETH_NUM_BUFFER * WL_BASEBAND_ETH_COMPRESS_BUFFER_SIZE] __attribute__ ((aligned(WL_BASEBAND_ETH_BUFFER_ALIGNMENT))) __attribute__ ((section (".eth_data")));
+
+
 /*************************** Functions Prototypes ****************************/
 
-void read_rx_buffers(u32 cmd_id, u32 buffer_sel, u32 offset, u32 length, u32 dest_addr, warp_ip_udp_buffer * buffer);
+void read_rx_buffers(u32 cmd_id, u32 buffer_sel, u32 offset, u32 length, u32 dest_addr, warp_ip_udp_buffer * buffer, warp_ip_udp_buffer * zero_buffer);
+u32  read_iq_compressed_length(u32 format, u32 num_samp);
+void read_iq_compress(u32 format, u32 * src, u32 num_samp, u8 * dest);
+void read_iq_metadata(u32 buffer_sel, u32 start_samp, u32 num_samp, wl_bb_read_iq_metadata * metadata);
+u32  read_iq_defer_park(int socket_index, void * from, wl_cmd_resp * command, wl_cmd_resp * response);
+void read_iq_defer_service();
+u16  wl_ip_checksum_adjust(u16 checksum, u16 old_value, u16 new_value);
 void write_tx_buffers(u32 buffer_sel, u32 src_addr, u32 offset, u32 length);
+void write_tx_stream(u32 buffer_sel, u32 src_addr, u32 start_samp, u32 num_samp);
+void rx_accum_samples(u32 * src, u32 * accum, u32 num_samp);
+void rx_accum_clear(u32 num_samp);
 
 // Functions implemented in HW specific sections of the file
 void baseband_hw_specific_reset();
 void baseband_transfer_data(u32 src_addr, u32 dest_addr, u32 length);
 void populate_tmp_tx_buffers(u32 buffer_sel, u32 offset, u32 length);
+u32  wait_rx_samples(u32 eth_dev_num, u32 cmd_id, u32 buffer_sel, u32 end_byte);
 void baseband_buffers_config(u8 dram_present);
 int  baseband_check_parameters();
 
@@ -259,10 +356,28 @@ int baseband_process_cmd(int socket_index, void * from, wl_cmd_resp * command, w
     u32                 start_samp, curr_samp, start_byte, num_samp, samp_len, num_pkts, offset;
     u32                 total_samp, max_samp_len_per_pkt, max_samp_per_pkt, next_start_samp;
     u8                  sample_iq_id;
+    u32                 read_iq_flags;
+    u32                 num_buffs, buff_index, pkt_index;
+    u32                 stream_rx;
+    u32                 read_iq_format, wire_len, max_wire_len;
+    u32                 num_meta_pkts;
+    u8                  samp_flags;
+    u32                 sched_rate;
+    u64                 sched_bits;
+    u64                 sched_start, sched_wait;
+    u32                 req_error;
+    interrupt_state_t   prev_interrupt_state;
+    u64                 timestamp;
+    u32                 window_base;
+    u8                * compress_addr;
+    u32                 read_buff_sel[4];
+    u8                  read_iq_id[4];
 
     warp_ip_udp_buffer  header_buffer;
     warp_ip_udp_buffer  sample_buffer;
-    void              * read_iq_resp[2];
+    warp_ip_udp_buffer  zero_buffer;
+    void              * read_iq_resp[3];
+    u32                 num_resp_buffers;
     u32                 header_length;
     u16                 ip_length;
     u16                 udp_length;
@@ -277,6 +392,9 @@ int baseband_process_cmd(int socket_index, void * from, wl_cmd_resp * command, w
     u8                * header_addr;
     u32                 header_buffer_size;
     u8                  tmp_header[80];                         // Temporary header (80 bytes)
+    u16                 ip_id;
+    u16                 ip_total_length;
+    u16                 ip_checksum;
 
     u32                 temp;
     u32                 temp_offset;
@@ -453,6 +571,26 @@ int baseband_process_cmd(int socket_index, void * from, wl_cmd_resp * command, w
                             sample_length = supported_rx_length;
                         }
 
+                        // Segments are sized by the RX buffer size, so changing the length disables segmented RX
+                        if (rx_seg_num) {
+                            wl_printf(WL_PRINT_WARNING, print_type_baseband, "Rx length changed.  Disabling segmented Rx.\n");
+
+                            wl_cdma_wait_all();
+
+                            rx_seg_num   = 0;
+                            rx_seg_base  = 0;
+                        }
+
+                        // The accumulator is placed after the RX buffer, so changing the length disables RX accumulation
+                        if (rx_accum_en) {
+                            wl_printf(WL_PRINT_WARNING, print_type_baseband, "Rx length changed.  Disabling Rx accumulation.\n");
+
+                            wl_cdma_wait_all();
+
+                            rx_accum_en      = 0;
+                            rx_accum_pending = 0;
+                        }
+
                         // Set the global variable of the RX buffer size (in bytes) aligned to the RX transfer boundary
                         rx_buffer_size = byte_length & WL_BUF_RX_TRANSFER_BYTE_ALIGNMENT_MASK;
 
@@ -571,11 +709,19 @@ int baseband_process_cmd(int socket_index, void * from, wl_cmd_resp * command, w
             //
             // Message format:
             //     cmd_args_32[0]      Mode:
-            //                             - 1        - Set Continuous TX mode
+            //                             - 2        - Set Streaming TX mode (CMD_PARAM_BASEBAND_TX_MODE_STREAM)
+            //                             - 1        - Set Continuous TX mode (CMD_PARAM_BASEBAND_TX_MODE_CONTINUOUS)
             //                             - 0        - Clear Continuous TX mode (normal TX mode)
             //
+            // NOTE:  Streaming TX mode is continuous TX mode where the host keeps writing samples ahead of
+            //     the transmission using a stream sample index (see write_tx_stream()).  The stream is restarted
+            //     from stream sample 0 every time the mode is set, so the mode must be set before the initial
+            //     Write IQ of the stream.  The initial Write IQ must not be longer than the TX length.
+            //
             mode = Xil_Ntohl(cmd_args_32[0]);
 
+            tx_stream_en = 0;
+
             if(mode) {
                 sample_length = wl_bb_get_tx_length() + 1;
 
@@ -584,6 +730,25 @@ int baseband_process_cmd(int socket_index, void * from, wl_cmd_resp * command, w
                               "Tx length not a multiple of %d.\n    Tx waveform not fully defined.\n", WL_BUF_TX_TRANSFER_THRESHOLD_SAMPLES);
                 }
 
+                if (mode == CMD_PARAM_BASEBAND_TX_MODE_STREAM) {
+                    // Streaming requires the ring to be refilled from DDR by the TX interrupt
+                    if ((use_dram_for_buffers) && (sample_length > WL_BUF_DEFAULT_TX_NUM_SAMPLES) &&
+                        ((sample_length % WL_BUF_TX_TRANSFER_THRESHOLD_SAMPLES) == 0)) {
+
+                        // The initial Write IQ populates the temporary TX buffers from the start of the ring
+                        tx_stream_length    = sample_length;
+                        tx_stream_rd_samp   = (WARPLAB_IQ_TX_BUF_SIZE >> 2);
+                        tx_stream_rd_offset = (WARPLAB_IQ_TX_BUF_SIZE >> 2);
+                        tx_stream_wr_samp   = 0;
+                        tx_stream_underruns = 0;
+                        tx_stream_en        = 1;
+                    } else {
+                        wl_printf(WL_PRINT_WARNING, print_type_baseband,
+                                  "Streaming TX requires DDR and a Tx length that is a multiple of %d.\n    Using continuous TX.\n",
+                                  WL_BUF_TX_TRANSFER_THRESHOLD_SAMPLES);
+                    }
+                }
+
                 wl_bb_set_config(WL_BUF_REG_CONFIG_CONT_TX);
             } else {
                 wl_bb_clear_config(WL_BUF_REG_CONFIG_CONT_TX);
@@ -591,6 +756,315 @@ int baseband_process_cmd(int socket_index, void * from, wl_cmd_resp * command, w
         break;
 
 
+        //---------------------------------------------------------------------
+        case CMDID_BASEBAND_TX_STREAM_STATUS:
+            // Get the streaming TX status
+            //
+            // Response format:
+            //     resp_args_32[0]     Status
+            //     resp_args_32[1]     Tx read pointer  (stream index of the next sample transferred to the temporary TX buffers)
+            //     resp_args_32[2]     Tx write pointer (stream index after the last sample written by the host)
+            //     resp_args_32[3]     Number of underruns
+            //
+            status = (tx_stream_en) ? CMD_PARAM_SUCCESS : CMD_PARAM_ERROR;
+
+            resp_args_32[resp_index++] = Xil_Htonl(status);
+            resp_args_32[resp_index++] = Xil_Htonl(tx_stream_rd_samp);
+            resp_args_32[resp_index++] = Xil_Htonl(tx_stream_wr_samp);
+            resp_args_32[resp_index++] = Xil_Htonl(tx_stream_underruns);
+
+            resp_hdr->length  += (resp_index * sizeof(resp_args_32));
+            resp_hdr->num_args = resp_index;
+        break;
+
+
+        //---------------------------------------------------------------------
+        case CMDID_BASEBAND_RX_SEGMENT_CONFIG:
+            // Configure segmented RX mode
+            //
+            // Message format:
+            //     cmd_args_32[0]      Number of segments (0 or 1 disables segmented RX)
+            //
+            // Response format:
+            //     resp_args_32[0]     Status
+            //     resp_args_32[1]     Number of segments
+            //     resp_args_32[2]     Segment size (in samples; ie the offset between the start of each segment)
+            //
+            // NOTE:  Each segment is rx_buffer_size bytes (ie the Rx length aligned to the Rx transfer boundary).
+            //     Segmented RX requires DDR and an Rx length of at least WL_BUF_RX_TRANSFER_THRESHOLD_SAMPLES since
+            //     the segment is advanced when the RX interrupt transfers the end of the buffer (see
+            //     wl_buffers_core_rx_xfer_done()).  Configuring the segments resets the segment index and count
+            //     and must not be done during a reception.  Changing the Rx length disables segmented RX.
+            //
+            status = CMD_PARAM_SUCCESS;
+            mode   = Xil_Ntohl(cmd_args_32[0]);
+
+            if (mode > 1) {
+                if ((use_dram_for_buffers == 0) || ((wl_bb_get_rx_length() + 1) < WL_BUF_RX_TRANSFER_THRESHOLD_SAMPLES) ||
+                    (mode > CMD_PARAM_BASEBAND_RX_SEGMENT_MAX) || (mode > (wl_iq_rx_buff_a_size / rx_buffer_size)) || (rx_accum_en)) {
+
+                    wl_printf(WL_PRINT_ERROR, print_type_baseband,
+                              "Segmented Rx not supported for %d segments of %d samples\n", mode, (rx_buffer_size >> 2));
+
+                    status = CMD_PARAM_ERROR;
+                    mode   = 0;
+                }
+            } else {
+                mode       = 0;
+            }
+
+            // Wait for any transfers of the previous reception before moving the segment
+            wl_cdma_wait_all();
+
+            prev_interrupt_state = wl_interrupt_stop();
+
+            rx_seg_num     = mode;
+            rx_seg_base    = 0;
+            rx_seg_index   = 0;
+            rx_seg_count   = 0;
+
+            wl_interrupt_restore_state(prev_interrupt_state);
+
+            // Send response
+            resp_args_32[resp_index++] = Xil_Htonl(status);
+            resp_args_32[resp_index++] = Xil_Htonl(rx_seg_num);
+            resp_args_32[resp_index++] = Xil_Htonl((rx_seg_num) ? (rx_buffer_size >> 2) : 0);
+
+            resp_hdr->length  += (resp_index * sizeof(resp_args_32));
+            resp_hdr->num_args = resp_index;
+        break;
+
+
+        //---------------------------------------------------------------------
+        case CMDID_BASEBAND_RX_SEGMENT_STATUS:
+            // Get the segmented RX status
+            //
+            // Message format:
+            //     cmd_args_32[0]      Index of the first segment to return
+            //
+            // Response format:
+            //     resp_args_32[0]     Number of segments
+            //     resp_args_32[1]     Segment size (in samples)
+            //     resp_args_32[2]     Number of receptions captured (segments are overwritten once this
+            //                             is greater than the number of segments)
+            //     resp_args_32[3]     Index of the next segment to be written
+            //     resp_args_32[4]     Number of segments returned (N; at most CMD_PARAM_BASEBAND_RX_SEGMENT_STATUS_MAX)
+            //     resp_args_32[5:]    For each of the N segments:
+            //                             Timestamp MSB (usec timestamp when the reception finished)
+            //                             Timestamp LSB
+            //                             Rx count of the reception
+            //
+            offset   = Xil_Ntohl(cmd_args_32[0]);
+
+            prev_interrupt_state = wl_interrupt_stop();
+
+            resp_args_32[resp_index++] = Xil_Htonl(rx_seg_num);
+            resp_args_32[resp_index++] = Xil_Htonl((rx_seg_num) ? (rx_buffer_size >> 2) : 0);
+            resp_args_32[resp_index++] = Xil_Htonl(rx_seg_count);
+            resp_args_32[resp_index++] = Xil_Htonl(rx_seg_index);
+
+            temp     = (offset < rx_seg_num) ? (rx_seg_num - offset) : 0;
+
+            if (temp > CMD_PARAM_BASEBAND_RX_SEGMENT_STATUS_MAX) {
+                temp     = CMD_PARAM_BASEBAND_RX_SEGMENT_STATUS_MAX;
+            }
+
+            resp_args_32[resp_index++] = Xil_Htonl(temp);
+
+            for (i = offset; i < (offset + temp); i++) {
+                timestamp                  = rx_seg_timestamp[i];
+
+                resp_args_32[resp_index++] = Xil_Htonl((u32)(timestamp >> 32));
+                resp_args_32[resp_index++] = Xil_Htonl((u32)(timestamp & 0xFFFFFFFF));
+                resp_args_32[resp_index++] = Xil_Htonl(rx_seg_rx_count[i]);
+            }
+
+            wl_interrupt_restore_state(prev_interrupt_state);
+
+            resp_hdr->length  += (resp_index * sizeof(resp_args_32));
+            resp_hdr->num_args = resp_index;
+        break;
+
+
+        //---------------------------------------------------------------------
+        case CMDID_BASEBAND_RX_ACCUM_CONFIG:
+            // Configure RX accumulation mode
+            //
+            // Message format:
+            //     cmd_args_32[0]      Mode (CMD_PARAM_BASEBAND_RX_ACCUM_*)
+            //
+            // Response format:
+            //     resp_args_32[0]     Status
+            //     resp_args_32[1]     Accumulator offset (in 32-bit words from the start of the RX buffer; ie the
+            //                             start sample of a Read IQ of the accumulator)
+            //     resp_args_32[2]     Accumulator length (in 32-bit words; ie 2 words (I, Q) per sample)
+            //
+            // NOTE:  Enabling RX accumulation (re)starts the accumulation:  the accumulators of all RX buffers are
+            //     cleared along with the count.  RX accumulation requires DDR, an Rx length of at least
+            //     WL_BUF_RX_TRANSFER_THRESHOLD_SAMPLES (see CMDID_BASEBAND_RX_SEGMENT_CONFIG), that segmented RX
+            //     is disabled, and that the accumulator (2x the RX buffer) fits in the RX buffer after the reception.
+            //     Changing the Rx length disables RX accumulation.
+            //
+            status = CMD_PARAM_SUCCESS;
+            mode   = Xil_Ntohl(cmd_args_32[0]);
+
+            // Stop any accumulation in progress
+            wl_cdma_wait_all();
+
+            prev_interrupt_state = wl_interrupt_stop();
+
+            rx_accum_en      = 0;
+            rx_accum_pending = 0;
+
+            wl_interrupt_restore_state(prev_interrupt_state);
+
+            if (mode == CMD_PARAM_BASEBAND_RX_ACCUM_ENABLE) {
+                sample_length = wl_bb_get_rx_length() + 1;
+
+                if ((use_dram_for_buffers == 0) || (sample_length < WL_BUF_RX_TRANSFER_THRESHOLD_SAMPLES) ||
+                    (rx_seg_num) || (rx_buffer_size > (wl_iq_rx_buff_a_size / 3))) {
+
+                    wl_printf(WL_PRINT_ERROR, print_type_baseband, "Rx accumulation not supported for %d samples\n", sample_length);
+
+                    status = CMD_PARAM_ERROR;
+                } else {
+                    rx_accum_clear(sample_length);
+
+                    rx_accum_length   = sample_length;
+                    rx_accum_samp     = 0;
+                    rx_accum_count    = 0;
+                    rx_accum_overruns = 0;
+                    rx_accum_en       = 1;
+                }
+            }
+
+            // Send response
+            resp_args_32[resp_index++] = Xil_Htonl(status);
+            resp_args_32[resp_index++] = Xil_Htonl((rx_accum_en) ? (rx_buffer_size >> 2) : 0);
+            resp_args_32[resp_index++] = Xil_Htonl((rx_accum_en) ? (rx_accum_length << 1) : 0);
+
+            resp_hdr->length  += (resp_index * sizeof(resp_args_32));
+            resp_hdr->num_args = resp_index;
+        break;
+
+
+        //---------------------------------------------------------------------
+        case CMDID_BASEBAND_RX_ACCUM_STATUS:
+            // Get the RX accumulation status
+            //
+            // Response format:
+            //     resp_args_32[0]     Enabled
+            //     resp_args_32[1]     Number of receptions accumulated
+            //     resp_args_32[2]     Number of receptions that were not (completely) accumulated
+            //     resp_args_32[3]     Busy (ie a reception is being accumulated)
+            //     resp_args_32[4]     Accumulator offset (in 32-bit words)
+            //     resp_args_32[5]     Accumulator length (in 32-bit words)
+            //
+            // NOTE:  The accumulator is only valid if the node is not busy and there are no overruns.
+            //
+            resp_args_32[resp_index++] = Xil_Htonl(rx_accum_en);
+            resp_args_32[resp_index++] = Xil_Htonl(rx_accum_count);
+            resp_args_32[resp_index++] = Xil_Htonl(rx_accum_overruns);
+            resp_args_32[resp_index++] = Xil_Htonl((rx_accum_pending) ? 1 : 0);
+            resp_args_32[resp_index++] = Xil_Htonl((rx_accum_en) ? (rx_buffer_size >> 2) : 0);
+            resp_args_32[resp_index++] = Xil_Htonl((rx_accum_en) ? (rx_accum_length << 1) : 0);
+
+            resp_hdr->length  += (resp_index * sizeof(resp_args_32));
+            resp_hdr->num_args = resp_index;
+        break;
+
+
+        //---------------------------------------------------------------------
+        case CMDID_BASEBAND_READ_IQ_SCHEDULE:
+            // Configure the schedule of scheduled Read IQ requests (see READ_IQ_FLAG_SCHEDULE)
+            //
+            // Message format:
+            //     cmd_args_32[0]      Rank of the node (CMD_PARAM_BASEBAND_READ_IQ_RANK_NODE_ID - use the node ID)
+            //     cmd_args_32[1]      Slot time (in usec; 0 - time on the wire of the response)
+            //     cmd_args_32[2]      Rate cap (in Mbps; 0 - no rate cap)
+            //
+            // Response format:
+            //     resp_args_32[0]     Status
+            //     resp_args_32[1]     Rank of the node
+            //     resp_args_32[2]     Slot time (in usec)
+            //     resp_args_32[3]     Rate cap (in Mbps)
+            //
+            // NOTE:  The node ID is a good rank when the nodes have consecutive IDs starting at 0 (ie the
+            //     default for wl_initNodes()).  Otherwise, the host should assign the ranks.
+            //
+            status                  = CMD_PARAM_SUCCESS;
+
+            read_iq_sched_rank      = Xil_Ntohl(cmd_args_32[0]);
+            read_iq_sched_slot_time = Xil_Ntohl(cmd_args_32[1]);
+            read_iq_sched_rate      = Xil_Ntohl(cmd_args_32[2]);
+
+            // Send response
+            resp_args_32[resp_index++] = Xil_Htonl(status);
+            resp_args_32[resp_index++] = Xil_Htonl((read_iq_sched_rank == CMD_PARAM_BASEBAND_READ_IQ_RANK_NODE_ID) ? node : read_iq_sched_rank);
+            resp_args_32[resp_index++] = Xil_Htonl(read_iq_sched_slot_time);
+            resp_args_32[resp_index++] = Xil_Htonl(read_iq_sched_rate);
+
+            resp_hdr->length  += (resp_index * sizeof(resp_args_32));
+            resp_hdr->num_args = resp_index;
+        break;
+
+
+        //---------------------------------------------------------------------
+        case CMDID_BASEBAND_SAMPLE_BYTE_ORDER:
+            // Get / Set the byte order of the samples in the buffers and on the wire
+            //
+            // Message format:
+            //     cmd_args_32[0]      Command:
+            //                             - Write       (NODE_WRITE_VAL)
+            //                             - Read        (NODE_READ_VAL)
+            //     cmd_args_32[1]      Byte order (CMD_PARAM_BASEBAND_SAMPLE_BYTE_ORDER_*)
+            //
+            // Response format:
+            //     resp_args_32[0]     Status
+            //     resp_args_32[1]     Current byte order
+            //
+            // NOTE:  The byte order is set by the host after the node is initialized (baseband_reset()
+            //     restores big endian).  Samples that are already in the buffers are not converted.
+            //
+            status  = CMD_PARAM_SUCCESS;
+            msg_cmd = Xil_Ntohl(cmd_args_32[0]);
+
+            switch (msg_cmd) {
+                case CMD_PARAM_WRITE_VAL:
+                    temp = Xil_Ntohl(cmd_args_32[1]);
+
+                    switch (temp) {
+                        case CMD_PARAM_BASEBAND_SAMPLE_BYTE_ORDER_BIG:
+                        case CMD_PARAM_BASEBAND_SAMPLE_BYTE_ORDER_LITTLE:
+                            samp_byte_order = temp;
+                            baseband_hw_specific_reset();
+                        break;
+
+                        default:
+                            wl_printf(WL_PRINT_ERROR, print_type_baseband, "Unsupported sample byte order: %d\n", temp);
+                            status = CMD_PARAM_ERROR;
+                        break;
+                    }
+                break;
+
+                case CMD_PARAM_READ_VAL:
+                break;
+
+                default:
+                    wl_printf(WL_PRINT_ERROR, print_type_baseband, "Unknown command for 0x%6x: %d\n", cmd_id, msg_cmd);
+                    status = CMD_PARAM_ERROR;
+                break;
+            }
+
+            // Send response
+            resp_args_32[resp_index++] = Xil_Htonl(status);
+            resp_args_32[resp_index++] = Xil_Htonl(samp_byte_order);
+
+            resp_hdr->length  += (resp_index * sizeof(resp_args_32));
+            resp_hdr->num_args = resp_index;
+        break;
+
+
         //---------------------------------------------------------------------
         case CMDID_BASEBAND_TX_BUFF_EN:
             // Enable TX buffers
@@ -794,7 +1268,9 @@ int baseband_process_cmd(int socket_index, void * from, wl_cmd_resp * command, w
             //   - resp_args_32[1]     - IQ ID
             //   - resp_args_32[2]     - Current checksum            (ignore if Status != CMD_PARAM_SUCCESS)
             //   - resp_args_32[3]     - Tx status                   (ignore if Status != SAMPLE_HDR_FLAG_IQ_NOT_READY)
+            //                           Tx read pointer (samples)   (if Status == CMD_PARAM_SUCCESS in streaming TX mode)
             //   - resp_args_32[4]     - Current Tx read pointer     (ignore if Status != SAMPLE_HDR_FLAG_IQ_NOT_READY)
+            //                           Tx stream underruns         (if Status == CMD_PARAM_SUCCESS in streaming TX mode)
             //   - resp_args_32[5]     - Tx length                   (ignore if Status != SAMPLE_HDR_FLAG_IQ_NOT_READY)
             //   - resp_args_32[6]     - Rx status                   (ignore if Status != SAMPLE_HDR_FLAG_IQ_NOT_READY)
             //   - resp_args_32[7]     - Current Rx write pointer    (ignore if Status != SAMPLE_HDR_FLAG_IQ_NOT_READY)
@@ -807,6 +1283,13 @@ int baseband_process_cmd(int socket_index, void * from, wl_cmd_resp * command, w
             //   NOTE:  Node will return SAMPLE_HDR_FLAG_IQ_ERROR if in continuous Tx
             //       mode since the node will never be ready.
             //
+            //   NOTE:  In streaming TX mode, the start sample is the stream sample index.  The node returns
+            //       SAMPLE_HDR_FLAG_IQ_NOT_READY if the write would overwrite samples of the ring that have not
+            //       been transmitted.  In this case, the Tx read pointer and Tx length are the byte position of
+            //       the stream and the byte position the stream must reach so the write can be processed.  On
+            //       success, the Tx read pointer is the stream index of the next sample to be transmitted.
+            //       Otherwise, it is the sample index of the current Tx read offset.
+            //
             samp_hdr         = (wl_bb_samp_hdr *)cmd_args_32;
 
             // Parse the command arguments
@@ -871,7 +1354,16 @@ int baseband_process_cmd(int socket_index, void * from, wl_cmd_resp * command, w
             }
 
             // Check Write IQ command parameters
-            if (check_status) {
+            if (check_status && tx_stream_en) {
+                //
+                // NOTE:  In streaming TX mode, the write only needs to wait if it would overwrite samples of the
+                //     ring that have not been transferred to the temporary TX buffers.  Transfers to the temporary
+                //     TX buffers are queued by the TX interrupt ahead of any Write IQ transfers, so samples that
+                //     have been transferred can be overwritten.
+                //
+                status         = ((s32)((start_samp + num_samp) - (tx_stream_rd_samp + tx_stream_length)) > 0);
+
+            } else if (check_status) {
                 //
                 // NOTE:  We will only allow a write of an IQ buffer that is currently transmitting data if the
                 //     requested write is at least 16 kSamples (64 kB) behind the current write pointer (ie the
@@ -895,7 +1387,19 @@ int baseband_process_cmd(int socket_index, void * from, wl_cmd_resp * command, w
             //     If yes, then tell the host to wait and request again.
             if (status) {
 
-                if (wl_bb_get_config() & WL_BUF_REG_CONFIG_CONT_TX) {
+                if (tx_stream_en) {
+                    // If we are in 'streaming tx' mode, then return 'not ready' with the stream position
+                    resp_args_32[resp_index++] = Xil_Htonl(SAMPLE_HDR_FLAG_IQ_NOT_READY);                    // Status
+                    resp_args_32[resp_index++] = Xil_Htonl(sample_iq_id);                                    // ID
+                    resp_args_32[resp_index++] = 0x00000000;                                                 // Checksum
+                    resp_args_32[resp_index++] = Xil_Htonl(wl_bb_get_tx_status());                           // Tx status
+                    resp_args_32[resp_index++] = Xil_Htonl((tx_stream_rd_samp << 2));                        // Tx pointer
+                    resp_args_32[resp_index++] = Xil_Htonl(((start_samp + num_samp - tx_stream_length) << 2)); // Tx length
+                    resp_args_32[resp_index++] = Xil_Htonl(wl_bb_get_rx_status());                           // Rx status
+                    resp_args_32[resp_index++] = Xil_Htonl((wl_bb_get_rf_rx_iq_buf_wr_byte_offset() + 4));   // Rx pointer
+                    resp_args_32[resp_index++] = Xil_Htonl(((wl_bb_get_rx_length() + 1) << 2));              // Rx length
+
+                } else if (wl_bb_get_config() & WL_BUF_REG_CONFIG_CONT_TX) {
                     // If we are in 'continuous tx' mode, then return 'error'
                     resp_args_32[resp_index++] = Xil_Htonl(SAMPLE_HDR_FLAG_IQ_ERROR);                        // Status
                     resp_args_32[resp_index++] = Xil_Htonl(sample_iq_id);                                    // ID
@@ -922,7 +1426,7 @@ int baseband_process_cmd(int socket_index, void * from, wl_cmd_resp * command, w
                 samp_addr              = (void *)samp_hdr + sizeof(wl_bb_samp_hdr);
                 samp_addr_32           = (u32 *)samp_addr;
                 samp_len               = num_samp * sizeof(wl_samp);
-                checksum_input_32      = Xil_Ntohl(samp_addr_32[num_samp-1]);
+                checksum_input_32      = wl_bb_samp_ntoh(samp_byte_order, samp_addr_32[num_samp-1]);
                 checksum_input_16      = (checksum_input_32 >> 16) ^ (0xFFFF & checksum_input_32);
 
                 // Update the write checksum
@@ -937,11 +1441,22 @@ int baseband_process_cmd(int socket_index, void * from, wl_cmd_resp * command, w
                 resp_args_32[resp_index++]  = Xil_Htonl(CMD_PARAM_SUCCESS);                        // Status
                 resp_args_32[resp_index++]  = Xil_Htonl(sample_iq_id);                             // ID
                 resp_args_32[resp_index++]  = Xil_Htonl(curr_checksum);                            // Checksum
+
+                // Write the samples
+                //     NOTE:  In streaming TX mode, the response also carries the Tx read pointer for host flow control
+                //
+                if (tx_stream_en) {
+                    write_tx_stream(buff_sel, (u32)(samp_addr), start_samp, num_samp);
+
+                    resp_args_32[resp_index++]  = Xil_Htonl(tx_stream_rd_samp);                    // Tx read pointer
+                    resp_args_32[resp_index++]  = Xil_Htonl(tx_stream_underruns);                  // Tx underruns
+                } else {
+                    write_tx_buffers(buff_sel, (u32)(samp_addr), offset, samp_len);
+                }
+
                 resp_hdr->length           += (resp_index * sizeof(resp_args_32));
                 resp_hdr->num_args          = resp_index;
 
-                write_tx_buffers(buff_sel, (u32)(samp_addr), offset, samp_len);
-
                 // If this is the last transfer for a WRITE IQ, then we need to populate the temporary buffers
                 // that have been written
                 //
@@ -952,6 +1467,9 @@ int baseband_process_cmd(int socket_index, void * from, wl_cmd_resp * command, w
                 if (flags & SAMPLE_HDR_FLAG_LAST_WRITE) {
 
                     populate_tmp_tx_buffers(((~wl_bb_get_tx_status()) & buff_sel), 0x0, WARPLAB_IQ_TX_BUF_SIZE);
+
+                    // The temporary buffers must be populated before a trigger can start the transmission
+                    wl_cdma_wait_all();
                 }
             }
         break;
@@ -973,14 +1491,58 @@ int baseband_process_cmd(int socket_index, void * from, wl_cmd_resp * command, w
         case CMDID_BASEBAND_READ_RSSI:
             // BB_READ_IQ / BB_READ_RSSI Packet Format:
             //
-            //   - cmd_args_32[0]      - Buffer selection (guaranteed to be singular) (uint16)
+            //   - cmd_args_32[0]      - Buffer selection
+            //                               [31]   - Interleave buffers (READ_IQ_FLAG_INTERLEAVE)
+            //                               [30]   - Stream samples during a reception (READ_IQ_FLAG_STREAM)
+            //                               [29:28]- Sample format (READ_IQ_FORMAT_*)
+            //                               [27:26]- Start sample reference (READ_IQ_WINDOW_*)
+            //                               [25]   - Send capture metadata (READ_IQ_FLAG_METADATA)
+            //                               [24]   - Park the request until the reception is done (READ_IQ_FLAG_DEFER)
+            //                               [23:16]- Deadline of a parked request (READ_IQ_DEFER_TIMEOUT_UNIT usec)
+            //                               [15]   - Wait for the transmit slot of the node (READ_IQ_FLAG_SCHEDULE)
+            //                               [3:0]  - Mask of buffers to read (RF_SEL_*)
             //   - cmd_args_32[1]      - Start sample
-            //   - cmd_args_32[2]      - Total samples in transfer
+            //   - cmd_args_32[2]      - Total samples in transfer (per buffer)
             //   - cmd_args_32[3]      - Maximum number of samples per packet
-            //   - cmd_args_32[4]      - Number of packets in transfer
+            //   - cmd_args_32[4]      - Number of packets in transfer (per buffer)
             //
             //   - resp_args           - Samples:  wl_bb_samp_hdr followed by appropriate samples
             //
+            //   NOTE:  The buff_sel field of each sample header contains the single buffer the samples
+            //       were read from.  If multiple buffers are selected, then (num_pkts * num_buffers)
+            //       packets are sent for the request.  Buffers are sent in the order RFA -> RFB -> RFC
+            //       -> RFD, either one buffer at a time or, if READ_IQ_FLAG_INTERLEAVE is set, one packet
+            //       of each buffer for every set of samples.
+            //
+            //   NOTE:  If a compressed sample format is requested, then the samples after the sample header
+            //       are compressed (see read_iq_compress()) and the sample header flags contain the format
+            //       (SAMPLE_HDR_FLAG_FORMAT_*).  The num_samp field of the sample header is still the number of
+            //       samples.  Read RSSI samples are not compressed.  Since the host sizes the packets of a compressed
+            //       request by the compressed bytes, a request with a reserved format or whose compressed packets
+            //       do not fit in the compression buffers fails with SAMPLE_HDR_FLAG_IQ_ERROR.
+            //
+            //   NOTE:  If the start sample reference is READ_IQ_WINDOW_AGC_DONE, then the start sample is a
+            //       signed offset from the AGC done address (ie a negative start sample gives pre-trigger
+            //       samples).  The start_samp field of each sample header is in the same coordinates as the
+            //       request so the host does not need to know the AGC done address.  Samples outside the
+            //       buffer are returned as zeros.  The reference is only supported for Read IQ.
+            //
+            //   NOTE:  If READ_IQ_FLAG_METADATA is set, then one additional packet is sent before the samples.
+            //       The sample header of the packet has SAMPLE_HDR_FLAG_METADATA set, the buffer selection and
+            //       start sample of the request, and num_samp of zero.  The payload is a wl_bb_read_iq_metadata
+            //       for each selected buffer (see read_iq_metadata()).  The metadata is only supported for Read IQ.
+            //       If READ_IQ_FLAG_STREAM is also set, then the metadata is sampled before the reception is done.
+            //       If the number of packets is zero, then only the metadata packet is sent (ie the host lost the
+            //       metadata packet but received all of the samples).
+            //
+            //   NOTE:  If READ_IQ_FLAG_DEFER is set and the request would return SAMPLE_HDR_FLAG_IQ_NOT_READY,
+            //       then the request is parked and processed once the reception is done (see read_iq_defer_park()).
+            //       No packet is sent to the host until then.
+            //
+            //   NOTE:  If READ_IQ_FLAG_STREAM is set and a selected buffer is currently receiving, then
+            //       the node will not return SAMPLE_HDR_FLAG_IQ_NOT_READY.  Instead, each packet is sent
+            //       as soon as the reception has written the samples for the packet to the buffer.
+            //
             //   NOTE:  If the sample header flags == SAMPLE_HDR_FLAG_IQ_NOT_READY, then the "samples"
             //       after the sample header need to be interpreted in the following manner:
             //
@@ -1003,27 +1565,62 @@ int baseband_process_cmd(int socket_index, void * from, wl_cmd_resp * command, w
             // wl_printf(WL_PRINT_DEBUG, print_type_baseband, "Read IQ\n");
 
             // Process command arguments
-            buff_sel              = Xil_Ntohl(cmd_args_32[0]);
+            read_iq_flags         = Xil_Ntohl(cmd_args_32[0]);
+            buff_sel              = read_iq_flags & READ_IQ_BUFF_SEL_MASK;
             start_samp            = Xil_Ntohl(cmd_args_32[1]);
             total_samp            = Xil_Ntohl(cmd_args_32[2]);
             max_samp_len_per_pkt  = Xil_Ntohl(cmd_args_32[3]);
             num_pkts              = Xil_Ntohl(cmd_args_32[4]);
 
-            // Set the sample_iq_id
-            //   NOTE:  This is the lower 8 bits of the RX counter for the given buffer.  Since buff_sel is
-            //       guaranteed to be a single value (ie one of RFA, RFB, RFC, or RFD), this will always
-            //       select the appropriate RX counter.
+            // Create the list of buffers to read and set the sample_iq_id for each buffer
+            //   NOTE:  The sample_iq_id is the lower 8 bits of the RX counter for the given buffer.
             //
-            sample_iq_id          = 0;
+            num_buffs             = 0;
+
+            if (buff_sel & RF_SEL_A) { read_buff_sel[num_buffs] = RF_SEL_A;  read_iq_id[num_buffs++] = (wl_bb_get_rfa_rx_count() & 0x000000FF); }
+            if (buff_sel & RF_SEL_B) { read_buff_sel[num_buffs] = RF_SEL_B;  read_iq_id[num_buffs++] = (wl_bb_get_rfb_rx_count() & 0x000000FF); }
+            if (buff_sel & RF_SEL_C) { read_buff_sel[num_buffs] = RF_SEL_C;  read_iq_id[num_buffs++] = (wl_bb_get_rfc_rx_count() & 0x000000FF); }
+            if (buff_sel & RF_SEL_D) { read_buff_sel[num_buffs] = RF_SEL_D;  read_iq_id[num_buffs++] = (wl_bb_get_rfd_rx_count() & 0x000000FF); }
 
-            if      (buff_sel & RF_SEL_A) { sample_iq_id = (wl_bb_get_rfa_rx_count() & 0x000000FF); }
-            else if (buff_sel & RF_SEL_B) { sample_iq_id = (wl_bb_get_rfb_rx_count() & 0x000000FF); }
-            else if (buff_sel & RF_SEL_C) { sample_iq_id = (wl_bb_get_rfc_rx_count() & 0x000000FF); }
-            else if (buff_sel & RF_SEL_D) { sample_iq_id = (wl_bb_get_rfd_rx_count() & 0x000000FF); }
+            // If no buffer is selected, then send a single set of packets that will be filled with zeros by read_rx_buffers()
+            if (num_buffs == 0) {
+                read_buff_sel[num_buffs] = buff_sel;
+                read_iq_id[num_buffs++]  = 0;
+            }
+
+            sample_iq_id          = read_iq_id[0];
 
             // Calculate the maximum samples per packet
             max_samp_per_pkt      = max_samp_len_per_pkt / sizeof(wl_samp);      // This is an constant integer division that is optimized away by the compiler
 
+            // Determine the sample format
+            //     NOTE:  The host sizes the packets of a compressed request by the compressed bytes, so the raw
+            //            samples of a packet do not fit in the transport payload.  Therefore, a request whose
+            //            compressed packets do not fit in the compression buffers fails instead of being sent raw.
+            //
+            read_iq_format        = read_iq_flags & READ_IQ_FORMAT_MASK;
+            req_error             = 0;
+
+            if (cmd_id != CMDID_BASEBAND_READ_IQ) {
+                read_iq_format    = READ_IQ_FORMAT_RAW;
+            }
+
+            if ((read_iq_format == READ_IQ_FORMAT_RSVD) || ((read_iq_format != READ_IQ_FORMAT_RAW) &&
+                (read_iq_compressed_length(read_iq_format, max_samp_per_pkt) > WL_BASEBAND_ETH_COMPRESS_BUFFER_SIZE))) {
+                wl_printf(WL_PRINT_ERROR, print_type_baseband, "Read IQ packet of %d samples cannot be compressed\n", max_samp_per_pkt);
+                req_error         = 1;
+            }
+
+            // Resolve the start sample reference
+            //     NOTE:  All sample indexes of the request are in "request" coordinates.  Only the byte offsets
+            //            in to the buffer (and the ready check below) use the absolute sample index.
+            //
+            if ((cmd_id == CMDID_BASEBAND_READ_IQ) && ((read_iq_flags & READ_IQ_WINDOW_MASK) == READ_IQ_WINDOW_AGC_DONE)) {
+                window_base       = wl_bb_get_agc_done_addr();
+            } else {
+                window_base       = 0;
+            }
+
             // Initialize loop variables
             num_samp              = 0;
             curr_samp             = start_samp;
@@ -1046,23 +1643,79 @@ int baseband_process_cmd(int socket_index, void * from, wl_cmd_resp * command, w
             //     Read IQ process will transfer 16 kSample "chunks" from BRAM to DDR, which is where is it
             //     read for the Read IQ command).
             //
-            temp_threshold = ((start_samp + (WL_BUF_RX_TRANSFER_THRESHOLD_SAMPLES)) << 2);
+            temp_threshold = ((start_samp + window_base + (WL_BUF_RX_TRANSFER_THRESHOLD_SAMPLES)) << 2);
             temp_status    = (wl_bb_get_rx_status()) & buff_sel;
             temp_offset    = (wl_bb_get_rf_rx_iq_buf_wr_byte_offset() + 4);
             status         = (temp_status) && (temp_offset < temp_threshold);
 
+            // In streaming mode, the read is never deferred.  Each packet will wait for its samples
+            //     while the reception is ongoing (see wait_rx_samples()).  If a newer packet arrives from the
+            //     host while waiting (eg the host timed out and sent the request again), then the remaining
+            //     packets are not sent.
+            //
+            stream_rx      = 0;
+
+            if (read_iq_flags & READ_IQ_FLAG_STREAM) {
+                stream_rx  = temp_status;
+                status     = 0;
+            }
+
+
+            // Park the read request until the reception is done if the host asked for it
+            //     NOTE:  The response is sent when the request is processed again (see read_iq_defer_service())
+            //
+            if ((status) && (cmd_id == CMDID_BASEBAND_READ_IQ) && (read_iq_flags & READ_IQ_FLAG_DEFER)) {
+                if (read_iq_defer_park(socket_index, from, command, response) == XST_SUCCESS) {
+                    resp_sent = RESP_SENT;
+                    break;
+                }
+            }
+
+            // Compute the wait for the transmit slot of the node
+            //     NOTE:  Ethernet packets are not processed while waiting, so a request whose slot starts more
+            //            than WL_READ_IQ_SCHEDULE_MAX_WAIT usec after it is processed fails with
+            //            SAMPLE_HDR_FLAG_IQ_ERROR instead of sending the samples outside of its slot.
+            //
+            sched_wait            = 0;
+
+            if ((status == 0) && (req_error == 0) && (read_iq_flags & READ_IQ_FLAG_SCHEDULE)) {
+                if (read_iq_sched_slot_time) {
+                    sched_wait    = read_iq_sched_slot_time;
+                } else {
+                    if (read_iq_format != READ_IQ_FORMAT_RAW) {
+                        wire_len  = read_iq_compressed_length(read_iq_format, max_samp_per_pkt);
+                    } else {
+                        wire_len  = max_samp_per_pkt * sizeof(wl_samp);
+                    }
+
+                    num_meta_pkts = ((cmd_id == CMDID_BASEBAND_READ_IQ) && (read_iq_flags & READ_IQ_FLAG_METADATA)) ? 1 : 0;
+                    sched_rate    = (read_iq_sched_rate) ? read_iq_sched_rate : WL_READ_IQ_SCHEDULE_LINK_RATE;
+                    sched_wait    = ((((u64)((num_pkts * num_buffs) + num_meta_pkts)) * (sizeof(warp_ip_udp_header) + sizeof(wl_transport_header) + sizeof(wl_cmd_resp_hdr) + sizeof(wl_bb_samp_hdr) + WL_READ_IQ_SCHEDULE_PKT_OVERHEAD + wire_len) * 8) / sched_rate) + 1;
+                }
+
+                if (read_iq_sched_rank == CMD_PARAM_BASEBAND_READ_IQ_RANK_NODE_ID) {
+                    sched_wait   *= node;
+                } else {
+                    sched_wait   *= read_iq_sched_rank;
+                }
+
+                if (sched_wait > WL_READ_IQ_SCHEDULE_MAX_WAIT) {
+                    wl_printf(WL_PRINT_ERROR, print_type_baseband, "Read IQ slot wait of %d usec is longer than %d usec\n", (u32)sched_wait, WL_READ_IQ_SCHEDULE_MAX_WAIT);
+                    req_error   = 1;
+                }
+            }
 
             // Check if we need to defer the read request due to an ongoing reception
             //     If yes, then tell the host to wait and request again
             //
-            if (status) {
+            if (status || req_error) {
 
                 // Fill in parts of sample header that do not change between Write IQ packets
                 samp_hdr                   = (wl_bb_samp_hdr *)resp_args_32;
                 samp_hdr->buff_sel         = (u16)buff_sel;
                 samp_hdr->buff_sel         = Xil_Htons(samp_hdr->buff_sel);
 
-                samp_hdr->flags            = SAMPLE_HDR_FLAG_IQ_NOT_READY;
+                samp_hdr->flags            = (req_error) ? SAMPLE_HDR_FLAG_IQ_ERROR : SAMPLE_HDR_FLAG_IQ_NOT_READY;
 
                 resp_args_32               = (u32 *)dest_addr;
 
@@ -1153,10 +1806,16 @@ int baseband_process_cmd(int socket_index, void * from, wl_cmd_resp * command, w
                 //
 
                 // Fill in parts of sample header that do not change between Read IQ packets
-                samp_hdr->buff_sel     = (u16)buff_sel;
-                samp_hdr->buff_sel     = Xil_Htons(samp_hdr->buff_sel);
-                samp_hdr->sample_iq_id = sample_iq_id;
-                samp_hdr->flags        = 0;
+                //     NOTE:  The buffer select and sample IQ ID are set per packet since a request can
+                //            contain packets from multiple buffers.
+                //
+                switch (read_iq_format) {
+                    case READ_IQ_FORMAT_12BIT:  samp_flags = SAMPLE_HDR_FLAG_FORMAT_12BIT;  break;
+                    case READ_IQ_FORMAT_BFP:    samp_flags = SAMPLE_HDR_FLAG_FORMAT_BFP;    break;
+                    default:                    samp_flags = (samp_byte_order == CMD_PARAM_BASEBAND_SAMPLE_BYTE_ORDER_LITTLE) ? SAMPLE_HDR_FLAG_LITTLE_ENDIAN : 0;  break;
+                }
+
+                samp_hdr->flags        = samp_flags;
 
                 // Populate response header fields with static data
                 resp_hdr->cmd          = Xil_Ntohl(resp_hdr->cmd);
@@ -1184,73 +1843,259 @@ int baseband_process_cmd(int socket_index, void * from, wl_cmd_resp * command, w
                 eth_ip_udp_header->udp_hdr.dest_port  = dest_port;
                 eth_ip_udp_header->udp_hdr.checksum   = UDP_NO_CHECKSUM;
 
-                // Set AXI BRAM address for the header
-                header_base_addr       = ETH_IQ_buffer;             // Use the buffer allocated above
-                header_offset          = 0;
-                header_buffer_size     = WL_BASEBAND_ETH_BUFFER_SIZE * WL_BASEBAND_ETH_NUM_BUFFER;
-
-                // Process the Read IQ / Read RSSI packets
-                for(i = 0; i < num_pkts; i++){
-
+                // Build the header template for a full size packet
+                //     NOTE:  The IPv4 header is only fully computed once per Read IQ request.  This will pull the
+                //            IP ID from the counter maintained in the library and compute the header checksum.  All
+                //            other packets in the request will apply an incremental update to the checksum (see
+                //            RFC 1624) for the fields that change between packets (ie IP ID and IP length).
+                //
+                if (read_iq_format != READ_IQ_FORMAT_RAW) {
+                    max_wire_len       = read_iq_compressed_length(read_iq_format, max_samp_per_pkt);
+                } else {
+                    max_wire_len       = max_samp_per_pkt * sizeof(wl_samp);
+                }
+
+                data_length            = max_wire_len + header_length;
+
+                resp_hdr->length       = Xil_Ntohs(max_wire_len + sizeof(wl_bb_samp_hdr));
+                wl_header_tx->length   = Xil_Htons(data_length + WARP_IP_UDP_DELIM_LEN);
+
+                eth_ip_udp_header->udp_hdr.length = Xil_Htons(udp_length + data_length);
+
+                ipv4_update_header(&(eth_ip_udp_header->ip_hdr), dest_ip_addr, (ip_length + data_length), IP_PROTOCOL_UDP);
+
+                ip_id                  = Xil_Ntohs(eth_ip_udp_header->ip_hdr.identification);
+                ip_total_length        = eth_ip_udp_header->ip_hdr.total_length;           // NOTE:  Value big endian
+                ip_checksum            = eth_ip_udp_header->ip_hdr.header_checksum;        // NOTE:  Value big endian
+
+                // Wait for any pending transfers of RX data to DDR
+                //     NOTE:  The final transfer of a reception is queued by the RX interrupt and could still
+                //            be in the CDMA queue even though the reception is done.
+                //
+                wl_cdma_wait_all();
+
+                // Set AXI BRAM address for the header
+                header_base_addr       = ETH_IQ_buffer;             // Use the buffer allocated above
+                header_offset          = 0;
+                header_buffer_size     = WL_BASEBAND_ETH_BUFFER_SIZE * WL_BASEBAND_ETH_NUM_BUFFER;
+
+                // Initialize loop variables for the buffer list
+                buff_index             = 0;
+                pkt_index              = 0;
+
+                // Send the metadata packet first if requested
+                if ((cmd_id == CMDID_BASEBAND_READ_IQ) && (read_iq_flags & READ_IQ_FLAG_METADATA)) {
+                    num_meta_pkts      = 1;
+                } else {
+                    num_meta_pkts      = 0;
+                }
+
+                // Wait for the transmit slot of the node
+                //     NOTE:  The slot is relative to when the request is processed, which is about the same time
+                //            on all nodes when the host sends the requests of all nodes at once.  The CDMA queue
+                //            is kept moving while waiting.  The packets are only paced if there is a rate cap.
+                //
+                sched_rate             = 0;
+
+                if (read_iq_flags & READ_IQ_FLAG_SCHEDULE) {
+                    timestamp          = get_usec_timestamp() + sched_wait;
+
+                    while (get_usec_timestamp() < timestamp) {
+                        wl_cdma_service();
+                    }
+
+                    sched_rate         = read_iq_sched_rate;
+                }
+
+                sched_start            = get_usec_timestamp();
+                sched_bits             = 0;
+
+                // Process the Read IQ / Read RSSI packets for all selected buffers
+                for(i = 0; i < ((num_pkts * num_buffs) + num_meta_pkts); i++){
+
                     // Update loop variables
                     header_addr     = (u8 *)(((u32)header_base_addr) + header_offset);
-                    next_start_samp = curr_samp + max_samp_per_pkt;
 
-                    if(next_start_samp > (start_samp + total_samp)){
-                        num_samp = (start_samp + total_samp) - curr_samp;
+                    if (i < num_meta_pkts) {
+                        num_samp         = 0;
+                        wire_len         = num_buffs * sizeof(wl_bb_read_iq_metadata);
                     } else {
-                        num_samp = max_samp_per_pkt;
+                        next_start_samp  = curr_samp + max_samp_per_pkt;
+
+                        if(next_start_samp > (start_samp + total_samp)){
+                            num_samp = (start_samp + total_samp) - curr_samp;
+                        } else {
+                            num_samp = max_samp_per_pkt;
+                        }
+
+                        samp_len         = num_samp * sizeof(wl_samp);
+                        start_byte       = (curr_samp + window_base) * sizeof(wl_samp);
+
+                        if (read_iq_format != READ_IQ_FORMAT_RAW) {
+                            wire_len     = read_iq_compressed_length(read_iq_format, num_samp);
+                        } else {
+                            wire_len     = samp_len;
+                        }
                     }
 
-                    samp_len             = num_samp * sizeof(wl_samp);
-                    start_byte           = curr_samp * sizeof(wl_samp);
-                    data_length          = samp_len + header_length;
+                    data_length          = wire_len + header_length;
+
+                    // Copy the header template to DMA accessible BRAM the first time each header buffer is used
+                    //     NOTE:  After this, only the fields that change between packets are written to the header
+                    //            buffer, which removes the per packet copy of the full header.
+                    //
+                    if (i < WL_BASEBAND_ETH_NUM_BUFFER) {
+                        memcpy((void *)header_addr, (void *)tmp_header, total_hdr_length);
+                    }
+
+                    // Set up pointers to the header fields in the header buffer
+                    eth_ip_udp_header    = (warp_ip_udp_header  *)(header_addr);
+                    wl_header_tx         = (wl_transport_header *)(header_addr + sizeof(warp_ip_udp_header));
+                    resp_hdr             = (wl_cmd_resp_hdr     *)(header_addr + sizeof(warp_ip_udp_header) + sizeof(wl_transport_header));
+                    samp_hdr             = (wl_bb_samp_hdr      *)(header_addr + sizeof(warp_ip_udp_header) + sizeof(wl_transport_header) + sizeof(wl_cmd_resp_hdr));
 
                     // Populate sample header fields with per packet data
-                    samp_hdr->start_samp = Xil_Htonl(curr_samp);
-                    samp_hdr->num_samp   = Xil_Htonl(num_samp);
+                    //     NOTE:  The flags are written for every packet since a header buffer can hold the
+                    //            metadata packet.
+                    //
+                    if (i < num_meta_pkts) {
+                        samp_hdr->buff_sel     = Xil_Htons((u16)buff_sel);
+                        samp_hdr->flags        = SAMPLE_HDR_FLAG_METADATA;
+                        samp_hdr->sample_iq_id = sample_iq_id;
+                    } else {
+                        samp_hdr->buff_sel     = Xil_Htons((u16)read_buff_sel[buff_index]);
+                        samp_hdr->flags        = samp_flags;
+                        samp_hdr->sample_iq_id = read_iq_id[buff_index];
+                    }
 
-                    // Populate response header fields with per packet data
-                    resp_hdr->length     = Xil_Ntohs(samp_len + sizeof(wl_bb_samp_hdr));
+                    samp_hdr->start_samp   = Xil_Htonl(curr_samp);
+                    samp_hdr->num_samp     = Xil_Htonl(num_samp);
 
-                    // Populate transport header fields with per packet data
+                    // Populate length fields with per packet data
+                    //     NOTE:  Only the last packet of a request is shorter than the template.  The length fields must
+                    //            still be written for every packet since a header buffer can hold the last packet of
+                    //            the previous pass through the header buffers.
+                    //
+                    resp_hdr->length     = Xil_Ntohs(wire_len + sizeof(wl_bb_samp_hdr));
                     wl_header_tx->length = Xil_Htons(data_length + WARP_IP_UDP_DELIM_LEN);
 
-                    // Update the UDP header
-                    //     NOTE:  Requires dest_port to be big-endian; udp_length to be little-endian
-                    //     NOTE:  Adapted from the function:
-                    //                udp_update_header(&(eth_ip_udp_header->udp_hdr), dest_port, (udp_length + data_length));
-                    //
-                    eth_ip_udp_header->udp_hdr.length = Xil_Htons(udp_length + data_length);
+                    eth_ip_udp_header->udp_hdr.length        = Xil_Htons(udp_length + data_length);
+                    eth_ip_udp_header->ip_hdr.total_length   = Xil_Htons(ip_length + data_length);
 
-                    // Update the IPv4 header
-                    //     NOTE:  Requires dest_ip_addr to be big-endian; ip_length to be little-endian
-                    //     NOTE:  We did not break this function apart like the other header updates b/c the IP ID counter is
-                    //            maintained in the library and we did not want to violate that.
+                    // Update the IPv4 header ID and checksum from the template
+                    //     NOTE:  The IP ID is incremented per packet the same way the library would.  The library
+                    //            counter is only advanced once per request, which is fine since all Read IQ packets
+                    //            are atomic datagrams (ie they are never fragmented).
                     //
-                    ipv4_update_header(&(eth_ip_udp_header->ip_hdr), dest_ip_addr, (ip_length + data_length), IP_PROTOCOL_UDP);
+                    eth_ip_udp_header->ip_hdr.identification = Xil_Htons((u16)(ip_id + i));
 
-                    // Copy the completed header to DMA accessible BRAM
-                    memcpy((void *)header_addr, (void *)tmp_header, total_hdr_length);
+                    temp = wl_ip_checksum_adjust(ip_checksum, Xil_Htons(ip_id), Xil_Htons((u16)(ip_id + i)));
+
+                    if (wire_len != max_wire_len) {
+                        temp = wl_ip_checksum_adjust(temp, ip_total_length, Xil_Htons(ip_length + data_length));
+                    }
+
+                    eth_ip_udp_header->ip_hdr.header_checksum = (u16)temp;
 
                     // Set the header buffer data / offset
                     header_buffer.data   = (u8 *)header_addr;
                     header_buffer.offset = (u8 *)header_addr;
 
-                    // Set up the IQ data for the Ethernet packet buffer
-                    read_rx_buffers(cmd_id, buff_sel, start_byte, samp_len, dest_addr, &sample_buffer);
+                    // Only a packet that straddles the beginning of a buffer uses the zero buffer
+                    zero_buffer.length   = 0;
+                    zero_buffer.size     = 0;
+
+                    // Set up the metadata for the Ethernet packet buffer
+                    //     NOTE:  The metadata uses the compression buffer that goes with the header buffer
+                    //            since it must be in DMA accessible memory.
+                    //
+                    if (i < num_meta_pkts) {
+                        compress_addr = &ETH_IQ_compress_buffer[(header_offset / WL_BASEBAND_ETH_BUFFER_SIZE) * WL_BASEBAND_ETH_COMPRESS_BUFFER_SIZE];
+
+                        for (buff_index = 0; buff_index < num_buffs; buff_index++) {
+                            read_iq_metadata(read_buff_sel[buff_index], (start_samp + window_base), total_samp,
+                                             &(((wl_bb_read_iq_metadata *)compress_addr)[buff_index]));
+                        }
+
+                        buff_index           = 0;
+
+                        sample_buffer.data   = compress_addr;
+                        sample_buffer.offset = compress_addr;
+                        sample_buffer.length = wire_len;
+                        sample_buffer.size   = wire_len;
+
+                    } else {
+                        // If streaming, wait until the samples for the packet have been received
+                        //     NOTE:  Once the reception is done, there is no need to check the remaining packets.
+                        //
+                        if (stream_rx) {
+                            stream_rx = wait_rx_samples(eth_dev_num, cmd_id, read_buff_sel[buff_index], (start_byte + samp_len));
+
+                            if (stream_rx == WAIT_RX_SAMPLES_ABORT) {
+                                wl_printf(WL_PRINT_WARNING, print_type_baseband, "Read IQ stopped by a newer packet from the host.\n");
+                                break;
+                            }
+                        }
+
+                        // Set up the IQ data for the Ethernet packet buffer
+                        //     NOTE:  Compression reads the samples contiguously, so the zero buffer is only
+                        //            used for raw samples.
+                        //
+                        read_rx_buffers(cmd_id, read_buff_sel[buff_index], start_byte, samp_len, dest_addr, &sample_buffer,
+                                        ((read_iq_format == READ_IQ_FORMAT_RAW) ? &zero_buffer : NULL));
+
+                        // Compress the samples in to the compression buffer that goes with the header buffer
+                        //     NOTE:  Like the header buffers, the compression buffers are rotated so the Ethernet DMA
+                        //            has transferred the contents of a buffer before it is written again.
+                        //
+                        if (read_iq_format != READ_IQ_FORMAT_RAW) {
+                            compress_addr = &ETH_IQ_compress_buffer[(header_offset / WL_BASEBAND_ETH_BUFFER_SIZE) * WL_BASEBAND_ETH_COMPRESS_BUFFER_SIZE];
+
+                            read_iq_compress(read_iq_format, (u32 *)(sample_buffer.data), num_samp, compress_addr);
+
+                            sample_buffer.data   = compress_addr;
+                            sample_buffer.offset = compress_addr;
+                            sample_buffer.length = wire_len;
+                            sample_buffer.size   = wire_len;
+                        }
+                    }
 
                     // Update the green LEDs for every packet sent
                     increment_green_leds_one_hot();
 
+                    // Keep the CDMA queue moving while sending packets (eg for an ongoing reception)
+                    wl_cdma_service();
+
+                    // Pace the packets to the rate cap
+                    //     NOTE:  The packet is sent once the previous packets have had their time on the wire
+                    //            at the rate cap (ie bits / Mbps = usec).
+                    //
+                    if (sched_rate) {
+                        while (get_usec_timestamp() < (sched_start + (sched_bits / sched_rate))) {
+                            wl_cdma_service();
+                        }
+
+                        sched_bits += (total_hdr_length + WL_READ_IQ_SCHEDULE_PKT_OVERHEAD + wire_len) * 8;
+                    }
+
                     // Send the Ethernet packet
                     //   NOTE:  In an effort to reduce overhead (ie improve performance) for Read IQ, we are using the "raw"
                     //       socket_sendto method which transmits the provided buffers "as is" (ie there are no header updates
                     //       or other modifications to the buffer data).  Also, we have consolidated all the headers into a
                     //       single buffer so that a Read IQ Ethernet packet only requires two Transmit Buffer Descriptors
-                    //       (TX BDs).
+                    //       (TX BDs).  A packet that straddles the beginning of a buffer requires a third TX BD for the
+                    //       zeros before the buffer.
                     //
-                    status = socket_sendto_raw(socket_index, (warp_ip_udp_buffer **)read_iq_resp, 0x2);
+                    if (zero_buffer.length != 0) {
+                        read_iq_resp[1]  = (void *) &zero_buffer;
+                        read_iq_resp[2]  = (void *) &sample_buffer;
+                        num_resp_buffers = 0x3;
+                    } else {
+                        read_iq_resp[1]  = (void *) &sample_buffer;
+                        num_resp_buffers = 0x2;
+                    }
+
+                    status = socket_sendto_raw(socket_index, (warp_ip_udp_buffer **)read_iq_resp, num_resp_buffers);
 
                     // Check that the packet was sent correctly
                     if (status == WARP_IP_UDP_FAILURE) {
@@ -1258,8 +2103,35 @@ int baseband_process_cmd(int socket_index, void * from, wl_cmd_resp * command, w
                     }
 
                     // Update loop variables
-                    curr_samp          = next_start_samp;
-                    header_offset      = (header_offset + WL_BASEBAND_ETH_BUFFER_SIZE) % header_buffer_size;
+                    //     NOTE:  When interleaving, move to the next buffer for every packet and only advance
+                    //            the samples once all buffers have been sent.  Otherwise, send all packets of
+                    //            a buffer before moving to the next buffer.
+                    //
+                    if (i < num_meta_pkts) {
+                        // The metadata packet does not contain samples
+                    } else if (read_iq_flags & READ_IQ_FLAG_INTERLEAVE) {
+                        buff_index++;
+
+                        if (buff_index == num_buffs) {
+                            buff_index = 0;
+                            curr_samp  = next_start_samp;
+                        }
+                    } else {
+                        pkt_index++;
+                        curr_samp      = next_start_samp;
+
+                        if (pkt_index == num_pkts) {
+                            pkt_index  = 0;
+                            buff_index++;
+                            curr_samp  = start_samp;
+                        }
+                    }
+
+                    header_offset     += WL_BASEBAND_ETH_BUFFER_SIZE;
+
+                    if (header_offset == header_buffer_size) {
+                        header_offset  = 0;
+                    }
                 }
 
                 //
@@ -1771,15 +2643,25 @@ int baseband_process_cmd(int socket_index, void * from, wl_cmd_resp * command, w
  * @param   length           - Length of the transfer (in bytes)
  * @param   dest_addr        - Destination address of the transfer (in bytes; must be 16 byte
  *                             aligned due to CDMA usage)
+ * @param   buffer           - Buffer to set up with the data
+ * @param   zero_buffer      - Buffer to set up with the zeros before the beginning of the RX
+ *                             buffer (if NULL, the zeros and data are copied to dest_addr)
  *
  * @return  None
  *
+ * @note    If the window straddles the beginning of the RX buffer and zero_buffer is not
+ *          NULL, then zero_buffer is set up with the zeros (from dest_addr) and buffer is set
+ *          up with the data from the beginning of the RX buffer so the data is not copied
+ *          in to dest_addr while it may still be in use by the Ethernet DMA.  Otherwise,
+ *          zero_buffer length is zero.
+ *
  *****************************************************************************/
-void read_rx_buffers(u32 cmd_id, u32 buffer_sel, u32 offset, u32 length, u32 dest_addr, warp_ip_udp_buffer * buffer) {
+void read_rx_buffers(u32 cmd_id, u32 buffer_sel, u32 offset, u32 length, u32 dest_addr, warp_ip_udp_buffer * buffer, warp_ip_udp_buffer * zero_buffer) {
 
     u32 src_addr       = 0;
     u32 buffer_size    = 0;
     u32 end_byte       = offset + length - 1;
+    u32 zero_length;
 
     // Process Read IQ
     if(cmd_id == CMDID_BASEBAND_READ_IQ) {
@@ -1839,11 +2721,40 @@ void read_rx_buffers(u32 cmd_id, u32 buffer_sel, u32 offset, u32 length, u32 des
 
     // Transfer data or zeros
     //   NOTE:  buffer_size is initialized to zero so it will return zeros when RFC / RFD errors occur
-    if (end_byte <= buffer_size) {
+    //   NOTE:  A window that starts before the beginning of the buffer (see READ_IQ_WINDOW_AGC_DONE)
+    //          will wrap the offset, so the end byte must also be after the offset.  If only the start
+    //          of the packet is before the buffer, then only those bytes are zeros.
+    if ((end_byte <= buffer_size) && (end_byte >= offset)) {
         buffer->data   = (u8 *)src_addr;
         buffer->offset = (u8 *)src_addr;
         buffer->length = length;
         buffer->size   = length;
+    } else if ((buffer_size != 0) && (end_byte < buffer_size) && (end_byte < offset)) {
+        // Window straddles the beginning of the buffer:  zeros for the bytes before the buffer followed
+        // by the bytes from the beginning of the buffer
+        zero_length    = (0 - offset);
+
+        bzero((void *)(dest_addr), zero_length);
+
+        if (zero_buffer != NULL) {
+            zero_buffer->data   = (u8 *)dest_addr;
+            zero_buffer->offset = (u8 *)dest_addr;
+            zero_buffer->length = zero_length;
+            zero_buffer->size   = zero_length;
+
+            buffer->data   = (u8 *)(src_addr - offset);
+            buffer->offset = (u8 *)(src_addr - offset);
+            buffer->length = (end_byte + 1);
+            buffer->size   = (end_byte + 1);
+            return;
+        }
+
+        memcpy((void *)(dest_addr + zero_length), (void *)(src_addr - offset), (end_byte + 1));
+
+        buffer->data   = (u8 *)dest_addr;
+        buffer->offset = (u8 *)dest_addr;
+        buffer->length = length;
+        buffer->size   = length;
     } else {
         wl_printf(WL_PRINT_ERROR, print_type_baseband, "Too many bytes read from buffer - Size = %d;  Read end = %d\n", buffer_size, end_byte);
         bzero((void *)(dest_addr), length);
@@ -1858,6 +2769,452 @@ void read_rx_buffers(u32 cmd_id, u32 buffer_sel, u32 offset, u32 length, u32 des
 
 
 
+/*****************************************************************************/
+/**
+ * Read IQ compressed length
+ *
+ *   Computes the number of bytes of compressed samples for the given format.  The
+ * length is padded to a multiple of 4 bytes.
+ *
+ * @param   format           - Sample format (READ_IQ_FORMAT_*)
+ * @param   num_samp         - Number of samples
+ *
+ * @return  u32              - Length of the compressed samples (in bytes)
+ *
+ *****************************************************************************/
+u32 read_iq_compressed_length(u32 format, u32 num_samp) {
+
+    u32 length;
+
+    switch (format) {
+        case READ_IQ_FORMAT_12BIT:
+            // 3 bytes per sample
+            length = num_samp * 3;
+        break;
+
+        case READ_IQ_FORMAT_BFP:
+            // 4 byte block header per block and 2 bytes per sample
+            length = (((num_samp + READ_IQ_BFP_BLOCK_SAMPLES - 1) / READ_IQ_BFP_BLOCK_SAMPLES) * 4) + (num_samp * 2);
+        break;
+
+        default:
+            length = num_samp * sizeof(wl_samp);
+        break;
+    }
+
+    return ((length + 3) & 0xFFFFFFFC);
+}
+
+
+
+/*****************************************************************************/
+/**
+ * Read IQ compress
+ *
+ *   Compresses samples in to the given destination.  Each sample is a 32-bit word
+ * in the sample byte order with I in the upper 16 bits and Q in the lower 16 bits.
+ * The compressed formats are:
+ *
+ *   READ_IQ_FORMAT_12BIT - The 12 MSBs of I and Q (ie the resolution of the converters)
+ *       are packed in to 3 bytes per sample:  I[15:4], Q[15:4]
+ *
+ *   READ_IQ_FORMAT_BFP   - Block floating point.  Each block of READ_IQ_BFP_BLOCK_SAMPLES
+ *       samples starts with a 4 byte header whose first byte is the shared exponent
+ *       of the block.  Each sample is then 2 bytes:  (I >> exponent), (Q >> exponent)
+ *       The exponent is the smallest shift so that all I / Q values of the block fit
+ *       in 8 bits.
+ *
+ * Any padding at the end of the compressed samples is filled with zeros.
+ *
+ * @param   format           - Sample format (READ_IQ_FORMAT_*)
+ * @param   src              - Pointer to the samples
+ * @param   num_samp         - Number of samples
+ * @param   dest             - Pointer to the destination of the compressed samples
+ *
+ * @return  None
+ *
+ *****************************************************************************/
+void read_iq_compress(u32 format, u32 * src, u32 num_samp, u8 * dest) {
+
+    u32 i, j;
+    u32 sample;
+    u32 block_samp;
+    u32 magnitude;
+    u32 exponent;
+    s32 i_val, q_val;
+    u32 block[READ_IQ_BFP_BLOCK_SAMPLES];
+    u8 * end = dest + read_iq_compressed_length(format, num_samp);
+
+    switch (format) {
+        case READ_IQ_FORMAT_12BIT:
+            for (i = 0; i < num_samp; i++) {
+                sample  = wl_bb_samp_ntoh(samp_byte_order, src[i]);
+
+                *dest++ = (u8)(sample >> 24);
+                *dest++ = (u8)(((sample >> 16) & 0xF0) | ((sample >> 12) & 0x0F));
+                *dest++ = (u8)(sample >> 4);
+            }
+        break;
+
+        case READ_IQ_FORMAT_BFP:
+            for (i = 0; i < num_samp; i += READ_IQ_BFP_BLOCK_SAMPLES) {
+                block_samp = num_samp - i;
+
+                if (block_samp > READ_IQ_BFP_BLOCK_SAMPLES) {
+                    block_samp = READ_IQ_BFP_BLOCK_SAMPLES;
+                }
+
+                // Find the largest magnitude of the block
+                //     NOTE:  Pull the block in to local memory so DDR is only read once per sample
+                //
+                magnitude = 0;
+
+                for (j = 0; j < block_samp; j++) {
+                    sample     = wl_bb_samp_ntoh(samp_byte_order, src[i + j]);
+                    block[j]   = sample;
+
+                    i_val      = (s16)(sample >> 16);
+                    q_val      = (s16)(sample & 0xFFFF);
+
+                    magnitude |= (u32)(i_val ^ (i_val >> 31)) | (u32)(q_val ^ (q_val >> 31));
+                }
+
+                // Compute the shared exponent of the block
+                exponent = 0;
+
+                while ((magnitude >> exponent) > 0x7F) {
+                    exponent++;
+                }
+
+                *dest++ = (u8)exponent;
+                *dest++ = 0;
+                *dest++ = 0;
+                *dest++ = 0;
+
+                // Add the samples
+                for (j = 0; j < block_samp; j++) {
+                    i_val   = (s16)(block[j] >> 16);
+                    q_val   = (s16)(block[j] & 0xFFFF);
+
+                    *dest++ = (u8)(i_val >> exponent);
+                    *dest++ = (u8)(q_val >> exponent);
+                }
+            }
+        break;
+    }
+
+    // Zero any padding
+    while (dest < end) {
+        *dest++ = 0;
+    }
+}
+
+
+
+/*****************************************************************************/
+/**
+ * Read IQ metadata
+ *
+ *   Fills in the capture metadata of a buffer for a Read IQ request (see
+ * READ_IQ_FLAG_METADATA).  All fields are written in network byte order.
+ *
+ *   The RSSI statistics are computed over the RSSI words that cover the requested
+ * samples (ie with a resolution of 8 samples).  Requested samples that are outside
+ * of the RSSI buffer are ignored.  If no RSSI values are covered, then the min, mean
+ * and max are all zero.
+ *
+ * @param   buffer_sel       - Buffer select (RF_SEL_*; only one buffer)
+ * @param   start_samp       - Absolute start sample of the request
+ * @param   num_samp         - Number of samples of the request
+ * @param   metadata         - Pointer to the metadata (must be DMA accessible)
+ *
+ * @return  None
+ *
+ * @note    Any pending transfers of RX data to DDR must be complete (ie wl_cdma_wait_all())
+ *          before this function is called.
+ *
+ *****************************************************************************/
+void read_iq_metadata(u32 buffer_sel, u32 start_samp, u32 num_samp, wl_bb_read_iq_metadata * metadata) {
+
+    u32   i;
+    u32   ant            = 0;
+    u32 * rssi_buff      = NULL;
+    u32   rssi_buff_size = 0;
+    u32   rx_count       = 0;
+    u32   agc_done_rssi  = 0;
+    u32   agc_gains      = 0;
+    u32   rssi_word;
+    u32   rssi_val;
+    u32   rssi_min       = 0xFFFFFFFF;
+    u32   rssi_max       = 0;
+    u32   rssi_sum       = 0;
+    u32   rssi_num       = 0;
+    s32   first_samp;
+    s32   last_samp;
+    u64   timestamp;
+    interrupt_state_t prev_interrupt_state;
+
+    if (buffer_sel & RF_SEL_A) {
+        ant            = 0;
+        rssi_buff      = (u32 *)wl_rssi_buff_a;
+        rssi_buff_size = wl_rssi_buff_a_size;
+        rx_count       = wl_bb_get_rfa_rx_count();
+        agc_done_rssi  = wl_bb_get_rfa_agc_done_rssi();
+
+    } else if (buffer_sel & RF_SEL_B) {
+        ant            = 1;
+        rssi_buff      = (u32 *)wl_rssi_buff_b;
+        rssi_buff_size = wl_rssi_buff_b_size;
+        rx_count       = wl_bb_get_rfb_rx_count();
+        agc_done_rssi  = wl_bb_get_rfb_agc_done_rssi();
+
+    } else if ((buffer_sel & RF_SEL_C) && (WARPLAB_CONFIG_4RF)) {
+        ant            = 2;
+        rssi_buff      = (u32 *)wl_rssi_buff_c;
+        rssi_buff_size = wl_rssi_buff_c_size;
+        rx_count       = wl_bb_get_rfc_rx_count();
+        agc_done_rssi  = wl_bb_get_rfc_agc_done_rssi();
+
+    } else if ((buffer_sel & RF_SEL_D) && (WARPLAB_CONFIG_4RF)) {
+        ant            = 3;
+        rssi_buff      = (u32 *)wl_rssi_buff_d;
+        rssi_buff_size = wl_rssi_buff_d_size;
+        rx_count       = wl_bb_get_rfd_rx_count();
+        agc_done_rssi  = wl_bb_get_rfd_agc_done_rssi();
+    }
+
+    if (rssi_buff != NULL) {
+        agc_gains      = (wl_get_agc_gains_raw() >> (ant << 3)) & 0xFF;
+    }
+
+    // Compute the RSSI statistics
+    //     NOTE:  Each 32-bit RSSI word covers 8 samples and contains two 10-bit RSSI values
+    //            (bits [25:16] and [9:0]).  The start sample can be "negative" for a window
+    //            that starts before the buffer (see READ_IQ_WINDOW_AGC_DONE).
+    //
+    first_samp = (s32)start_samp;
+    last_samp  = first_samp + (s32)num_samp;
+
+    if (first_samp < 0) {
+        first_samp = 0;
+    }
+
+    if (last_samp > (s32)(rssi_buff_size << 1)) {
+        last_samp  = (s32)(rssi_buff_size << 1);
+    }
+
+    for (i = (first_samp >> 3); (s32)(i << 3) < last_samp; i++) {
+        rssi_word = wl_bb_samp_ntoh(samp_byte_order, rssi_buff[i]);
+
+        rssi_val  = (rssi_word >> 16) & 0x3FF;
+        rssi_sum += rssi_val;
+        if (rssi_val < rssi_min) { rssi_min = rssi_val; }
+        if (rssi_val > rssi_max) { rssi_max = rssi_val; }
+
+        rssi_val  = rssi_word & 0x3FF;
+        rssi_sum += rssi_val;
+        if (rssi_val < rssi_min) { rssi_min = rssi_val; }
+        if (rssi_val > rssi_max) { rssi_max = rssi_val; }
+
+        rssi_num += 2;
+    }
+
+    if (rssi_num == 0) {
+        rssi_min  = 0;
+    }
+
+    // Fill in the metadata
+    metadata->buff_sel              = Xil_Htonl(buffer_sel);
+    metadata->rx_count              = Xil_Htonl(rx_count);
+
+    // Disable interrupts so the RX interrupt does not update the timestamp while it is read
+    prev_interrupt_state            = wl_interrupt_stop();
+    timestamp                       = rx_capture_timestamp;
+    wl_interrupt_restore_state(prev_interrupt_state);
+
+    metadata->capture_timestamp_msb = Xil_Htonl((u32)(timestamp >> 32));
+    metadata->capture_timestamp_lsb = Xil_Htonl((u32)(timestamp & 0xFFFFFFFF));
+
+    timestamp                       = get_usec_timestamp();
+    metadata->read_timestamp_msb    = Xil_Htonl((u32)(timestamp >> 32));
+    metadata->read_timestamp_lsb    = Xil_Htonl((u32)(timestamp & 0xFFFFFFFF));
+
+    metadata->agc_gains             = Xil_Htonl(agc_gains);
+    metadata->agc_done_rssi         = Xil_Htonl(agc_done_rssi);
+    metadata->agc_done_addr         = Xil_Htonl(wl_bb_get_agc_done_addr());
+    metadata->rssi_min              = Xil_Htonl(rssi_min);
+    metadata->rssi_mean             = Xil_Htonl((rssi_num) ? (rssi_sum / rssi_num) : 0);
+    metadata->rssi_max              = Xil_Htonl(rssi_max);
+    metadata->tx_rx_status          = Xil_Htonl((wl_bb_get_rx_status() << 8) | wl_bb_get_tx_status());
+    metadata->buffer_en             = Xil_Htonl((wl_bb_get_rx_buffer_en() << 8) | wl_bb_get_tx_buffer_en());
+    metadata->rx_length             = Xil_Htonl(wl_bb_get_rx_length() + 1);
+    metadata->rssi_count            = Xil_Htonl(rssi_num);
+}
+
+
+
+/*****************************************************************************/
+/**
+ * Read IQ defer park
+ *
+ *   Saves a Read IQ request that arrived during a reception so it can be processed
+ * as soon as the reception is done (see READ_IQ_FLAG_DEFER).  The deferral flag is
+ * removed from the saved request so that processing it again can not park it a
+ * second time.
+ *
+ * @param   socket_index     - Index of the socket on which the request was received
+ * @param   from             - Pointer to socket address structure of the host
+ * @param   command          - Pointer to the Read IQ command
+ * @param   response         - Pointer to the response (only the transport header is used)
+ *
+ * @return  u32              - Status:
+ *                                 XST_SUCCESS - Request was parked
+ *                                 XST_FAILURE - Another request is already parked
+ *
+ *****************************************************************************/
+u32 read_iq_defer_park(int socket_index, void * from, wl_cmd_resp * command, wl_cmd_resp * response) {
+
+    u32 flags;
+    u32 timeout;
+
+    if (read_iq_defer_state != READ_IQ_DEFER_IDLE) {
+        return XST_FAILURE;
+    }
+
+    flags   = Xil_Ntohl(command->args[0]);
+    timeout = (flags & READ_IQ_DEFER_TIMEOUT_MASK) >> READ_IQ_DEFER_TIMEOUT_SHIFT;
+
+    if (timeout == 0) {
+        timeout = 1;
+    }
+
+    // Save the request
+    //     NOTE:  The data of the send buffer starts at the transport header of the response
+    //
+    read_iq_defer_socket   = socket_index;
+    read_iq_defer_buff_sel = flags & READ_IQ_BUFF_SEL_MASK;
+    read_iq_defer_deadline = get_usec_timestamp() + (timeout * READ_IQ_DEFER_TIMEOUT_UNIT);
+
+    memcpy((void *)&read_iq_defer_from, from, sizeof(struct sockaddr));
+    memcpy((void *)&read_iq_defer_hdr, (void *)(((warp_ip_udp_buffer *)(response->buffer))->data), sizeof(wl_transport_header));
+    memcpy((void *)&read_iq_defer_cmd_hdr, (void *)(command->header), sizeof(wl_cmd_resp_hdr));
+    memcpy((void *)read_iq_defer_args, (void *)(command->args), sizeof(read_iq_defer_args));
+
+    read_iq_defer_args[0]  = Xil_Htonl(flags & ~(READ_IQ_FLAG_DEFER | READ_IQ_DEFER_TIMEOUT_MASK));
+    read_iq_defer_cmd_hdr.num_args = 5;
+    read_iq_defer_cmd_hdr.length   = sizeof(read_iq_defer_args);
+
+    read_iq_defer_state    = READ_IQ_DEFER_PARKED;
+
+    return XST_SUCCESS;
+}
+
+
+
+/*****************************************************************************/
+/**
+ * Read IQ defer service
+ *
+ *   Processes a parked Read IQ request once it is ready.  The request is ready when
+ * the RX transfer done callback marks the end of a reception, when none of the
+ * selected buffers are receiving (eg a reception that was stopped or that is too
+ * short to use the RX interrupt) or when the deadline has passed.  If the samples are
+ * still not ready at the deadline, then the host gets SAMPLE_HDR_FLAG_IQ_NOT_READY
+ * as if the request had not been parked.
+ *
+ * @param   None
+ *
+ * @return  None
+ *
+ *****************************************************************************/
+void read_iq_defer_service() {
+
+    u32                   resp_sent;
+    warp_ip_udp_buffer  * send_buffer;
+    wl_transport_header * wl_header_tx;
+    wl_cmd_resp           command;
+    wl_cmd_resp           response;
+
+    if (read_iq_defer_state == READ_IQ_DEFER_PARKED) {
+        if (((wl_bb_get_rx_status() & read_iq_defer_buff_sel) == 0) || (get_usec_timestamp() > read_iq_defer_deadline)) {
+            read_iq_defer_state = READ_IQ_DEFER_READY;
+        }
+    }
+
+    if (read_iq_defer_state != READ_IQ_DEFER_READY) {
+        return;
+    }
+
+    read_iq_defer_state = READ_IQ_DEFER_IDLE;
+
+    // Set up the send buffer the same way as the transport does for a received message
+    //     (see transport_receive())
+    //
+    send_buffer          = socket_alloc_send_buffer();
+    wl_header_tx         = (wl_transport_header *)(send_buffer->offset);
+
+    memcpy((void *)wl_header_tx, (void *)&read_iq_defer_hdr, sizeof(wl_transport_header));
+
+    send_buffer->offset += sizeof(wl_transport_header);
+    send_buffer->length += sizeof(wl_transport_header);
+    send_buffer->size   += sizeof(wl_transport_header);
+
+    // Initialize the Command/Response structures (see node_rx_from_transport())
+    command.header       = &read_iq_defer_cmd_hdr;
+    command.args         = read_iq_defer_args;
+    command.buffer       = NULL;
+
+    response.header      = (wl_cmd_resp_hdr *)(send_buffer->offset);
+    response.args        = (u32 *)((send_buffer->offset) + sizeof(wl_cmd_resp_hdr));
+    response.buffer      = (void *)(send_buffer);
+
+    resp_sent = baseband_process_cmd(read_iq_defer_socket, (void *)&read_iq_defer_from, &command, &response);
+
+    // If the samples are still not ready, then send the response so the host can request again
+    if (resp_sent == NODE_NOT_READY) {
+        wl_header_tx->flags = TRANSPORT_HDR_NODE_NOT_READY_FLAG;
+
+        node_send_early_resp(read_iq_defer_socket, (void *)&read_iq_defer_from, response.header, send_buffer);
+    }
+
+    socket_free_send_buffer(send_buffer);
+}
+
+
+
+/*****************************************************************************/
+/**
+ * Incremental IP checksum update
+ *
+ *   Updates an Internet checksum for a change of a single 16-bit field of the
+ * checksummed data without recomputing the checksum over the entire header.  This
+ * uses equation 3 of RFC 1624:  HC' = ~(~HC + ~m + m')
+ *
+ * @param   checksum         - Current checksum
+ * @param   old_value        - Old value of the 16-bit field
+ * @param   new_value        - New value of the 16-bit field
+ *
+ * @return  u16              - Updated checksum
+ *
+ * @note    One's complement addition is independent of byte order, so all arguments
+ *          can be passed in network byte order as long as they are all in the same order.
+ *
+ *****************************************************************************/
+u16 wl_ip_checksum_adjust(u16 checksum, u16 old_value, u16 new_value) {
+
+    u32 sum;
+
+    sum = ((u16)(~checksum)) + ((u16)(~old_value)) + new_value;
+
+    // Fold the carries back in to 16 bits
+    sum = (sum & 0xFFFF) + (sum >> 16);
+    sum = (sum & 0xFFFF) + (sum >> 16);
+
+    return (u16)(~sum);
+}
+
+
+
 /*****************************************************************************/
 /**
  * Write TX buffers
@@ -1944,6 +3301,202 @@ void write_tx_buffers(u32 buffer_sel, u32 src_addr, u32 offset, u32 length) {
 
 
 
+/*****************************************************************************/
+/**
+ * Write TX stream
+ *
+ *     Writes samples of a TX stream from the source address to all of the buffers
+ * indicated by the buffer_sel parameter.  The stream sample index is mapped to the
+ * ring of tx_stream_length samples relative to the current Tx read pointer of the
+ * stream.  If the samples wrap around the end of the ring, the write is split into
+ * two transfers.
+ *
+ * @param   buffer_sel       - Buffer select (Indicates which buffer(s) should be written)
+ * @param   src_addr         - Source address of the transfer (in bytes; must be 16 byte
+ *                             aligned due to CDMA usage)
+ * @param   start_samp       - Stream sample index of the first sample
+ * @param   num_samp         - Number of samples
+ *
+ * @return  None
+ *
+ *****************************************************************************/
+void write_tx_stream(u32 buffer_sel, u32 src_addr, u32 start_samp, u32 num_samp) {
+
+    interrupt_state_t  prev_interrupt_state;
+    s32                delta;
+    u32                ring_offset;
+    u32                length;
+
+    // Get a consistent copy of the Tx read pointer from the TX interrupt
+    prev_interrupt_state = wl_interrupt_stop();
+
+    delta       = (s32)(start_samp - tx_stream_rd_samp);
+    ring_offset = tx_stream_rd_offset;
+
+    wl_interrupt_restore_state(prev_interrupt_state);
+
+    // Map the stream sample index to the ring
+    delta       = delta % (s32)tx_stream_length;
+
+    if (delta < 0) {
+        delta  += tx_stream_length;
+    }
+
+    ring_offset = (ring_offset + delta) % tx_stream_length;
+
+    // Write the samples up to the end of the ring
+    length      = tx_stream_length - ring_offset;
+
+    if (num_samp < length) {
+        length  = num_samp;
+    }
+
+    write_tx_buffers(buffer_sel, src_addr, (ring_offset << 2), (length << 2));
+
+    // Write any remaining samples at the start of the ring
+    if (num_samp > length) {
+        write_tx_buffers(buffer_sel, (src_addr + (length << 2)), 0, ((num_samp - length) << 2));
+    }
+
+    // Update the Tx write pointer of the stream
+    if ((s32)((start_samp + num_samp) - tx_stream_wr_samp) > 0) {
+        tx_stream_wr_samp = start_samp + num_samp;
+    }
+}
+
+
+
+/*****************************************************************************/
+/**
+ * Accumulate RX samples
+ *
+ *   Adds the I and Q of each sample to the 32-bit I and Q sums of the accumulator.
+ * Samples and sums are in the sample byte order.
+ *
+ * @param   src              - Pointer to the samples
+ * @param   accum            - Pointer to the accumulator of the first sample
+ * @param   num_samp         - Number of samples
+ *
+ * @return  None
+ *
+ *****************************************************************************/
+void rx_accum_samples(u32 * src, u32 * accum, u32 num_samp) {
+
+    u32 i;
+    u32 sample;
+
+    for (i = 0; i < num_samp; i++) {
+        sample   = wl_bb_samp_ntoh(samp_byte_order, src[i]);
+
+        accum[0] = wl_bb_samp_hton(samp_byte_order, wl_bb_samp_ntoh(samp_byte_order, accum[0]) + (s32)((s16)(sample >> 16)));
+        accum[1] = wl_bb_samp_hton(samp_byte_order, wl_bb_samp_ntoh(samp_byte_order, accum[1]) + (s32)((s16)(sample & 0xFFFF)));
+
+        accum   += 2;
+    }
+}
+
+
+
+/*****************************************************************************/
+/**
+ * Clear RX accumulators
+ *
+ *   Clears the accumulator of every RX buffer.
+ *
+ * @param   num_samp         - Number of samples in the accumulator
+ *
+ * @return  None
+ *
+ *****************************************************************************/
+void rx_accum_clear(u32 num_samp) {
+
+    bzero((void *)(wl_iq_rx_buff_a + rx_buffer_size), (num_samp << 3));
+    bzero((void *)(wl_iq_rx_buff_b + rx_buffer_size), (num_samp << 3));
+
+    if (WARPLAB_CONFIG_4RF) {
+        bzero((void *)(wl_iq_rx_buff_c + rx_buffer_size), (num_samp << 3));
+        bzero((void *)(wl_iq_rx_buff_d + rx_buffer_size), (num_samp << 3));
+    }
+}
+
+
+
+/*****************************************************************************/
+/**
+ * Baseband service
+ *
+ *   Called from the main loop to perform baseband processing that is too long for an
+ * interrupt.  This processes a parked Read IQ request (see read_iq_defer_service())
+ * and accumulates a pending reception in RX accumulation mode.  At most
+ * WL_BUF_RX_ACCUM_SAMPLES_PER_SERVICE samples of each buffer are accumulated per
+ * call so that Ethernet processing is not blocked.
+ *
+ * If a new reception transfers samples to DDR that have not been accumulated, the
+ * reception being accumulated is corrupted and an overrun is counted.
+ *
+ * @param   None
+ *
+ * @return  None
+ *
+ *****************************************************************************/
+void baseband_service() {
+
+    u32 buff_sel;
+    u32 num_samp;
+    u32 offset;
+
+    // Process a parked Read IQ request
+    if (read_iq_defer_state != READ_IQ_DEFER_IDLE) {
+        read_iq_defer_service();
+    }
+
+    buff_sel = rx_accum_pending;
+
+    if (buff_sel == 0) {
+        return;
+    }
+
+    // Check that a new reception has not overwritten the samples that are left
+    if ((wl_bb_get_rx_status() & buff_sel) && (wl_bb_get_rf_rx_iq_buf_rd_byte_offset() > (rx_accum_samp << 2))) {
+        rx_accum_overruns++;
+        rx_accum_pending = 0;
+        return;
+    }
+
+    num_samp = rx_accum_length - rx_accum_samp;
+
+    if (num_samp > WL_BUF_RX_ACCUM_SAMPLES_PER_SERVICE) {
+        num_samp = WL_BUF_RX_ACCUM_SAMPLES_PER_SERVICE;
+    }
+
+    offset = rx_accum_samp << 2;
+
+    if (buff_sel & RF_SEL_A) {
+        rx_accum_samples((u32 *)(wl_iq_rx_buff_a + offset), (u32 *)(wl_iq_rx_buff_a + rx_buffer_size + (offset << 1)), num_samp);
+    }
+
+    if (buff_sel & RF_SEL_B) {
+        rx_accum_samples((u32 *)(wl_iq_rx_buff_b + offset), (u32 *)(wl_iq_rx_buff_b + rx_buffer_size + (offset << 1)), num_samp);
+    }
+
+    if ((buff_sel & RF_SEL_C) && (WARPLAB_CONFIG_4RF)) {
+        rx_accum_samples((u32 *)(wl_iq_rx_buff_c + offset), (u32 *)(wl_iq_rx_buff_c + rx_buffer_size + (offset << 1)), num_samp);
+    }
+
+    if ((buff_sel & RF_SEL_D) && (WARPLAB_CONFIG_4RF)) {
+        rx_accum_samples((u32 *)(wl_iq_rx_buff_d + offset), (u32 *)(wl_iq_rx_buff_d + rx_buffer_size + (offset << 1)), num_samp);
+    }
+
+    rx_accum_samp += num_samp;
+
+    if (rx_accum_samp == rx_accum_length) {
+        rx_accum_count++;
+        rx_accum_pending = 0;
+    }
+}
+
+
+
 /*****************************************************************************/
 /**
  * @brief Baseband reset
@@ -1960,12 +3513,24 @@ void baseband_reset(){
     write_iq_checksum_lsb = 0;
     write_iq_checksum_msb = 0;
 
+    tx_stream_en          = 0;
+
+    rx_seg_num            = 0;
+    rx_seg_base           = 0;
+
+    rx_accum_en           = 0;
+    rx_accum_pending      = 0;
+
+    read_iq_defer_state   = READ_IQ_DEFER_IDLE;
+
 
     // ------------------------------------------
     // Reset the buffers core
     //
     
     // Perform any HW specific resets
+    samp_byte_order = CMD_PARAM_BASEBAND_SAMPLE_BYTE_ORDER_BIG;
+
     baseband_hw_specific_reset();
 
     // Set default config register values
@@ -2298,10 +3863,21 @@ void warplab_set_agc_rx_length(u32 num_samples) {
 
 /*************************** Variable Definitions ****************************/
 
+// Buffers core interrupt transfer state
+//     NOTE:  The interrupt handlers only queue CDMA transfers.  The buffers core offsets are updated by
+//         a CDMA queue callback once the transfers are done.  If an interrupt occurs while the transfers of
+//         the previous interrupt are pending, the handler waits for them (ie the transfer ID of the callback)
+//         so that every interrupt is processed when it occurs.
+//
+static u32 rx_xfer_id;
+static u32 tx_xfer_id;
+
 /*************************** Functions Prototypes ****************************/
 
 void wl_buffers_core_rx_int_handler(void *InstancePtr);
 void wl_buffers_core_tx_int_handler(void *InstancePtr);
+int  wl_buffers_core_rx_xfer_done(u32 iq_write_offset);
+int  wl_buffers_core_tx_xfer_done(u32 iq_write_offset);
 
 
 /******************************** Functions **********************************/
@@ -2310,7 +3886,7 @@ void wl_buffers_core_tx_int_handler(void *InstancePtr);
 /**
  * @brief Transfer Baseband Data
  *
- *     Uses CDMA to transfer baseband data.
+ *     Uses CDMA to transfer baseband data from a received packet (ie Write IQ).
  *
  * @param   src_addr         - Source address of the data
  * @param   dest_addr        - Destination address of the data
@@ -2318,9 +3894,75 @@ void wl_buffers_core_tx_int_handler(void *InstancePtr);
  *
  * @return  None
  *
+ * @note    The receive buffer is not freed until the transfer is done (see
+ *          transport_set_recv_buffer_xfer()).
+ *
  *****************************************************************************/
 void baseband_transfer_data( u32 src_addr, u32 dest_addr, u32 length ) {
-    wl_cdma_transfer(src_addr, dest_addr, length);
+    transport_set_recv_buffer_xfer(wl_cdma_transfer(src_addr, dest_addr, length));
+}
+
+
+
+/*****************************************************************************/
+/**
+ * @brief Wait for RX Samples
+ *
+ *     Waits until the samples up to the given end byte of the buffer have been
+ * received and can be read.  When the node is using DDR for buffers, samples are
+ * only valid once the RX interrupt has transferred them to DDR (ie the read
+ * offset of the buffers core has passed them); otherwise, samples are valid once
+ * the write offset of the buffers core has passed them.  If the reception for
+ * the buffer is done, then the function waits for any remaining transfers to DDR.
+ * If a packet is received while waiting, then the function stops waiting so the
+ * packet can be processed (see transport_check_recv()).
+ *
+ * @param   eth_dev_num      - Ethernet device number of the request
+ * @param   cmd_id           - Command ID (Differentiates between READ_IQ and READ_RSSI commands
+ * @param   buffer_sel       - Buffer select (Indicates which buffer will be read)
+ * @param   end_byte         - Byte offset in the buffer after the last byte that will be read
+ *
+ * @return  u32              - Reception status:
+ *                                 WAIT_RX_SAMPLES_DONE    - Reception for the buffer is done
+ *                                 WAIT_RX_SAMPLES_ONGOING - Reception for the buffer is ongoing
+ *                                 WAIT_RX_SAMPLES_ABORT   - Packet received while waiting
+ *
+ *****************************************************************************/
+u32 wait_rx_samples(u32 eth_dev_num, u32 cmd_id, u32 buffer_sel, u32 end_byte) {
+
+    u32 valid_bytes;
+
+    // Convert the end byte to an IQ byte offset (RSSI data is 8x less bytes than IQ data)
+    if (cmd_id == CMDID_BASEBAND_READ_RSSI) {
+        end_byte = end_byte << 3;
+    }
+
+    while (1) {
+        // Check if the reception is done
+        if ((wl_bb_get_rx_status() & buffer_sel) == 0) {
+            wl_cdma_wait_all();
+            return WAIT_RX_SAMPLES_DONE;
+        }
+
+        // Get the number of valid bytes in the buffer
+        if (use_dram_for_buffers) {
+            valid_bytes = wl_bb_get_rf_rx_iq_buf_rd_byte_offset();
+        } else {
+            valid_bytes = wl_bb_get_rf_rx_iq_buf_wr_byte_offset() + 4;
+        }
+
+        if (end_byte <= valid_bytes) {
+            return WAIT_RX_SAMPLES_ONGOING;
+        }
+
+        // Stop waiting if there is a newer packet from the host
+        if (transport_check_recv(eth_dev_num)) {
+            return WAIT_RX_SAMPLES_ABORT;
+        }
+
+        // Keep the CDMA queue moving so the RX interrupt can transfer samples to DDR
+        wl_cdma_service();
+    }
 }
 
 
@@ -2338,8 +3980,12 @@ void baseband_transfer_data( u32 src_addr, u32 dest_addr, u32 length ) {
  *
  *****************************************************************************/
 void baseband_hw_specific_reset() {
-    // Enable byte swapping
-    wl_bb_set_config(WL_BUF_REG_CONFIG_RX_BYTE_ORDER | WL_BUF_REG_CONFIG_TX_BYTE_ORDER);
+    // Enable byte swapping for big endian samples (see CMDID_BASEBAND_SAMPLE_BYTE_ORDER)
+    if (samp_byte_order == CMD_PARAM_BASEBAND_SAMPLE_BYTE_ORDER_LITTLE) {
+        wl_bb_clear_config(WL_BUF_REG_CONFIG_RX_BYTE_ORDER | WL_BUF_REG_CONFIG_TX_BYTE_ORDER);
+    } else {
+        wl_bb_set_config(WL_BUF_REG_CONFIG_RX_BYTE_ORDER | WL_BUF_REG_CONFIG_TX_BYTE_ORDER);
+    }
 }
 
 
@@ -2459,6 +4105,10 @@ void wl_buffers_core_rx_int_handler(void *InstancePtr){
             return;
         }
 
+        // Wait for the transfers from the previous interrupt so the read offset is up to date
+        //     (see wl_buffers_core_rx_xfer_done())
+        wl_cdma_wait(rx_xfer_id);
+
         // Get buffers core register values
         //   NOTE:  Since we are transferring both IQ and RSSI data, we need to align the write offset
         //          To transfer the correct number of RSSI bytes.  Note that IQ data is 8x RSSI data (in bytes).
@@ -2492,13 +4142,13 @@ void wl_buffers_core_rx_int_handler(void *InstancePtr){
         if (buff_en & RF_SEL_A) {
             // Transfer IQ data
             src_addr    = (u32)(WARPLAB_IQ_RX_BUF_A + iq_read_offset_mod_buf_size);
-            dest_addr   = (u32)(wl_iq_rx_buff_a + iq_read_offset);
+            dest_addr   = (u32)(wl_iq_rx_buff_a + rx_seg_base + iq_read_offset);
 
             wl_cdma_transfer(src_addr, dest_addr, iq_xfer_length);
 
             // Transfer RSSI data (RSSI data is 8x less bytes than IQ data)
             src_addr    = (u32)(WARPLAB_RSSI_BUF_A + rssi_read_offset_mod_buf_size);
-            dest_addr   = (u32)(wl_rssi_buff_a + rssi_read_offset);
+            dest_addr   = (u32)(wl_rssi_buff_a + (rx_seg_base >> 3) + rssi_read_offset);
 
             wl_cdma_transfer(src_addr, dest_addr, rssi_xfer_length);
         }
@@ -2506,13 +4156,13 @@ void wl_buffers_core_rx_int_handler(void *InstancePtr){
         if (buff_en & RF_SEL_B) {
             // Transfer IQ data
             src_addr    = (u32)(WARPLAB_IQ_RX_BUF_B + iq_read_offset_mod_buf_size);
-            dest_addr   = (u32)(wl_iq_rx_buff_b + iq_read_offset);
+            dest_addr   = (u32)(wl_iq_rx_buff_b + rx_seg_base + iq_read_offset);
 
             wl_cdma_transfer(src_addr, dest_addr, iq_xfer_length);
 
             // Transfer RSSI data (RSSI data is 8x less bytes than IQ data)
             src_addr    = (u32)(WARPLAB_RSSI_BUF_B + rssi_read_offset_mod_buf_size);
-            dest_addr   = (u32)(wl_rssi_buff_b + rssi_read_offset);
+            dest_addr   = (u32)(wl_rssi_buff_b + (rx_seg_base >> 3) + rssi_read_offset);
 
             wl_cdma_transfer(src_addr, dest_addr, rssi_xfer_length);
         }
@@ -2520,13 +4170,13 @@ void wl_buffers_core_rx_int_handler(void *InstancePtr){
         if ((buff_en & RF_SEL_C) && (WARPLAB_CONFIG_4RF)) {
             // Transfer IQ data
             src_addr    = (u32)(WARPLAB_IQ_RX_BUF_C + iq_read_offset_mod_buf_size);
-            dest_addr   = (u32)(wl_iq_rx_buff_c + iq_read_offset);
+            dest_addr   = (u32)(wl_iq_rx_buff_c + rx_seg_base + iq_read_offset);
 
             wl_cdma_transfer(src_addr, dest_addr, iq_xfer_length);
 
             // Transfer RSSI data (RSSI data is 8x less bytes than IQ data)
             src_addr    = (u32)(WARPLAB_RSSI_BUF_C + rssi_read_offset_mod_buf_size);
-            dest_addr   = (u32)(wl_rssi_buff_c + rssi_read_offset);
+            dest_addr   = (u32)(wl_rssi_buff_c + (rx_seg_base >> 3) + rssi_read_offset);
 
             wl_cdma_transfer(src_addr, dest_addr, rssi_xfer_length);
         }
@@ -2534,29 +4184,38 @@ void wl_buffers_core_rx_int_handler(void *InstancePtr){
         if ((buff_en & RF_SEL_D) && (WARPLAB_CONFIG_4RF)) {
             // Transfer IQ data
             src_addr    = (u32)(WARPLAB_IQ_RX_BUF_D + iq_read_offset_mod_buf_size);
-            dest_addr   = (u32)(wl_iq_rx_buff_d + iq_read_offset);
+            dest_addr   = (u32)(wl_iq_rx_buff_d + rx_seg_base + iq_read_offset);
 
             wl_cdma_transfer(src_addr, dest_addr, iq_xfer_length);
 
             // Transfer RSSI data (RSSI data is 8x less bytes than IQ data)
             src_addr    = (u32)(WARPLAB_RSSI_BUF_D + rssi_read_offset_mod_buf_size);
-            dest_addr   = (u32)(wl_rssi_buff_d + rssi_read_offset);
+            dest_addr   = (u32)(wl_rssi_buff_d + (rx_seg_base >> 3) + rssi_read_offset);
 
             wl_cdma_transfer(src_addr, dest_addr, rssi_xfer_length);
         }
 
-        // If we are done, then reset the read / write offsets.  Otherwise, update
-        //     the read offset to reflect the bytes read only if at least one of
-        //     the buffers is enabled.
-        if (buff_en) {
-            if (iq_write_offset == rx_buffer_size) {
-                wl_bb_set_rf_rx_iq_buf_rd_byte_offset(0);
-                wl_bb_set_rf_rx_iq_buf_wr_byte_offset(0);
-            } else {
-                wl_bb_set_rf_rx_iq_buf_rd_byte_offset(iq_write_offset);
+        // Stamp the capture (and the segment) at the end of the reception
+        //     NOTE:  The segment is advanced once the transfers are done (see wl_buffers_core_rx_xfer_done())
+        if ((buff_en) && (iq_write_offset == rx_buffer_size)) {
+            rx_capture_timestamp = get_usec_timestamp();
+
+            if (rx_seg_num) {
+                rx_seg_timestamp[rx_seg_index] = rx_capture_timestamp;
+
+                if      (buff_en & RF_SEL_A) { rx_seg_rx_count[rx_seg_index] = wl_bb_get_rfa_rx_count(); }
+                else if (buff_en & RF_SEL_B) { rx_seg_rx_count[rx_seg_index] = wl_bb_get_rfb_rx_count(); }
+                else if (buff_en & RF_SEL_C) { rx_seg_rx_count[rx_seg_index] = wl_bb_get_rfc_rx_count(); }
+                else                         { rx_seg_rx_count[rx_seg_index] = wl_bb_get_rfd_rx_count(); }
             }
         }
 
+        // Update the read / write offsets once the transfers are done only if at
+        //     least one of the buffers is enabled.
+        if (buff_en) {
+            rx_xfer_id = wl_cdma_submit_callback((wl_function_ptr_t)wl_buffers_core_rx_xfer_done, iq_write_offset);
+        }
+
     } else {
         // Since we should not use the interrupt since DDR is not present; reset the
         //     read / write offsets so we don't hit any weird conditions
@@ -2589,12 +4248,23 @@ void wl_buffers_core_tx_int_handler(void *InstancePtr){
     // Only perform a transfer if the node is using DDR for buffers
     if (use_dram_for_buffers) {
 
-        // Check if there was a RX error
+        // Check if there was a TX error
+        //     NOTE:  In streaming TX mode, the underflow is counted and the transmission continues.
+        //
         if (wl_bb_get_rf_tx_iq_error()) {
-            wl_printf(WL_PRINT_ERROR, print_type_baseband, "TX temp buffer underflowed.\n");
-            return;
+            if (tx_stream_en) {
+                tx_stream_underruns++;
+                wl_bb_clear_rf_tx_iq_error();
+            } else {
+                wl_printf(WL_PRINT_ERROR, print_type_baseband, "TX temp buffer underflowed.\n");
+                return;
+            }
         }
 
+        // Wait for the transfers from the previous interrupt so the write offset is up to date
+        //     (see wl_buffers_core_tx_xfer_done())
+        wl_cdma_wait(tx_xfer_id);
+
         // Get buffers core register values
         buff_en          = wl_bb_get_tx_buffer_en();
         tx_iq_status     = wl_bb_get_rf_tx_iq_status();
@@ -2630,8 +4300,21 @@ void wl_buffers_core_tx_int_handler(void *InstancePtr){
             // Transfer the data
             populate_tmp_tx_buffers(buff_en, iq_write_offset, iq_xfer_length);
 
-            // Update the write_offset in the buffers core
-            wl_bb_set_rf_tx_iq_buf_wr_byte_offset(iq_write_offset + iq_xfer_length);
+            // Advance the Tx read pointer of the stream.  If the host has not written the samples
+            //     for this transfer, then the stale samples from the previous pass through the ring
+            //     are transmitted.
+            //
+            if (tx_stream_en) {
+                tx_stream_rd_samp  += (iq_xfer_length >> 2);
+                tx_stream_rd_offset = ((iq_write_offset + iq_xfer_length) >> 2) % tx_stream_length;
+
+                if ((s32)(tx_stream_rd_samp - tx_stream_wr_samp) > 0) {
+                    tx_stream_underruns++;
+                }
+            }
+
+            // Update the write_offset in the buffers core once the transfers are done
+            tx_xfer_id = wl_cdma_submit_callback((wl_function_ptr_t)wl_buffers_core_tx_xfer_done, (iq_write_offset + iq_xfer_length));
         }
 
     } else {
@@ -2643,6 +4326,84 @@ void wl_buffers_core_tx_int_handler(void *InstancePtr){
 
 
 
+/*****************************************************************************/
+/**
+ * @brief Buffers Core RX Transfer Done
+ *
+ * CDMA queue callback executed once all transfers queued by the RX interrupt
+ * handler are done.  If we are done, then reset the read / write offsets (and
+ * advance the segment in segmented RX mode or start the accumulation in RX
+ * accumulation mode).  Otherwise, update the read offset to reflect the bytes read.
+ *
+ * @param   iq_write_offset  - Write offset of the buffers core when the transfers were queued
+ *
+ * @return  int              - Status of the command:
+ *                                 XST_SUCCESS - Command completed successfully
+ *
+ ******************************************************************************/
+int wl_buffers_core_rx_xfer_done(u32 iq_write_offset){
+
+    if (iq_write_offset == rx_buffer_size) {
+        wl_bb_set_rf_rx_iq_buf_rd_byte_offset(0);
+        wl_bb_set_rf_rx_iq_buf_wr_byte_offset(0);
+
+        // Move the next reception to the next segment
+        if (rx_seg_num) {
+            rx_seg_count++;
+            rx_seg_index++;
+
+            if (rx_seg_index == rx_seg_num) {
+                rx_seg_index = 0;
+            }
+
+            rx_seg_base = rx_seg_index * rx_buffer_size;
+        }
+
+        // Process a parked Read IQ request in the main loop (see read_iq_defer_service())
+        if (read_iq_defer_state == READ_IQ_DEFER_PARKED) {
+            read_iq_defer_state = READ_IQ_DEFER_READY;
+        }
+
+        // Accumulate the reception in the main loop (see baseband_service())
+        if (rx_accum_en) {
+            if ((rx_accum_pending) || (rx_accum_count == WL_BUF_RX_ACCUM_MAX_COUNT)) {
+                rx_accum_overruns++;
+            } else {
+                rx_accum_samp    = 0;
+                rx_accum_pending = wl_bb_get_rx_buffer_en();
+            }
+        }
+    } else {
+        wl_bb_set_rf_rx_iq_buf_rd_byte_offset(iq_write_offset);
+    }
+
+    return XST_SUCCESS;
+}
+
+
+
+/*****************************************************************************/
+/**
+ * @brief Buffers Core TX Transfer Done
+ *
+ * CDMA queue callback executed once all transfers queued by the TX interrupt
+ * handler are done.  Updates the write offset in the buffers core.
+ *
+ * @param   iq_write_offset  - New write offset of the buffers core
+ *
+ * @return  int              - Status of the command:
+ *                                 XST_SUCCESS - Command completed successfully
+ *
+ ******************************************************************************/
+int wl_buffers_core_tx_xfer_done(u32 iq_write_offset){
+
+    wl_bb_set_rf_tx_iq_buf_wr_byte_offset(iq_write_offset);
+
+    return XST_SUCCESS;
+}
+
+
+
 /*****************************************************************************/
 /**
  * @brief Configure Baseband Buffers
@@ -419,6 +419,8 @@ u64 get_usec_timestamp(){
 // CDMA defines
 #define CDMA_ALIGNMENT                                     0x10
 #define CDMA_ALIGNMENT_MASK                                0xFFFFFFF0
+#define CDMA_QUEUE_LENGTH                                  32                                ///< Must be a power of 2
+#define CDMA_QUEUE_MASK                                    (CDMA_QUEUE_LENGTH - 1)
 
 
 /*********************** Global Variable Definitions *************************/
@@ -437,11 +439,26 @@ volatile wl_function_ptr_t        uart_callback;                     ///< User c
 // Interrupt State
 volatile static interrupt_state_t interrupt_state;
 
+// CDMA transfer queue
+//     NOTE:  Transfers are started in order from cdma_queue_head.  The transfer at cdma_queue_head is
+//         in progress if cdma_xfer_active is set.  Transfer IDs are assigned in order of submission,
+//         so a transfer is complete once cdma_done_count has reached its ID.
+//
+static wl_cdma_xfer               cdma_queue[CDMA_QUEUE_LENGTH];
+volatile static u32               cdma_queue_head;
+volatile static u32               cdma_queue_tail;
+volatile static u32               cdma_xfer_active;
+volatile static u32               cdma_submit_count;
+volatile static u32               cdma_done_count;
+
 
 /*************************** Functions Prototypes ****************************/
 
 void wl_uart_rx_handler(void* CallBackRef, unsigned int EventData);
 
+u32  wl_cdma_queue_push(u32 src_address, u32 dest_address, u32 length, wl_function_ptr_t callback, u32 callback_arg);
+void wl_cdma_queue_process();
+
 
 
 /******************************** Functions **********************************/
@@ -539,6 +556,13 @@ int wl_cdma_initialize(){
 
     XAxiCdma_IntrDisable(&cdma_inst, XAXICDMA_XR_IRQ_ALL_MASK);
 
+    // Initialize the transfer queue
+    cdma_queue_head   = 0;
+    cdma_queue_tail   = 0;
+    cdma_xfer_active  = 0;
+    cdma_submit_count = 0;
+    cdma_done_count   = 0;
+
     return status;
 }
 
@@ -578,43 +602,257 @@ int wl_uart_initialize(){
  * @param   dest_address     - Destination address (u32) of the transfer
  * @param   length           - Length of the transfer in bytes
  *
- * @return  None
+ * @return  u32              - Transfer ID (use with wl_cdma_done() / wl_cdma_wait())
  *
  * @note  The CDMA is 128 bits and contains no data re-alignment engine
  *   (limitation of the IP).  Therefore, we can only perform 16 byte aligned
  *   transfers without issue.  If the transfer was unaligned, we will issue
  *   a warning since this call can be in timing critical loops.
  *
- * @note  This function does not wait for a DMA transfer to complete once it
- *   has been issued.  This allows the CPU to pipeline instructions while the
- *   DMA is transferring data.  However, this function will wait for the DMA
- *   to be ready if it is currently in use.
+ * @note  This function does not wait for the DMA.  The transfer is added to
+ *   the CDMA queue and is started immediately if the DMA is idle.  Otherwise,
+ *   it is started by wl_cdma_service() once all previous transfers are done.
+ *   This function will only wait if the queue is full.
  *
  ********************************************************************/
-void wl_cdma_transfer(u32 src_address, u32 dest_address, u32 length){
-
-    // This code assumes all transfers are 16 byte aligned
-
-    // Check if there was an error in the previous transfer and reset the DMA
-    if ( XAxiCdma_GetError(&cdma_inst) != 0x0 ) {
-        wl_printf(WL_PRINT_ERROR, print_type_node, "DMA transfer prior to %d bytes from 0x%08x to 0x%08x failed.\nResetting DMA ... \n\n", length, src_address, dest_address);
-        XAxiCdma_Reset(&cdma_inst);
-        while(!XAxiCdma_ResetIsDone(&cdma_inst)) {}
-    }
-
-    // Wait for the DMA to be ready before issuing a new transfer
-    while(XAxiCdma_IsBusy(&cdma_inst)) {}
-    XAxiCdma_SimpleTransfer(&cdma_inst, src_address, dest_address, length, NULL, NULL);
+u32 wl_cdma_transfer(u32 src_address, u32 dest_address, u32 length){
+    u32               transfer_id;
+    interrupt_state_t prev_interrupt_state;
 
     // Issue a warning if the transfer was unaligned
     if (((src_address  & CDMA_ALIGNMENT_MASK) != src_address ) ||
         ((dest_address & CDMA_ALIGNMENT_MASK) != dest_address)) {
         wl_printf(WL_PRINT_ERROR, print_type_node, "DMA transfer not %d byte aligned: %d bytes from 0x%08x to 0x%08x.\n", CDMA_ALIGNMENT, length, src_address, dest_address);
     }
+
+    // Queue the transfer
+    //     NOTE:  Transfers can be submitted from both the main loop and interrupt handlers
+    prev_interrupt_state = wl_interrupt_stop();
+
+    transfer_id = wl_cdma_queue_push(src_address, dest_address, length, NULL, 0);
+
+    wl_interrupt_restore_state(prev_interrupt_state);
+
+    return transfer_id;
+}
+
+
+
+/********************************************************************
+ * @brief Add a callback to the CDMA queue
+ *
+ * The callback is executed once all transfers submitted before it are complete.
+ * This allows an interrupt handler to queue its transfers along with the
+ * processing that must happen after the transfers are done (eg updating the
+ * pointers in the buffers core) and return without waiting on the DMA.
+ *
+ * @param   callback         - Function to execute:  callback(callback_arg)
+ * @param   callback_arg     - Argument to the callback
+ *
+ * @return  u32              - Transfer ID (use with wl_cdma_done() / wl_cdma_wait())
+ *
+ * @note  Callbacks are executed with interrupts stopped.
+ *
+ ********************************************************************/
+u32 wl_cdma_submit_callback(wl_function_ptr_t callback, u32 callback_arg){
+    u32               transfer_id;
+    interrupt_state_t prev_interrupt_state;
+
+    prev_interrupt_state = wl_interrupt_stop();
+
+    transfer_id = wl_cdma_queue_push(0, 0, 0, callback, callback_arg);
+
+    wl_interrupt_restore_state(prev_interrupt_state);
+
+    return transfer_id;
+}
+
+
+
+/********************************************************************
+ * @brief Service the CDMA queue
+ *
+ * Completes the transfer in progress (if the DMA is done) and starts the next
+ * transfer in the queue.  This should be called regularly (ie from the main
+ * loop and from long running loops) so the queue continues to make progress.
+ *
+ * @param   None
+ *
+ * @return  None
+ *
+ ********************************************************************/
+void wl_cdma_service(){
+    interrupt_state_t prev_interrupt_state;
+
+    prev_interrupt_state = wl_interrupt_stop();
+
+    wl_cdma_queue_process();
+
+    wl_interrupt_restore_state(prev_interrupt_state);
+}
+
+
+
+/********************************************************************
+ * @brief Check if a CDMA transfer is complete
+ *
+ * @param   transfer_id      - Transfer ID returned when the transfer was submitted
+ *
+ * @return  int              - 1 if the transfer is done; 0 otherwise
+ *
+ ********************************************************************/
+int wl_cdma_done(u32 transfer_id){
+    // NOTE:  Signed difference so that the transfer ID can wrap
+    return (((int)(cdma_done_count - transfer_id)) >= 0);
+}
+
+
+
+/********************************************************************
+ * @brief Wait for a CDMA transfer to complete
+ *
+ * Services the CDMA queue until the given transfer and all transfers
+ * submitted before it are complete.
+ *
+ * @param   transfer_id      - Transfer ID returned when the transfer was submitted
+ *
+ * @return  None
+ *
+ ********************************************************************/
+void wl_cdma_wait(u32 transfer_id){
+    while (!wl_cdma_done(transfer_id)) {
+        wl_cdma_service();
+    }
+}
+
+
+
+/********************************************************************
+ * @brief Wait for all CDMA transfers to complete
+ *
+ * @param   None
+ *
+ * @return  None
+ *
+ ********************************************************************/
+void wl_cdma_wait_all(){
+    wl_cdma_wait(cdma_submit_count);
 }
 
+
+
+/********************************************************************
+ * @brief Check if the CDMA is busy
+ *
+ * @param   None
+ *
+ * @return  int              - 1 if there are transfers that are not complete; 0 otherwise
+ *
+ ********************************************************************/
 int  wl_cdma_busy() {
-    return XAxiCdma_IsBusy(&cdma_inst);
+    return (cdma_done_count != cdma_submit_count);
+}
+
+
+
+/********************************************************************
+ * @brief Add an entry to the CDMA queue
+ *
+ * @param   src_address      - Source address (u32) of the transfer
+ * @param   dest_address     - Destination address (u32) of the transfer
+ * @param   length           - Length of the transfer in bytes (0 for callback only entries)
+ * @param   callback         - Function to execute once the transfer is done (or NULL)
+ * @param   callback_arg     - Argument to the callback
+ *
+ * @return  u32              - Transfer ID
+ *
+ * @note  Interrupts must be stopped by the caller.  If the queue is full, this
+ *   function will wait for the transfer in progress to complete.
+ *
+ ********************************************************************/
+u32 wl_cdma_queue_push(u32 src_address, u32 dest_address, u32 length, wl_function_ptr_t callback, u32 callback_arg){
+    wl_cdma_xfer * xfer;
+
+    // Wait for space in the queue
+    while (((cdma_queue_tail - cdma_queue_head) & CDMA_QUEUE_MASK) == CDMA_QUEUE_MASK) {
+        wl_cdma_queue_process();
+    }
+
+    // Add the transfer to the queue
+    xfer               = &(cdma_queue[cdma_queue_tail]);
+
+    xfer->src_address  = src_address;
+    xfer->dest_address = dest_address;
+    xfer->length       = length;
+    xfer->callback     = callback;
+    xfer->callback_arg = callback_arg;
+
+    cdma_queue_tail    = (cdma_queue_tail + 1) & CDMA_QUEUE_MASK;
+    cdma_submit_count += 1;
+
+    // Start the transfer if the DMA is idle
+    wl_cdma_queue_process();
+
+    return cdma_submit_count;
+}
+
+
+
+/********************************************************************
+ * @brief Process the CDMA queue
+ *
+ * @param   None
+ *
+ * @return  None
+ *
+ * @note  Interrupts must be stopped by the caller.
+ *
+ ********************************************************************/
+void wl_cdma_queue_process(){
+    wl_cdma_xfer      * xfer;
+    wl_function_ptr_t   callback;
+    u32                 callback_arg;
+
+    while (cdma_queue_head != cdma_queue_tail) {
+
+        xfer = &(cdma_queue[cdma_queue_head]);
+
+        if (cdma_xfer_active) {
+            // Check if there was an error in the transfer and reset the DMA
+            if ( XAxiCdma_GetError(&cdma_inst) != 0x0 ) {
+                wl_printf(WL_PRINT_ERROR, print_type_node, "DMA transfer of %d bytes from 0x%08x to 0x%08x failed.\nResetting DMA ... \n\n", xfer->length, xfer->src_address, xfer->dest_address);
+                XAxiCdma_Reset(&cdma_inst);
+                while(!XAxiCdma_ResetIsDone(&cdma_inst)) {}
+
+            } else if (XAxiCdma_IsBusy(&cdma_inst)) {
+                // Nothing to do if the transfer in progress has not completed
+                return;
+            }
+
+            cdma_xfer_active = 0;
+
+        } else if (xfer->length != 0) {
+            // Start the transfer at the head of the queue
+            XAxiCdma_SimpleTransfer(&cdma_inst, xfer->src_address, xfer->dest_address, xfer->length, NULL, NULL);
+
+            cdma_xfer_active = 1;
+            return;
+        }
+
+        // Transfer is complete; remove it from the queue and execute the callback
+        //     NOTE:  The entry must be removed before the callback is executed since the callback can
+        //            queue new transfers (ie re-run an interrupt handler), which processes the queue again.
+        //
+        callback         = xfer->callback;
+        callback_arg     = xfer->callback_arg;
+
+        cdma_queue_head  = (cdma_queue_head + 1) & CDMA_QUEUE_MASK;
+        cdma_done_count += 1;
+
+        if (callback != NULL) {
+            callback(callback_arg);
+        }
+    }
 }
 
 
@@ -994,6 +1232,8 @@ void clear_ddr(u32 verbose) {
     for (i = 1; i < num_step; i++) {
         wl_cdma_transfer(start_address, (start_address + (step_size * i)), step_size);
     }
+
+    wl_cdma_wait_all();
 #endif
 
     end_time   = get_usec_timestamp();
@@ -65,12 +65,40 @@ static u8                    configure_buffers;            // Configure the base
 u8                           ethernet_pause;               // State variable to pause the reception of Ethernet packets
 #endif
 
+// Node sequencer (see NODE_SEQ_* in wl_node.h)
+static u32                   seq_program[NODE_SEQ_MAX_WORDS];              // Program (network byte order)
+static u32                   seq_length;                                   // Length of the program (in words)
+static u32                   seq_state;
+static u32                   seq_flags;
+static u32                   seq_pc;                                       // Index of the current instruction
+static u32                   seq_num_cmds;                                 // Number of commands processed
+static u32                   seq_loop_depth;
+static u32                   seq_loop_start[NODE_SEQ_MAX_LOOP_DEPTH];
+static u32                   seq_loop_count[NODE_SEQ_MAX_LOOP_DEPTH];
+static u32                   seq_wait_active;
+static u64                   seq_wait_deadline;
+
+static int                   seq_socket;                                   // Host that started the sequencer
+static struct sockaddr       seq_from;
+static wl_transport_header   seq_hdr;
+
+static wl_cmd_resp_hdr       seq_cmd_hdr;                                  // Command being processed
+static u32                   seq_cmd_args[NODE_SEQ_MAX_CMD_ARGS];
+
 /*************************** Functions Prototypes ****************************/
 
 void blink_node( int num_blinks, int blink_time );
 
 void set_node_error_status( int status );
 
+void node_seq_error(char * msg);
+
+u32  node_cmd_needs_packet(u32 cmd);
+u32  node_seq_cmd_valid(u32 cmd);
+int  node_seq_check_program(u32 length, u32 partial);
+u32  node_cmd_sends_resp(u32 cmd);
+u32  node_bundle_resp_length(wl_cmd_resp_hdr * cmd_hdr, u32 * cmd_args_32);
+
 
 /******************************** Functions **********************************/
 
@@ -98,7 +126,6 @@ void set_node_error_status( int status );
  *****************************************************************************/
 int  node_rx_from_transport(int socket_index, struct sockaddr * from, warp_ip_udp_buffer * recv_buffer, warp_ip_udp_buffer * send_buffer) {
 
-    u8                  cmd_group;
     u32                 resp_sent      = NO_RESP_SENT;
     u32                 resp_length;
 
@@ -124,49 +151,76 @@ int  node_rx_from_transport(int socket_index, struct sockaddr * from, warp_ip_ud
     cmd_hdr->num_args   = Xil_Ntohs(cmd_hdr->num_args);
 
     // Send command to appropriate processing sub-system
-    cmd_group           = WL_CMD_TO_GRP(cmd_hdr->cmd);
+    resp_sent           = node_dispatch_cmd(socket_index, from, &command, &response);
+
+    // Adjust the length of the response to include the response data from the sub-system and the
+    // response header
+    //
+    if((resp_sent == NO_RESP_SENT) || (resp_sent == NODE_NOT_READY)) {
+        resp_length = (resp_hdr->length + sizeof(wl_cmd_resp_hdr));
+
+        // Keep the length and size of the response in sync since we are adding bytes to the buffer
+        send_buffer->length += resp_length;
+        send_buffer->size   += resp_length;
+    }
+
+    // Endian swap the response header before returning
+    resp_hdr->cmd       = Xil_Ntohl(resp_hdr->cmd);
+    resp_hdr->length    = Xil_Ntohs(resp_hdr->length);
+    resp_hdr->num_args  = Xil_Ntohs(resp_hdr->num_args);
+
+    // Return the status
+    return resp_sent;
+}
+
+
+
+/*****************************************************************************/
+/**
+ * Node Dispatch Command
+ *
+ * Based on the Command Group field in the Command header, this function will call
+ * the appropriate sub-system to process the command.
+ *
+ * @param   socket_index     - Index of the socket on which message was received
+ * @param   from             - Pointer to socket address structure from which message was received
+ * @param   command          - Pointer to WARPLab Command (header already endian swapped)
+ * @param   response         - Pointer to WARPLab Response
+ *
+ * @return  u32              - Status of the command (see node_process_cmd())
+ *
+ *****************************************************************************/
+u32 node_dispatch_cmd(int socket_index, void * from, wl_cmd_resp * command, wl_cmd_resp * response) {
+
+    u8                  cmd_group;
+    u32                 resp_sent      = NO_RESP_SENT;
+
+    cmd_group           = WL_CMD_TO_GRP(command->header->cmd);
 
     switch(cmd_group){
         case GROUP_NODE:
-            resp_sent = node_process_cmd(socket_index, from, &command, &response);
+            resp_sent = node_process_cmd(socket_index, from, command, response);
         break;
         case GROUP_TRANSPORT:
-            resp_sent = transport_process_cmd(socket_index, from, &command, &response);
+            resp_sent = transport_process_cmd(socket_index, from, command, response);
         break;
         case GROUP_INTERFACE:
-            resp_sent = ifc_process_cmd(socket_index, from, &command, &response);
+            resp_sent = ifc_process_cmd(socket_index, from, command, response);
         break;
         case GROUP_BASEBAND:
-            resp_sent = baseband_process_cmd(socket_index, from, &command, &response);
+            resp_sent = baseband_process_cmd(socket_index, from, command, response);
         break;
         case GROUP_TRIGGER_MANAGER:
-            resp_sent = trigmngr_process_cmd(socket_index, from, &command, &response);
+            resp_sent = trigmngr_process_cmd(socket_index, from, command, response);
         break;
         case GROUP_USER:
-            resp_sent = user_process_cmd(socket_index, from, &command, &response);
+            resp_sent = user_process_cmd(socket_index, from, command, response);
         break;
         default:
             wl_printf(WL_PRINT_ERROR, print_type_node, "Unknown command group: %d\n", cmd_group);
         break;
     }
 
-    // Adjust the length of the response to include the response data from the sub-system and the
-    // response header
-    //
-    if((resp_sent == NO_RESP_SENT) || (resp_sent == NODE_NOT_READY)) {
-        resp_length = (resp_hdr->length + sizeof(wl_cmd_resp_hdr));
-
-        // Keep the length and size of the response in sync since we are adding bytes to the buffer
-        send_buffer->length += resp_length;
-        send_buffer->size   += resp_length;
-    }
-
-    // Endian swap the response header before returning
-    resp_hdr->cmd       = Xil_Ntohl(resp_hdr->cmd);
-    resp_hdr->length    = Xil_Ntohs(resp_hdr->length);
-    resp_hdr->num_args  = Xil_Ntohs(resp_hdr->num_args);
-
-    // Return the status
     return resp_sent;
 }
 
@@ -293,6 +347,383 @@ int global_initialize(){
 
 
 
+/*****************************************************************************/
+/**
+ * Node Sequencer Service
+ *
+ * This function is called from the main loop and processes the next instruction
+ * of a running sequencer program (see NODE_SEQ_* in wl_node.h).  Waits do not
+ * block, so Ethernet packets (eg CMDID_NODE_SEQ_STOP) are still processed while
+ * the program runs.
+ *
+ * @param   None
+ *
+ * @return  None
+ *
+ * @note    Commands are processed the same way as the deferred Read IQ (see
+ *          read_iq_defer_service()).  The response uses the transport header of the
+ *          CMDID_NODE_SEQ_START command.
+ *
+ *****************************************************************************/
+void node_seq_service() {
+
+    u32                   instr;
+    u32                   op;
+    u32                   operand;
+    u32                   resp_sent;
+    warp_ip_udp_buffer  * send_buffer;
+    wl_transport_header * wl_header_tx;
+    wl_cmd_resp           command;
+    wl_cmd_resp           response;
+
+    if (seq_state != NODE_SEQ_STATE_RUNNING) {
+        return;
+    }
+
+    if (seq_pc >= seq_length) {
+        seq_state = NODE_SEQ_STATE_DONE;
+        return;
+    }
+
+    instr   = Xil_Ntohl(seq_program[seq_pc]);
+    op      = (instr & NODE_SEQ_OP_MASK) >> NODE_SEQ_OP_SHIFT;
+    operand = (instr & NODE_SEQ_OPERAND_MASK);
+
+    switch (op) {
+        case NODE_SEQ_OP_CMD:
+            if ((operand < (sizeof(wl_cmd_resp_hdr) / sizeof(u32))) ||
+                ((seq_pc + 1 + operand) > seq_length) ||
+                ((operand - (sizeof(wl_cmd_resp_hdr) / sizeof(u32))) > NODE_SEQ_MAX_CMD_ARGS)) {
+                node_seq_error("Invalid command length");
+                return;
+            }
+
+            // Copy the command so that processing it can not change the program
+            memcpy((void *)&seq_cmd_hdr, (void *)&seq_program[seq_pc + 1], sizeof(wl_cmd_resp_hdr));
+            memcpy((void *)seq_cmd_args, (void *)&seq_program[seq_pc + 1 + (sizeof(wl_cmd_resp_hdr) / sizeof(u32))],
+                   ((operand * sizeof(u32)) - sizeof(wl_cmd_resp_hdr)));
+
+            seq_cmd_hdr.cmd      = Xil_Ntohl(seq_cmd_hdr.cmd);
+            seq_cmd_hdr.length   = Xil_Ntohs(seq_cmd_hdr.length);
+            seq_cmd_hdr.num_args = Xil_Ntohs(seq_cmd_hdr.num_args);
+
+            // Check the command again since NODE_SEQ_OP_ADD can change the program
+            if (!node_seq_cmd_valid(seq_cmd_hdr.cmd)) {
+                node_seq_error("Command can not be used in a program");
+                return;
+            }
+
+            // Set up the send buffer the same way as the transport does for a received message
+            //     (see transport_receive())
+            //
+            send_buffer          = socket_alloc_send_buffer();
+            wl_header_tx         = (wl_transport_header *)(send_buffer->offset);
+
+            memcpy((void *)wl_header_tx, (void *)&seq_hdr, sizeof(wl_transport_header));
+
+            send_buffer->offset += sizeof(wl_transport_header);
+            send_buffer->length += sizeof(wl_transport_header);
+            send_buffer->size   += sizeof(wl_transport_header);
+
+            command.header       = &seq_cmd_hdr;
+            command.args         = seq_cmd_args;
+            command.buffer       = NULL;
+
+            response.header      = (wl_cmd_resp_hdr *)(send_buffer->offset);
+            response.args        = (u32 *)((send_buffer->offset) + sizeof(wl_cmd_resp_hdr));
+            response.buffer      = (void *)(send_buffer);
+
+            resp_sent = node_dispatch_cmd(seq_socket, (void *)&seq_from, &command, &response);
+
+            if ((resp_sent == NO_RESP_SENT) && (seq_flags & NODE_SEQ_FLAG_SEND_RESP)) {
+                node_send_early_resp(seq_socket, (void *)&seq_from, response.header, send_buffer);
+            }
+
+            socket_free_send_buffer(send_buffer);
+
+            // If the node is not ready for the command (eg Read IQ during a reception), then process it again
+            if (resp_sent == NODE_NOT_READY) {
+                return;
+            }
+
+            seq_num_cmds++;
+            seq_pc += (1 + operand);
+        break;
+
+        case NODE_SEQ_OP_LOOP:
+            if (seq_loop_depth == NODE_SEQ_MAX_LOOP_DEPTH) {
+                node_seq_error("Too many nested loops");
+                return;
+            }
+
+            seq_loop_start[seq_loop_depth] = seq_pc + 1;
+            seq_loop_count[seq_loop_depth] = operand;
+            seq_loop_depth++;
+            seq_pc++;
+        break;
+
+        case NODE_SEQ_OP_END_LOOP:
+            if (seq_loop_depth == 0) {
+                node_seq_error("End of loop without a loop");
+                return;
+            }
+
+            if (seq_loop_count[seq_loop_depth - 1] > 1) {
+                seq_loop_count[seq_loop_depth - 1]--;
+                seq_pc = seq_loop_start[seq_loop_depth - 1];
+            } else {
+                seq_loop_depth--;
+                seq_pc++;
+            }
+        break;
+
+        case NODE_SEQ_OP_WAIT_TIME:
+            if (seq_wait_active == 0) {
+                seq_wait_deadline = get_usec_timestamp() + operand;
+                seq_wait_active   = 1;
+            }
+
+            if (get_usec_timestamp() >= seq_wait_deadline) {
+                seq_wait_active   = 0;
+                seq_pc++;
+            }
+        break;
+
+        case NODE_SEQ_OP_WAIT_BUFFERS:
+            if (((wl_bb_get_tx_status() | wl_bb_get_rx_status()) & operand) == 0) {
+                seq_pc++;
+            }
+        break;
+
+        case NODE_SEQ_OP_ADD:
+            if ((operand >= seq_length) || ((seq_pc + 1) >= seq_length)) {
+                node_seq_error("Invalid parameter increment");
+                return;
+            }
+
+            seq_program[operand] = Xil_Htonl(Xil_Ntohl(seq_program[operand]) + Xil_Ntohl(seq_program[seq_pc + 1]));
+            seq_pc += 2;
+        break;
+
+        default:
+            node_seq_error("Unknown instruction");
+        break;
+    }
+}
+
+
+
+/*****************************************************************************/
+/**
+ * Node Sequencer Error
+ *
+ * Stops the sequencer program because of an error.
+ *
+ * @param   msg              - Description of the error
+ *
+ * @return  None
+ *
+ *****************************************************************************/
+void node_seq_error(char * msg) {
+    wl_printf(WL_PRINT_ERROR, print_type_node, "Sequencer: %s at word %d\n", msg, seq_pc);
+
+    seq_state = NODE_SEQ_STATE_ERROR;
+}
+
+
+
+/*****************************************************************************/
+/**
+ * Node Command Needs Packet
+ *
+ * Checks if a command needs the data of the received packet (ie command->buffer
+ * or sample data in the arguments), so it can not be processed from a sequencer
+ * program or a bundle.
+ *
+ * @param   cmd              - Command (group and command ID)
+ *
+ * @return  u32              - WL_TRUE if the command needs the packet; WL_FALSE otherwise
+ *
+ *****************************************************************************/
+u32 node_cmd_needs_packet(u32 cmd) {
+
+    switch (WL_CMD_TO_GRP(cmd)) {
+        case GROUP_TRANSPORT:
+            if (WL_CMD_TO_CMDID(cmd) == CMDID_TRANSPORT_PAYLOAD_SIZE_TEST) { return WL_TRUE; }
+        break;
+
+        case GROUP_BASEBAND:
+            if (WL_CMD_TO_CMDID(cmd) == CMDID_BASEBAND_WRITE_IQ)           { return WL_TRUE; }
+        break;
+    }
+
+    return WL_FALSE;
+}
+
+
+
+/*****************************************************************************/
+/**
+ * Node Sequencer Command Valid
+ *
+ * Checks if a command can be used in a sequencer program.  Commands that need the
+ * received packet and commands that change the sequencer (ie load / start, or a
+ * bundle that could contain them) are not allowed.
+ *
+ * @param   cmd              - Command (group and command ID)
+ *
+ * @return  u32              - WL_TRUE if the command can be used in a program; WL_FALSE otherwise
+ *
+ *****************************************************************************/
+u32 node_seq_cmd_valid(u32 cmd) {
+
+    if (node_cmd_needs_packet(cmd)) {
+        return WL_FALSE;
+    }
+
+    if (WL_CMD_TO_GRP(cmd) == GROUP_NODE) {
+        switch (WL_CMD_TO_CMDID(cmd)) {
+            case CMDID_NODE_SEQ_LOAD:
+            case CMDID_NODE_SEQ_START:
+            case CMDID_NODE_BUNDLE:
+                return WL_FALSE;
+            break;
+        }
+    }
+
+    return WL_TRUE;
+}
+
+
+
+/*****************************************************************************/
+/**
+ * Node Sequencer Check Program
+ *
+ * Checks the commands of the first words of the sequencer program.
+ *
+ * @param   length           - Number of words of the program to check
+ * @param   partial          - WL_TRUE if the program is still being loaded (ie an instruction
+ *                             that extends past length is not an error)
+ *
+ * @return  int              - Status of the command:
+ *                                 XST_SUCCESS - The program is valid
+ *                                 XST_FAILURE - The program has an invalid instruction
+ *
+ * @note    Programs are loaded in order (see 'sequencer_load' in wl_node.m), so the
+ *          words before the last word loaded are the words of the program.
+ *
+ *****************************************************************************/
+int node_seq_check_program(u32 length, u32 partial) {
+
+    u32                   pc = 0;
+    u32                   instr;
+    u32                   op;
+    u32                   operand;
+
+    while (pc < length) {
+        instr   = Xil_Ntohl(seq_program[pc]);
+        op      = (instr & NODE_SEQ_OP_MASK) >> NODE_SEQ_OP_SHIFT;
+        operand = (instr & NODE_SEQ_OPERAND_MASK);
+
+        switch (op) {
+            case NODE_SEQ_OP_CMD:
+                if (operand < (sizeof(wl_cmd_resp_hdr) / sizeof(u32))) {
+                    return XST_FAILURE;
+                }
+
+                if ((pc + 1 + operand) > length) {
+                    return (partial ? XST_SUCCESS : XST_FAILURE);
+                }
+
+                if (!node_seq_cmd_valid(Xil_Ntohl(seq_program[pc + 1]))) {
+                    wl_printf(WL_PRINT_ERROR, print_type_node, "Command 0x%08x at word %d can not be used in a program\n", Xil_Ntohl(seq_program[pc + 1]), pc);
+                    return XST_FAILURE;
+                }
+
+                pc += (1 + operand);
+            break;
+
+            case NODE_SEQ_OP_ADD:
+                pc += 2;
+            break;
+
+            default:
+                pc += 1;
+            break;
+        }
+    }
+
+    return XST_SUCCESS;
+}
+
+
+
+/*****************************************************************************/
+/**
+ * Node Command Sends Response
+ *
+ * Checks if a command sends its own response packets (ie the response is not
+ * returned in the response structure), so it can not be processed in a bundle.
+ *
+ * @param   cmd              - Command (group and command ID)
+ *
+ * @return  u32              - WL_TRUE if the command sends its own response; WL_FALSE otherwise
+ *
+ *****************************************************************************/
+u32 node_cmd_sends_resp(u32 cmd) {
+
+    switch (WL_CMD_TO_GRP(cmd)) {
+        case GROUP_NODE:
+            if (WL_CMD_TO_CMDID(cmd) == CMDID_NODE_IDENTIFY)               { return WL_TRUE; }
+            if (WL_CMD_TO_CMDID(cmd) == CMDID_NODE_CONFIG_RESET)           { return WL_TRUE; }
+        break;
+
+        case GROUP_BASEBAND:
+            if (WL_CMD_TO_CMDID(cmd) == CMDID_BASEBAND_READ_IQ)            { return WL_TRUE; }
+            if (WL_CMD_TO_CMDID(cmd) == CMDID_BASEBAND_READ_RSSI)          { return WL_TRUE; }
+        break;
+    }
+
+    return WL_FALSE;
+}
+
+
+
+/*****************************************************************************/
+/**
+ * Node Bundle Response Length
+ *
+ * Returns the length of the response of a bundled command (response header and
+ * arguments) if it is known before the command is processed.  This is reserved
+ * in the bundle response before the command is processed.
+ *
+ * @param   cmd_hdr          - Pointer to the command header (already endian swapped)
+ * @param   cmd_args_32      - Pointer to the command arguments
+ *
+ * @return  u32              - Response length (in bytes); 0 if the length is not known
+ *
+ *****************************************************************************/
+u32 node_bundle_resp_length(wl_cmd_resp_hdr * cmd_hdr, u32 * cmd_args_32) {
+
+    u32 mem_length;
+
+    // A NODE_MEM_RW read returns the memory values (see node_process_cmd())
+    if ((cmd_hdr->cmd == CMDID_NODE_MEM_RW) && (cmd_hdr->length >= (3 * sizeof(u32))) &&
+        (Xil_Ntohl(cmd_args_32[0]) == CMD_PARAM_READ_VAL)) {
+
+        mem_length = Xil_Ntohl(cmd_args_32[2]);
+
+        if (mem_length < CMD_PARAM_NODE_MEM_RW_MAX_BYTES) {
+            return (sizeof(wl_cmd_resp_hdr) + ((2 + mem_length) * sizeof(u32)));
+        }
+    }
+
+    return 0;
+}
+
+
+
 
 /**********************************************************************************************************************/
 /**
@@ -387,6 +818,19 @@ int node_process_cmd(int socket_index, void * from, wl_cmd_resp * command, wl_cm
     u32                 mem_length;
     u32                 mem_index;
 
+    u32                 seq_offset;
+    u32                 seq_words;
+
+    u32                 bundle_index;
+    u32                 bundle_words;
+    u32                 bundle_count;
+    u32                 bundle_max_length;
+    u32                 bundle_resp_length;
+    wl_cmd_resp_hdr   * bundle_cmd_hdr;
+    wl_cmd_resp_hdr   * bundle_resp_hdr;
+    wl_cmd_resp         bundle_command;
+    wl_cmd_resp         bundle_response;
+
     // Set up the response header
     resp_hdr->cmd       = cmd_hdr->cmd;
     resp_hdr->length    = 0;
@@ -700,6 +1144,231 @@ int node_process_cmd(int socket_index, void * from, wl_cmd_resp * command, wl_cm
         break;
 
 
+        //---------------------------------------------------------------------
+        case CMDID_NODE_SEQ_LOAD:
+            // Load the words of a sequencer program
+            //
+            // Message format:
+            //     cmd_args_32[0]      Index of the first word
+            //     cmd_args_32[1:N]    Program words (see NODE_SEQ_* in wl_node.h)
+            //
+            // Response format:
+            //     resp_args_32[0]     Status
+            //
+            // NOTE:  A program that does not fit in one packet is loaded with multiple commands.  The program
+            //     can not be loaded while the sequencer is running.
+            //
+            status     = CMD_PARAM_SUCCESS;
+
+            if (cmd_hdr->length < sizeof(u32)) {
+                seq_offset = 0;
+                seq_words  = 0;
+                status     = CMD_PARAM_ERROR;
+            } else {
+                seq_offset = Xil_Ntohl(cmd_args_32[0]);
+                seq_words  = (cmd_hdr->length / sizeof(u32)) - 1;
+            }
+
+            // Check the words fit in the program (written so the check can not overflow)
+            if ((status == CMD_PARAM_ERROR) || (seq_state == NODE_SEQ_STATE_RUNNING) ||
+                (seq_offset > NODE_SEQ_MAX_WORDS) || (seq_words > (NODE_SEQ_MAX_WORDS - seq_offset))) {
+                wl_printf(WL_PRINT_ERROR, print_type_node, "Could not load sequencer words %d to %d\n", seq_offset, (seq_offset + seq_words));
+                status = CMD_PARAM_ERROR;
+            } else {
+                memcpy((void *)&seq_program[seq_offset], (void *)&cmd_args_32[1], (seq_words * sizeof(u32)));
+
+                // Check the commands loaded so far
+                if (node_seq_check_program((seq_offset + seq_words), WL_TRUE) != XST_SUCCESS) {
+                    status = CMD_PARAM_ERROR;
+                }
+            }
+
+            // Send response
+            resp_args_32[resp_index++] = Xil_Htonl(status);
+
+            resp_hdr->length  += (resp_index * sizeof(resp_args_32));
+            resp_hdr->num_args = resp_index;
+        break;
+
+
+        //---------------------------------------------------------------------
+        case CMDID_NODE_SEQ_START:
+            // Start the sequencer program
+            //
+            // Message format:
+            //     cmd_args_32[0]      Program length (in words)
+            //     cmd_args_32[1]      Flags (NODE_SEQ_FLAG_*)
+            //
+            // Response format:
+            //     resp_args_32[0]     Status
+            //
+            seq_words  = Xil_Ntohl(cmd_args_32[0]);
+            status     = CMD_PARAM_SUCCESS;
+
+            if ((seq_state == NODE_SEQ_STATE_RUNNING) || (seq_words > NODE_SEQ_MAX_WORDS) ||
+                (node_seq_check_program(seq_words, WL_FALSE) != XST_SUCCESS)) {
+                wl_printf(WL_PRINT_ERROR, print_type_node, "Could not start sequencer\n");
+                status = CMD_PARAM_ERROR;
+            } else {
+                seq_length      = seq_words;
+                seq_flags       = Xil_Ntohl(cmd_args_32[1]);
+                seq_pc          = 0;
+                seq_num_cmds    = 0;
+                seq_loop_depth  = 0;
+                seq_wait_active = 0;
+
+                // Save the host for the responses
+                //     NOTE:  The data of the send buffer starts at the transport header of the response
+                //
+                seq_socket      = socket_index;
+
+                memcpy((void *)&seq_from, from, sizeof(struct sockaddr));
+                memcpy((void *)&seq_hdr, (void *)(((warp_ip_udp_buffer *)(response->buffer))->data), sizeof(wl_transport_header));
+
+                seq_state       = NODE_SEQ_STATE_RUNNING;
+            }
+
+            // Send response
+            resp_args_32[resp_index++] = Xil_Htonl(status);
+
+            resp_hdr->length  += (resp_index * sizeof(resp_args_32));
+            resp_hdr->num_args = resp_index;
+        break;
+
+
+        //---------------------------------------------------------------------
+        case CMDID_NODE_SEQ_STOP:
+            // Stop the sequencer program
+            //
+            if (seq_state == NODE_SEQ_STATE_RUNNING) {
+                seq_state = NODE_SEQ_STATE_IDLE;
+            }
+        break;
+
+
+        //---------------------------------------------------------------------
+        case CMDID_NODE_SEQ_STATUS:
+            // Get the status of the sequencer
+            //
+            // Response format:
+            //     resp_args_32[0]     State (NODE_SEQ_STATE_*)
+            //     resp_args_32[1]     Index of the current instruction
+            //     resp_args_32[2]     Number of commands processed
+            //
+            resp_args_32[resp_index++] = Xil_Htonl(seq_state);
+            resp_args_32[resp_index++] = Xil_Htonl(seq_pc);
+            resp_args_32[resp_index++] = Xil_Htonl(seq_num_cmds);
+
+            resp_hdr->length  += (resp_index * sizeof(resp_args_32));
+            resp_hdr->num_args = resp_index;
+        break;
+
+
+        //---------------------------------------------------------------------
+        case CMDID_NODE_BUNDLE:
+            // Process a bundle of commands
+            //
+            // Message format:
+            //     cmd_args_32[0]      Maximum payload of the response packet (in bytes)
+            //     cmd_args_32[1:N]    Commands (command header followed by the arguments of each command)
+            //
+            // Response format:
+            //     resp_args_32[0]     Number of commands processed
+            //     resp_args_32[1:M]   Responses (response header followed by the arguments of each response)
+            //
+            // NOTE:  Each response carries the status of its command.  If the number of commands processed
+            //     is less than the number of commands in the bundle, then the host must send the remaining
+            //     commands again.
+            //
+            bundle_index      = 1;
+            bundle_words      = cmd_hdr->length / sizeof(u32);
+            bundle_count      = 0;
+            resp_index        = 1;
+
+            // Bytes available for the bundle response arguments in the response packet
+            bundle_max_length = Xil_Ntohl(cmd_args_32[0]);
+
+            if (bundle_max_length > NODE_BUNDLE_MAX_PAYLOAD) {
+                bundle_max_length = NODE_BUNDLE_MAX_PAYLOAD;
+            }
+
+            if (bundle_max_length > NODE_BUNDLE_RESP_OVERHEAD) {
+                bundle_max_length -= NODE_BUNDLE_RESP_OVERHEAD;
+            } else {
+                bundle_max_length  = 0;
+            }
+
+            while ((bundle_index + (sizeof(wl_cmd_resp_hdr) / sizeof(u32))) <= bundle_words) {
+
+                // Endian swap the command header in place (see node_rx_from_transport())
+                bundle_cmd_hdr           = (wl_cmd_resp_hdr *)(&cmd_args_32[bundle_index]);
+                bundle_cmd_hdr->cmd      = Xil_Ntohl(bundle_cmd_hdr->cmd);
+                bundle_cmd_hdr->length   = Xil_Ntohs(bundle_cmd_hdr->length);
+                bundle_cmd_hdr->num_args = Xil_Ntohs(bundle_cmd_hdr->num_args);
+
+                if (((bundle_index + ((sizeof(wl_cmd_resp_hdr) + bundle_cmd_hdr->length) / sizeof(u32))) > bundle_words) ||
+                    (bundle_cmd_hdr->cmd == cmd_hdr->cmd)) {
+                    wl_printf(WL_PRINT_ERROR, print_type_node, "Invalid command 0x%08x in bundle\n", bundle_cmd_hdr->cmd);
+                    break;
+                }
+
+                bundle_command.header    = bundle_cmd_hdr;
+                bundle_command.args      = (u32 *)(&cmd_args_32[bundle_index]) + (sizeof(wl_cmd_resp_hdr) / sizeof(u32));
+                bundle_command.buffer    = NULL;
+
+                // Reserve the response of the command if its length is known.  Otherwise, the send buffer
+                // must be able to hold the longest response and the response is checked after the command
+                // is processed.
+                bundle_resp_length = node_bundle_resp_length(bundle_cmd_hdr, bundle_command.args);
+
+                if (bundle_resp_length != 0) {
+                    if (((resp_index * sizeof(u32)) + bundle_resp_length) > bundle_max_length) {
+                        break;
+                    }
+                } else if (((resp_index * sizeof(u32)) + NODE_BUNDLE_MAX_CMD_RESP_LENGTH) > (NODE_BUNDLE_MAX_PAYLOAD - NODE_BUNDLE_RESP_OVERHEAD)) {
+                    break;
+                }
+
+                bundle_resp_hdr          = (wl_cmd_resp_hdr *)(&resp_args_32[resp_index]);
+                bundle_response.header   = bundle_resp_hdr;
+                bundle_response.args     = (u32 *)(&resp_args_32[resp_index]) + (sizeof(wl_cmd_resp_hdr) / sizeof(u32));
+                bundle_response.buffer   = response->buffer;
+
+                // Commands that send their own responses or need the packet get an error response
+                if (node_cmd_needs_packet(bundle_cmd_hdr->cmd) || node_cmd_sends_resp(bundle_cmd_hdr->cmd)) {
+                    wl_printf(WL_PRINT_ERROR, print_type_node, "Command 0x%08x can not be bundled\n", bundle_cmd_hdr->cmd);
+
+                    bundle_resp_hdr->cmd      = bundle_cmd_hdr->cmd;
+                    bundle_resp_hdr->length   = sizeof(u32);
+                    bundle_resp_hdr->num_args = 1;
+                    bundle_response.args[0]   = Xil_Htonl(CMD_PARAM_ERROR);
+
+                } else if (node_dispatch_cmd(socket_index, from, &bundle_command, &bundle_response) != NO_RESP_SENT) {
+                    break;
+                }
+
+                // Roll back a response that does not fit in the packet (the host sends the command again)
+                if (((resp_index * sizeof(u32)) + sizeof(wl_cmd_resp_hdr) + bundle_resp_hdr->length) > bundle_max_length) {
+                    break;
+                }
+
+                resp_index   += (sizeof(wl_cmd_resp_hdr) + bundle_resp_hdr->length) / sizeof(u32);
+                bundle_index += (sizeof(wl_cmd_resp_hdr) + bundle_cmd_hdr->length) / sizeof(u32);
+                bundle_count++;
+
+                // Endian swap the response header (see node_rx_from_transport())
+                bundle_resp_hdr->cmd      = Xil_Htonl(bundle_resp_hdr->cmd);
+                bundle_resp_hdr->length   = Xil_Htons(bundle_resp_hdr->length);
+                bundle_resp_hdr->num_args = Xil_Htons(bundle_resp_hdr->num_args);
+            }
+
+            resp_args_32[0]    = Xil_Htonl(bundle_count);
+
+            resp_hdr->length  += (resp_index * sizeof(resp_args_32));
+            resp_hdr->num_args = resp_index;
+        break;
+
+
         //---------------------------------------------------------------------
         default:
             wl_printf(WL_PRINT_ERROR, print_type_node, "Unknown node command: %d\n", cmd_id);
@@ -1356,6 +2025,17 @@ int main() {
 
 #endif
 
+        // Process any transfers queued by interrupts
+        wl_cdma_service();
+
+        // Process any baseband work deferred by interrupts
+        baseband_service();
+
+        // Raise any scheduled triggers that are due
+        trigmngr_service();
+
+        // Process the next instruction of the sequencer program
+        node_seq_service();
     }
 
     return XST_SUCCESS;
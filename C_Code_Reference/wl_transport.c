@@ -50,6 +50,18 @@ wl_eth_dev_info              eth_devices[WL_NUM_ETH_DEVICES];
 // Callbacks
 volatile wl_function_ptr_t   process_hton_msg_callback;
 
+// CDMA transfer out of the receive buffer being processed (see transport_set_recv_buffer_xfer())
+static u32                   recv_buffer_xfer_pending;
+static u32                   recv_buffer_xfer_id;
+
+// Packet received while a command was being processed (see transport_check_recv())
+static u32                   held_recv_pending;
+static int                   held_recv_bytes;
+static u32                   held_eth_dev_num;
+static int                   held_socket_index;
+static struct sockaddr       held_from;
+static warp_ip_udp_buffer    held_recv_buffer;
+
 
 /*************************** Function Prototypes *****************************/
 
@@ -85,8 +97,19 @@ void transport_poll(u32 eth_dev_num) {
     warp_ip_udp_buffer    * send_buffer;
     struct sockaddr         from;
 
-    // Check the socket to see if there is data
-    recv_bytes = socket_recvfrom_eth(eth_dev_num, &socket_index, &from, &recv_buffer);
+    // Process a packet that was received while processing the previous packet first
+    //     NOTE:  Otherwise, check the socket to see if there is data
+    //
+    if ((held_recv_pending) && (held_eth_dev_num == eth_dev_num)) {
+        socket_index      = held_socket_index;
+        from              = held_from;
+        recv_buffer       = held_recv_buffer;
+        recv_bytes        = held_recv_bytes;
+
+        held_recv_pending = 0;
+    } else {
+        recv_bytes = socket_recvfrom_eth(eth_dev_num, &socket_index, &from, &recv_buffer);
+    }
 
     // If we have received data, then we need to process it
     if (recv_bytes > 0) {
@@ -94,8 +117,18 @@ void transport_poll(u32 eth_dev_num) {
         send_buffer = socket_alloc_send_buffer();
 
         // Process the received packet
+        recv_buffer_xfer_pending = 0;
+
         transport_receive(eth_dev_num, socket_index, &from, &recv_buffer, send_buffer);
 
+        // Wait for any DMA transfers out of the receive buffer (eg Write IQ samples)
+        //     NOTE:  Commands only queue the transfers so they can overlap with sending the response.
+        //            Packets without transfers out of the receive buffer do not wait on the CDMA queue.
+        //
+        if (recv_buffer_xfer_pending) {
+            wl_cdma_wait(recv_buffer_xfer_id);
+        }
+
         // Need to communicate to the transport driver that the buffers can now be reused
         socket_free_recv_buffer(socket_index, &recv_buffer);
         socket_free_send_buffer(send_buffer);
@@ -104,6 +137,54 @@ void transport_poll(u32 eth_dev_num) {
 
 
 
+/*****************************************************************************/
+/**
+ * Check for a packet received while processing a command
+ *
+ * @param   eth_dev_num      - Ethernet device number
+ *
+ * @return  int              - 1 if a packet was received; 0 otherwise
+ *
+ * @note    The received packet is held and processed by the next call to
+ *          transport_poll().  This allows a long running command (eg a streamed
+ *          Read IQ) to stop when a newer packet arrives from the host.
+ *
+ *****************************************************************************/
+int transport_check_recv(u32 eth_dev_num) {
+
+    if (held_recv_pending == 0) {
+        held_recv_bytes = socket_recvfrom_eth(eth_dev_num, &held_socket_index, &held_from, &held_recv_buffer);
+
+        if (held_recv_bytes > 0) {
+            held_recv_pending = 1;
+            held_eth_dev_num  = eth_dev_num;
+        }
+    }
+
+    return held_recv_pending;
+}
+
+
+
+/*****************************************************************************/
+/**
+ * Set the CDMA transfer out of the receive buffer
+ *
+ * @param   transfer_id      - Transfer ID of the last transfer out of the receive buffer
+ *
+ * @return  None
+ *
+ * @note    Commands that queue CDMA transfers out of the receive buffer must call this
+ *          function so the receive buffer is not freed until the transfers are done.
+ *
+ *****************************************************************************/
+void transport_set_recv_buffer_xfer(u32 transfer_id) {
+    recv_buffer_xfer_pending = 1;
+    recv_buffer_xfer_id      = transfer_id;
+}
+
+
+
 /*****************************************************************************/
 /**
  * Process the received UDP packet by the transport
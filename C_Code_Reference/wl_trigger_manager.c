@@ -81,6 +81,13 @@ u32      active_ethernet_id_mask;
 u32      eth_A_sw_ethernet_trigger_enable;
 u32      eth_B_sw_ethernet_trigger_enable;
 
+// Scheduled triggers (FIFO of trigger times in increasing order)
+u64      trigger_schedule_time[TRIG_MNGR_SCHEDULE_MAX];
+u32      trigger_schedule_eth_dev_num[TRIG_MNGR_SCHEDULE_MAX];
+u32      trigger_schedule_read_index;
+u32      trigger_schedule_num;
+u32      trigger_schedule_late;
+
 
 /*************************** Function Prototypes *****************************/
 
@@ -158,6 +165,10 @@ int trigmngr_process_cmd(int socket_index, void * from, wl_cmd_resp * command, w
     u32                 delay;
     u32                 mode;
     u32                 type;
+    u32                 status;
+    u32                 num_triggers;
+    u64                 timestamp;
+    u64                 last_timestamp;
 
     // Set up the response header
     resp_hdr->cmd       = cmd_hdr->cmd;
@@ -715,6 +726,102 @@ int trigmngr_process_cmd(int socket_index, void * from, wl_cmd_resp * command, w
         break;
 
 
+        //---------------------------------------------------------------------
+        case CMDID_TRIG_MNGR_GET_TIMESTAMP:
+            // Get the node timestamp
+            //
+            // Response format:
+            //     resp_args_32[0]     Timestamp MSB (usec)
+            //     resp_args_32[1]     Timestamp LSB (usec)
+            //
+            // NOTE:  The host estimates the offset between its clock and the node timestamp from the round
+            //     trip of this command (see 'clock_sync' in wl_trigger_manager_proc.m).  Only the round trips
+            //     with the smallest time are used, so no other processing is done.
+            //
+            timestamp = get_usec_timestamp();
+
+            resp_args_32[resp_index++] = Xil_Htonl((u32)(timestamp >> 32));
+            resp_args_32[resp_index++] = Xil_Htonl((u32)(timestamp & 0xFFFFFFFF));
+
+            resp_hdr->length  += (resp_index * sizeof(resp_args_32));
+            resp_hdr->num_args = resp_index;
+        break;
+
+
+        //---------------------------------------------------------------------
+        case CMDID_TRIG_MNGR_SCHEDULE_TRIGGER:
+            // Schedule triggers at absolute node timestamps
+            //
+            // Message format:
+            //     cmd_args_32[0]      Number of trigger times (N; 0 clears the schedule)
+            //     cmd_args_32[1:2N]   Trigger times (MSB, LSB; node timestamp in usec)
+            //
+            // Response format:
+            //     resp_args_32[0]     Status
+            //     resp_args_32[1]     Number of triggers in the schedule
+            //     resp_args_32[2]     Number of late triggers since the schedule was cleared
+            //
+            // NOTE:  Trigger times must be in the future and must be after all triggers already in the
+            //     schedule.  Trigger times are added until one is not valid (or the schedule is full), in
+            //     which case an error is returned.
+            //
+            status       = CMD_PARAM_SUCCESS;
+
+            if (cmd_hdr->num_args < 1) {
+                wl_printf(WL_PRINT_ERROR, print_type_trigger, "Trigger schedule command without arguments\n");
+
+                resp_args_32[resp_index++] = Xil_Htonl(CMD_PARAM_ERROR);
+                resp_args_32[resp_index++] = Xil_Htonl(trigger_schedule_num);
+                resp_args_32[resp_index++] = Xil_Htonl(trigger_schedule_late);
+
+                resp_hdr->length  += (resp_index * sizeof(resp_args_32));
+                resp_hdr->num_args = resp_index;
+                break;
+            }
+
+            num_triggers = Xil_Ntohl(cmd_args_32[0]);
+
+            if (num_triggers > ((u32)(cmd_hdr->num_args - 1) >> 1)) {
+                num_triggers = (u32)(cmd_hdr->num_args - 1) >> 1;
+            }
+
+            if (num_triggers == 0) {
+                trigger_schedule_num  = 0;
+                trigger_schedule_late = 0;
+            }
+
+            for (i = 0; i < num_triggers; i++) {
+                timestamp = (((u64)Xil_Ntohl(cmd_args_32[(2 * i) + 1])) << 32) + (u64)Xil_Ntohl(cmd_args_32[(2 * i) + 2]);
+
+                if (trigger_schedule_num) {
+                    last_timestamp = trigger_schedule_time[(trigger_schedule_read_index + trigger_schedule_num - 1) % TRIG_MNGR_SCHEDULE_MAX];
+                } else {
+                    last_timestamp = get_usec_timestamp();
+                }
+
+                if ((trigger_schedule_num == TRIG_MNGR_SCHEDULE_MAX) || (timestamp <= last_timestamp)) {
+                    wl_printf(WL_PRINT_ERROR, print_type_trigger, "Could not schedule trigger at 0x%08x%08x\n", (u32)(timestamp >> 32), (u32)(timestamp & 0xFFFFFFFF));
+                    status = CMD_PARAM_ERROR;
+                    break;
+                }
+
+                j = (trigger_schedule_read_index + trigger_schedule_num) % TRIG_MNGR_SCHEDULE_MAX;
+
+                trigger_schedule_time[j]        = timestamp;
+                trigger_schedule_eth_dev_num[j] = eth_dev_num;
+                trigger_schedule_num++;
+            }
+
+            // Send response
+            resp_args_32[resp_index++] = Xil_Htonl(status);
+            resp_args_32[resp_index++] = Xil_Htonl(trigger_schedule_num);
+            resp_args_32[resp_index++] = Xil_Htonl(trigger_schedule_late);
+
+            resp_hdr->length  += (resp_index * sizeof(resp_args_32));
+            resp_hdr->num_args = resp_index;
+        break;
+
+
         //---------------------------------------------------------------------
         case CMDID_TRIG_MNGR_TEST_TRIGGER:
             // TRIG_MNGR_TEST_TRIGGER Packet Format:
@@ -823,6 +930,67 @@ void trigmngr_trigger_in(u32 ethernet_id, u32 eth_dev_num){
 
 
 
+/*****************************************************************************/
+/**
+ * Trigger Manager Service
+ *
+ * This method is called from the main loop and raises the next scheduled trigger
+ * (see CMDID_TRIG_MNGR_SCHEDULE_TRIGGER) once its time is near.  The last
+ * TRIG_MNGR_SCHEDULE_SPIN_TIME usec are spent in a busy wait with interrupts
+ * disabled so that the trigger is raised at the trigger time.
+ *
+ * @param   None
+ *
+ * @return  None
+ *
+ *****************************************************************************/
+void trigmngr_service() {
+
+    u64                 timestamp;
+    u64                 trigger_time;
+    interrupt_state_t   prev_interrupt_state;
+
+    if (trigger_schedule_num == 0) {
+        return;
+    }
+
+    trigger_time = trigger_schedule_time[trigger_schedule_read_index];
+
+    if ((get_usec_timestamp() + TRIG_MNGR_SCHEDULE_SPIN_TIME) < trigger_time) {
+        return;
+    }
+
+    // Wait for the trigger time and raise the trigger
+    prev_interrupt_state = wl_interrupt_stop();
+
+    do {
+        timestamp = get_usec_timestamp();
+    } while (timestamp < trigger_time);
+
+    switch (trigger_schedule_eth_dev_num[trigger_schedule_read_index]) {
+        case WL_ETH_A:
+            trigger_proc_in_eth_A_raise_trigger();
+            trigger_proc_in_eth_A_lower_trigger();
+        break;
+        case WL_ETH_B:
+            trigger_proc_in_eth_B_raise_trigger();
+            trigger_proc_in_eth_B_lower_trigger();
+        break;
+    }
+
+    wl_interrupt_restore_state(prev_interrupt_state);
+
+    if ((timestamp - trigger_time) > TRIG_MNGR_SCHEDULE_LATE_TIME) {
+        trigger_schedule_late++;
+    }
+
+    // Remove the trigger from the schedule
+    trigger_schedule_read_index = (trigger_schedule_read_index + 1) % TRIG_MNGR_SCHEDULE_MAX;
+    trigger_schedule_num--;
+}
+
+
+
 /*****************************************************************************/
 /**
  * Trigger Manager disable all triggers
@@ -893,6 +1061,10 @@ int trigmngr_init(){
     active_ethernet_id_mask  = 0;
     trigger_test_flag        = 0;
 
+    trigger_schedule_read_index = 0;
+    trigger_schedule_num        = 0;
+    trigger_schedule_late       = 0;
+
     // Initialize Trigger Processor
 
     // Set all reset bits (disable all triggers)
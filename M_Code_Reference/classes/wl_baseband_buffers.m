@@ -24,6 +24,10 @@ classdef wl_baseband_buffers < wl_baseband
         
         seq_num_tracker;            % Sequence number tracker
                                     %     Array of 8 entries:  [RFA_IQ, RFA_RSSI, RFB_IQ, RFB_RSSI, RFC_IQ, RFC_RSSI, RFD_IQ, RFD_RSSI]
+        
+        tx_delay;                   % Tx delay (in samples) last set on the node
+        tx_length;                  % Tx length (in samples) last set on the node
+        rx_length;                  % Rx length (in samples) last set on the node (empty if not set)
     end
 
     % NOTE:  These properties will be removed in future releases
@@ -92,6 +96,13 @@ classdef wl_baseband_buffers < wl_baseband
 
         CMD_TXRX_COUNT_RESET           = 16;               % 0x000010
         CMD_TXRX_COUNT_GET             = 17;               % 0x000011
+        CMD_TX_STREAM_STATUS           = 18;               % 0x000012
+        CMD_RX_SEGMENT_CONFIG          = 19;               % 0x000013
+        CMD_RX_SEGMENT_STATUS          = 20;               % 0x000014
+        CMD_RX_ACCUM_CONFIG            = 21;               % 0x000015
+        CMD_RX_ACCUM_STATUS            = 22;               % 0x000016
+        CMD_READ_IQ_SCHEDULE           = 23;               % 0x000017
+        CMD_SAMPLE_BYTE_ORDER          = 24;               % 0x000018
         
         CMD_AGC_STATE                  = 256;              % 0x000100
         CMD_AGC_DONE_ADDR              = 257;              % 0x000101
@@ -160,6 +171,10 @@ classdef wl_baseband_buffers < wl_baseband
             
             obj.seq_num_tracker         = uint32(zeros(1, 8));                      % Initialize all 8 trackers to zero
             obj.seq_num_match_severity  = obj.SEQ_NUM_MATCH_WARNING;
+            
+            obj.tx_delay                = 0;
+            obj.tx_length               = 0;
+            obj.rx_length               = [];
         end 
         
         function out = procCmd(obj, nodeInd, node, varargin)
@@ -239,6 +254,8 @@ classdef wl_baseband_buffers < wl_baseband
                         resp = node.sendCmd(myCmd);
                         ret  = resp.getArgs();
                         out  = ret(2);
+                        
+                        obj.tx_delay = double(out);
                     else                                   % Write Mode
                         myCmd.addArgs(myCmd.CMD_PARAM_WRITE_VAL);
                         
@@ -270,6 +287,8 @@ classdef wl_baseband_buffers < wl_baseband
                                 error(msg);
                             end
                         end
+                        
+                        obj.tx_delay = double(delay);
                     end
 
                 %---------------------------------------------------------
@@ -322,6 +341,7 @@ classdef wl_baseband_buffers < wl_baseband
                         
                         % Update internal object values
                         obj.tx_iq_warning_needed = false;       % Since we have explicitly set the tx IQ length, we do not need a warning
+                        obj.tx_length            = double(len);
                     end
 
                 %---------------------------------------------------------
@@ -374,6 +394,7 @@ classdef wl_baseband_buffers < wl_baseband
                         
                         % Update internal object values
                         obj.rx_iq_warning_needed = false;       % Since we have explicitly set the rx IQ length, we do not need a warning
+                        obj.rx_length            = double(len);
                     end
 
                 %---------------------------------------------------------
@@ -487,6 +508,77 @@ classdef wl_baseband_buffers < wl_baseband
                     myCmd = wl_cmd(node.calcCmd(obj.GRP, obj.CMD_TX_MODE), uint32(boolean(varargin{1})));
                     node.sendCmd(myCmd);
 
+                %---------------------------------------------------------
+                case 'stream_tx'
+                    % Enable/disable streaming transmit mode
+                    %
+                    % Requires BUFF_SEL: No
+                    % Arguments: (boolean STREAM_TX)
+                    %     STREAM_TX:
+                    %         true enables streaming transmit mode
+                    %         false disables streaming (and continuous) transmit mode
+                    % Returns: none
+                    %
+                    % Streaming transmit mode is continuous transmit mode where the transmit buffer is
+                    %     used as a ring of 'tx_length' samples.  The OFFSET of 'write_iq' is the index of the
+                    %     sample in the stream, so the host can keep writing samples past 'tx_length' while the
+                    %     node is transmitting.  The node will not accept samples that would overwrite samples
+                    %     that have not been transmitted; in this case, 'write_iq' waits and tries again.
+                    %
+                    % Restrictions on streaming transmit:
+                    %     - 'tx_length' must be a multiple of 2^14 samples and greater than 2^15 samples
+                    %     - Streaming transmit mode must be enabled before the initial 'write_iq' of the
+                    %       stream (ie stream sample 0).  The initial 'write_iq' must not be longer than
+                    %       'tx_length'.
+                    %     - If the host does not write samples before they are transmitted, then the samples
+                    %       from the previous pass through the ring are transmitted and an underrun is counted
+                    %       (see 'tx_stream_status').
+                    %
+                    % Example:
+                    %     wl_basebandCmd(node, 'tx_length', 2^20);
+                    %     wl_basebandCmd(node, 'stream_tx', true);
+                    %     wl_basebandCmd(node, RFA, 'write_iq', X(1:2^20), 0);
+                    %     wl_interfaceCmd(node, RFA, 'tx_en');
+                    %     wl_basebandCmd(node, RFA, 'tx_buff_en');
+                    %     eth_trig.send();
+                    %     wl_basebandCmd(node, RFA, 'write_iq', X((2^20 + 1):(2^21)), 2^20);
+                    %
+                    if(length(varargin) ~= 1)
+                        error('%s: requires one boolean argument',cmdStr);
+                    end
+                    
+                    myCmd = wl_cmd(node.calcCmd(obj.GRP, obj.CMD_TX_MODE), (2 * uint32(boolean(varargin{1}))));
+                    node.sendCmd(myCmd);
+
+                %---------------------------------------------------------
+                case 'tx_stream_status'
+                    % Get the status of streaming transmit mode
+                    %
+                    % Requires BUFF_SEL: No
+                    % Arguments: none
+                    % Returns: [uint32 READ_POINTER, uint32 WRITE_POINTER, uint32 UNDERRUNS]
+                    %     READ_POINTER:  Stream index of the next sample to be transmitted
+                    %     WRITE_POINTER: Stream index after the last sample written by the host
+                    %     UNDERRUNS:     Number of times the node transmitted samples the host had not written
+                    %
+                    myCmd = wl_cmd(node.calcCmd(obj.GRP, obj.CMD_TX_STREAM_STATUS));
+                    
+                    resp = node.sendCmd(myCmd);
+                    
+                    % Process response from the node.  Return arguments:
+                    %     [1] - Status
+                    %     [2] - Read pointer
+                    %     [3] - Write pointer
+                    %     [4] - Underruns
+                    %
+                    ret = resp.getArgs();
+                    
+                    if (ret(1) == myCmd.CMD_PARAM_SUCCESS)
+                        out = reshape(double(ret(2:4)), 1, 3);
+                    else
+                        error('%s: Streaming transmit mode is not enabled.', cmdStr);
+                    end
+
                 %---------------------------------------------------------
                 case 'tx_buff_en'
                     % Enable transmit buffer for one or more interfaces. When a buffer is enabled it will
@@ -701,6 +793,477 @@ classdef wl_baseband_buffers < wl_baseband
                     %
                     out = readIQ(obj, node, buffSel, cmdStr, varargin{:});
 
+                %---------------------------------------------------------
+                case 'read_iq_agc_window'
+                    % Read a window of I/Q samples around the sample where the AGC finished. The window is
+                    %     resolved on the node when the request is processed, so only the samples of the window
+                    %     are transferred (see 'agc_done_addr').
+                    %
+                    % Requires BUFF_SEL: Yes (combined BUFF_SEL values not allowed)
+                    % Arguments: (int PRE, int POST)
+                    %     PRE:  number of samples to read before the AGC done sample
+                    %     POST: number of samples to read starting at the AGC done sample
+                    %
+                    % Returns: complex samples of size [(PRE + POST), length(BUFF_SEL)]
+                    %     Samples of the window that fall outside of the Rx buffer are returned as zeros.
+                    %
+                    % NOTE:  Requires the WARPLab MEX transport.
+                    %
+                    % Examples:
+                    %     % Read 1000 samples before and 4000 samples after AGC done for RFA
+                    %     X = wl_basebandCmd(node, RFA, 'read_iq_agc_window', 1000, 4000);
+                    %
+                    if (length(varargin) ~= 2)
+                        error('%s: invalid arguments... user must provide a pre and post number of samples', cmdStr);
+                    end
+                    
+                    if (~strcmp(class(node.transport), 'wl_transport_eth_udp_mex'))
+                        error('%s: requires the WARPLab MEX transport', cmdStr);
+                    end
+                    
+                    pre  = varargin{1};
+                    post = varargin{2};
+                    
+                    if ((pre < 0) || (post < 0) || ((pre + post) == 0))
+                        error('%s: pre and post must be non-negative and the window must not be empty', cmdStr);
+                    end
+                    
+                    wl_mex_udp_transport('read_iq_set_window', 1);
+                    
+                    try
+                        out = readIQ(obj, node, buffSel, cmdStr, -pre, (pre + post));
+                    catch err
+                        wl_mex_udp_transport('read_iq_set_window', 0);
+                        rethrow(err);
+                    end
+                    
+                    wl_mex_udp_transport('read_iq_set_window', 0);
+
+                %---------------------------------------------------------
+                case 'read_iq_metadata'
+                    % Read I/Q samples from the specified buffers along with the metadata of the capture. The
+                    %     metadata is returned by the node with the samples, so no additional requests are needed.
+                    %
+                    % Requires BUFF_SEL: Yes (combined BUFF_SEL values not allowed)
+                    % Arguments: (int OFFSET, int NUM_SAMPS)
+                    %     OFFSET: buffer index of first sample to read (optional; defaults to 0)
+                    %     NUM_SAMPS: number of complex samples to read (optional; defaults to length(OFFSET:rxIQLen-1))
+                    %
+                    % Returns: struct with fields:
+                    %     iq:        complex samples (same as 'read_iq')
+                    %     metadata:  struct array with one element per buffer (in the order RFA, RFB, RFC, RFD):
+                    %         buffer_id:          Buffer of the metadata
+                    %         rx_count:           Rx counter of the buffer
+                    %         capture_timestamp:  Node time (usec) the last reception finished (0 if not known)
+                    %         read_timestamp:     Node time (usec) the Read IQ was processed
+                    %         agc_rf_gain:        AGC RF gain
+                    %         agc_bb_gain:        AGC BB gain
+                    %         agc_rxhp:           AGC RXHP
+                    %         agc_done_rssi:      RSSI when the AGC finished
+                    %         agc_done_addr:      Sample index where the AGC finished
+                    %         rssi_min:           Minimum RSSI of the samples read
+                    %         rssi_mean:          Mean RSSI of the samples read
+                    %         rssi_max:           Maximum RSSI of the samples read
+                    %         rssi_count:         Number of RSSI values in the statistics
+                    %         tx_status:          Tx status of the buffers
+                    %         rx_status:          Rx status of the buffers
+                    %         tx_buffer_en:       Tx buffer enables
+                    %         rx_buffer_en:       Rx buffer enables
+                    %         rx_length:          Rx length (in samples)
+                    %
+                    % NOTE:  Requires the WARPLab MEX transport.
+                    %
+                    % Examples:
+                    %     % Read full buffers for RFA and RFB with metadata
+                    %     X = wl_basebandCmd(node, [RFA RFB], 'read_iq_metadata');
+                    %     rssi_mean = [X.metadata.rssi_mean];
+                    %
+                    if (~strcmp(class(node.transport), 'wl_transport_eth_udp_mex'))
+                        error('%s: requires the WARPLab MEX transport', cmdStr);
+                    end
+                    
+                    wl_mex_udp_transport('read_iq_set_metadata', 1);
+                    
+                    try
+                        iq = readIQ(obj, node, buffSel, cmdStr, varargin{:});
+                    catch err
+                        wl_mex_udp_transport('read_iq_set_metadata', 0);
+                        rethrow(err);
+                    end
+                    
+                    wl_mex_udp_transport('read_iq_set_metadata', 0);
+                    
+                    out = struct('iq', iq, 'metadata', wl_mex_udp_transport('read_iq_get_metadata'));
+
+                %---------------------------------------------------------
+                case 'rx_segments'
+                    % Configure segmented receive mode
+                    %
+                    % Requires BUFF_SEL: No
+                    % Arguments: (int NUM_SEGMENTS)
+                    %     NUM_SEGMENTS: number of segments the Rx buffers are partitioned in to (0 or 1 disables
+                    %                   segmented receive mode)
+                    % Returns: (uint32 SEGMENT_SIZE)
+                    %     SEGMENT_SIZE: offset (in samples) between the start of each segment
+                    %
+                    % In segmented receive mode, every reception is captured in to the next segment of the Rx
+                    %     buffers instead of overwriting the previous reception, so many receptions can be
+                    %     captured before they are read with a single 'read_iq_segments'.  Once all segments
+                    %     are used, the oldest segment is overwritten.
+                    %
+                    % Restrictions on segmented receive:
+                    %     - Requires a node with DDR
+                    %     - 'rx_length' must be set before enabling segmented receive and must be at least
+                    %       2^14 samples.  Changing 'rx_length' disables segmented receive.
+                    %     - NUM_SEGMENTS * SEGMENT_SIZE must fit in the Rx buffers (see 'rx_buff_max_num_samples')
+                    %
+                    % Example:
+                    %     wl_basebandCmd(node, 'rx_length', 2^14);
+                    %     wl_basebandCmd(node, 'rx_segments', 32);
+                    %     ... 32 triggers ...
+                    %     X = wl_basebandCmd(node, RFA, 'read_iq_segments');
+                    %
+                    if(length(varargin) ~= 1)
+                        error('%s: requires one argument', cmdStr);
+                    end
+                    
+                    myCmd = wl_cmd(node.calcCmd(obj.GRP, obj.CMD_RX_SEGMENT_CONFIG), uint32(varargin{1}));
+                    
+                    resp = node.sendCmd(myCmd);
+                    
+                    % Process response from the node.  Return arguments:
+                    %     [1] - Status
+                    %     [2] - Number of segments
+                    %     [3] - Segment size
+                    %
+                    ret = resp.getArgs();
+                    
+                    if (ret(1) == myCmd.CMD_PARAM_SUCCESS)
+                        out = double(ret(3));
+                    else
+                        error('%s: Node does not support %d segments of the current Rx length.', cmdStr, varargin{1});
+                    end
+
+                %---------------------------------------------------------
+                case 'rx_segment_status'
+                    % Get the status of segmented receive mode
+                    %
+                    % Requires BUFF_SEL: No
+                    % Arguments: none
+                    % Returns: (struct STATUS)
+                    %     STATUS.num_segments: number of segments (0 if segmented receive is disabled)
+                    %     STATUS.segment_size: offset (in samples) between the start of each segment
+                    %     STATUS.num_captured: number of receptions captured since the segments were configured
+                    %     STATUS.next_segment: index (0 based) of the segment for the next reception
+                    %     STATUS.timestamp:    [1, num_segments] node timestamp (usec) at the end of the reception of each segment
+                    %     STATUS.rx_count:     [1, num_segments] Rx counter of the reception of each segment
+                    %
+                    out        = struct('num_segments', 0, 'segment_size', 0, 'num_captured', 0, 'next_segment', 0, 'timestamp', [], 'rx_count', []);
+                    first      = 0;
+                    done       = 0;
+                    
+                    while (done == 0)
+                        myCmd = wl_cmd(node.calcCmd(obj.GRP, obj.CMD_RX_SEGMENT_STATUS), uint32(first));
+                        resp  = node.sendCmd(myCmd);
+                        ret   = double(resp.getArgs());
+                        
+                        out.num_segments = ret(1);
+                        out.segment_size = ret(2);
+                        out.num_captured = ret(3);
+                        out.next_segment = ret(4);
+                        
+                        num_entries      = ret(5);
+                        
+                        if (num_entries > 0)
+                            entries        = reshape(ret(6:(5 + (3 * num_entries))), 3, num_entries);
+                            out.timestamp  = [out.timestamp, ((entries(1, :) * 2^32) + entries(2, :))];
+                            out.rx_count   = [out.rx_count, entries(3, :)];
+                        end
+                        
+                        first = first + num_entries;
+                        
+                        if ((num_entries == 0) || (first >= out.num_segments))
+                            done = 1;
+                        end
+                    end
+
+                %---------------------------------------------------------
+                case 'read_iq_segments'
+                    % Read I/Q samples of all segments captured in segmented receive mode (see 'rx_segments')
+                    %     with a single Read IQ
+                    %
+                    % Requires BUFF_SEL: Yes (combined BUFF_SEL values not allowed)
+                    % Arguments: none
+                    % Returns: complex samples of size [SEGMENT_SIZE, NUM_SEGMENTS, length(BUFF_SEL)]
+                    %     Column k is segment (k - 1).  Only the first 'rx_length' samples of each segment are
+                    %     valid.  Use 'rx_segment_status' for the order of the captures.
+                    %
+                    myCmd = wl_cmd(node.calcCmd(obj.GRP, obj.CMD_RX_SEGMENT_STATUS), uint32(0));
+                    resp  = node.sendCmd(myCmd);
+                    ret   = double(resp.getArgs());
+                    
+                    num_segments = ret(1);
+                    segment_size = ret(2);
+                    
+                    if (num_segments == 0)
+                        error('%s: Segmented receive mode is not enabled.', cmdStr);
+                    end
+                    
+                    samples = readIQ(obj, node, buffSel, cmdStr, 0, (num_segments * segment_size));
+                    out     = reshape(samples, segment_size, num_segments, length(buffSel));
+
+                %---------------------------------------------------------
+                case 'rx_accum'
+                    % Enable/disable receive accumulation mode
+                    %
+                    % Requires BUFF_SEL: No
+                    % Arguments: (boolean RX_ACCUM)
+                    %     RX_ACCUM:
+                    %         true clears the accumulators and enables receive accumulation mode
+                    %         false disables receive accumulation mode
+                    % Returns: none
+                    %
+                    % In receive accumulation mode, the node adds every reception sample by sample to an
+                    %     accumulator in DDR.  After N triggers, 'read_iq_accum' returns the sum or mean of the
+                    %     N receptions with a single Read IQ of the accumulator.
+                    %
+                    % Restrictions on receive accumulation:
+                    %     - Requires a node with DDR
+                    %     - 'rx_length' must be set before enabling receive accumulation, must be at least
+                    %       2^14 samples, and must be at most 1/3 of 'rx_buff_max_num_samples'.  Changing
+                    %       'rx_length' disables receive accumulation.
+                    %     - Segmented receive mode must be disabled
+                    %     - The node accumulates a reception after the reception is done.  If the next reception
+                    %       finishes (or overwrites samples) before the accumulation is done, it is counted as
+                    %       an overrun (see 'rx_accum_status')
+                    %     - At most 2^16 receptions are accumulated
+                    %
+                    % Example:
+                    %     wl_basebandCmd(node, 'rx_length', 2^14);
+                    %     wl_basebandCmd(node, 'rx_accum', true);
+                    %     ... N triggers ...
+                    %     X = wl_basebandCmd(node, RFA, 'read_iq_accum', 'mean');
+                    %
+                    if(length(varargin) ~= 1)
+                        error('%s: requires one boolean argument', cmdStr);
+                    end
+                    
+                    myCmd = wl_cmd(node.calcCmd(obj.GRP, obj.CMD_RX_ACCUM_CONFIG), uint32(boolean(varargin{1})));
+                    
+                    resp = node.sendCmd(myCmd);
+                    ret  = resp.getArgs();
+                    
+                    if (ret(1) ~= myCmd.CMD_PARAM_SUCCESS)
+                        error('%s: Node does not support receive accumulation for the current Rx length.', cmdStr);
+                    end
+
+                %---------------------------------------------------------
+                case 'rx_accum_status'
+                    % Get the status of receive accumulation mode
+                    %
+                    % Requires BUFF_SEL: No
+                    % Arguments: none
+                    % Returns: [uint32 COUNT, uint32 OVERRUNS, uint32 BUSY]
+                    %     COUNT:    Number of receptions accumulated
+                    %     OVERRUNS: Number of receptions that were not (completely) accumulated
+                    %     BUSY:     1 if the node is accumulating a reception
+                    %
+                    myCmd = wl_cmd(node.calcCmd(obj.GRP, obj.CMD_RX_ACCUM_STATUS));
+                    
+                    resp = node.sendCmd(myCmd);
+                    
+                    % Process response from the node.  Return arguments:
+                    %     [1] - Enabled
+                    %     [2] - Count
+                    %     [3] - Overruns
+                    %     [4] - Busy
+                    %     [5] - Accumulator offset
+                    %     [6] - Accumulator length
+                    %
+                    ret = resp.getArgs();
+                    
+                    if (ret(1) == 0)
+                        error('%s: Receive accumulation mode is not enabled.', cmdStr);
+                    end
+                    
+                    out = reshape(double(ret(2:4)), 1, 3);
+
+                %---------------------------------------------------------
+                case 'read_iq_schedule'
+                    % Configure the transmit slot of scheduled Read IQ requests
+                    %
+                    % Requires BUFF_SEL: No
+                    % Arguments: (uint32 RANK, uint32 SLOT_TIME, uint32 RATE_CAP)
+                    %     RANK:      Slot of the node ('node_id' uses the node ID)
+                    %     SLOT_TIME: Length of a slot in microseconds (0 uses the time on the wire of the response)
+                    %     RATE_CAP:  Maximum rate of the response in Mbps (0 disables the rate cap)
+                    % Returns: [uint32 RANK, uint32 SLOT_TIME, uint32 RATE_CAP]
+                    %
+                    % A scheduled Read IQ (see wl_mex_udp_transport('read_iq_set_schedule', ...)) is sent by
+                    %     the node in its slot, which starts RANK * SLOT_TIME microseconds after the request
+                    %     arrives.  wl_triggerAndReadIQ sends the first Read IQ request of all nodes at once
+                    %     and schedules it, so that the nodes do not all send at the same time and overflow
+                    %     the switch port or the host socket.  Sequential reads (ie wl_basebandCmd 'read_iq')
+                    %     are not scheduled.  The node fails a request whose slot starts more than 500 ms
+                    %     after it arrives.
+                    %
+                    % Example:
+                    %     for n = 1:length(nodes)
+                    %         wl_basebandCmd(nodes(n), 'read_iq_schedule', (n - 1), 0, 500);
+                    %     end
+                    %
+                    if(length(varargin) ~= 3)
+                        error('%s: requires three arguments', cmdStr);
+                    end
+                    
+                    if(ischar(varargin{1}) && strcmp(lower(varargin{1}), 'node_id'))
+                        rank = hex2dec('FFFFFFFF');
+                    else
+                        rank = varargin{1};
+                    end
+                    
+                    myCmd = wl_cmd(node.calcCmd(obj.GRP, obj.CMD_READ_IQ_SCHEDULE), uint32(rank), uint32(varargin{2}), uint32(varargin{3}));
+                    
+                    resp = node.sendCmd(myCmd);
+                    ret  = resp.getArgs();
+                    
+                    if (ret(1) ~= myCmd.CMD_PARAM_SUCCESS)
+                        error('%s: Node does not support scheduled Read IQ.', cmdStr);
+                    end
+                    
+                    out = reshape(double(ret(2:4)), 1, 3);
+
+                %---------------------------------------------------------
+                case 'sample_byte_order'
+                    % Get / Set the byte order of the samples on the wire
+                    %
+                    % Requires BUFF_SEL: No
+                    % Arguments: (string ORDER) or none
+                    %     ORDER:
+                    %         'big'    - Big endian samples (default)
+                    %         'little' - Little endian samples
+                    %         'host'   - Little endian samples if the transport supports them and the host
+                    %                    is little endian; otherwise big endian samples
+                    % Returns: (string ORDER) - Byte order of the node ('big' or 'little')
+                    %
+                    % With little endian samples, raw Read IQ / Write IQ are a straight copy on little
+                    %     endian hosts.  Headers and compressed samples are always big endian.  The byte
+                    %     order is negotiated with 'host' when the node is initialized (initializing the
+                    %     node restores big endian).  Only the WARPLab MEX transport supports little endian
+                    %     samples.
+                    %
+                    [host_str, host_max_size, host_endian] = computer;
+                    
+                    if (strcmp(class(node.transport), 'wl_transport_eth_udp_mex'))
+                        host_order = double(host_endian == 'L');
+                    else
+                        host_order = 0;
+                    end
+                    
+                    myCmd = wl_cmd(node.calcCmd(obj.GRP, obj.CMD_SAMPLE_BYTE_ORDER));
+                    
+                    if(isempty(varargin))                  % Read Mode
+                        myCmd.addArgs(myCmd.CMD_PARAM_READ_VAL);
+                    elseif(length(varargin) == 1)          % Write Mode
+                        switch(lower(varargin{1}))
+                            case 'big'
+                                order = 0;
+                            case 'little'
+                                order = 1;
+                            case 'host'
+                                order = host_order;
+                            otherwise
+                                error('%s: unknown byte order ''%s''; must be ''big'', ''little'' or ''host''', cmdStr, varargin{1});
+                        end
+                        
+                        if (order > host_order)
+                            error('%s: The transport does not support little endian samples.', cmdStr);
+                        end
+                        
+                        myCmd.addArgs(myCmd.CMD_PARAM_WRITE_VAL, order);
+                    else
+                        error('%s: requires zero or one argument', cmdStr);
+                    end
+                    
+                    resp = node.sendCmd(myCmd);
+                    ret  = resp.getArgs();
+                    
+                    % Nodes without support for the command only have big endian samples
+                    if ((length(ret) < 2) || (ret(1) ~= myCmd.CMD_PARAM_SUCCESS))
+                        order = 0;
+                    else
+                        order = double(ret(2));
+                    end
+                    
+                    if (strcmp(class(node.transport), 'wl_transport_eth_udp_mex'))
+                        node.transport.sampleByteOrder = order;
+                    end
+                    
+                    if (order == 1)
+                        out = 'little';
+                    else
+                        out = 'big';
+                    end
+
+                %---------------------------------------------------------
+                case 'read_iq_accum'
+                    % Read the accumulated I/Q samples of receive accumulation mode (see 'rx_accum')
+                    %
+                    % Requires BUFF_SEL: Yes (combined BUFF_SEL values not allowed)
+                    % Arguments: (string TYPE)
+                    %     TYPE: 'sum' or 'mean' (optional; defaults to 'mean')
+                    % Returns: complex samples of size [rx_length, length(BUFF_SEL)]
+                    %     'sum' returns the sum of the raw 16-bit I / Q values of all receptions
+                    %     'mean' returns the mean of the receptions scaled like 'read_iq' (ie +/- 1)
+                    %
+                    if (isempty(varargin))
+                        type = 'mean';
+                    else
+                        type = lower(varargin{1});
+                    end
+                    
+                    myCmd = wl_cmd(node.calcCmd(obj.GRP, obj.CMD_RX_ACCUM_STATUS));
+                    resp  = node.sendCmd(myCmd);
+                    ret   = double(resp.getArgs());
+                    
+                    if (ret(1) == 0)
+                        error('%s: Receive accumulation mode is not enabled.', cmdStr);
+                    end
+                    
+                    if (ret(4) ~= 0)
+                        warning('%s: Node is still accumulating a reception.', cmdStr);
+                    end
+                    
+                    if (ret(3) ~= 0)
+                        warning('%s: %d receptions were not accumulated correctly.', cmdStr, ret(3));
+                    end
+                    
+                    count      = ret(2);
+                    offset     = ret(5);
+                    num_words  = ret(6);
+                    
+                    % Read the accumulator as raw 32-bit words:  [I_0, Q_0, I_1, Q_1, ...]
+                    myCmd = wl_cmd(node.calcCmd(obj.GRP, obj.CMD_READ_IQ));
+                    
+                    if (strcmp(class(node.transport), 'wl_transport_eth_udp_mex'))
+                        words = node.transport.read_buffers('IQ', num_words, buffSel, offset, obj.seq_num_tracker, obj.seq_num_match_severity, node.repr(), myCmd, 3);
+                    else
+                        words = read_baseband_buffer(obj, node, buffSel, myCmd, num_words, offset, 'read_iq');
+                    end
+                    
+                    sums = double(typecast(uint32(words(:)), 'int32'));
+                    sums = reshape(sums, 2, (num_words / 2), length(buffSel));
+                    out  = reshape(complex(sums(1, :, :), sums(2, :, :)), (num_words / 2), length(buffSel));
+                    
+                    switch (type)
+                        case 'sum'
+                            % Nothing to do
+                        case 'mean'
+                            out = out ./ (max(count, 1) * 2^15);
+                        otherwise
+                            error('%s: unknown type ''%s''; must be ''sum'' or ''mean''', cmdStr, type);
+                    end
+
                 %---------------------------------------------------------
                 case 'read_rssi'
                     % Read RSSI samples from the specified buffers. The elements of the buffer selection must be scalers which
@@ -1402,6 +1965,44 @@ classdef wl_baseband_buffers < wl_baseband
                 out = {out}; 
             end
          end
+         
+        function out = readIQArgs(obj, node, buffSel, varargin)
+            % Arguments of the MEX 'read_iq' function to read I/Q samples from the node (see 'read_iq' for
+            %     the arguments).  Used by wl_triggerAndReadIQ to read the samples of many nodes in one call.
+            %
+            %     NOTE:  The caller must increment the transport header by the number of commands used.
+            %
+            myCmd = wl_cmd(node.calcCmd(obj.GRP, obj.CMD_READ_IQ));
+            
+            if(isempty(varargin))
+                offset   = 0;
+                numSamps = obj.rxIQLen;
+            elseif(length(varargin) == 2)
+                offset   = varargin{1};
+                numSamps = varargin{2};
+            else
+                error('read_iq: invalid arguments... user must provide an offset and a length');
+            end
+            
+            if ( numSamps > obj.MEX_TRANSPORT_MAX_IQ )
+                error('read_iq: Requested %d samples.  Due to Matlab memory limitations, the mex transport only supports %d samples.', numSamps, obj.MEX_TRANSPORT_MAX_IQ);
+            end
+            
+            out = node.transport.read_buffers_args(numSamps, buffSel, offset, obj.seq_num_tracker, obj.seq_num_match_severity, node.repr(), myCmd, 0);
+        end
+        
+        function out = captureTime(obj)
+            % Time (in seconds) from a trigger until the Tx and Rx of the node are done, based on the
+            %     Tx delay, Tx length and Rx length set on the node (the Rx length defaults to rxIQLen).
+            %
+            if(isempty(obj.rx_length))
+                rxLength = obj.rxIQLen;
+            else
+                rxLength = obj.rx_length;
+            end
+            
+            out = max(rxLength, (obj.tx_delay + obj.tx_length)) / 40e6;
+        end
     end
 end
 
@@ -65,6 +65,13 @@ classdef wl_node < handle_light
         CMD_NODE_CONFIG_RESET          = 6;                % 0x000006
         
         CMD_MEM_RW                     = 16;               % 0x000010
+        
+        CMD_SEQ_LOAD                   = 32;               % 0x000020
+        CMD_SEQ_START                  = 33;               % 0x000021
+        CMD_SEQ_STOP                   = 34;               % 0x000022
+        CMD_SEQ_STATUS                 = 35;               % 0x000023
+        
+        CMD_BUNDLE                     = 48;               % 0x000030
     end
     
     methods
@@ -198,6 +205,11 @@ classdef wl_node < handle_light
             for ifcGroupIndex = 1:length(obj.interfaceGroups)
                 obj.interfaceIDs = [obj.interfaceIDs, obj.interfaceGroups{1}.ID(:).'];
             end
+
+            % Negotiate the byte order of the samples on the wire (little endian on little endian hosts)
+            if(strcmp(class(obj.baseband), 'wl_baseband_buffers'))
+                obj.wl_basebandCmd('sample_byte_order', 'host');
+            end
                 
             % Populate the description property with a human-readable
             % description of the node
@@ -307,6 +319,56 @@ classdef wl_node < handle_light
         end
         
         
+        function out = wl_triggerAndReadIQ(obj, trigger, buffSel, varargin)
+            % Sends a broadcast Ethernet trigger and reads I/Q samples
+            % from the specified buffers of all nodes with a single call
+            % to the WARPLab MEX transport.  For example, let node0 and 
+            % node1 be wl_node objects and eth_trig be a
+            % wl_trigger_eth_udp_broadcast object:
+            %
+            %   X = wl_triggerAndReadIQ([node0, node1], eth_trig, [RFA, RFB])
+            %   X = wl_triggerAndReadIQ([node0, node1], eth_trig, RFA, OFFSET, NUM_SAMPS)
+            %
+            % which replaces eth_trig.send(), a pause() and a 'read_iq'
+            % baseband command for each node.  The optional OFFSET and 
+            % NUM_SAMPS are the same as for 'read_iq'.  The buffers of 
+            % each node are returned in consecutive columns of X (ie 
+            % size(X) is [NUM_SAMPS, length(buffSel) * numel(nodes)]).
+            %
+            % The time between the trigger and the Read IQ is computed
+            % from the 'tx_delay', 'tx_length' and 'rx_length' last set
+            % on each node with the baseband commands.  The Read IQ 
+            % requests of all nodes are then sent at once and the 
+            % samples of all nodes are received at the same time.
+            %
+            nodes    = obj;
+            numNodes = numel(nodes);
+            readArgs = cell(numNodes, 14);
+            waitTime = 0;
+            
+            if (~strcmp(class(trigger.transport), 'wl_transport_eth_udp_mex_bcast'))
+                error('wl_triggerAndReadIQ requires a broadcast trigger using the WARPLab MEX transport');
+            end
+            
+            for n = 1:numNodes
+                currNode = nodes(n);
+                
+                if (~strcmp(class(currNode.transport), 'wl_transport_eth_udp_mex'))
+                    error('Node %d: wl_triggerAndReadIQ requires the WARPLab MEX transport', currNode.ID);
+                end
+                
+                readArgs(n, :) = currNode.baseband.readIQArgs(currNode, buffSel, varargin{:});
+                waitTime       = max(waitTime, currNode.baseband.captureTime());
+            end
+            
+            [numSamps, cmdsUsed, out] = trigger.transport.trigger_and_read(trigger.ID, ceil(waitTime * 1e6), readArgs);
+            
+            for n = 1:numNodes
+                nodes(n).transport.hdr.increment(cmdsUsed(n));
+            end
+        end
+        
+        
         function out = wl_nodeCmd(obj, varargin)
             %Sends commands to the node object.
             % This method is safe to call with multiple wl_node objects as
@@ -1137,6 +1199,171 @@ classdef wl_node < handle_light
                         end
                     end
                     
+                %---------------------------------------------------------
+                case 'sequencer_load'
+                    % Load a program into the node sequencer
+                    %
+                    % Arguments: (cell STEPS)
+                    % Returns: (uint32 LENGTH)
+                    %
+                    % STEPS:       Cell array of program steps.  Each step is a cell array:
+                    %                  {'cmd', CMD}               - Process the wl_cmd object CMD
+                    %                  {'loop', N}                - Repeat the steps up to the matching 'end_loop' N times
+                    %                  {'end_loop'}               - End of a loop
+                    %                  {'wait_time', USEC}        - Wait USEC microseconds
+                    %                  {'wait_buffers', BUFF_SEL} - Wait until the Tx / Rx of the RF interfaces in
+                    %                                               BUFF_SEL is done (eg RFA + RFB)
+                    %                  {'add', STEP, ARG, INC}    - Add INC to argument ARG of the 'cmd' step STEP
+                    %                                               (eg to move the offset of a Read IQ each loop)
+                    %
+                    % LENGTH:      Length of the program (in uint32 words); used by 'sequencer_start'
+                    %
+                    % NOTE:  The commands in the program are processed by the node exactly as if they were
+                    %     sent by the host, so any command that does not need sample data from the host (ie
+                    %     anything other than Write IQ) can be used.
+                    %
+                    % NOTE:  'add' steps change the program in the node.  The program must be loaded again
+                    %     before it is started again.
+                    %
+                    if((length(varargin) ~= 1) || (~iscell(varargin{1})))
+                        error('%s: Requires one argument:  Cell array of program steps', cmdStr);
+                    end
+                    
+                    steps       = varargin{1};
+                    step_offset = zeros(1, numel(steps));
+                    program     = uint32([]);
+                    
+                    % Encode the steps
+                    %     Instruction word:  [31:24] Operation, [23:0] Operand (see NODE_SEQ_* in wl_node.h)
+                    %
+                    for i = 1:numel(steps)
+                        step           = steps{i};
+                        step_offset(i) = length(program);
+                        
+                        switch(lower(step{1}))
+                            case 'cmd'
+                                words   = step{2}.serialize();
+                                program = [program, uint32(hex2dec('01000000') + length(words)), words];
+                            case 'loop'
+                                program = [program, uint32(hex2dec('02000000') + step{2})];
+                            case 'end_loop'
+                                program = [program, uint32(hex2dec('03000000'))];
+                            case 'wait_time'
+                                program = [program, uint32(hex2dec('04000000') + step{2})];
+                            case 'wait_buffers'
+                                program = [program, uint32(hex2dec('05000000') + step{2})];
+                            case 'add'
+                                if ((step{2} >= i) || (~strcmpi(steps{step{2}}{1}, 'cmd')))
+                                    error('%s: Step %d must add to a previous ''cmd'' step', cmdStr, i);
+                                end
+                                
+                                % Index of the argument:  instruction word + command header (2 words)
+                                target  = step_offset(step{2}) + 3 + (step{3} - 1);
+                                program = [program, uint32(hex2dec('06000000') + target), uint32(step{4})];
+                            otherwise
+                                error('%s: Unknown program step ''%s''', cmdStr, step{1});
+                        end
+                    end
+                    
+                    if (length(program) > 4096)
+                        error('%s: Program is %d words; the node supports 4096 words.\n', cmdStr, length(program));
+                    end
+                    
+                    % Send the program to the node
+                    %     NOTE:  The program is split so each command fits in one packet
+                    %
+                    for offset = 0:300:(length(program) - 1)
+                        myCmd = wl_cmd(node.calcCmd(obj.GRP, obj.CMD_SEQ_LOAD));
+                        myCmd.addArgs(offset);
+                        myCmd.addArgs(program((offset + 1):min((offset + 300), length(program))));
+                        
+                        resp  = node.sendCmd(myCmd);
+
+                        for j = 1:numel(resp)                   % Needed for unicast node_group support
+                            ret   = resp(j).getArgs();
+
+                            if (ret(1) ~= myCmd.CMD_PARAM_SUCCESS)
+                                msg = sprintf('%s: Sequencer load error in node %d.\n', cmdStr, nodeInd);
+                                error(msg);
+                            end
+                        end
+                    end
+                    
+                    out = length(program);
+                    
+                %---------------------------------------------------------
+                case 'sequencer_start'
+                    % Start the program in the node sequencer
+                    %
+                    % Arguments: (uint32 LENGTH), (boolean SEND_RESP)
+                    % Returns: none
+                    %
+                    % LENGTH:      Length of the program (returned by 'sequencer_load')
+                    %
+                    % SEND_RESP:   Optional (default false).  If true, the node sends the response of each
+                    %              command in the program to the host.
+                    %
+                    if((length(varargin) < 1) || (length(varargin) > 2))
+                        error('%s: Requires one or two arguments:  Length, Send responses (optional)', cmdStr);
+                    end
+                    
+                    flags = 0;
+                    
+                    if((length(varargin) == 2) && (varargin{2}))
+                        flags = 1;
+                    end
+
+                    myCmd = wl_cmd(node.calcCmd(obj.GRP, obj.CMD_SEQ_START));
+                    myCmd.addArgs(varargin{1});
+                    myCmd.addArgs(flags);
+                    
+                    resp  = node.sendCmd(myCmd);
+
+                    for i = 1:numel(resp)                   % Needed for unicast node_group support
+                        ret   = resp(i).getArgs();
+
+                        if (ret(1) ~= myCmd.CMD_PARAM_SUCCESS)
+                            msg = sprintf('%s: Sequencer start error in node %d.\n', cmdStr, nodeInd);
+                            error(msg);
+                        end
+                    end
+                    
+                %---------------------------------------------------------
+                case 'sequencer_stop'
+                    % Stop the program in the node sequencer
+                    %
+                    % Arguments: none
+                    % Returns: none
+                    %
+                    myCmd = wl_cmd(node.calcCmd(obj.GRP, obj.CMD_SEQ_STOP));
+                    node.sendCmd(myCmd);
+                    
+                %---------------------------------------------------------
+                case 'sequencer_status'
+                    % Get the status of the node sequencer
+                    %
+                    % Arguments: none
+                    % Returns: [STATE, STEP_WORD, NUM_CMDS]
+                    %
+                    % STATE:       0 - Idle; 1 - Running; 2 - Done; 3 - Error
+                    %
+                    % STEP_WORD:   Index of the current instruction word in the program
+                    %
+                    % NUM_CMDS:    Number of commands processed by the program
+                    %
+                    myCmd = wl_cmd(node.calcCmd(obj.GRP, obj.CMD_SEQ_STATUS));
+                    resp  = node.sendCmd(myCmd);
+                    
+                    for i = 1:numel(resp)                   % Needed for unicast node_group support
+                        ret   = resp(i).getArgs();
+                        
+                        if (i == 1)
+                            out = double(ret(1:3)).';
+                        else
+                            out(:,i) = double(ret(1:3)).';
+                        end
+                    end
+                    
                 %---------------------------------------------------------
                 otherwise
                     error( 'unknown node command %s', cmdStr);
@@ -1175,6 +1402,106 @@ classdef wl_node < handle_light
         end 
         
         
+        function out = sendCmds(obj, cmds, varargin)
+            % This method sends a list of commands that require a response
+            % while keeping several commands waiting for a response at the
+            % same time, instead of waiting for each response in turn.
+            %     cmds:        Cell array of command objects; the string
+            %                  'barrier' makes the following commands wait
+            %                  for all previous commands to be done
+            %     varargin{1}: (optional) Maximum number of commands waiting
+            %                  for a response (default 8)
+            %
+            % The responses are returned in the same order as the commands
+            % (without the barriers).  If the transport can not pipeline
+            % commands, then the commands are sent one at a time.
+            %
+            window = 8;
+            
+            if (nargin == 3)
+                window = varargin{1};
+            end
+            
+            is_cmd = cellfun(@(x) ~ischar(x), cmds);
+            
+            if (ismethod(obj.transport, 'send_window'))
+                payloads         = cell(1, numel(cmds));
+                payloads(is_cmd) = cellfun(@(x) x.serialize(), cmds(is_cmd), 'UniformOutput', false);
+                
+                resp = obj.transport.send_window(payloads, window);
+                resp = resp(is_cmd);
+            else
+                resp = cellfun(@(x) obj.transport.send(x.serialize(), true), cmds(is_cmd), 'UniformOutput', false);
+            end
+            
+            out = [];
+            
+            for i = 1:numel(resp)
+                out(i) = wl_resp(resp{i});
+            end
+        end
+        
+        
+        function out = sendCmdBundle(obj, cmds)
+            % This method sends a list of commands that require a response
+            % bundled into as few packets as possible.  The node processes
+            % the commands of a bundle in order and returns all of their
+            % responses in one packet.
+            %     cmds:        Cell array of command objects
+            %
+            % The responses are returned in the same order as the commands.
+            % The node returns as many responses as fit in one packet of the
+            % maximum payload of the transport; the remaining commands are
+            % sent in the next bundle.
+            %
+            % NOTE:  Commands that send their own responses or need data
+            %     from the packet (ie Read IQ / Write IQ) can not be bundled.
+            %     The node does not process them and returns a response
+            %     with an error status.
+            %
+            max_payload = obj.transport.getMaxPayload();
+            max_words   = floor((max_payload - 24) / 4);                     % Transport header, bundle command header and payload argument
+            payloads  = cellfun(@(x) x.serialize(), cmds, 'UniformOutput', false);
+            next_cmd  = 1;
+            out       = [];
+            
+            while (next_cmd <= numel(cmds))
+                
+                % Add commands to the bundle until the packet is full
+                myCmd     = wl_cmd(obj.calcCmd(obj.GRP, obj.CMD_BUNDLE), max_payload);
+                num_words = 0;
+                last_cmd  = next_cmd;
+                
+                while ((last_cmd <= numel(cmds)) && ((last_cmd == next_cmd) || ((num_words + length(payloads{last_cmd})) <= max_words)))
+                    myCmd.addArgs(payloads{last_cmd});
+                    num_words = num_words + length(payloads{last_cmd});
+                    last_cmd  = last_cmd + 1;
+                end
+                
+                % Process response from the node.  Return arguments:
+                %         [1] - Number of commands processed
+                %     [ 2: N] - Responses
+                %
+                ret       = obj.sendCmd(myCmd).getArgs();
+                num_resp  = double(ret(1));
+                index     = 2;
+                
+                if (num_resp == 0)
+                    error('%s: Node %d could not process command %d of the bundle', 'sendCmdBundle', obj.ID, next_cmd);
+                end
+                
+                for i = 1:num_resp
+                    resp  = wl_resp(ret(index:end));
+                    index = index + resp.len();
+                    out   = [out, resp];
+                end
+                
+                % Commands that were not processed are sent in the next bundle
+                next_cmd  = next_cmd + num_resp;
+            end
+        end
+        
+        
         function out = receiveResp(obj)
             % This method will return a vector of responses that are
             % sitting in the host's receive queue. It will empty the queue
@@ -35,6 +35,7 @@ classdef wl_transport_eth_udp_mex < wl_transport & handle_light
     properties (SetAccess = public)
         hdr;                 % Transport header object
         rxBufferSize;        % OS's receive buffer size in bytes
+        sampleByteOrder;     % Byte order of the samples on the wire (0 - big endian, 1 - little endian)
     end
 
     properties(Hidden = true, Constant = true)
@@ -67,6 +68,8 @@ classdef wl_transport_eth_udp_mex < wl_transport & handle_light
             obj.port        = 0;
             obj.address     = '10.0.0.0';
             
+            obj.sampleByteOrder = 0;   % Big endian until negotiated with the node (see wl_baseband_buffers 'sample_byte_order')
+            
             obj.checkSetup();
         end
         
@@ -121,6 +124,8 @@ classdef wl_transport_eth_udp_mex < wl_transport & handle_light
             else
                 obj.address = obj.int2IP(value);
             end
+            
+            obj.connect();
         end
         
         function out = getAddress(obj)
@@ -129,6 +134,8 @@ classdef wl_transport_eth_udp_mex < wl_transport & handle_light
         
         function setPort(obj, value)
             obj.port = value;
+            
+            obj.connect();
         end
         
         function out = getPort(obj)
@@ -157,9 +164,23 @@ classdef wl_transport_eth_udp_mex < wl_transport & handle_light
 
             if(x < REQUESTED_BUF_SIZE)
                 fprintf('OS reduced recv buffer size to %d\n', x);
+                fprintf('    Increase the OS maximum (e.g. net.core.rmem_max on Linux) to avoid dropped Read IQ packets\n');
             end
             
             obj.status = 1;
+            
+            obj.connect();
+        end
+        
+        function connect(obj)
+            % Connect the socket to the node
+            %     The OS then only delivers packets from the node to this socket and does not need
+            %     to look up the address of each packet that is sent.  Once connected, the MEX
+            %     transport does not use the address / port arguments of the other functions.
+            %
+            if((obj.status == 1) && (obj.port ~= 0))
+                wl_mex_udp_transport('connect', obj.sock, obj.address, obj.port);
+            end
         end
         
         function out = procCmd(obj,nodeInd,node,cmdStr,varargin)
@@ -332,80 +353,22 @@ classdef wl_transport_eth_udp_mex < wl_transport & handle_light
                 obj.hdr.increment;
             end
                         
-            % Format the data / address arguments for transmission
-            data     = [obj.hdr.serialize, payload];                                      % Get a unified array with the header and data
-            data8    = [zeros(1,2,'uint8') typecast(swapbytes(uint32(data)), 'uint8')];   % Change to uint8 and pad by 2 bytes so payload is 32 bit aligned w/ Eth header
-
-            % Send the packet
-            size = wl_mex_udp_transport('send', obj.sock, data8, length(data8), obj.address, obj.port);
-
-            % Wait to receive reply from the board                
-            if(robust == 1)
-                MAX_PKT_LEN      = obj.getMaxPayload() + 100;
-                hdr_length       = obj.hdr.length;
-                currTx           = 1;
-                numWaitRetries   = 0;
-                receivedResponse = 0;
-                currTime         = tic;
-
-                while (receivedResponse == 0)
-                    try
-                        [recv_len, recv_data8] = wl_mex_udp_transport('receive', obj.sock, MAX_PKT_LEN);
-
-                    catch receiveError
-                        error('%s.m -- Failed to receive UDP packet.\nMEX transport error message follows:\n    %s\n', mfilename, receiveError.message);
-                    end
-                    
-                    % If we have a packet, then process the contents
-                    if(recv_len > 0)
-                        reply8     = [recv_data8(3:recv_len) zeros(mod(-(recv_len - 2), 4), 1, 'uint8')];
-                        reply      = swapbytes(typecast(reply8, 'uint32'));
-
-                        % Check the header to see if this was a valid reply                        
-                        if(obj.hdr.isReply(reply(1:hdr_length)))
-                        
-                            % Check the header to see if we need to wait for the node to be ready
-                            if (obj.hdr.isNodeReady(reply(1:hdr_length)))
-                            
-                                % Strip off transport header to give response to caller
-                                reply  = reply((hdr_length + 1):end);
-                                
-                                if(isempty(reply))
-                                    reply = []; 
-                                end
-                                
-                                receivedResponse = 1;
-                                
-                            else
-                                % Node is not ready; Wait and try again
-                                pause(obj.TRANSPORT_NOT_READY_WAIT_TIME);
-                                numWaitRetries = numWaitRetries + 1;
+            % Send the command and wait for the response
+            %     NOTE:  The MEX transport builds the transport header, byte swaps the packet and matches
+            %            the response (sequence number, not ready flag and retransmissions).  The command
+            %            is sent again if there is no response within obj.timeout seconds.
+            %
+            hdr_fields = [double(obj.hdr.destID), double(obj.hdr.srcID), double(obj.hdr.pktType), double(obj.hdr.seqNum)];
 
-                                % Send packet packet again
-                                obj.sock.send(pkt_send);
+            try
+                reply = wl_mex_udp_transport('send_cmd', obj.sock, obj.address, obj.port, hdr_fields, payload, robust, maxAttempts, obj.timeout);
 
-                                % Check that we have not spent a "long time" waiting for samples to be ready                
-                                if (numWaitRetries > obj.TRANSPORT_NOT_READY_MAX_RETRY)
-                                    error('wl_transport_eth_mex:send:isReady', 'Error:  Timeout waiting for node to be ready.  Please check the node operation.');
-                                end
-                                
-                                reply = [];
-                            end
-                        end
-                    end
-                    
-                    % Look for timeout
-                    if ((toc(currTime) > obj.timeout) && (receivedResponse == 0))
-                        if(currTx == maxAttempts)
-                            error('wl_transport_eth_mex:send:noReply', 'maximum number of retransmissions met without reply from node'); 
-                        end
-                        
-                        % Retry the packet
-                        size = wl_mex_udp_transport('send', obj.sock, data8, length(data8), obj.address, obj.port);
-                        currTx   = currTx + 1;
-                        currTime = tic;
-                    end
-                end
+            catch sendError
+                error('%s.m -- Failed to send command.\nMEX transport error message follows:\n    %s\n', mfilename, sendError.message);
+            end
+            
+            if(isempty(reply))
+                reply = [];
             end
         end
         
@@ -418,13 +381,84 @@ classdef wl_transport_eth_udp_mex < wl_transport & handle_light
             %            there are no packets available.
             %
 
+            % Get the next response to the last command
+            %     NOTE:  The MEX transport strips off the transport header and byte swaps the response
+            %
+            hdr_fields = [double(obj.hdr.destID), double(obj.hdr.srcID), double(obj.hdr.pktType), double(obj.hdr.seqNum)];
+            
+            try
+                resp = wl_mex_udp_transport('receive_resp', obj.sock, hdr_fields);
+
+            catch receiveError
+                error('%s.m -- Failed to receive UDP packet.\nMEX transport error message follows:\n    %s\n', mfilename, receiveError.message);
+            end
+            
+            if(isempty(resp))
+                resp = [];
+            end
+        end
+        
+        function replies = send_window(obj, payloads, window)
+            % Send multiple robust commands with up to 'window' commands waiting for a response
+            %
+            % payloads   : Cell array of data to be sent to the node (one command per cell);
+            %                  an empty cell is a barrier (ie all previous commands must
+            %                  receive a response before the next command is sent)
+            % window     : Maximum number of commands waiting for a response
+            %
+            % replies    : Cell array of responses (transport header removed) in the same
+            %                  order as payloads
+            %
+            % NOTE:  Responses are matched to commands using the sequence number of the
+            %     transport header.  Only commands without a response before the timeout are
+            %     sent again.
+            %
+
             % Initialize variables
-            MAX_PKT_LEN = obj.getMaxPayload() + 100;            
-            hdr_length  = obj.hdr.length;
-            done        = false;
-            resp        = [];
+            maxAttempts       = 2;                                   % Maximum times the transport will re-try a packet
+            MAX_PKT_LEN       = obj.getMaxPayload() + 100;
+            hdr_length        = obj.hdr.length;
+            src_dest          = ((2^16 * obj.hdr.srcID) + obj.hdr.destID);
+            num_cmds          = numel(payloads);
             
-            while ~done
+            replies           = cell(1, num_cmds);
+            data8             = cell(1, num_cmds);
+            seq_num           = zeros(1, num_cmds);
+            num_tx            = zeros(1, num_cmds);
+            num_wait_retries  = zeros(1, num_cmds);
+            deadline          = zeros(1, num_cmds);
+            waiting           = [];                                  % Indexes of commands waiting for a response
+            next_cmd          = 1;
+            start_time        = tic;
+
+            obj.hdr.flags     = bitset(obj.hdr.flags, 1, 1);
+            
+            while ((next_cmd <= num_cmds) || ~isempty(waiting))
+            
+                % Send commands until the window is full or a barrier is reached
+                while ((next_cmd <= num_cmds) && (length(waiting) < window))
+                    if (isempty(payloads{next_cmd}))
+                        if (~isempty(waiting))
+                            break;
+                        end
+                    else
+                        payload           = uint32(payloads{next_cmd});
+                        obj.hdr.msgLength = ((length(payload)) * 4);
+                        obj.hdr.increment;
+
+                        seq_num(next_cmd) = obj.hdr.seqNum;
+                        data8{next_cmd}   = [zeros(1,2,'uint8') typecast(swapbytes(uint32([obj.hdr.serialize, payload])), 'uint8')];
+
+                        wl_mex_udp_transport('send', obj.sock, data8{next_cmd}, length(data8{next_cmd}), obj.address, obj.port);
+
+                        num_tx(next_cmd)   = 1;
+                        deadline(next_cmd) = toc(start_time) + obj.timeout;
+                        waiting            = [waiting, next_cmd];
+                    end
+                    
+                    next_cmd = next_cmd + 1;
+                end
+                
                 try
                     [recv_len, recv_data8] = wl_mex_udp_transport('receive', obj.sock, MAX_PKT_LEN);
 
@@ -432,24 +466,46 @@ classdef wl_transport_eth_udp_mex < wl_transport & handle_light
                     error('%s.m -- Failed to receive UDP packet.\nMEX transport error message follows:\n    %s\n', mfilename, receiveError.message);
                 end
                 
+                % If we have a packet, then match it to a waiting command
                 if(recv_len > 0)
-                    reply8 = [recv_data8(3:recv_len) zeros(mod(-(recv_len - 2), 4), 1, 'uint8')].';
-                    reply  = swapbytes(typecast(reply8, 'uint32'));
+                    reply8     = [recv_data8(3:recv_len) zeros(mod(-(recv_len - 2), 4), 1, 'uint8')];
+                    reply      = swapbytes(typecast(reply8, 'uint32'));
+                    
+                    if ((length(reply) >= hdr_length) && (reply(1) == src_dest))
+                        index = waiting(seq_num(waiting) == bitshift(reply(3), -16));
 
-                    if(obj.hdr.isReply(reply(1:hdr_length)))
-                        % Strip off transport header to give response to caller
-                        reply  = reply((hdr_length + 1):end);
-                        
-                        if(isempty(reply))
-                            reply = [];
+                        if (~isempty(index))
+                            if (obj.hdr.isNodeReady(reply(1:hdr_length)))
+                                % Strip off transport header to give response to caller
+                                replies{index} = reply((hdr_length + 1):end);
+                                waiting        = waiting(waiting ~= index);
+                            else
+                                % Node is not ready; Send the command again after the wait time
+                                num_wait_retries(index) = num_wait_retries(index) + 1;
+
+                                if (num_wait_retries(index) > obj.TRANSPORT_NOT_READY_MAX_RETRY)
+                                    error('wl_transport_eth_mex:send_window:isReady', 'Error:  Timeout waiting for node to be ready.  Please check the node operation.');
+                                end
+                                
+                                num_tx(index)   = 0;
+                                deadline(index) = toc(start_time) + obj.TRANSPORT_NOT_READY_WAIT_TIME;
+                            end
                         end
-                        
-                        resp = [resp, reply];                        
+                    end
+                end
+                
+                % Send the commands that timed out again
+                curr_time = toc(start_time);
 
-                        done = true;
+                for index = waiting(deadline(waiting) < curr_time)
+                    if(num_tx(index) == maxAttempts)
+                        error('wl_transport_eth_mex:send_window:noReply', 'maximum number of retransmissions met without reply from node (command %d)', index); 
                     end
-                else
-                    done = true;
+                    
+                    wl_mex_udp_transport('send', obj.sock, data8{index}, length(data8{index}), obj.address, obj.port);
+                    
+                    num_tx(index)   = num_tx(index) + 1;
+                    deadline(index) = curr_time + obj.timeout;
                 end
             end
         end
@@ -543,31 +599,17 @@ classdef wl_transport_eth_udp_mex < wl_transport & handle_light
             % Get the lowercase version of the function            
             func = lower(func);
 
-            % Calculate how many transport packets are required
-            numPktsRequired = ceil(double(num_samples)/double(obj.maxSamples));
-
-            % Arguments for the command will be set in the MEX function since it is faster
-            %     wl_command.setArgs(buffer_id, start_sample, num_samples, obj.maxSamples * 4, numPktsRequired);
-            
-            % Construct the minimal WARPLab command that will be used used to get the samples
-            %   NOTE:  Since we did not add the arguments of the command thru setArgs, we need to pad the structure so that 
-            %          the proper amount of memory is allocated to be available to the MEX
-            payload           = uint32( wl_command.serialize() );        % Convert command to uint32
-            cmd_args_pad      = uint32( zeros(1, 5) );                   % Padding for command args
-            obj.hdr.flags     = bitset(obj.hdr.flags,1,0);               % We do not need a response for the sent command
-            obj.hdr.msgLength = ( ( length( payload ) ) + 5) * 4;        % Length in bytes
-
-            data  = [obj.hdr.serialize, payload, cmd_args_pad];
-            data8 = [zeros(1,2,'uint8') typecast(swapbytes(uint32(data)), 'uint8')];
+            % Get the arguments of the MEX function
+            args = obj.read_buffers_args(num_samples, buffer_ids, start_sample, seq_num_tracker, seq_num_match_severity, node_id_str, wl_command, input_type);
 
             % Pass all of the command arguments down to MEX
             switch(func)
                 case 'iq'
                     % Calls the MEX read_iq command
                     %
-                    % obj.print_cmd('READ_IQ', num_samples, start_sample, buffer_ids, data8);
+                    % obj.print_cmd('READ_IQ', num_samples, start_sample, buffer_ids, args{2});
                     
-                    [num_rcvd_samples, cmds_used, rx_samples]  = wl_mex_udp_transport('read_iq', obj.sock, data8, length(data8), obj.address, obj.port, num_samples, buffer_ids, start_sample, obj.maxSamples * 4, numPktsRequired, input_type, seq_num_tracker, seq_num_match_severity, node_id_str);
+                    [num_rcvd_samples, cmds_used, rx_samples]  = wl_mex_udp_transport('read_iq', args{:});
                     
                     % Code to test higher level matlab code without invoking the MEX transport
                     % 
@@ -577,9 +619,9 @@ classdef wl_transport_eth_udp_mex < wl_transport & handle_light
                 case 'rssi'
                     % Calls the MEX read_rssi command
                     %                        
-                    % obj.print_cmd('READ_RSSI', num_samples, start_sample, buffer_ids, data8);
+                    % obj.print_cmd('READ_RSSI', num_samples, start_sample, buffer_ids, args{2});
 
-                    [num_rcvd_samples, cmds_used, rx_samples]  = wl_mex_udp_transport('read_rssi', obj.sock, data8, length(data8), obj.address, obj.port, num_samples, buffer_ids, start_sample, obj.maxSamples * 4, numPktsRequired, input_type, seq_num_tracker, seq_num_match_severity, node_id_str);
+                    [num_rcvd_samples, cmds_used, rx_samples]  = wl_mex_udp_transport('read_rssi', args{:});
 
                     % Code to test higher level matlab code without invoking the MEX transport
                     %
@@ -594,6 +636,37 @@ classdef wl_transport_eth_udp_mex < wl_transport & handle_light
             
             reply = rx_samples;
         end
+        
+        %-----------------------------------------------------------------
+        % read_buffers_args
+        %     Arguments of the MEX 'read_iq' and 'read_rssi' functions (after the function name) for a request.
+        %     The arguments of several nodes can be combined for the MEX 'trigger_and_read' function.
+        %     
+        %     NOTE:  The caller must increment the transport header by the number of commands used by the 
+        %            MEX function.
+        % 
+        function args = read_buffers_args(obj, num_samples, buffer_ids, start_sample, seq_num_tracker, seq_num_match_severity, node_id_str, wl_command, input_type)
+            % See read_buffers for a description of the arguments
+
+            % Calculate how many transport packets are required
+            numPktsRequired = ceil(double(num_samples)/double(obj.maxSamples));
+
+            % Arguments for the command will be set in the MEX function since it is faster
+            %     wl_command.setArgs(buffer_id, start_sample, num_samples, obj.maxSamples * 4, numPktsRequired);
+            
+            % Construct the minimal WARPLab command that will be used used to get the samples
+            %   NOTE:  Since we did not add the arguments of the command thru setArgs, we need to pad the structure so that 
+            %          the proper amount of memory is allocated to be available to the MEX
+            payload           = uint32( wl_command.serialize() );        % Convert command to uint32
+            cmd_args_pad      = uint32( zeros(1, 5) );                   % Padding for command args
+            obj.hdr.flags     = bitset(obj.hdr.flags,1,0);               % We do not need a response for the sent command
+            obj.hdr.msgLength = ( ( length( payload ) ) + 5) * 4;        % Length in bytes
+
+            data  = [obj.hdr.serialize, payload, cmd_args_pad];
+            data8 = [zeros(1,2,'uint8') typecast(swapbytes(uint32(data)), 'uint8')];
+
+            args  = {obj.sock, data8, length(data8), obj.address, obj.port, num_samples, buffer_ids, start_sample, obj.maxSamples * 4, numPktsRequired, input_type, seq_num_tracker, seq_num_match_severity, node_id_str};
+        end
  
  
         %-----------------------------------------------------------------
@@ -639,7 +712,7 @@ classdef wl_transport_eth_udp_mex < wl_transport & handle_light
                 case 'iq'
                     % Calls the MEX read_iq command
                     %
-                    [cmds_used, checksum] = wl_mex_udp_transport('write_iq', socket, data8, max_payload, address, port, num_samples, samples, buffer_ids, start_sample, num_pkts_required, max_samples, hw_ver, check_chksum, input_type);
+                    [cmds_used, checksum] = wl_mex_udp_transport('write_iq', socket, data8, max_payload, address, port, num_samples, samples, buffer_ids, start_sample, num_pkts_required, max_samples, hw_ver, check_chksum, input_type, obj.sampleByteOrder);
                     
                     % Increment the transport header by cmds_used (ie number of commands used
                     obj.hdr.increment(cmds_used);
@@ -192,6 +192,30 @@ classdef wl_transport_eth_udp_mex_bcast < wl_transport & handle_light
             
         end
         
+        %-----------------------------------------------------------------
+        % trigger_and_read
+        %     Sends a trigger and reads the buffers of the nodes with a single call to the MEX transport
+        % 
+        function [num_samples, cmds_used, samples] = trigger_and_read(obj, trigger_id, wait_time, read_args)
+            % trigger_id     : Trigger ID to send
+            % wait_time      : Time (in us) from the trigger until the captures of all nodes are done
+            % read_args      : Arguments of the MEX 'read_iq' with one row per node
+            %                      (see read_buffers_args in wl_transport_eth_udp_mex)
+            
+            obj.hdr.pktType   = obj.hdr.PKTTYPE_TRIGGER;
+            
+            data = uint32(trigger_id);
+            
+            obj.hdr.msgLength = (length(data))*4;          % Length in bytes
+            obj.hdr.flags     = bitset(obj.hdr.flags,1,0);
+            obj.hdr.increment;
+            
+            data  = [obj.hdr.serialize,data];    
+            data8 = [zeros(1,2,'uint8') typecast(swapbytes(uint32(data)),'uint8')];
+            
+            [num_samples, cmds_used, samples] = wl_mex_udp_transport('trigger_and_read', obj.sock, data8, obj.address, obj.port, wait_time, read_args);
+        end
+        
         function dottedIPout = int2IP(obj,intIn)
             addrChars(4) = mod(intIn, 2^8);
             addrChars(3) = mod(bitshift(intIn, -8), 2^8);
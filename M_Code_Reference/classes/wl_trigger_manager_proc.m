@@ -27,6 +27,8 @@ classdef wl_trigger_manager_proc < wl_trigger_manager & handle_light
         triggerOutputIDs;
         numInputs; 
         numOutputs;
+        clockRef;                                % Host time reference (tic) of the last clock_sync
+        clockOffset;                             % Node timestamp (usec) at the host time reference
     end
     
     properties(Hidden = true,Constant = true)
@@ -56,6 +58,9 @@ classdef wl_trigger_manager_proc < wl_trigger_manager & handle_light
         CMD_ENERGY_BUSY_MIN_LEN        = 50;               % 0x000032
         CMD_ENERGY_IFC_SELECTION       = 51;               % 0x000033
 
+        CMD_GET_TIMESTAMP              = 64;               % 0x000040
+        CMD_SCHEDULE_TRIGGER           = 65;               % 0x000041
+
         CMD_TEST_TRIGGER               = 128;              % 0x000080
         
         TRIGGER_INPUT_FLAG             = hex2dec('80000000');        % Used to check trigger input IDs vs trigger output IDs
@@ -883,6 +888,135 @@ classdef wl_trigger_manager_proc < wl_trigger_manager & handle_light
                     % Send the command to the node
                     node.sendCmd(myCmd);
                 
+                %---------------------------------------------------------
+                case 'get_timestamp'
+                    % Reads the node timestamp
+                    %
+                    % Arguments: none
+                    % Returns: (double TIMESTAMP)
+                    %
+                    % TIMESTAMP:    Node timestamp in microseconds
+                    %
+                    myCmd = wl_cmd(node.calcCmd(obj.GRP, obj.CMD_GET_TIMESTAMP));
+                    
+                    resp = node.sendCmd(myCmd);
+                    ret  = resp.getArgs();
+                    out  = double(ret(1)) * 2^32 + double(ret(2));
+                
+                %---------------------------------------------------------
+                case 'clock_sync'
+                    % Estimates the offset between the host clock and the 
+                    % node timestamp
+                    %
+                    % Arguments: (uint32 NUM_EXCHANGES)
+                    % Returns: (double OFFSET, double RTT)
+                    %
+                    % NUM_EXCHANGES:  Number of timestamp requests sent to 
+                    %                 the node (optional; default 16)
+                    %
+                    % OFFSET:         Node timestamp (usec) at the host time
+                    %                 reference used by 'schedule_trigger'
+                    %
+                    % RTT:            Round trip time (usec) of the request 
+                    %                 used for the estimate
+                    %
+                    % Note: The node timestamp is assumed to be read half way
+                    % through the round trip.  The request with the smallest
+                    % round trip time has the least queuing delay, so only
+                    % that request is used.  All nodes share the same host
+                    % time reference so that triggers scheduled on several
+                    % nodes are raised at the same time.
+                    %
+                    if(length(varargin) == 1)
+                        numExchanges = varargin{1};
+                    else
+                        numExchanges = 16;
+                    end
+                    
+                    obj.clockRef = wl_trigger_manager_proc.hostClockRef();
+                    
+                    myCmd  = wl_cmd(node.calcCmd(obj.GRP, obj.CMD_GET_TIMESTAMP));
+                    minRtt = inf;
+                    
+                    for index = 1:numExchanges
+                        t0   = toc(obj.clockRef) * 1e6;
+                        resp = node.sendCmd(myCmd);
+                        t1   = toc(obj.clockRef) * 1e6;
+                        
+                        ret  = resp.getArgs();
+                        
+                        if((t1 - t0) < minRtt)
+                            minRtt          = t1 - t0;
+                            obj.clockOffset = double(ret(1)) * 2^32 + double(ret(2)) - ((t0 + t1) / 2);
+                        end
+                    end
+                    
+                    out = [obj.clockOffset, minRtt];
+                
+                %---------------------------------------------------------
+                case 'schedule_trigger'
+                    % Schedules the Ethernet trigger of the node to be
+                    % raised at the given times
+                    %
+                    % Arguments: (double TIMES, string MODE)
+                    % Returns: (uint32 NUM_PENDING, uint32 NUM_LATE)
+                    %
+                    % TIMES:        Vector of increasing trigger times.  An
+                    %               empty vector clears the schedule.
+                    %
+                    % MODE:         'relative' (default) -- TIMES are in seconds
+                    %                   from now on the host clock (requires
+                    %                   'clock_sync')
+                    %               'node' -- TIMES are node timestamps in usec
+                    %
+                    % NUM_PENDING:  Number of triggers in the node schedule
+                    %
+                    % NUM_LATE:     Number of triggers raised late since the
+                    %               schedule was last cleared
+                    %
+                    % Note: The node holds up to 16 triggers.  The node raises
+                    % the trigger from its main loop, so a trigger whose time
+                    % passes during a long command (eg a Read IQ) is raised
+                    % when the command completes and is counted as late.
+                    %
+                    myCmd = wl_cmd(node.calcCmd(obj.GRP, obj.CMD_SCHEDULE_TRIGGER));
+                    
+                    times = varargin{1};
+                    
+                    if(length(varargin) == 2)
+                        timeMode = lower(varargin{2});
+                    else
+                        timeMode = 'relative';
+                    end
+                    
+                    switch(timeMode)
+                        case 'relative'
+                            if(isempty(obj.clockOffset))
+                                error('Node clock offset is unknown; run the ''clock_sync'' command first');
+                            end
+                            times = round(obj.clockOffset + (toc(obj.clockRef) + times) * 1e6);
+                        case 'node'
+                            times = round(times);
+                        otherwise
+                            error('unknown mode ''%s''; must be ''relative'' or ''node''', timeMode);
+                    end
+                    
+                    myCmd.addArgs(uint32(length(times)));
+                    
+                    for index = 1:length(times)
+                        myCmd.addArgs(uint32(floor(times(index) / 2^32)));
+                        myCmd.addArgs(uint32(mod(times(index), 2^32)));
+                    end
+                    
+                    resp = node.sendCmd(myCmd);
+                    ret  = resp.getArgs();
+                    
+                    if(ret(1) ~= myCmd.CMD_PARAM_SUCCESS)
+                        warning('Node %d could not schedule all triggers', node.ID);
+                    end
+                    
+                    out = double(ret(2:3)).';
+                
                 %---------------------------------------------------------
                 case 'test_trigger'
                     % Sends a test trigger
@@ -904,4 +1038,17 @@ classdef wl_trigger_manager_proc < wl_trigger_manager & handle_light
             end
          end
     end
+    
+    methods (Static = true)
+        function out = hostClockRef()
+            % Host time reference shared by all nodes
+            persistent ref;
+            
+            if(isempty(ref))
+                ref = tic;
+            end
+            
+            out = ref;
+        end
+    end
 end
\ No newline at end of file
@@ -20,7 +20,7 @@
 *       mex -g -O wl_mex_udp_transport.c -lwsock32 -lKernel32 -DWIN32
 *
 *   MAC / Unix:
-*       mex -g -O wl_mex_udp_transport.c
+*       mex -g -O wl_mex_udp_transport.c -lpthread
 *
 *
 * MODIFICATION HISTORY:
@@ -62,6 +62,9 @@
 #include <arpa/inet.h>
 #include <unistd.h>
 #include <fcntl.h>
+#include <time.h>
+#include <pthread.h>
+#include <sys/select.h>
 
 #endif
 
@@ -99,7 +102,20 @@
 #define SOCKET                                             SOCKET
 #define get_last_error                                     WSAGetLastError()
 #define EWOULDBLOCK                                        WSAEWOULDBLOCK
+#define ECONNREFUSED                                       WSAECONNRESET
 #define socklen_t                                          int
+#define wl_thread_t                                        HANDLE
+#define wl_thread_return_t                                 DWORD WINAPI
+#define wl_thread_create(t, f)                             ( ( *(t) = CreateThread( NULL, 0, f, NULL, 0, NULL ) ) != NULL )
+#define wl_thread_join(t)                                  { WaitForSingleObject( t, INFINITE ); CloseHandle( t ); }
+#define wl_mutex_t                                         CRITICAL_SECTION
+#define wl_mutex_init(x)                                   InitializeCriticalSection(x)
+#define wl_mutex_lock(x)                                   EnterCriticalSection(x)
+#define wl_mutex_unlock(x)                                 LeaveCriticalSection(x)
+#define wl_cond_t                                          CONDITION_VARIABLE
+#define wl_cond_init(x)                                    InitializeConditionVariable(x)
+#define wl_cond_wait(c, m)                                 SleepConditionVariableCS( c, m, INFINITE )
+#define wl_cond_broadcast(x)                               WakeAllConditionVariable(x)
 
 #else
 
@@ -117,6 +133,18 @@
 #define get_last_error                                     errno
 #define INVALID_SOCKET                                     0xFFFFFFFF
 #define SOCKET_ERROR                                       -1
+#define wl_thread_t                                        pthread_t
+#define wl_thread_return_t                                 void *
+#define wl_thread_create(t, f)                             ( pthread_create( t, NULL, f, NULL ) == 0 )
+#define wl_thread_join(t)                                  pthread_join( t, NULL )
+#define wl_mutex_t                                         pthread_mutex_t
+#define wl_mutex_init(x)                                   pthread_mutex_init( x, NULL )
+#define wl_mutex_lock(x)                                   pthread_mutex_lock(x)
+#define wl_mutex_unlock(x)                                 pthread_mutex_unlock(x)
+#define wl_cond_t                                          pthread_cond_t
+#define wl_cond_init(x)                                    pthread_cond_init( x, NULL )
+#define wl_cond_wait(c, m)                                 pthread_cond_wait( c, m )
+#define wl_cond_broadcast(x)                               pthread_cond_broadcast(x)
 
 #endif
 
@@ -138,6 +166,26 @@
 #define TRANSPORT_WRITE_IQ_SET_PKT_WAIT_TIME               13
 #define TRANSPORT_READ_IQ_SET_MAX_REQUEST_SIZE             14
 #define TRANSPORT_SUPPRESS_IQ_WARNINGS                     15
+#define TRANSPORT_READ_IQ_SET_MULTI_BUFFER                 16
+#define TRANSPORT_READ_IQ_SET_STREAM                       17
+#define TRANSPORT_READ_IQ_SET_COMPRESSION                  18
+#define TRANSPORT_READ_IQ_GET_COMPRESSION_RATIO            19
+#define TRANSPORT_READ_IQ_SET_WINDOW                       20
+#define TRANSPORT_READ_IQ_SET_METADATA                     21
+#define TRANSPORT_READ_IQ_GET_METADATA                     22
+#define TRANSPORT_READ_IQ_SET_DEFER                        23
+#define TRANSPORT_READ_IQ_SET_SCHEDULE                     24
+#define TRANSPORT_TRIGGER_AND_READ                         25
+#define TRANSPORT_SEND_CMD                                 26
+#define TRANSPORT_RECEIVE_RESP                             27
+#define TRANSPORT_CONNECT                                  28
+#define TRANSPORT_GET_RX_DROPS                             29
+#define TRANSPORT_SET_TRACE                                30
+#define TRANSPORT_GET_TRACE                                31
+#define TRANSPORT_SET_CAPTURE                              32
+#define TRANSPORT_SET_IMPAIRMENT                           33
+#define TRANSPORT_GET_IMPAIRMENT_STATS                     34
+#define TRANSPORT_READ_IQ_SET_DECODE_THREADS               35
 
 
 // Maximum number of sockets that can be allocated
@@ -159,9 +207,86 @@
 #define TRANSPORT_TIMEOUT                                  10000000
 #define TRANSPORT_MAX_RETRY                                50
 #define TRANSPORT_NOT_READY_WAIT_TIME                      100000
+#define TRANSPORT_READ_IQ_NODE_TIMEOUT                     0.1
+#define TRANSPORT_READ_IQ_NODE_POLL_TIME                   1000
 #define TRANSPORT_NOT_READY_MAX_RETRY                      50
 #define TRANSPORT_HDR_NODE_NOT_READY_FLAG                  0x8000
 
+// Transport header fields of the 'send_cmd' / 'receive_resp' functions
+#define TRANSPORT_HDR_FIELD_DEST_ID                        0
+#define TRANSPORT_HDR_FIELD_SRC_ID                         1
+#define TRANSPORT_HDR_FIELD_PKT_TYPE                       2
+#define TRANSPORT_HDR_FIELD_SEQ_NUM                        3
+#define TRANSPORT_HDR_NUM_FIELDS                           4
+
+#define TRANSPORT_RESP_NO_MATCH                            -1
+#define TRANSPORT_RESP_NOT_READY                           -2
+
+// Transport packet trace defines
+//     NOTE:  The trace is returned to MATLAB as a matrix with one column per packet and one row per field
+//
+#define TRANSPORT_TRACE_TX                                 0
+#define TRANSPORT_TRACE_RX                                 1
+#define TRANSPORT_TRACE_NO_SAMPLE                          0xFFFFFFFF
+#define TRANSPORT_TRACE_MAX_ENTRIES                        0x01000000
+
+#define TRANSPORT_TRACE_FIELD_DIRECTION                    0
+#define TRANSPORT_TRACE_FIELD_SOCKET                       1
+#define TRANSPORT_TRACE_FIELD_KERNEL_TIME                  2
+#define TRANSPORT_TRACE_FIELD_HOST_TIME                    3
+#define TRANSPORT_TRACE_FIELD_LENGTH                       4
+#define TRANSPORT_TRACE_FIELD_SAMPLE                       5
+#define TRANSPORT_TRACE_FIELD_RETRY                        6
+#define TRANSPORT_TRACE_NUM_FIELDS                         7
+
+// Transport packet capture defines (pcap format; each datagram is stored with an IPv4 / UDP header)
+#define TRANSPORT_CAPTURE_MAGIC                            0xA1B2C3D4
+#define TRANSPORT_CAPTURE_VERSION_MAJOR                    2
+#define TRANSPORT_CAPTURE_VERSION_MINOR                    4
+#define TRANSPORT_CAPTURE_SNAPLEN                          65535
+#define TRANSPORT_CAPTURE_LINKTYPE_RAW                     101
+#define TRANSPORT_CAPTURE_IP_HDR_LENGTH                    20
+#define TRANSPORT_CAPTURE_UDP_HDR_LENGTH                   8
+
+// Transport impairment defines
+#define TRANSPORT_IMPAIR_TX                                0x1
+#define TRANSPORT_IMPAIR_RX                                0x2
+
+#define TRANSPORT_IMPAIR_LOSS_BERNOULLI                    0
+#define TRANSPORT_IMPAIR_LOSS_GILBERT_ELLIOTT              1
+
+#define TRANSPORT_IMPAIR_STATE_GOOD                        0
+#define TRANSPORT_IMPAIR_STATE_BAD                         1
+
+#define TRANSPORT_IMPAIR_QUEUE_SIZE                        256
+#define TRANSPORT_IMPAIR_REORDER_TIMEOUT                   0.001          // Max time (in sec) a reordered packet waits for later packets
+#define TRANSPORT_IMPAIR_DEFAULT_SEED                      0x2545F491
+
+#define TRANSPORT_IMPAIR_STAT_TX_LOST                      0
+#define TRANSPORT_IMPAIR_STAT_RX_LOST                      1
+#define TRANSPORT_IMPAIR_STAT_DUPLICATED                   2
+#define TRANSPORT_IMPAIR_STAT_REORDERED                    3
+#define TRANSPORT_IMPAIR_STAT_DELAYED                      4
+#define TRANSPORT_IMPAIR_STAT_OVERFLOW                     5
+#define TRANSPORT_IMPAIR_NUM_STATS                         6
+
+// Read IQ decode thread defines
+//     NOTE:  Requests with fewer than TRANSPORT_DECODE_MIN_PKTS packets are decoded on the receive thread
+//
+#define TRANSPORT_DECODE_THREADS_AUTO                      0xFFFFFFFF
+#define TRANSPORT_DECODE_MAX_THREADS                       8
+#define TRANSPORT_DECODE_SLOTS_PER_THREAD                  8
+#define TRANSPORT_DECODE_MIN_PKTS                          16
+
+#define TRANSPORT_DECODE_SLOT_FREE                         0
+#define TRANSPORT_DECODE_SLOT_RECEIVE                      1
+#define TRANSPORT_DECODE_SLOT_READY                        2
+#define TRANSPORT_DECODE_SLOT_BUSY                         3
+
+#define TRANSPORT_DECODE_SUCCESS                           0
+#define TRANSPORT_DECODE_BAD_FUNCTION                      -1
+#define TRANSPORT_DECODE_BAD_DATA_TYPE                     -2
+
 // Command defines
 #define CMD_PARAM_SUCCESS                                  0x00000000
 #define CMD_PARAM_ERROR                                    0xFF000000
@@ -181,6 +306,23 @@
 
 #define SAMPLE_LAST_WRITE                                  0x20
 
+#define SAMPLE_IQ_FORMAT_12BIT                             0x04
+#define SAMPLE_IQ_FORMAT_BFP                               0x08
+
+#define SAMPLE_IQ_METADATA                                 0x40
+
+// Sample byte order defines
+//     NOTE:  Samples are big endian on the wire unless the node was set to little endian samples (see
+//            'sample_byte_order' in wl_baseband_buffers.m).  Raw Read IQ / Read RSSI packets with little
+//            endian samples have SAMPLE_IQ_LITTLE_ENDIAN set.  Like endian_swap_16() / endian_swap_32()
+//            (which are used for all header fields), this assumes a little endian host so little endian
+//            samples can be copied directly.
+//
+#define SAMPLE_IQ_LITTLE_ENDIAN                            0x80
+
+#define SAMPLE_BYTE_ORDER_BIG                              0
+#define SAMPLE_BYTE_ORDER_LITTLE                           1
+
 // WARP HW version defines
 #define TRANSPORT_WARP_HW_v2                               2
 #define TRANSPORT_WARP_HW_v3                               3
@@ -200,6 +342,84 @@
 #define BUFFER_ID_RFC                                      0x00000004
 #define BUFFER_ID_RFD                                      0x00000008
 
+// Read IQ buffer selection defines
+#define READ_IQ_BUFFER_ID_MASK                             0x0000000F
+#define READ_IQ_FLAG_INTERLEAVE                            0x80000000
+#define READ_IQ_FLAG_STREAM                                0x40000000
+
+#define READ_IQ_MULTI_BUFFER_DISABLED                      0
+#define READ_IQ_MULTI_BUFFER_SEQUENTIAL                    1
+#define READ_IQ_MULTI_BUFFER_INTERLEAVED                   2
+
+// Read IQ sample format defines
+//     NOTE:  READ_IQ_COMPRESS_MAX_LENGTH must match the size of the node compression buffers
+//            (ie WL_BASEBAND_ETH_COMPRESS_BUFFER_SIZE in wl_baseband.c)
+//
+#define READ_IQ_FORMAT_SHIFT                               28
+#define READ_IQ_BFP_BLOCK_SAMPLES                          32
+#define READ_IQ_COMPRESS_MAX_LENGTH                        0x2400
+
+#define READ_IQ_COMPRESSION_NONE                           0
+#define READ_IQ_COMPRESSION_12BIT                          1
+#define READ_IQ_COMPRESSION_BFP                            2
+
+// Read IQ capture window defines
+//     NOTE:  With READ_IQ_WINDOW_AGC_DONE, the start sample of a Read IQ request is a signed offset
+//            from the sample where the AGC finished and is resolved by the node.
+//
+#define READ_IQ_WINDOW_SHIFT                               26
+#define READ_IQ_WINDOW_ABSOLUTE                            0
+#define READ_IQ_WINDOW_AGC_DONE                            1
+
+// Read IQ capture metadata defines
+//     NOTE:  With READ_IQ_FLAG_METADATA, the node sends a metadata packet before the samples of a Read IQ
+//            request that contains READ_IQ_METADATA_WORDS big endian words for each buffer of the request
+//            (ie wl_bb_read_iq_metadata in wl_baseband.h).
+//
+#define READ_IQ_FLAG_METADATA                              0x02000000
+
+#define READ_IQ_METADATA_WORDS                             16
+#define READ_IQ_METADATA_BUFF_SEL                          0
+#define READ_IQ_METADATA_RX_COUNT                          1
+#define READ_IQ_METADATA_CAPTURE_TIME_MSB                  2
+#define READ_IQ_METADATA_CAPTURE_TIME_LSB                  3
+#define READ_IQ_METADATA_READ_TIME_MSB                     4
+#define READ_IQ_METADATA_READ_TIME_LSB                     5
+#define READ_IQ_METADATA_AGC_GAINS                         6
+#define READ_IQ_METADATA_AGC_DONE_RSSI                     7
+#define READ_IQ_METADATA_AGC_DONE_ADDR                     8
+#define READ_IQ_METADATA_RSSI_MIN                          9
+#define READ_IQ_METADATA_RSSI_MEAN                         10
+#define READ_IQ_METADATA_RSSI_MAX                          11
+#define READ_IQ_METADATA_STATUS                            12
+#define READ_IQ_METADATA_BUFFER_EN                         13
+#define READ_IQ_METADATA_RX_LENGTH                         14
+#define READ_IQ_METADATA_RSSI_COUNT                        15
+
+// Read IQ deferral defines
+//     NOTE:  With READ_IQ_FLAG_DEFER, a Read IQ request that arrives during a reception is parked on the
+//            node until the reception is done (or the deadline passes) instead of returning SAMPLE_IQ_NOT_READY.
+//            The deadline is in units of READ_IQ_DEFER_TIMEOUT_UNIT usec.
+//
+#define READ_IQ_FLAG_DEFER                                 0x01000000
+#define READ_IQ_DEFER_TIMEOUT_SHIFT                        16
+#define READ_IQ_DEFER_TIMEOUT_MASK                         0x00FF0000
+#define READ_IQ_DEFER_TIMEOUT_UNIT                         10000
+#define READ_IQ_DEFER_TIMEOUT_MAX                          255
+#define READ_IQ_DEFER_POLL_TIME                            50
+
+// Read IQ streaming defines
+//     NOTE:  With READ_IQ_FLAG_STREAM, the node sends each packet once the reception has captured its samples,
+//            so the first packet can take up to the capture time of the requested samples.
+//
+#define READ_IQ_STREAM_SAMPLES_PER_USEC                    40
+
+// Read IQ scheduling defines
+//     NOTE:  With READ_IQ_FLAG_SCHEDULE, the node waits for its transmit slot before sending the response
+//            (see 'read_iq_schedule' in wl_baseband_buffers.m).
+//
+#define READ_IQ_FLAG_SCHEDULE                              0x00008000
+
 // Sequence number defines
 #define SEQ_NUM_MATCH_IGNORE                               "ignore"
 #define SEQ_NUM_MATCH_WARNING                              "warning"
@@ -236,6 +456,9 @@ typedef struct
     wl_trans_data_pkt  *packet;             // Pointer to a data_packet
     uint32              rx_buffer_size;     // Rx buffer size of the socket
     uint32              tx_buffer_size;     // Tx buffer size of the socket
+    uint32              connected;          // Socket is connected to a node (see connect_socket())
+    uint32              rx_drops;           // Number of packets dropped by the OS because the Rx buffer was full
+    uint32              read_iq_req_size;   // Read IQ request size (in bytes) adapted to the drops (0 - not set)
 } wl_trans_socket;
 
 // WARPLAB Transport Header
@@ -276,6 +499,97 @@ typedef struct
     uint32             num_samples;    // Number of samples
 } wl_sample_tracker;
 
+// Transport packet trace entry
+typedef struct
+{
+    uint8              direction;      // TRANSPORT_TRACE_TX / TRANSPORT_TRACE_RX
+    uint8              socket;         // Index in to socket structure
+    uint16             retry;          // Retry count of the transfer when the packet was sent / received
+    uint32             length;         // Length of the packet (in bytes)
+    uint32             sample;         // Starting sample of the packet (TRANSPORT_TRACE_NO_SAMPLE if not a sample packet)
+    double             kernel_time;    // Time the OS received the packet (in sec; 0 if not supported)
+    double             host_time;      // Time the packet was sent / read by the transport (in sec)
+} wl_trace_entry;
+
+// Transport impairment queue entry (received packet held back by the impairment layer)
+typedef struct
+{
+    int                socket;         // Index in to socket structure (-1 if the entry is free)
+    uint32             seq;            // Order the packets were received in
+    uint32             skip;           // Number of later packets that are delivered before this packet
+    double             release_time;   // Time the packet can be delivered (in sec)
+    double             kernel_time;    // Time the OS received the packet (in sec; 0 if not supported)
+    struct sockaddr_in address;        // Address of the node
+    int                length;         // Length of the packet (in bytes)
+    char               data[TRANSPORT_MAX_PKT_LENGTH];
+} wl_impair_entry;
+
+// Read IQ decode slot (packet received by the receive thread and decoded by a decode thread)
+typedef struct
+{
+    uint32             state;          // TRANSPORT_DECODE_SLOT_*
+    uint8             *data;           // Packet buffer
+    uint8             *scratch;        // Buffer to expand compressed samples
+    uint8             *samples;        // Samples in the packet buffer
+    uint8              sample_flags;   // Sample header flags
+    uint32             sample_num;     // Index of the first sample in the output column
+    uint32             sample_size;    // Number of samples
+    void              *column_array[2];// Output columns
+} wl_decode_slot;
+
+// Read IQ decode thread pool
+typedef struct
+{
+    uint32             initialized;    // Lock / conditions are initialized
+    uint32             num_threads;    // Number of decode threads running
+    uint32             stop;           // Decode threads must exit
+    wl_thread_t        threads[TRANSPORT_DECODE_MAX_THREADS];
+    wl_mutex_t         lock;           // Protects all fields below and the slot states
+    wl_cond_t          work;           // Signaled when a slot is ready (or the threads must exit)
+    wl_cond_t          done;           // Signaled when a slot is decoded
+    wl_decode_slot    *slots;          // Slots of the current Read IQ request (NULL if none)
+    uint32             num_slots;      // Number of slots
+    uint32             num_pending;    // Number of slots that are ready / being decoded
+    uint32             function;       // TRANSPORT_READ_IQ / TRANSPORT_READ_RSSI
+    uint32             data_type;      // IQ_DATA_TYPE_*
+    int                status;         // First decode error of the current request
+} wl_decode_pool;
+
+// Read IQ of one node in a multi-node read (see wl_read_iq_nodes())
+typedef struct
+{
+    int                index;          // Index in to socket structure
+    char              *buffer;         // Read IQ request packet
+    int                length;         // Length of the request packet
+    char              *ip_addr;        // IP address of the node
+    int                port;           // Port of the node
+    uint32            *buffer_ids;     // Buffers to read (one output column each)
+    uint32             num_buffers;    // Number of buffers
+    uint32             max_length;     // Max number of bytes of samples per packet (as 32-bit samples)
+    uint32             pkt_length;     // Max number of bytes of samples per packet on the wire
+    uint32             num_pkts;       // Number of packets it takes to read a buffer
+    uint32             flags;          // Read IQ options of the requests (READ_IQ_FLAG_*)
+    uint32            *seq_num_tracker;// Sequence number tracker of the node
+    char              *seq_num_severity;// Severity of response to sequence number match
+    char              *node_id_str;    // Node string ID
+    void              *output_array[2];// First output column of the node
+    uint32             column;         // Buffer (ie output column) of the current request
+    uint32             next_sample;    // First sample of the column that has not been requested
+    uint32             req_start;      // Starting sample of the current request
+    uint32             req_samples;    // Number of samples of the current request
+    uint32             req_pkts;       // Number of packets of the current request
+    uint32             rcvd_pkts;      // Number of packets of the current request received
+    uint32             num_retrys;     // Number of times the current request was sent again after a timeout
+    uint32             num_iq_retrys;  // Number of times the current request was sent again for a busy node
+    uint32             not_ready;      // The node was busy; the request is sent again at the deadline
+    uint32             rx_drops;       // Drop count of the socket when the current request was sent
+    uint32             num_cmds;       // Number of requests sent to the node
+    uint32             seq_num;        // Sequence number of the current buffer
+    uint32             done;           // All buffers of the node are read
+    double             deadline;       // Time the current request is sent again without a packet (in sec)
+    wl_sample_tracker *tracker;        // Packets received for the current request
+} wl_read_iq_node;
+
 
 typedef int (*wl_function_ptr_t)();
 
@@ -298,10 +612,68 @@ static uint32    user_read_iq_max_req_size       = 0;
 // Global variable to suppress Read IQ / Write IQ warnings
 static uint32    suppress_iq_warnings            = 0;
 
+// Global variable to allow M control of multi-buffer Read IQ requests
+static uint32    read_iq_multi_buffer            = READ_IQ_MULTI_BUFFER_DISABLED;
+
+// Global variable to allow M control of streaming Read IQ requests
+static uint32    read_iq_stream                  = 0;
+
+// Global variables to allow M control of compressed Read IQ requests and to track the compression ratio
+static uint32    read_iq_compression             = READ_IQ_COMPRESSION_NONE;
+static double    read_iq_raw_bytes               = 0;
+static double    read_iq_wire_bytes              = 0;
+
+// Global variable to count Read IQ requests sent again after a timeout (see wl_read_iq_adapt_req_size())
+static uint32    read_iq_num_retrys              = 0;
+
+// Global variable to allow M control of the Read IQ start sample reference
+static uint32    read_iq_window                  = READ_IQ_WINDOW_ABSOLUTE;
+
+// Global variables to allow M control of Read IQ capture metadata and to hold the metadata of the last Read IQ call
+//     NOTE:  The metadata of the buffer with index i (ie BUFFER_ID_RFA << i) is in read_iq_metadata[i]
+//
+static uint32    read_iq_metadata_en             = 0;
+static uint32    read_iq_metadata_valid          = 0;
+static uint32    read_iq_metadata[TRANSPORT_WARP_RF_BUFFER_MAX][READ_IQ_METADATA_WORDS];
+
+// Global variable to allow M control of deferred Read IQ requests (deadline in READ_IQ_DEFER_TIMEOUT_UNIT usec; 0 - disabled)
+static uint32    read_iq_defer_timeout           = 0;
+
+// Global variable to allow M control of scheduled Read IQ requests (maximum wait for the slot in usec; 0 - disabled)
+static uint32    read_iq_schedule_wait           = 0;
+
 // Global variables for Read / Write IQ IDs
 static uint8     sample_read_iq_id               = 0;
 static uint8     sample_write_iq_id              = 0;
 
+// Global variables for the packet trace (ring of trace_size entries; trace_count is the total number of packets recorded)
+static wl_trace_entry * trace_ring               = NULL;
+static uint32    trace_size                      = 0;
+static uint32    trace_count                     = 0;
+
+// Global variable for the packet capture file (NULL - disabled)
+static FILE    * capture_fp                      = NULL;
+
+// Global variables for the impairment layer (see wl_impair_tx() / wl_impair_rx())
+//     NOTE:  impair_loss is [p_loss, -, -, -] for Bernoulli loss and [p_good_to_bad, p_bad_to_good, p_loss_good, p_loss_bad] for Gilbert-Elliott loss
+//
+static uint32    impair_direction                = 0;
+static uint32    impair_loss_model               = TRANSPORT_IMPAIR_LOSS_BERNOULLI;
+static double    impair_loss[4]                  = {0, 0, 0, 0};
+static uint32    impair_loss_state[2]            = {TRANSPORT_IMPAIR_STATE_GOOD, TRANSPORT_IMPAIR_STATE_GOOD};
+static double    impair_reorder_prob             = 0;
+static uint32    impair_reorder_depth            = 0;
+static double    impair_duplicate                = 0;
+static double    impair_delay                    = 0;
+static uint32    impair_rng_state                = TRANSPORT_IMPAIR_DEFAULT_SEED;
+static uint32    impair_seq                      = 0;
+static uint32    impair_stats[TRANSPORT_IMPAIR_NUM_STATS];
+static wl_impair_entry * impair_queue            = NULL;
+
+// Global variables to allow M control of the number of Read IQ decode threads and for the thread pool
+static uint32    read_iq_decode_threads          = TRANSPORT_DECODE_THREADS_AUTO;
+static wl_decode_pool decode_pool;
+
 
 #ifdef WIN32
 WSADATA          wsaData;              // Structure for WinSock setup communication 
@@ -321,11 +693,15 @@ int          init_socket( void );
 void         set_so_timeout( int index, int value );
 void         set_reuse_address( int index, int value );
 void         set_broadcast( int index, int value );
+void         set_rx_drop_count( int index );
+void         set_rx_timestamp( int index, int value );
 void         set_send_buffer_size( int index, int size );
 int          get_send_buffer_size( int index );
 void         set_receive_buffer_size( int index, int size );
 int          get_receive_buffer_size( int index );
 void         close_socket( int index );
+void         connect_socket( int index, char *ip_addr, int port );
+char       * get_ip_addr( int index, const mxArray *ip_addr );
 int          send_socket( int index, char *buffer, int length, char *ip_addr, int port );
 int          receive_socket( int index, int length, char * buffer );
 
@@ -344,6 +720,7 @@ unsigned int find_transport_function( char *input, unsigned int len );
 
 uint16       endian_swap_16(uint16 value);
 uint32       endian_swap_32(uint32 value);
+uint32       wl_sample_to_wire(uint32 byte_order, uint32 value);
 
 unsigned int wl_update_checksum(unsigned short int newdata, unsigned char reset );
 uint32       wl_compute_sample_wait_time(uint32 * command_args);
@@ -351,11 +728,45 @@ uint32       wl_compute_sample_wait_time(uint32 * command_args);
 int          wl_read_iq_sample_error( wl_sample_tracker *tracker, uint32 num_samples, uint32 start_sample, uint32 num_pkts, uint32 max_sample_size );
 int          wl_read_iq_find_error( wl_sample_tracker *tracker, uint32 num_samples, uint32 start_sample, uint32 num_pkts, uint32 max_sample_size,
                                     uint32 *ret_num_samples, uint32 *ret_start_sample, uint32 *ret_num_pkts );
+uint32       wl_read_iq_setup_retry( wl_sample_tracker *tracker, uint32 *rcvd_pkts, uint32 *buffer_ids, uint32 num_buffers, uint32 retry_columns,
+                                     uint32 num_samples, uint32 start_sample, uint32 num_pkts, uint32 max_sample_size,
+                                     uint32 *ret_num_samples, uint32 *ret_start_sample, uint32 *ret_num_pkts );
+void         wl_read_iq_setup_metadata_retry( uint32 *command_args, uint32 buffer_id_cmd, uint32 start_sample, uint32 num_samples );
+uint32       wl_read_iq_compress_size( uint32 compression, uint32 num_samples, uint32 *max_length, uint32 *num_pkts );
+void         wl_read_iq_decompress( uint8 sample_flags, uint8 *src, uint32 num_samples, uint8 *dest );
+void         wl_read_iq_merge_metadata( uint8 *src, uint32 num_bytes );
+int          wl_read_iq_decode( uint32 function, uint32 data_type, uint8 sample_flags, uint8 *samples, uint32 sample_num,
+                                uint32 sample_size, void **column_array, uint8 *scratch );
+void         wl_read_iq_decode_check( int status );
+uint32       wl_num_cores( void );
+wl_thread_return_t wl_decode_thread( void *arg );
+uint32       wl_decode_pool_start( void );
+void         wl_decode_pool_stop( void );
+void         wl_decode_pool_attach( wl_decode_slot *slots, uint32 num_slots, uint32 function, uint32 data_type );
+int          wl_decode_pool_get_slot( void );
+void         wl_decode_pool_submit( int slot );
+int          wl_decode_pool_finish( void );
+mxArray    * wl_read_iq_get_metadata( void );
 
 uint32       wl_compute_write_wait_time(uint32 hw_ver, uint32 buffer_id, uint32 max_samples);
 uint32       wl_process_write_iq_response(uint32 * command_args, uint32 sample_iq_id, uint32 checksum, uint32 iq_ready_warn);
 
 void         wl_update_seq_num(uint32 function, uint32 buffer_id, uint32 seq_num, uint32 *seq_num_tracker);
+
+uint32       wl_read_iq_adapt_req_size( int index, uint32 max_length, uint32 num_retrys, uint32 rx_drops );
+double       wl_trace_host_time( void );
+void         wl_trace_set_size( uint32 size );
+void         wl_trace_record( int index, uint32 direction, uint32 length, double kernel_time );
+void         wl_trace_annotate( uint32 sample, uint32 retry );
+mxArray    * wl_trace_get( char *filename );
+void         wl_capture_open( char *filename );
+void         wl_capture_record( int index, uint32 direction, char *buffer, int length, struct sockaddr_in *remote, double time );
+void         wl_impair_set( uint32 direction, const mxArray *loss, const mxArray *reorder, double duplicate, double delay, uint32 seed );
+mxArray    * wl_impair_get_stats( void );
+double       wl_impair_rand( void );
+uint32       wl_impair_lose( uint32 direction );
+uint32       wl_impair_tx( void );
+int          wl_impair_rx( int index, char *buffer, int size, int length, struct sockaddr_in *address, double *kernel_time );
 void         wl_check_seq_num(uint32 function, char * node_id_str, uint32 buffer_id, uint32 seq_num, uint32 *seq_num_tracker, char *seq_num_severity);
 
 #ifdef WIN32
@@ -368,14 +779,25 @@ uint32       wl_mex_udp_transport_usec_timestamp();
 
 // WARPLab Functions
 int          wl_read_baseband_buffer( int index, char *buffer, int length, char *ip_addr, int port,
-                                      uint32 initial_offset, uint32 num_samples, uint32 start_sample, uint32 buffer_id, 
-                                      uint32 function, uint32 data_type,
+                                      uint32 initial_offset, uint32 num_samples, uint32 start_sample, uint32 *buffer_ids, uint32 num_buffers,
+                                      uint32 function, uint32 data_type, uint32 column_size,
                                       void **output_array, uint32 *num_cmds, uint32 *seq_num );
 
+void         wl_read_iq_nodes( wl_read_iq_node *nodes, uint32 num_nodes, uint32 num_samples, uint32 start_sample,
+                               uint32 data_type, uint32 column_size );
+void         wl_read_iq_node_request( wl_read_iq_node *node, uint32 num_samples, uint32 start_sample );
+void         wl_read_iq_node_retry( wl_read_iq_node *node );
+void         wl_read_iq_node_send( wl_read_iq_node *node );
+
 int          wl_write_baseband_buffer( int index, char *buffer, int max_length, char *ip_addr, int port,
                                        uint32 num_samples, uint32 start_sample, const void *samples, uint32 buffer_id, uint32 num_pkts, 
-                                       uint32 max_samples, uint32 hw_ver, uint32 check_chksum, uint32 data_type, uint32 iteration,
-                                       uint32 *num_cmds, uint32 *checksum );
+                                       uint32 max_samples, uint32 hw_ver, uint32 check_chksum, uint32 data_type, uint32 byte_order,
+                                       uint32 iteration, uint32 *num_cmds, uint32 *checksum );
+
+int          wl_send_cmd( int index, char *ip_addr, int port, uint32 *hdr_fields, uint32 *payload, uint32 payload_words,
+                          uint32 robust, uint32 max_attempts, double timeout, uint32 *resp, uint32 max_resp_words );
+
+int          wl_decode_resp( char *buffer, int length, uint32 *hdr_fields, uint32 accept_not_ready, uint32 *resp, uint32 max_resp_words );
 
 /******************************** Functions **********************************/
 
@@ -408,6 +830,9 @@ void init_wl_mex_udp_transport( void ) {
         sockets[i].packet         = NULL;
         sockets[i].rx_buffer_size = 0;
         sockets[i].tx_buffer_size = 0;
+        sockets[i].connected      = 0;
+        sockets[i].rx_drops       = 0;
+        sockets[i].read_iq_req_size = 0;
     }
 
 #ifdef WIN32
@@ -458,6 +883,12 @@ int init_socket( void ) {
     set_reuse_address( i, 1 );
     set_broadcast( i, 1 );
     
+    // Have the OS report the number of dropped packets (if supported)
+    set_rx_drop_count( i );
+    
+    // Have the OS timestamp received packets if the packet trace / capture is enabled
+    set_rx_timestamp( i, ( ( trace_size != 0 ) || ( capture_fp != NULL ) ) );
+    
     // Set the buffer sizes for all sockets
     get_send_buffer_size(i);
     get_receive_buffer_size(i);
@@ -522,6 +953,44 @@ void set_broadcast( int index, int value ) {
 }
 
 
+/*****************************************************************************/
+/**
+*  Function:  set_rx_drop_count
+*
+*  Enables the SO_RXQ_OVFL option on the socket so that each received packet
+*  carries the number of packets the OS dropped because the receive buffer was
+*  full (see receive_socket()).  Not all OSes support this option; the drop count
+*  then stays 0.
+*
+******************************************************************************/
+void set_rx_drop_count( int index ) {
+#ifdef SO_RXQ_OVFL
+    int optval = 1;
+
+    setsockopt( sockets[index].handle, SOL_SOCKET, SO_RXQ_OVFL, (const char *)&optval, sizeof(optval) );
+#endif
+}
+
+
+/*****************************************************************************/
+/**
+*  Function:  set_rx_timestamp
+*
+*  Sets the SO_TIMESTAMPNS option on the socket so that each received packet
+*  carries the time the OS received it (see receive_socket()).  This is only
+*  used by the packet trace / capture.  Not all OSes support this option; the
+*  kernel time in the trace then stays 0 and the capture uses the host time.
+*
+******************************************************************************/
+void set_rx_timestamp( int index, int value ) {
+#if defined(SO_TIMESTAMPNS) && defined(SO_RXQ_OVFL)
+    int optval = ( value ) ? 1 : 0;
+
+    setsockopt( sockets[index].handle, SOL_SOCKET, SO_TIMESTAMPNS, (const char *)&optval, sizeof(optval) );
+#endif
+}
+
+
 /*****************************************************************************/
 /**
 *  Function:  set_send_buffer_size
@@ -543,6 +1012,17 @@ void set_send_buffer_size( int index, int size ) {
     } else {
         sockets[index].tx_buffer_size = optval;
     }
+
+#ifdef SO_SNDBUFFORCE
+    // If the OS limited the buffer size (ie net.core.wmem_max), then try to override the limit
+    //     NOTE:  This requires CAP_NET_ADMIN; otherwise the buffer size does not change
+    //
+    if ( sockets[index].tx_buffer_size < (uint32) size ) {
+        optval = size;
+        setsockopt( sockets[index].handle, SOL_SOCKET, SO_SNDBUFFORCE, (const char *)&optval, sizeof(optval) );
+        get_send_buffer_size( index );
+    }
+#endif
 }
 
 
@@ -594,6 +1074,20 @@ void set_receive_buffer_size( int index, int size ) {
     } else {
         sockets[index].rx_buffer_size = optval;
     }
+
+#ifdef SO_RCVBUFFORCE
+    // If the OS limited the buffer size (ie net.core.rmem_max), then try to override the limit
+    //     NOTE:  This requires CAP_NET_ADMIN; otherwise the buffer size does not change
+    //
+    if ( sockets[index].rx_buffer_size < (uint32) size ) {
+        optval = size;
+        setsockopt( sockets[index].handle, SOL_SOCKET, SO_RCVBUFFORCE, (const char *)&optval, sizeof(optval) );
+        get_receive_buffer_size( index );
+    }
+#endif
+
+    // Start the Read IQ request size again from the new buffer size
+    sockets[index].read_iq_req_size = 0;
 }
 
 
@@ -632,6 +1126,7 @@ int get_receive_buffer_size( int index ) {
 *
 ******************************************************************************/
 void close_socket( int index ) {
+    int i;
 
 #ifdef _DEBUG_
     printf("Close Socket: %d\n", index);
@@ -653,6 +1148,68 @@ void close_socket( int index ) {
     sockets[index].packet         = NULL;
     sockets[index].rx_buffer_size = 0;
     sockets[index].tx_buffer_size = 0;
+    sockets[index].connected      = 0;
+    sockets[index].rx_drops       = 0;
+    sockets[index].read_iq_req_size = 0;
+    
+    // Drop any packets of the socket held back by the impairment layer
+    if ( impair_queue != NULL ) {
+        for ( i = 0; i < TRANSPORT_IMPAIR_QUEUE_SIZE; i++ ) {
+            if ( impair_queue[i].socket == index ) { impair_queue[i].socket = -1; }
+        }
+    }
+}
+
+
+/*****************************************************************************/
+/**
+*  Function:  connect_socket
+*
+*  Connects the socket to the IP address / Port of a node.  The kernel then only
+*  delivers packets from the node to the socket, and sends do not need an address.
+*
+******************************************************************************/
+void connect_socket( int index, char *ip_addr, int port ) {
+
+    struct sockaddr_in socket_addr;  // Socket address
+
+    // Construct the address structure
+    memset( &socket_addr, 0, sizeof(socket_addr) );        // Zero out structure 
+    socket_addr.sin_family      = AF_INET;                 // Internet address family
+    socket_addr.sin_addr.s_addr = inet_addr(ip_addr);      // IP address 
+    socket_addr.sin_port        = htons(port);             // Port 
+
+    if ( connect( sockets[index].handle, (struct sockaddr *) &socket_addr, sizeof(socket_addr) ) != 0 ) {
+        die_with_error("Error:  Could not connect socket.");
+    }
+    
+    sockets[index].connected = 1;
+}
+
+
+/*****************************************************************************/
+/**
+*  Function:  get_ip_addr
+*
+*  Returns the IP address argument as a string.  For a connected socket, the
+*  argument is not used (ie it can be empty) and NULL is returned.
+*
+******************************************************************************/
+char * get_ip_addr( int index, const mxArray *ip_addr ) {
+
+    char  *ret_val;
+    
+    if ( sockets[index].connected ) {
+        return NULL;
+    }
+
+    // IP address input must be a string 
+    if ( mxIsChar( ip_addr ) != 1 ) { mexErrMsgTxt("Error: Input IP address must be a string."); }
+    if ( mxGetM( ip_addr ) != 1 ) { mexErrMsgTxt("Error: Input IP address must be a row vector."); }
+    ret_val = mxArrayToString( ip_addr );
+    if( ret_val == NULL ) { mexErrMsgTxt("Error:  Could not convert input IP address to string."); }
+    
+    return ret_val;
 }
 
 
@@ -668,12 +1225,17 @@ int send_socket( int index, char *buffer, int length, char *ip_addr, int port )
     struct sockaddr_in socket_addr;  // Socket address
     int                length_sent;
     int                size;
+    uint32             num_copies      = 1;
 
     // Construct the address structure
-    memset( &socket_addr, 0, sizeof(socket_addr) );        // Zero out structure 
-    socket_addr.sin_family      = AF_INET;                 // Internet address family
-    socket_addr.sin_addr.s_addr = inet_addr(ip_addr);      // IP address 
-    socket_addr.sin_port        = htons(port);             // Port 
+    //     NOTE:  A connected socket already has the address of the node
+    //
+    if ( !sockets[index].connected ) {
+        memset( &socket_addr, 0, sizeof(socket_addr) );        // Zero out structure 
+        socket_addr.sin_family      = AF_INET;                 // Internet address family
+        socket_addr.sin_addr.s_addr = inet_addr(ip_addr);      // IP address 
+        socket_addr.sin_port        = htons(port);             // Port 
+    }
 
     // If we are sending a large amount of data, we need to make sure the entire 
     // buffer has been sent.
@@ -685,6 +1247,15 @@ int send_socket( int index, char *buffer, int length, char *ip_addr, int port )
         return length_sent;
     }
 
+    // Apply the impairments to the packet (see wl_impair_tx())
+    //     NOTE:  A lost packet is reported as sent
+    //
+    if ( impair_direction & TRANSPORT_IMPAIR_TX ) {
+        num_copies = wl_impair_tx();
+        
+        if ( num_copies == 0 ) { return length; }
+    }
+
     while ( length_sent < length ) {
     
         // If we did not send more than MIN_SEND_SIZE, then wait a bit
@@ -693,8 +1264,12 @@ int send_socket( int index, char *buffer, int length, char *ip_addr, int port )
         }
 
         // Send as much data as possible to the address
-        size = sendto( sockets[index].handle, &buffer[length_sent], (length - length_sent), 0, 
-                      (struct sockaddr *) &socket_addr, sizeof(socket_addr) );
+        if ( sockets[index].connected ) {
+            size = send( sockets[index].handle, &buffer[length_sent], (length - length_sent), 0 );
+        } else {
+            size = sendto( sockets[index].handle, &buffer[length_sent], (length - length_sent), 0, 
+                          (struct sockaddr *) &socket_addr, sizeof(socket_addr) );
+        }
 
         // Check the return value    
         if ( size == SOCKET_ERROR )  {
@@ -707,6 +1282,16 @@ int send_socket( int index, char *buffer, int length, char *ip_addr, int port )
         } else {
             // Update how many bytes we sent
             length_sent += size;        
+            
+            // Record the packet in the trace / capture
+            if ( trace_size != 0 ) {
+                wl_trace_record( index, TRANSPORT_TRACE_TX, size, 0 );
+            }
+            
+            if ( capture_fp != NULL ) {
+                wl_capture_record( index, TRANSPORT_TRACE_TX, &buffer[length_sent - size], size, 
+                                   ( sockets[index].connected ? NULL : &socket_addr ), wl_trace_host_time() );
+            }
         }
 
         // TODO:  IMPLEMENT A TIMEOUT SO WE DONT GET STUCK HERE FOREVER
@@ -721,6 +1306,27 @@ int send_socket( int index, char *buffer, int length, char *ip_addr, int port )
         die_with_error("Error:  Size of packet sent does not match size of packet.  See above.");
     }
     
+    // Send the duplicate of the packet (best effort)
+    if ( num_copies > 1 ) {
+        if ( sockets[index].connected ) {
+            size = send( sockets[index].handle, buffer, length, 0 );
+        } else {
+            size = sendto( sockets[index].handle, buffer, length, 0, (struct sockaddr *) &socket_addr, sizeof(socket_addr) );
+        }
+        
+        // Record the duplicate in the trace / capture
+        if ( size > 0 ) {
+            if ( trace_size != 0 ) {
+                wl_trace_record( index, TRANSPORT_TRACE_TX, size, 0 );
+            }
+            
+            if ( capture_fp != NULL ) {
+                wl_capture_record( index, TRANSPORT_TRACE_TX, buffer, size, 
+                                   ( sockets[index].connected ? NULL : &socket_addr ), wl_trace_host_time() );
+            }
+        }
+    }
+    
     return length_sent;
 }
 
@@ -737,6 +1343,16 @@ int receive_socket( int index, int length, char * buffer ) {
     wl_trans_data_pkt  *pkt;           
     int                 size;
     int                 socket_addr_size = sizeof(struct sockaddr_in);
+    double              kernel_time      = 0;
+#ifdef SO_RXQ_OVFL
+    struct msghdr       msg;
+    struct iovec        iov;
+    struct cmsghdr     *cmsg;
+    char                control[CMSG_SPACE(sizeof(uint32)) + CMSG_SPACE(sizeof(struct timespec))];
+#ifdef SO_TIMESTAMPNS
+    struct timespec     ts;
+#endif
+#endif
     
     // Allocate a packet in memory if necessary
     if ( sockets[index].packet == NULL ) {
@@ -760,13 +1376,54 @@ int receive_socket( int index, int length, char * buffer ) {
     }
 
     // Receive a response 
+#ifdef SO_RXQ_OVFL
+    //     NOTE:  The drop count of the socket is sent with each packet as control data (see set_rx_drop_count())
+    //
+    memset( &msg, 0, sizeof(msg) );
+    
+    iov.iov_base       = buffer;
+    iov.iov_len        = length;
+    msg.msg_name       = &(pkt->address);
+    msg.msg_namelen    = socket_addr_size;
+    msg.msg_iov        = &iov;
+    msg.msg_iovlen     = 1;
+    msg.msg_control    = control;
+    msg.msg_controllen = sizeof(control);
+
+    size = recvmsg( sockets[index].handle, &msg, 0 );
+    
+    if ( size > 0 ) {
+        for ( cmsg = CMSG_FIRSTHDR(&msg); cmsg != NULL; cmsg = CMSG_NXTHDR(&msg, cmsg) ) {
+            if ( ( cmsg->cmsg_level == SOL_SOCKET ) && ( cmsg->cmsg_type == SO_RXQ_OVFL ) ) {
+                memcpy( &(sockets[index].rx_drops), CMSG_DATA(cmsg), sizeof(uint32) );
+            }
+#ifdef SO_TIMESTAMPNS
+            if ( ( cmsg->cmsg_level == SOL_SOCKET ) && ( cmsg->cmsg_type == SCM_TIMESTAMPNS ) ) {
+                memcpy( &ts, CMSG_DATA(cmsg), sizeof(struct timespec) );
+                kernel_time = (double) ts.tv_sec + ( (double) ts.tv_nsec * 1e-9 );
+            }
+#endif
+        }
+    }
+#else
     size = recvfrom( sockets[index].handle, buffer, length, 0, 
                     (struct sockaddr *) &(pkt->address), (socklen_t *) &socket_addr_size );
+#endif
+
+    // Apply the impairments to the received packet (see wl_impair_rx())
+    //     NOTE:  The packet is queued and the next queued packet that is due (if any) is returned instead
+    //
+    if ( impair_direction & TRANSPORT_IMPAIR_RX ) {
+        size = wl_impair_rx( index, buffer, size, length, &(pkt->address), &kernel_time );
+    }
 
 
     // Check on error conditions
+    //     NOTE:  A connected socket reports an ICMP port unreachable from the node (eg the node is not
+    //            running yet) as an error.  This is treated the same as no packet so the command times out.
+    //
     if ( size == SOCKET_ERROR )  {
-        if ( get_last_error != EWOULDBLOCK ) {
+        if ( ( get_last_error != EWOULDBLOCK ) && ( !sockets[index].connected || ( get_last_error != ECONNREFUSED ) ) ) {
             die_with_error("Error:  Socket Error.");
         } else {
             // If the socket is not ready, then just return a size of 0 so the function can be 
@@ -779,6 +1436,18 @@ int receive_socket( int index, int length, char * buffer ) {
         //   NOTE:  pkt.address was updated via the function call
         pkt->buf     = buffer;
         pkt->offset  = 0;
+        
+        // Record the packet in the trace / capture
+        //     NOTE:  There is no packet if the impairments held back the received packet (size is 0)
+        //
+        if ( ( trace_size != 0 ) && ( size > 0 ) ) {
+            wl_trace_record( index, TRANSPORT_TRACE_RX, size, kernel_time );
+        }
+        
+        if ( ( capture_fp != NULL ) && ( size > 0 ) ) {
+            wl_capture_record( index, TRANSPORT_TRACE_RX, buffer, size, &(pkt->address),
+                               ( ( kernel_time != 0 ) ? kernel_time : wl_trace_host_time() ) );
+        }
     }
 
     // Update the packet length so we can determine when we need to zero out pkt.address
@@ -804,6 +1473,11 @@ void cleanup( void ) {
     for ( i = 0; i < TRANSPORT_MAX_SOCKETS; i++ ) {
         if ( sockets[i].handle != INVALID_SOCKET ) {  close_socket( i ); }    
     }
+    
+    // Free the packet trace, close the packet capture and stop the decode threads
+    wl_trace_set_size( 0 );
+    wl_capture_open( NULL );
+    wl_decode_pool_stop();
 
 #ifdef WIN32
     WSACleanup();  // Cleanup Winsock 
@@ -848,6 +1522,14 @@ void print_usage( ) {
     printf("    8.                  wl_mex_udp_transport('close', index) \n");
     printf("    9. size           = wl_mex_udp_transport('send', index, buffer, length, ip_addr, port) \n");
     printf("   10. [size, buffer] = wl_mex_udp_transport('receive', index, length ) \n");
+    printf("   11.                  wl_mex_udp_transport('connect', index, ip_addr, port) \n");
+    printf("   12. [drops, size]  = wl_mex_udp_transport('get_rx_drops', index) \n");
+    printf("   13.                  wl_mex_udp_transport('set_trace', num_entries) \n");
+    printf("   14. trace          = wl_mex_udp_transport('get_trace' [, filename]) \n");
+    printf("   15.                  wl_mex_udp_transport('set_capture', filename) \n");
+    printf("   16.                  wl_mex_udp_transport('set_impairment', direction, loss, reorder, \n");
+    printf("                                                duplicate, delay, seed) \n");
+    printf("   17. stats          = wl_mex_udp_transport('get_impairment_stats') \n");
     printf("\n");
     printf("Additional WARPLab MEX UDP transport functions: \n");
     printf("    1. [num_samples, cmds_used, samples]  = wl_mex_udp_transport('read_rssi' / 'read_iq', \n");
@@ -858,10 +1540,26 @@ void print_usage( ) {
     printf("                                                index, cmd_buffer, max_length, ip_addr, port, \n");
     printf("                                                number_samples, sample_buffer, buffer_id, \n");
     printf("                                                start_sample, num_pkts, max_samples, hw_ver, \n");
-    printf("                                                check_chksum) \n");
+    printf("                                                check_chksum, data_type [, byte_order]) \n");
     printf("    3.                = wl_mex_udp_transport('write_iq_set_pkt_wait_time', wait_time) \n");
     printf("    4.                = wl_mex_udp_transport('read_iq_set_max_request_size', size) \n");
     printf("    5.                = wl_mex_udp_transport('suppress_iq_warnings') \n");
+    printf("    6.                = wl_mex_udp_transport('read_iq_set_multi_buffer', mode) \n");
+    printf("    7.                = wl_mex_udp_transport('read_iq_set_stream', enable) \n");
+    printf("    8.                = wl_mex_udp_transport('read_iq_set_compression', mode) \n");
+    printf("    9. ratio          = wl_mex_udp_transport('read_iq_get_compression_ratio') \n");
+    printf("   10.                = wl_mex_udp_transport('read_iq_set_window', reference) \n");
+    printf("   11.                = wl_mex_udp_transport('read_iq_set_metadata', enable) \n");
+    printf("   12. metadata       = wl_mex_udp_transport('read_iq_get_metadata') \n");
+    printf("   13.                = wl_mex_udp_transport('read_iq_set_defer', timeout) \n");
+    printf("   14.                = wl_mex_udp_transport('read_iq_set_schedule', max_wait) \n");
+    printf("   15. [num_samples, cmds_used, samples]  = wl_mex_udp_transport('trigger_and_read', \n");
+    printf("                                                trig_index, trig_buffer, trig_ip_addr, trig_port, \n");
+    printf("                                                wait_time, read_args) \n");
+    printf("   16. resp           = wl_mex_udp_transport('send_cmd', index, ip_addr, port, hdr_fields, \n");
+    printf("                                                payload, robust, max_attempts, timeout) \n");
+    printf("   17. resp           = wl_mex_udp_transport('receive_resp', index, hdr_fields) \n");
+    printf("   18.                = wl_mex_udp_transport('read_iq_set_decode_threads', num_threads) \n");
     printf("\n");
     printf("See documentation for further details.\n");
     printf("\n");
@@ -876,6 +1574,9 @@ void print_usage( ) {
 *
 ******************************************************************************/
 void die( ) {
+    // Make sure the decode threads are done with the output arrays before MATLAB frees them
+    wl_decode_pool_finish();
+    
     mexErrMsgTxt("Error:  See description above.");
 }
 
@@ -1014,6 +1715,20 @@ uint32 endian_swap_32(uint32 value) {
 }
 
 
+/*****************************************************************************/
+/**
+*  Function:  wl_sample_to_wire
+*
+* This function will convert a 32-bit sample to the given byte order of the wire
+* (SAMPLE_BYTE_ORDER_*)
+*
+******************************************************************************/
+uint32 wl_sample_to_wire(uint32 byte_order, uint32 value) {
+
+    return ( byte_order == SAMPLE_BYTE_ORDER_LITTLE ) ? value : endian_swap_32( value );
+}
+
+
 /*****************************************************************************/
 /**
 *  Function:  convert_to_uppercase
@@ -1067,6 +1782,26 @@ unsigned int find_transport_function( char *input, unsigned int len ) {
     if ( !strcmp( uppercase, "WRITE_IQ_SET_PKT_WAIT_TIME"   ) && ( function == 0xFFFF ) ) { function = TRANSPORT_WRITE_IQ_SET_PKT_WAIT_TIME;   }
     if ( !strcmp( uppercase, "READ_IQ_SET_MAX_REQUEST_SIZE" ) && ( function == 0xFFFF ) ) { function = TRANSPORT_READ_IQ_SET_MAX_REQUEST_SIZE; }
     if ( !strcmp( uppercase, "SUPPRESS_IQ_WARNINGS"         ) && ( function == 0xFFFF ) ) { function = TRANSPORT_SUPPRESS_IQ_WARNINGS;         }
+    if ( !strcmp( uppercase, "READ_IQ_SET_MULTI_BUFFER"     ) && ( function == 0xFFFF ) ) { function = TRANSPORT_READ_IQ_SET_MULTI_BUFFER;     }
+    if ( !strcmp( uppercase, "READ_IQ_SET_STREAM"           ) && ( function == 0xFFFF ) ) { function = TRANSPORT_READ_IQ_SET_STREAM;           }
+    if ( !strcmp( uppercase, "READ_IQ_SET_COMPRESSION"      ) && ( function == 0xFFFF ) ) { function = TRANSPORT_READ_IQ_SET_COMPRESSION;      }
+    if ( !strcmp( uppercase, "READ_IQ_GET_COMPRESSION_RATIO") && ( function == 0xFFFF ) ) { function = TRANSPORT_READ_IQ_GET_COMPRESSION_RATIO;}
+    if ( !strcmp( uppercase, "READ_IQ_SET_WINDOW"           ) && ( function == 0xFFFF ) ) { function = TRANSPORT_READ_IQ_SET_WINDOW;           }
+    if ( !strcmp( uppercase, "READ_IQ_SET_METADATA"         ) && ( function == 0xFFFF ) ) { function = TRANSPORT_READ_IQ_SET_METADATA;         }
+    if ( !strcmp( uppercase, "READ_IQ_GET_METADATA"         ) && ( function == 0xFFFF ) ) { function = TRANSPORT_READ_IQ_GET_METADATA;         }
+    if ( !strcmp( uppercase, "READ_IQ_SET_DEFER"            ) && ( function == 0xFFFF ) ) { function = TRANSPORT_READ_IQ_SET_DEFER;            }
+    if ( !strcmp( uppercase, "READ_IQ_SET_SCHEDULE"         ) && ( function == 0xFFFF ) ) { function = TRANSPORT_READ_IQ_SET_SCHEDULE;         }
+    if ( !strcmp( uppercase, "TRIGGER_AND_READ"             ) && ( function == 0xFFFF ) ) { function = TRANSPORT_TRIGGER_AND_READ;             }
+    if ( !strcmp( uppercase, "SEND_CMD"                     ) && ( function == 0xFFFF ) ) { function = TRANSPORT_SEND_CMD;                     }
+    if ( !strcmp( uppercase, "RECEIVE_RESP"                 ) && ( function == 0xFFFF ) ) { function = TRANSPORT_RECEIVE_RESP;                 }
+    if ( !strcmp( uppercase, "CONNECT"                      ) && ( function == 0xFFFF ) ) { function = TRANSPORT_CONNECT;                      }
+    if ( !strcmp( uppercase, "GET_RX_DROPS"                 ) && ( function == 0xFFFF ) ) { function = TRANSPORT_GET_RX_DROPS;                 }
+    if ( !strcmp( uppercase, "SET_TRACE"                    ) && ( function == 0xFFFF ) ) { function = TRANSPORT_SET_TRACE;                    }
+    if ( !strcmp( uppercase, "GET_TRACE"                    ) && ( function == 0xFFFF ) ) { function = TRANSPORT_GET_TRACE;                    }
+    if ( !strcmp( uppercase, "SET_CAPTURE"                  ) && ( function == 0xFFFF ) ) { function = TRANSPORT_SET_CAPTURE;                  }
+    if ( !strcmp( uppercase, "SET_IMPAIRMENT"               ) && ( function == 0xFFFF ) ) { function = TRANSPORT_SET_IMPAIRMENT;               }
+    if ( !strcmp( uppercase, "GET_IMPAIRMENT_STATS"         ) && ( function == 0xFFFF ) ) { function = TRANSPORT_GET_IMPAIRMENT_STATS;         }
+    if ( !strcmp( uppercase, "READ_IQ_SET_DECODE_THREADS"   ) && ( function == 0xFFFF ) ) { function = TRANSPORT_READ_IQ_SET_DECODE_THREADS;   }
 
     mxFree( uppercase );
     return function;
@@ -1118,6 +1853,7 @@ void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
     uint32         start_sample             = 0;
     uint32         num_pkts                 = 0;
     uint32         max_length               = 0;
+    uint32         pkt_length               = 0;
     uint32         num_cmds                 = 0;
     int            check_chksum             = 0;
     uint32         checksum                 = 0;
@@ -1130,13 +1866,23 @@ void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
     uint32         num_samples_to_request   = 0;
     uint32         num_pkts_to_request      = 0;
     uint32         useful_rx_buffer_size    = 0;
+    uint32         num_retrys               = 0;
+    uint32         rx_drops                 = 0;
     uint32        *command_args             = NULL;
+    uint32         buffer_mask              = 0;
+    uint32         read_iq_flags            = 0;
+    int            num_requests             = 0;
+    int            buffers_per_request      = 0;
+    int            duplicate_buffers        = 0;
+    uint32         tmp_length               = 0;
 
     uint32         data_type                = 0;
     uint32         data_size                = 0;
     uint32         mex_data_type            = 0;
+    uint32         byte_order               = SAMPLE_BYTE_ORDER_BIG;
 
     uint32         seq_num                  = 0;
+    uint32         seq_nums[TRANSPORT_WARP_RF_BUFFER_MAX];
     uint32        *seq_num_tracker          = NULL;
     char          *seq_num_severity         = NULL;
     
@@ -1148,6 +1894,24 @@ void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
     mwSize         ndim                     = (mwSize) 2;
     mwSize         dims[2];
     
+    int            num_nodes                = 0;
+    uint32         num_columns              = 0;
+    uint32         trigger_time             = 0;
+    uint32         elapsed_time             = 0;
+    double        *cmds_array               = NULL;
+    const mxArray *read_arg;
+    wl_read_iq_node *read_nodes             = NULL;
+    wl_read_iq_node *read_node              = NULL;
+    
+    uint32         hdr_fields[TRANSPORT_HDR_NUM_FIELDS];
+    uint32        *payload                  = NULL;
+    uint32         payload_words            = 0;
+    uint32         robust                   = 0;
+    uint32         max_attempts             = 0;
+    double         resp_timeout             = 0;
+    uint32         resp[TRANSPORT_MAX_PKT_LENGTH / 4];
+    int            resp_words               = 0;
+    
     
     
     //--------------------------------------------------------------------
@@ -1429,94 +2193,375 @@ void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
         break;
 
         //------------------------------------------------------
-        // size = wl_mex_udp_transport('send', handle, buffer, length, ip_addr, port)
+        // [drops, size] = wl_mex_udp_transport('get_rx_drops', handle)
         //   - Arguments:
         //     - handle (int)     - index to the requested socket
-        //     - buffer (char *)  - Buffer of data to be sent
-        //     - length (int)     - Length of data to be sent
-        //     - ip_addr          - IP Address to send data to
-        //     - port             - Port to send data to
         //   - Returns:
-        //     - size (int)       - size of data sent (in bytes)
-        case TRANSPORT_SEND :
+        //     - drops (int)      - number of packets dropped by the OS because the receive buffer was full
+        //                          (always 0 if the OS does not support SO_RXQ_OVFL)
+        //     - size (int)       - current Read IQ request size (in bytes)
+        case TRANSPORT_GET_RX_DROPS :
 #ifdef _DEBUG_
-            printf("Function : TRANSPORT_SEND\n");
+            printf("Function : TRANSPORT_GET_RX_DROPS\n");
 #endif
             // Validate arguments
-            if( nrhs != 6 ) { print_usage(); die(); }
-            if( nlhs != 1 ) { print_usage(); die(); }
+            if( nrhs != 2 ) { print_usage(); die(); }
+            if( nlhs != 2 ) { print_usage(); die(); }
             
             // Get input arguments
             handle  = (int) mxGetScalar(prhs[1]);
-            length  = (int) mxGetScalar(prhs[3]);
-            port    = (int) mxGetScalar(prhs[5]);
-            
-            // Input must be a string 
-            if ( mxIsChar( prhs[4] ) != 1 ) { mexErrMsgTxt("Error: Input must be a string."); }
-            if ( mxGetM( prhs[4] ) != 1 ) { mexErrMsgTxt("Error: Input must be a row vector."); }
-            ip_addr = mxArrayToString( prhs[4] );
-            if( ip_addr == NULL ) { mexErrMsgTxt("Error:  Could not convert input to string."); }
 
-#ifdef _DEBUG_
-            printf("index = %d, length = %d, port = %d, ip_addr = %s \n", handle, length, port, ip_addr);
-#endif
-           
-            // Input must be an array of uint8
-            if ( mxIsUint8( prhs[2] ) != 1 ) { mexErrMsgTxt("Error: Input must be an array of uint8"); }
-            if ( mxGetM( prhs[2] ) != 1 ) { mexErrMsgTxt("Error: Input must be a row vector."); }
-            buffer = (char *) mxGetData( prhs[2] );
-            if( buffer == NULL ) { mexErrMsgTxt("Error:  Could not convert input to array of char."); }
-            
-            // Call function
-            size = send_socket( handle, buffer, length, ip_addr, port );
-            
-            // Return value to MABLAB
+            // Return values to MABLAB
             plhs[0] = mxCreateDoubleMatrix(1,1,mxREAL);
-            *mxGetPr(plhs[0]) = size;
-
-            mxFree( ip_addr );
-
+            *mxGetPr(plhs[0]) = sockets[handle].rx_drops;
+            
+            plhs[1] = mxCreateDoubleMatrix(1,1,mxREAL);
+            *mxGetPr(plhs[1]) = sockets[handle].read_iq_req_size;
+        
 #ifdef _DEBUG_
-            print_buffer( buffer, length );
-            printf("END TRANSPORT_SEND \n");
+            printf("END TRANSPORT_GET_RX_DROPS \n");
 #endif
         break;
-        
+
         //------------------------------------------------------
-        // [size, buffer] = wl_mex_udp_transport('receive', handle, length )
+        // wl_mex_udp_transport('set_trace', num_entries)
         //   - Arguments:
-        //     - handle (int)     - index to the requested socket
-        //     - length (int)     - length of data to be received (in bytes)
+        //     - num_entries (int) - Number of packets kept in the trace ring (0 ==> Disabled)
         //   - Returns:
-        //     - buffer (char *)  - Buffer of data received
-        case TRANSPORT_RECEIVE :
-                        
+        //     - none
+        //
+        //   NOTE:  The trace records every packet sent / received on all sockets.  When the ring
+        //          is full, the oldest packets are overwritten.  Setting the size clears the trace.
+        //
+        case TRANSPORT_SET_TRACE :
 #ifdef _DEBUG_
-            printf("Function : TRANSPORT_RECEIVE\n");
+            printf("Function : TRANSPORT_SET_TRACE\n");
 #endif
             // Validate arguments
-            if( nrhs != 3 ) { print_usage(); die(); }
-            if( nlhs != 2 ) { print_usage(); die(); }
-
+            if( nrhs != 2 ) { print_usage(); die(); }
+            if( nlhs != 0 ) { print_usage(); die(); }
+            
             // Get input arguments
-            handle  = (int) mxGetScalar(prhs[1]);
-            length  = (int) mxGetScalar(prhs[2]);
+            size = (int) mxGetScalar(prhs[1]);
 
+            if ( ( size < 0 ) || ( size > TRANSPORT_TRACE_MAX_ENTRIES ) ) {
+                printf("Trace size must be between 0 and %d packets\n", TRANSPORT_TRACE_MAX_ENTRIES);
+                die();
+            }
+            
+            // Call function
+            wl_trace_set_size( size );
+        
 #ifdef _DEBUG_
-            printf("index = %d, length = %d \n", handle, length );
+            printf("END TRANSPORT_SET_TRACE \n");
 #endif
+        break;
+
+        //------------------------------------------------------
+        // trace = wl_mex_udp_transport('get_trace' [, filename])
+        //   - Arguments:
+        //     - filename (string) - (optional) File to write the trace to
+        //   - Returns:
+        //     - trace (double)    - 7 x N matrix with one column per packet (oldest first):
+        //                             [direction (0 - TX, 1 - RX); socket index; kernel RX time (sec);
+        //                              host time (sec); length (bytes); starting sample (-1 if not a
+        //                              sample packet); retry count]
+        //
+        //   NOTE:  The file contains the matrix as little endian doubles in column order so that
+        //          fread(fid, [7, Inf], 'double') returns the same matrix.  Reading the trace clears it.
+        //
+        case TRANSPORT_GET_TRACE :
+#ifdef _DEBUG_
+            printf("Function : TRANSPORT_GET_TRACE\n");
+#endif
+            // Validate arguments
+            if( ( nrhs != 1 ) && ( nrhs != 2 ) ) { print_usage(); die(); }
+            if( nlhs > 1 ) { print_usage(); die(); }
+            
+            // Get input arguments
+            buffer = NULL;
+            
+            if ( nrhs == 2 ) {
+                buffer = mxArrayToString( prhs[1] );
+                
+                if ( buffer == NULL ) { print_usage(); die(); }
+            }
+            
+            // Call function
+            plhs[0] = wl_trace_get( buffer );
+            
+            if ( buffer != NULL ) { mxFree( buffer ); }
+        
+#ifdef _DEBUG_
+            printf("END TRANSPORT_GET_TRACE \n");
+#endif
+        break;
+
+        //------------------------------------------------------
+        // wl_mex_udp_transport('set_capture', filename)
+        //   - Arguments:
+        //     - filename (string) - pcap file to capture all packets to ('' ==> Stop the capture)
+        //   - Returns:
+        //     - none
+        //
+        //   NOTE:  Every datagram sent / received on all sockets is written to the file with
+        //          an IPv4 / UDP header so the file can be opened with standard tools (eg Wireshark)
+        //          and played back with wl_pcapReplay.m.  Starting a capture closes the previous one.
+        //
+        case TRANSPORT_SET_CAPTURE :
+#ifdef _DEBUG_
+            printf("Function : TRANSPORT_SET_CAPTURE\n");
+#endif
+            // Validate arguments
+            if( nrhs != 2 ) { print_usage(); die(); }
+            if( nlhs != 0 ) { print_usage(); die(); }
+            
+            // Get input arguments
+            buffer = mxArrayToString( prhs[1] );
+                
+            if ( buffer == NULL ) { print_usage(); die(); }
+            
+            // Call function
+            wl_capture_open( buffer );
+            
+            mxFree( buffer );
+        
+#ifdef _DEBUG_
+            printf("END TRANSPORT_SET_CAPTURE \n");
+#endif
+        break;
+
+        //------------------------------------------------------
+        // wl_mex_udp_transport('set_impairment', direction, loss, reorder, duplicate, delay, seed)
+        //   - Arguments:
+        //     - direction (int)      - Packets to impair:  0 - None (disabled); 1 - Sent; 2 - Received; 3 - Both
+        //     - loss (double)        - Bernoulli loss:         p_loss
+        //                              Gilbert-Elliott loss:   [p_good_to_bad, p_bad_to_good, p_loss_good, p_loss_bad]
+        //     - reorder (double)     - [probability, depth] - A reordered packet is delivered after up to depth later packets
+        //     - duplicate (double)   - Probability a packet is duplicated
+        //     - delay (double)       - Latency (in usec) added to each packet
+        //     - seed (int)           - Seed of the random number generator (0 ==> Default seed)
+        //   - Returns:
+        //     - none
+        //
+        //   NOTE:  Loss and duplication apply to sent and received packets.  Reordering and latency only
+        //          apply to received packets (ie the transport sees the packets of the node out of order /
+        //          late).  With the same seed and traffic, the same packets are impaired.  Setting the
+        //          impairment clears the statistics and drops any packets that are held back.
+        //
+        case TRANSPORT_SET_IMPAIRMENT :
+#ifdef _DEBUG_
+            printf("Function : TRANSPORT_SET_IMPAIRMENT\n");
+#endif
+            // Validate arguments
+            if( nrhs != 7 ) { print_usage(); die(); }
+            if( nlhs != 0 ) { print_usage(); die(); }
+            
+            if ( ( mxGetNumberOfElements( prhs[2] ) != 1 ) && ( mxGetNumberOfElements( prhs[2] ) != 4 ) ) {
+                mexErrMsgTxt("Error:  Loss must be p_loss or [p_good_to_bad, p_bad_to_good, p_loss_good, p_loss_bad]");
+            }
+            
+            if ( ( mxGetNumberOfElements( prhs[3] ) != 1 ) && ( mxGetNumberOfElements( prhs[3] ) != 2 ) ) {
+                mexErrMsgTxt("Error:  Reorder must be 0 or [probability, depth]");
+            }
+            
+            // Call function
+            wl_impair_set( (uint32) mxGetScalar(prhs[1]), prhs[2], prhs[3], mxGetScalar(prhs[4]), mxGetScalar(prhs[5]), (uint32) mxGetScalar(prhs[6]) );
+        
+#ifdef _DEBUG_
+            printf("END TRANSPORT_SET_IMPAIRMENT \n");
+#endif
+        break;
+
+        //------------------------------------------------------
+        // stats = wl_mex_udp_transport('get_impairment_stats')
+        //   - Arguments:
+        //     - none
+        //   - Returns:
+        //     - stats (struct)   - Number of packets impaired since the impairment was set:
+        //                          tx_lost, rx_lost, duplicated, reordered, delayed, overflow (received
+        //                          packets lost because the impairment queue was full)
+        //
+        case TRANSPORT_GET_IMPAIRMENT_STATS :
+#ifdef _DEBUG_
+            printf("Function : TRANSPORT_GET_IMPAIRMENT_STATS\n");
+#endif
+            // Validate arguments
+            if( nrhs != 1 ) { print_usage(); die(); }
+            if( nlhs != 1 ) { print_usage(); die(); }
+
+            // Return the statistics
+            plhs[0] = wl_impair_get_stats();
+        
+#ifdef _DEBUG_
+            printf("END TRANSPORT_GET_IMPAIRMENT_STATS \n");
+#endif
+        break;
+
+        //------------------------------------------------------
+        // wl_mex_udp_transport('read_iq_set_decode_threads', num_threads)
+        //   - Arguments:
+        //     - num_threads (int) - Number of threads that decode Read IQ / Read RSSI packets:
+        //                             -1 - One less than the number of cores (default; at most 8)
+        //                              0 - Decode on the thread that receives the packets
+        //   - Returns:
+        //     - none
+        //
+        //   NOTE:  With decode threads, the receive loop only checks the packet headers so the next packet
+        //          is read from the socket sooner (which reduces the packets dropped by the OS for large
+        //          multi-buffer / multi-node reads).
+        //
+        case TRANSPORT_READ_IQ_SET_DECODE_THREADS :
+#ifdef _DEBUG_
+            printf("Function : TRANSPORT_READ_IQ_SET_DECODE_THREADS\n");
+#endif
+            // Validate arguments
+            if( nrhs != 2 ) { print_usage(); die(); }
+            if( nlhs != 0 ) { print_usage(); die(); }
+            
+            // Get input arguments
+            size = (int) mxGetScalar(prhs[1]);
+
+            if ( size < 0 ) {
+                read_iq_decode_threads = TRANSPORT_DECODE_THREADS_AUTO;
+            } else if ( size > TRANSPORT_DECODE_MAX_THREADS ) {
+                printf("Number of decode threads must be at most %d\n", TRANSPORT_DECODE_MAX_THREADS);
+                die();
+            } else {
+                read_iq_decode_threads = size;
+            }
+        
+#ifdef _DEBUG_
+            printf("END TRANSPORT_READ_IQ_SET_DECODE_THREADS \n");
+#endif
+        break;
+
+        //------------------------------------------------------
+        // wl_mex_udp_transport('connect', handle, ip_addr, port)
+        //   - Arguments:
+        //     - handle (int)     - index to the requested socket
+        //     - ip_addr          - IP Address of the node
+        //     - port             - Port of the node
+        //   - Returns:
+        //     - none
+        //
+        //   NOTE:  Once a socket is connected, the ip_addr / port arguments of the other functions are not
+        //       used for the socket (ie they can be empty) and only packets from the node are received.
+        //
+        case TRANSPORT_CONNECT :
+#ifdef _DEBUG_
+            printf("Function : TRANSPORT_CONNECT\n");
+#endif
+            // Validate arguments
+            if( nrhs != 4 ) { print_usage(); die(); }
+            if( nlhs != 0 ) { print_usage(); die(); }
+
+            // Get input arguments
+            handle  = (int) mxGetScalar(prhs[1]);
+            port    = (int) mxGetScalar(prhs[3]);
+            
+            // Input must be a string 
+            if ( mxIsChar( prhs[2] ) != 1 ) { mexErrMsgTxt("Error: Input must be a string."); }
+            if ( mxGetM( prhs[2] ) != 1 ) { mexErrMsgTxt("Error: Input must be a row vector."); }
+            ip_addr = mxArrayToString( prhs[2] );
+            if( ip_addr == NULL ) { mexErrMsgTxt("Error:  Could not convert input to string."); }
+
+            // Call function
+            connect_socket( handle, ip_addr, port );
+            
+            mxFree( ip_addr );
+
+#ifdef _DEBUG_
+            printf("END TRANSPORT_CONNECT \n");
+#endif
+        break;
+
+        //------------------------------------------------------
+        // size = wl_mex_udp_transport('send', handle, buffer, length, ip_addr, port)
+        //   - Arguments:
+        //     - handle (int)     - index to the requested socket
+        //     - buffer (char *)  - Buffer of data to be sent
+        //     - length (int)     - Length of data to be sent
+        //     - ip_addr          - IP Address to send data to
+        //     - port             - Port to send data to
+        //   - Returns:
+        //     - size (int)       - size of data sent (in bytes)
+        case TRANSPORT_SEND :
+#ifdef _DEBUG_
+            printf("Function : TRANSPORT_SEND\n");
+#endif
+            // Validate arguments
+            if( nrhs != 6 ) { print_usage(); die(); }
+            if( nlhs != 1 ) { print_usage(); die(); }
+            
+            // Get input arguments
+            handle  = (int) mxGetScalar(prhs[1]);
+            length  = (int) mxGetScalar(prhs[3]);
+            port    = (int) mxGetScalar(prhs[5]);
+            
+            // IP address (not needed if the socket is connected)
+            ip_addr = get_ip_addr( handle, prhs[4] );
+
+#ifdef _DEBUG_
+            printf("index = %d, length = %d, port = %d, ip_addr = %s \n", handle, length, port, ip_addr);
+#endif
+           
+            // Input must be an array of uint8
+            if ( mxIsUint8( prhs[2] ) != 1 ) { mexErrMsgTxt("Error: Input must be an array of uint8"); }
+            if ( mxGetM( prhs[2] ) != 1 ) { mexErrMsgTxt("Error: Input must be a row vector."); }
+            buffer = (char *) mxGetData( prhs[2] );
+            if( buffer == NULL ) { mexErrMsgTxt("Error:  Could not convert input to array of char."); }
+            
+            // Call function
+            size = send_socket( handle, buffer, length, ip_addr, port );
+            
+            // Return value to MABLAB
+            plhs[0] = mxCreateDoubleMatrix(1,1,mxREAL);
+            *mxGetPr(plhs[0]) = size;
+
+            mxFree( ip_addr );
+
+#ifdef _DEBUG_
+            print_buffer( buffer, length );
+            printf("END TRANSPORT_SEND \n");
+#endif
+        break;
+        
+        //------------------------------------------------------
+        // [size, buffer] = wl_mex_udp_transport('receive', handle, length )
+        //   - Arguments:
+        //     - handle (int)     - index to the requested socket
+        //     - length (int)     - length of data to be received (in bytes)
+        //   - Returns:
+        //     - buffer (char *)  - Buffer of data received
+        case TRANSPORT_RECEIVE :
+                        
+#ifdef _DEBUG_
+            printf("Function : TRANSPORT_RECEIVE\n");
+#endif
+            // Validate arguments
+            if( nrhs != 3 ) { print_usage(); die(); }
+            if( nlhs != 2 ) { print_usage(); die(); }
+
+            // Get input arguments
+            handle  = (int) mxGetScalar(prhs[1]);
+            length  = (int) mxGetScalar(prhs[2]);
+
+#ifdef _DEBUG_
+            printf("index = %d, length = %d \n", handle, length );
+#endif
+
+            // Check the length input argument
+            if(length == 0) { mexErrMsgTxt("Error:  Receive length of 0 not allowed."); }
+
+            // Allocate memory for the buffer
+            buffer = (char *) malloc(sizeof(char) * length);
+            if(buffer == NULL) { mexErrMsgTxt("Error:  Could not allocate receive buffer"); }
+            for (i = 0; i < length; i++) { buffer[i] = 0; }
+
+            // Call function
+            size = receive_socket(handle, length, buffer);
 
-            // Check the length input argument
-            if(length == 0) { mexErrMsgTxt("Error:  Receive length of 0 not allowed."); }
-
-            // Allocate memory for the buffer
-            buffer = (char *) malloc(sizeof(char) * length);
-            if(buffer == NULL) { mexErrMsgTxt("Error:  Could not allocate receive buffer"); }
-            for (i = 0; i < length; i++) { buffer[i] = 0; }
-
-            // Call function
-            size = receive_socket(handle, length, buffer);
-
             // Return value to MABLAB
             plhs[0] = mxCreateDoubleMatrix(1, 1, mxREAL);
             *mxGetPr(plhs[0]) = size;
@@ -1602,11 +2647,8 @@ void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
             buffer = (char *) mxGetData( prhs[2] );
             if( buffer == NULL ) { mexErrMsgTxt("Error:  Could not convert input buffer to array of char."); }
 
-            // IP address input must be a string 
-            if ( mxIsChar( prhs[4] ) != 1 ) { mexErrMsgTxt("Error: Input IP address must be a string."); }
-            if ( mxGetM( prhs[4] ) != 1 ) { mexErrMsgTxt("Error: Input IP address must be a row vector."); }
-            ip_addr = mxArrayToString( prhs[4] );
-            if( ip_addr == NULL ) { mexErrMsgTxt("Error:  Could not convert input IP address to string."); }
+            // IP address (not needed if the socket is connected)
+            ip_addr = get_ip_addr( handle, prhs[4] );
 
             // Sequence tracker must be an array of integers
             if ( mxIsUint32( prhs[12] ) != 1 ) { mexErrMsgTxt("Error: Sequence number tracker must be an array of uint32"); }
@@ -1633,6 +2675,7 @@ void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
             if( buffer_ids == NULL ) { mexErrMsgTxt("Error:  Could not convert input buffer IDs to array of uint32."); }
             
             num_buffers = (int) mxGetN( prhs[7] );
+            buffer_mask = 0;
 
             for ( i = 0; i < num_buffers; i++ ) {
                 buffer_id = buffer_ids[i];
@@ -1640,6 +2683,78 @@ void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
                 if ( !((buffer_id == BUFFER_ID_RFA) || (buffer_id == BUFFER_ID_RFB) || (buffer_id == BUFFER_ID_RFC) || (buffer_id == BUFFER_ID_RFD))) {
                     mexErrMsgTxt("Error:  Buffer selection must be singular.  Use vector notation for reading from multiple buffers e.g. [RFA,RFB]");
                 }
+                
+                // Buffers can only be read in a single request if each buffer is requested once
+                if ( buffer_mask & buffer_id ) {
+                    duplicate_buffers = 1;
+                }
+                
+                buffer_mask |= buffer_id;
+            }
+            
+            // Determine if all buffers can be read with a single Read IQ request
+            //     NOTE:  Each packet of a multi-buffer request contains the buffer ID in the sample header
+            //            so that the samples can be placed in the correct column of the output array
+            //
+            if ( ( read_iq_multi_buffer != READ_IQ_MULTI_BUFFER_DISABLED ) && ( num_buffers > 1 ) && ( duplicate_buffers == 0 ) ) {
+                num_requests        = 1;
+                buffers_per_request = num_buffers;
+                
+                if ( read_iq_multi_buffer == READ_IQ_MULTI_BUFFER_INTERLEAVED ) {
+                    read_iq_flags   = READ_IQ_FLAG_INTERLEAVE;
+                } else {
+                    read_iq_flags   = 0;
+                }
+            } else {
+                num_requests        = num_buffers;
+                buffers_per_request = 1;
+                read_iq_flags       = 0;
+            }
+            
+            // Request that the node stream samples of an ongoing reception
+            if ( read_iq_stream ) {
+                read_iq_flags      |= READ_IQ_FLAG_STREAM;
+            }
+            
+            // Request that the node resolve the start sample relative to the window reference
+            //     NOTE:  The node returns the sample indexes in the same coordinates as the request, so a
+            //            negative start sample (ie pre-trigger samples) simply wraps as a uint32.
+            //
+            if ( function == TRANSPORT_READ_IQ ) {
+                read_iq_flags      |= ( read_iq_window << READ_IQ_WINDOW_SHIFT );
+            }
+            
+            // Request the capture metadata from the node
+            //     NOTE:  The metadata of all requests of the call is combined (see wl_read_iq_merge_metadata())
+            //
+            read_iq_metadata_valid  = 0;
+            
+            if ( ( read_iq_metadata_en ) && ( function == TRANSPORT_READ_IQ ) ) {
+                read_iq_flags      |= READ_IQ_FLAG_METADATA;
+            }
+            
+            // Request that the node park the request until an ongoing reception is done
+            if ( ( read_iq_defer_timeout ) && ( function == TRANSPORT_READ_IQ ) ) {
+                read_iq_flags      |= READ_IQ_FLAG_DEFER | ( read_iq_defer_timeout << READ_IQ_DEFER_TIMEOUT_SHIFT );
+            }
+            
+            // Request compressed samples from the node
+            //     NOTE:  The packets are sized by the compressed bytes (see wl_read_iq_compress_size()), so the
+            //            samples per packet (ie max_length) and the number of packets are recomputed.  The bytes
+            //            of a packet on the wire (ie pkt_length) are still used to size the requests to the
+            //            receive buffer.
+            //
+            read_iq_raw_bytes  = 0;
+            read_iq_wire_bytes = 0;
+            pkt_length         = max_length;
+            
+            //     NOTE:  Raw reads return the words of the buffer as is (eg to read the node RX accumulator),
+            //            so they are never compressed.
+            //
+            if ( ( read_iq_compression != READ_IQ_COMPRESSION_NONE ) && ( function == TRANSPORT_READ_IQ ) && ( data_type != IQ_DATA_TYPE_RAW ) ) {
+                if ( wl_read_iq_compress_size( read_iq_compression, num_samples, &max_length, &num_pkts ) ) {
+                    read_iq_flags  |= ( read_iq_compression << READ_IQ_FORMAT_SHIFT );
+                }
             }
             
             // Determine data types and sizes based on input data_type
@@ -1749,42 +2864,54 @@ void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
             
             // If the default implementation to limit Read IQ request size is not sufficient, then 
             // the user can override the Read IQ max request size.
-            //   NOTE:  The request size must be at least max_length so that we don't run in to a corner
+            //   NOTE:  The request size must be at least pkt_length so that we don't run in to a corner
             //          case of spinning forever requesting zero samples.  
             if ( use_user_read_iq_max_req_size == 1 ) {
                         
-                if ( user_read_iq_max_req_size < max_length ) {
-                    useful_rx_buffer_size = max_length;
+                if ( user_read_iq_max_req_size < pkt_length ) {
+                    useful_rx_buffer_size = pkt_length;
                 } else {
                     useful_rx_buffer_size = user_read_iq_max_req_size;
                 }
             } else {
 
-                // Set the useful RX buffer size to 80% of the RX buffer
+                // Start with the useful RX buffer size at 80% of the RX buffer
                 //     NOTE:  This is integer division so the rx_buffer_size will be truncated by the divide
+                //     NOTE:  The request size then adapts to the packets dropped by the OS (see wl_read_iq_adapt_req_size())
                 //
-                useful_rx_buffer_size  = 8 * ( sockets[handle].rx_buffer_size / 10 );
+                if ( sockets[handle].read_iq_req_size == 0 ) {
+                    sockets[handle].read_iq_req_size = 8 * ( sockets[handle].rx_buffer_size / 10 );
+                }
+                
+                useful_rx_buffer_size  = sockets[handle].read_iq_req_size;
             }
+            
+            num_retrys = read_iq_num_retrys;
+            rx_drops   = sockets[handle].rx_drops;
 
 #ifdef _DEBUG_
             printf("Useful buffer size = %d (of %d) for %d pkt request\n", useful_rx_buffer_size, sockets[handle].rx_buffer_size, num_pkts);
             printf("  Num samples  = %d     Useful buffer samples = %d\n", num_samples, (useful_rx_buffer_size >> 2));
 #endif
 
-            // Iterate thru all the buffers that have been requested
-            for (k = 0; k < num_buffers; k++) {
+            // Iterate thru all the requests needed for the buffers
+            for (k = 0; k < num_requests; k++) {
             
                 // Set the buffer ID for this Read IQ
-                buffer_id = buffer_ids[k];
+                buffer_id = 0;
+                
+                for (i = 0; i < buffers_per_request; i++) {
+                    buffer_id |= buffer_ids[(k * buffers_per_request) + i];
+                }
                 
                 // Update the buffer with the correct command arguments since it is too expensive to do in MATLAB
                 command_args    = (uint32 *) ( buffer + sizeof( wl_transport_header ) + sizeof( wl_command_header ) );
-                command_args[0] = endian_swap_32( buffer_id );
+                command_args[0] = endian_swap_32( buffer_id | read_iq_flags );
                 command_args[3] = endian_swap_32( max_length );
 
                 // Check to see if we have enough receive buffer space for the requested packets.
                 // If not, then break the request up in to multiple requests.            
-                if( num_samples < ( useful_rx_buffer_size >> 2 ) ) {
+                if( ( num_samples * buffers_per_request ) < ( ( useful_rx_buffer_size / pkt_length ) * ( max_length >> 2 ) ) ) {
 
                     // Call receive function normally
                     command_args[1] = endian_swap_32( start_sample );
@@ -1793,16 +2920,21 @@ void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
 
                     // Call function
                     size = wl_read_baseband_buffer( handle, buffer, length, ip_addr, port,
-                                                    start_sample, num_samples, start_sample, buffer_id, function, data_type,
-                                                    output_array, &num_cmds, &seq_num );
+                                                    start_sample, num_samples, start_sample, 
+                                                    &buffer_ids[k * buffers_per_request], buffers_per_request, function, data_type,
+                                                    (num_output_data * data_size), output_array, &num_cmds, seq_nums );
 
                 } else {
 
                     // Since we are requesting more data than can fit in to the receive buffer, break this 
                     // request in to multiple function calls, so we do not hit the timeout functions
 
-                    // Number of packets that can fit in the receive buffer
-                    num_pkts_to_request     = useful_rx_buffer_size / max_length;            // RX buffer size in bytes / Max packet size in bytes
+                    // Number of packets (per buffer) that can fit in the receive buffer
+                    num_pkts_to_request     = useful_rx_buffer_size / ( pkt_length * buffers_per_request );   // RX buffer size in bytes / Max packet size in bytes
+                    
+                    if ( num_pkts_to_request == 0 ) {
+                        num_pkts_to_request = 1;
+                    }
                     
                     // Number of samples in a request (number of samples in a packet * number of packets in a request)
                     num_samples_to_request  = (max_length >> 2) * num_pkts_to_request;
@@ -1824,7 +2956,9 @@ void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
                         die_with_error("Error:  Read IQ / Read RSSI - Parameter mismatch.  See above for debug information.");
                     }
 
-                    for( i = num_pkts; i > 0; i -= num_pkts_to_request ) {
+                    i = num_pkts;
+
+                    while ( i > 0 ) {
 
                         j = i - num_pkts_to_request;
 
@@ -1846,30 +2980,63 @@ void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
 
                         // Call function
                         size = wl_read_baseband_buffer( handle, buffer, length, ip_addr, port,
-                                                        start_sample, num_samples_to_request, start_sample_to_request, buffer_id, function, data_type,
-                                                        output_array, &num_cmds, &seq_num );
+                                                        start_sample, num_samples_to_request, start_sample_to_request, 
+                                                        &buffer_ids[k * buffers_per_request], buffers_per_request, function, data_type,
+                                                        (num_output_data * data_size), output_array, &num_cmds, seq_nums );
 
                         start_sample_to_request += num_samples_to_request;
+                        i                       -= num_pkts_to_request;
+
+                        // Adapt the request size to the packets dropped during this request so that the
+                        // next request of the read uses the new size
+                        if ( ( use_user_read_iq_max_req_size == 0 ) && ( i > 0 ) ) {
+                            useful_rx_buffer_size  = wl_read_iq_adapt_req_size( handle, pkt_length, ( read_iq_num_retrys - num_retrys ), ( sockets[handle].rx_drops - rx_drops ) );
+
+                            num_retrys             = read_iq_num_retrys;
+                            rx_drops               = sockets[handle].rx_drops;
+
+                            num_pkts_to_request    = useful_rx_buffer_size / ( pkt_length * buffers_per_request );
+
+                            if ( num_pkts_to_request == 0 ) {
+                                num_pkts_to_request = 1;
+                            }
+
+                            num_samples_to_request = (max_length >> 2) * num_pkts_to_request;
+                        }
                     }
                     
                     size = num_samples;
                 }
 
                 // Do not update the pointers on the last iteration thru the loop
-                if (k < (num_buffers - 1)) {
+                if (k < (num_requests - 1)) {
                     // Update the output array pointers to the next section of samples
                     for (i = 0; i < num_output_arrays; i++) {
-                        output_array[i] = (void *)(((long long)(output_array[i])) + (long long)(num_output_data * data_size));
+                        output_array[i] = (void *)(((long long)(output_array[i])) + (long long)(num_output_data * data_size * buffers_per_request));
                     }
                 }
                 
-                // Check the sequence number
-                wl_check_seq_num(function, node_id_str, buffer_id, seq_num, seq_num_tracker, seq_num_severity);
+                for (i = 0; i < buffers_per_request; i++) {
+                    buffer_id = buffer_ids[(k * buffers_per_request) + i];
+                    seq_num   = seq_nums[i];
                 
-                // Update the sequence number
-                wl_update_seq_num(function, buffer_id, seq_num, seq_num_tracker);
+                    // Check the sequence number
+                    wl_check_seq_num(function, node_id_str, buffer_id, seq_num, seq_num_tracker, seq_num_severity);
+                    
+                    // Update the sequence number
+                    wl_update_seq_num(function, buffer_id, seq_num, seq_num_tracker);
+                }
                 
-            }  // END for each buffer_id
+                // Adapt the request size of the node to the packets dropped during the last request
+                //     NOTE:  The next buffers of this call (or the next call) use the new size
+                if ( use_user_read_iq_max_req_size == 0 ) {
+                    useful_rx_buffer_size = wl_read_iq_adapt_req_size( handle, pkt_length, ( read_iq_num_retrys - num_retrys ), ( sockets[handle].rx_drops - rx_drops ) );
+
+                    num_retrys            = read_iq_num_retrys;
+                    rx_drops              = sockets[handle].rx_drops;
+                }
+                
+            }  // END for each request
             
             // Return values to MABLAB
             *mxGetPr(plhs[0]) = size;            
@@ -1921,6 +3088,9 @@ void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
         //                                        IQ_DATA_TYPE_SINGLE ==> float  / mxSINGLE_CLASS
         //                                        IQ_DATA_TYPE_INT16  ==> int16  / mxINT16_CLASS
         //                                        IQ_DATA_TYPE_RAW    ==> uint32 / mxUINT32_CLASS
+        //     - byte_order      (int)      - (optional) Byte order of the samples on the wire:
+        //                                        SAMPLE_BYTE_ORDER_BIG    ==> big endian (default)
+        //                                        SAMPLE_BYTE_ORDER_LITTLE ==> little endian
         //
         //   - Returns:
         //     - cmds_used   (int)  - number of transport commands used to send samples
@@ -1932,7 +3102,7 @@ void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
             printf("Function : TRANSPORT_WRITE_IQ\n");
 #endif
             // Validate arguments
-            if( nrhs != 15 ) { print_usage(); die(); }
+            if( ( nrhs != 15 ) && ( nrhs != 16 ) ) { print_usage(); die(); }
             if( nlhs !=  2 ) { print_usage(); die(); }
 
             // Get input arguments
@@ -1947,17 +3117,18 @@ void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
             check_chksum = (int) mxGetScalar(prhs[13]);
             data_type    = (int) mxGetScalar(prhs[14]);
             
+            if ( nrhs == 16 ) {
+                byte_order   = (int) mxGetScalar(prhs[15]);
+            }
+            
             // Packet data must be an array of uint8
             if ( mxIsUint8( prhs[2] ) != 1 ) { mexErrMsgTxt("Error: Command Buffer input must be an array of uint8"); }
             if ( mxGetM( prhs[2] ) != 1 ) { mexErrMsgTxt("Error: Command Buffer input must be a row vector."); }
             buffer = (char *) mxGetData( prhs[2] );
             if( buffer == NULL ) { mexErrMsgTxt("Error:  Could not convert command buffer input to array of char."); }
 
-            // IP address input must be a string 
-            if ( mxIsChar( prhs[4] ) != 1 ) { mexErrMsgTxt("Error: IP Address input must be a string."); }
-            if ( mxGetM( prhs[4] ) != 1 ) { mexErrMsgTxt("Error: IP Address input must be a row vector."); }
-            ip_addr = mxArrayToString( prhs[4] );
-            if( ip_addr == NULL ) { mexErrMsgTxt("Error:  Could not convert ip address input to string."); }
+            // IP address (not needed if the socket is connected)
+            ip_addr = get_ip_addr( handle, prhs[4] );
 
             // Buffer IDs must be an array of singular buffer IDs
             if ( mxIsUint32( prhs[8] ) != 1 ) { mexErrMsgTxt("Error: Input buffer IDs must be an array of uint32"); }
@@ -2001,8 +3172,8 @@ void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
                 //
                 size = wl_write_baseband_buffer( handle, buffer, max_length, ip_addr, port,
                                                  num_samples, start_sample, sample_buffer, buffer_id, 
-                                                 num_pkts, max_samples, hw_ver, check_chksum, data_type, k,
-                                                 &num_cmds, &checksum );
+                                                 num_pkts, max_samples, hw_ver, check_chksum, data_type, byte_order,
+                                                 k, &num_cmds, &checksum );
 
                 // Check that we actually sent some samples
                 if ( size == 0 ) {
@@ -2103,162 +3274,1706 @@ void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
 
 
         //------------------------------------------------------
-        //  Default
+        // wl_mex_udp_transport('read_iq_set_multi_buffer', mode)
+        //   - Arguments:
+        //     - mode (int) - Multi-buffer Read IQ mode:
+        //                        0 ==> Disabled (one request per buffer)
+        //                        1 ==> Single request for all buffers; buffers sent sequentially
+        //                        2 ==> Single request for all buffers; buffers interleaved per packet
+        //   - Returns:
+        //     - none
         //
-        //  Print error message
+        //   NOTE:  Multi-buffer Read IQ requires node support for multiple buffers in the
+        //          Read IQ buffer selection.
         //
-        default:
-            printf("Error:  Function %s not supported.", func);
-            mexErrMsgTxt("Error:  Function not supported.");
-        break; 
-    }
+        case TRANSPORT_READ_IQ_SET_MULTI_BUFFER :
+#ifdef _DEBUG_
+            printf("Function : TRANSPORT_READ_IQ_SET_MULTI_BUFFER\n");
+#endif
+            // Validate arguments
+            if( nrhs != 2 ) { print_usage(); die(); }
+            if( nlhs != 0 ) { print_usage(); die(); }
 
-    // Free allocated memory
-    mxFree( func );
-    
+            // Get input arguments
+            size = (int) mxGetScalar(prhs[1]);
+
+            if ( ( size < 0 ) || ( size > READ_IQ_MULTI_BUFFER_INTERLEAVED ) ) {
+                mexErrMsgTxt("Error:  Unsupported multi-buffer Read IQ mode");
+            }
+
+            // Set the global variables
+            read_iq_multi_buffer = size;
+        
 #ifdef _DEBUG_
-    printf("DONE \n");
+            printf("END TRANSPORT_READ_IQ_SET_MULTI_BUFFER \n");
 #endif
+        break;
 
-    // if ( function == TRANSPORT_READ_IQ) {
-    //     wl_usleep(5000000);
-    // }
 
-    // Return back to MATLAB
-    return;
-}
+        //------------------------------------------------------
+        // wl_mex_udp_transport('read_iq_set_stream', enable)
+        //   - Arguments:
+        //     - enable (int) - Streaming Read IQ mode:
+        //                          0 ==> Disabled (node returns 'not ready' during a reception)
+        //                          1 ==> Enabled (node sends samples as they are received)
+        //   - Returns:
+        //     - none
+        //
+        //   NOTE:  Streaming Read IQ requires node support for the stream flag in the
+        //          Read IQ buffer selection.
+        //
+        case TRANSPORT_READ_IQ_SET_STREAM :
+#ifdef _DEBUG_
+            printf("Function : TRANSPORT_READ_IQ_SET_STREAM\n");
+#endif
+            // Validate arguments
+            if( nrhs != 2 ) { print_usage(); die(); }
+            if( nlhs != 0 ) { print_usage(); die(); }
 
+            // Get input arguments
+            size = (int) mxGetScalar(prhs[1]);
 
+            // Set the global variables
+            read_iq_stream = ( size != 0 );
+        
+#ifdef _DEBUG_
+            printf("END TRANSPORT_READ_IQ_SET_STREAM \n");
+#endif
+        break;
 
 
-/*****************************************************************************/
-//           Additional WL Mex UDP Transport functionality
-/*****************************************************************************/
+        //------------------------------------------------------
+        // wl_mex_udp_transport('read_iq_set_compression', mode)
+        //   - Arguments:
+        //     - mode (int) - Read IQ sample format on the wire:
+        //                        0 ==> Disabled (32-bit samples)
+        //                        1 ==> 12-bit packed samples (3 bytes / sample)
+        //                        2 ==> Block floating point samples (8-bit I / Q with a shared exponent
+        //                              per block of 32 samples)
+        //   - Returns:
+        //     - none
+        //
+        //   NOTE:  Compression only applies to Read IQ (not Read RSSI) and requires node support for
+        //          the sample format in the Read IQ buffer selection.  Block floating point is lossy.
+        //
+        //   NOTE:  The packets are sized by the compressed bytes, so a read takes about 3/4 (12-bit) or
+        //          17/32 (block floating point) of the packets and bytes of an uncompressed read.  However,
+        //          the node packs the samples with its processor, while uncompressed samples are sent by DMA
+        //          straight from the buffer.  Compression therefore only speeds up a read when the link (eg
+        //          a switch port shared by many nodes in a 'trigger_and_read', or a Read IQ rate cap) is the
+        //          limit and not the node.  The throughput has not been measured on hardware; compare the
+        //          time of a read with and without compression (eg with 'set_trace' / 'get_trace') before
+        //          enabling it.
+        //
+        case TRANSPORT_READ_IQ_SET_COMPRESSION :
+#ifdef _DEBUG_
+            printf("Function : TRANSPORT_READ_IQ_SET_COMPRESSION\n");
+#endif
+            // Validate arguments
+            if( nrhs != 2 ) { print_usage(); die(); }
+            if( nlhs != 0 ) { print_usage(); die(); }
 
+            // Get input arguments
+            size = (int) mxGetScalar(prhs[1]);
 
-/*****************************************************************************/
-/**
-*
-* This function will receive a packet
-*
-* @param	index          - Index in to socket structure which will receive samples
-* @param	buffer         - WARPLab command to request samples
-* @param	length         - Length (in bytes) of buffer
-* @param    ip_addr        - IP Address of node to retrieve samples
-* @param    port           - Port of node to retrieve samples
-* @param    num_samples    - Number of samples to process (should be the same as the argument in the WARPLab command)
-* @param    start_sample   - Index of starting sample (should be the same as the agrument in the WARPLab command)
-* @param    buffer_id      - Which buffer(s) do we need to retrieve samples from
-* @param    output_array   - Return parameter - array of samples to return
-* @param    num_cmds       - Return parameter - number of ethernet send commands used to request packets 
-*                                (could be > 1 if there are transmission errors)
-*
-* @return	size           - Number of samples processed (also size of output_array)
-*
-* @note		This function requires the following pointers:
-*   Input:
-*       - Buffer containing command to request samples (char *)
-*       - IP Address (char *)
-*       - Array of buffer IDs (uint32 *)
-*       - Allocated memory to return samples (uint32 *)
-*       - Location to return the number of send commands used to generate the samples (uint32 *)
-*
-*   Output:
-*       - Number of samples processed 
-*
-******************************************************************************/
-int wl_receive_response( int index, 
-                         char *resp_buffer, int resp_buffer_size, uint32 *resp_time, 
-                         char *cmd_buffer,  int cmd_buffer_size, char *ip_addr, int port, wl_function_ptr_t cmd_update_callback
-                       ) {
+            if ( ( size < 0 ) || ( size > READ_IQ_COMPRESSION_BFP ) ) {
+                mexErrMsgTxt("Error:  Unsupported Read IQ compression mode");
+            }
 
-    int                      done                = 0;
-    uint32                   timeout             = 0;
-    uint32                   num_retries         = 0;
-    uint32                   num_wait_retries    = 0;
-    int                      sent_size           = 0;
-    int                      rcvd_size           = 0;
-    uint32                   total_cmds          = 0;
+            // Set the global variables
+            read_iq_compression = size;
+        
+#ifdef _DEBUG_
+            printf("END TRANSPORT_READ_IQ_SET_COMPRESSION \n");
+#endif
+        break;
 
-    wl_transport_header     *rcvd_transport_hdr;
-    
 
-    // Try to process the return packet
-    while ( !done ) {
+        //------------------------------------------------------
+        // ratio = wl_mex_udp_transport('read_iq_get_compression_ratio')
+        //   - Arguments:
+        //     - none
+        //   - Returns:
+        //     - ratio (double) - Ratio of sample bytes received on the wire to the size of the
+        //                        uncompressed samples for the last Read IQ / Read RSSI call
+        //
+        case TRANSPORT_READ_IQ_GET_COMPRESSION_RATIO :
+#ifdef _DEBUG_
+            printf("Function : TRANSPORT_READ_IQ_GET_COMPRESSION_RATIO\n");
+#endif
+            // Validate arguments
+            if( nrhs != 1 ) { print_usage(); die(); }
+            if( nlhs != 1 ) { print_usage(); die(); }
 
-        // If we hit the timeout, then resend the command
-        if ( timeout >= TRANSPORT_TIMEOUT ) {
+            // Return the ratio
+            plhs[0] = mxCreateDoubleMatrix(1, 1, mxREAL);
+            
+            if ( read_iq_raw_bytes != 0 ) {
+                *mxGetPr(plhs[0]) = read_iq_wire_bytes / read_iq_raw_bytes;
+            } else {
+                *mxGetPr(plhs[0]) = 1.0;
+            }
         
-            // If we hit the max number of retrys, then abort
-            if ( num_retries >= TRANSPORT_MAX_RETRY ) {
+#ifdef _DEBUG_
+            printf("END TRANSPORT_READ_IQ_GET_COMPRESSION_RATIO \n");
+#endif
+        break;
 
-                printf("ERROR:  Exceeded %d retries for current command request\n", TRANSPORT_MAX_RETRY);
-                die_with_error("Error:  Reached maximum number of retries without a response... aborting.");
-                
-            } else {            
-                // Retransmit the command packet
 
-                // See if there are any updates required                
-                cmd_update_callback( cmd_buffer, cmd_buffer_size, ip_addr, port );
-                
-                // Send the packet
-                sent_size    = send_socket( index, cmd_buffer, cmd_buffer_size, ip_addr, port );
-                total_cmds  += 1;
-                
-                // Update control variables
-                timeout      = 0;
-                num_retries += 1;
+        //------------------------------------------------------
+        // wl_mex_udp_transport('read_iq_set_window', reference)
+        //   - Arguments:
+        //     - reference (int) - Reference of the Read IQ start sample:
+        //                             0 ==> Absolute (sample 0 of the buffer, ie the trigger)
+        //                             1 ==> AGC done (start sample is a signed offset from the
+        //                                   sample where the AGC finished)
+        //   - Returns:
+        //     - none
+        //
+        //   NOTE:  The window reference only applies to Read IQ (not Read RSSI) and requires node
+        //          support.  Samples of the window outside of the buffer are returned as zeros.
+        //
+        case TRANSPORT_READ_IQ_SET_WINDOW :
+#ifdef _DEBUG_
+            printf("Function : TRANSPORT_READ_IQ_SET_WINDOW\n");
+#endif
+            // Validate arguments
+            if( nrhs != 2 ) { print_usage(); die(); }
+            if( nlhs != 0 ) { print_usage(); die(); }
+
+            // Get input arguments
+            size = (int) mxGetScalar(prhs[1]);
+
+            if ( ( size < 0 ) || ( size > READ_IQ_WINDOW_AGC_DONE ) ) {
+                mexErrMsgTxt("Error:  Unsupported Read IQ window reference");
             }
-        }
+
+            // Set the global variables
+            read_iq_window = size;
         
-        // Receive packet
-        rcvd_size = receive_socket( index, resp_buffer_size, resp_buffer );
+#ifdef _DEBUG_
+            printf("END TRANSPORT_READ_IQ_SET_WINDOW \n");
+#endif
+        break;
 
-        // receive_socket() handles all socket related errors and will only return:
-        //   - zero if no packet is available
-        //   - non-zero if packet is available
-        if ( rcvd_size > 0 ) {
-            // Decode the ethernet packet
-            rcvd_transport_hdr  = (wl_transport_header *) resp_buffer;
-            
-            // Record the response timeout value
-            *resp_time   = timeout;
 
-            // Reset the timeout regardless of the contents of the packet
-            timeout      = 0;
+        //------------------------------------------------------
+        // wl_mex_udp_transport('read_iq_set_metadata', enable)
+        //   - Arguments:
+        //     - enable (int) - Request the capture metadata with each Read IQ:
+        //                          0 ==> Disabled
+        //                          1 ==> Enabled
+        //   - Returns:
+        //     - none
+        //
+        //   NOTE:  The metadata only applies to Read IQ (not Read RSSI) and requires node support.
+        //          The metadata of the last Read IQ call is returned by 'read_iq_get_metadata'.
+        //
+        case TRANSPORT_READ_IQ_SET_METADATA :
+#ifdef _DEBUG_
+            printf("Function : TRANSPORT_READ_IQ_SET_METADATA\n");
+#endif
+            // Validate arguments
+            if( nrhs != 2 ) { print_usage(); die(); }
+            if( nlhs != 0 ) { print_usage(); die(); }
 
-            // Check the transport header to see if we should wait
-            if ( (rcvd_transport_hdr->flags & TRANSPORT_HDR_NODE_NOT_READY_FLAG) == TRANSPORT_HDR_NODE_NOT_READY_FLAG ) {
-            
-                // Node is not ready; Wait and try again
-                wl_usleep( TRANSPORT_NOT_READY_WAIT_TIME );                
-                num_wait_retries += 1;
+            // Get input arguments
+            size = (int) mxGetScalar(prhs[1]);
 
-                // Send packet to request samples
-                sent_size   = send_socket( index, cmd_buffer, cmd_buffer_size, ip_addr, port );
-                total_cmds += 1;
+            // Set the global variables
+            read_iq_metadata_en = ( size != 0 ) ? 1 : 0;
+        
+#ifdef _DEBUG_
+            printf("END TRANSPORT_READ_IQ_SET_METADATA \n");
+#endif
+        break;
 
-                // Check that we have not spent a "long time" waiting for samples to be ready                
-                if ( num_wait_retries > TRANSPORT_NOT_READY_MAX_RETRY ) {
-                    die_with_error("Error:  Timeout waiting for node to be ready.  Please check the node operation.");
-                }            
-            } else {
-                done = 1;
-            }
-        }
-    }
-    
-    return total_cmds;
-}
 
+        //------------------------------------------------------
+        // metadata = wl_mex_udp_transport('read_iq_get_metadata')
+        //   - Arguments:
+        //     - none
+        //   - Returns:
+        //     - metadata (struct array) - Capture metadata of the last Read IQ call (one element per
+        //                                 buffer in the order RFA -> RFB -> RFC -> RFD; empty if the
+        //                                 metadata was not received)
+        //
+        case TRANSPORT_READ_IQ_GET_METADATA :
+#ifdef _DEBUG_
+            printf("Function : TRANSPORT_READ_IQ_GET_METADATA\n");
+#endif
+            // Validate arguments
+            if( nrhs != 1 ) { print_usage(); die(); }
+            if( nlhs != 1 ) { print_usage(); die(); }
 
+            // Return the metadata
+            plhs[0] = wl_read_iq_get_metadata();
+        
+#ifdef _DEBUG_
+            printf("END TRANSPORT_READ_IQ_GET_METADATA \n");
+#endif
+        break;
 
-/*****************************************************************************/
-/**
-*
-* This function will read the baseband buffers and construct the sample array
-*
-* @param	index          - Index in to socket structure which will receive samples
+
+        //------------------------------------------------------
+        // wl_mex_udp_transport('read_iq_set_defer', timeout)
+        //   - Arguments:
+        //     - timeout (int) - Maximum time (in ms) the node will park a Read IQ request that
+        //                       arrives during a reception (0 ==> Disabled).  The timeout is
+        //                       rounded up to 10 ms and is at most 2550 ms.
+        //   - Returns:
+        //     - none
+        //
+        //   NOTE:  With deferral, a Read IQ can be issued right after the trigger.  The node sends
+        //          the samples as soon as the reception is done instead of returning 'not ready'
+        //          and the transport waits up to the timeout for the first packet.  Deferral only
+        //          applies to Read IQ (not Read RSSI) and requires node support.
+        //
+        case TRANSPORT_READ_IQ_SET_DEFER :
+#ifdef _DEBUG_
+            printf("Function : TRANSPORT_READ_IQ_SET_DEFER\n");
+#endif
+            // Validate arguments
+            if( nrhs != 2 ) { print_usage(); die(); }
+            if( nlhs != 0 ) { print_usage(); die(); }
+
+            // Get input arguments
+            size = (int) mxGetScalar(prhs[1]);
+
+            if ( size < 0 ) {
+                mexErrMsgTxt("Error:  Read IQ deferral timeout must be non-negative");
+            }
+
+            // Set the global variables
+            //     NOTE:  Convert ms to READ_IQ_DEFER_TIMEOUT_UNIT (ie 10 ms) rounding up
+            //
+            tmp_length = ( size + ( READ_IQ_DEFER_TIMEOUT_UNIT / 1000 ) - 1 ) / ( READ_IQ_DEFER_TIMEOUT_UNIT / 1000 );
+            
+            read_iq_defer_timeout = ( tmp_length > READ_IQ_DEFER_TIMEOUT_MAX ) ? READ_IQ_DEFER_TIMEOUT_MAX : tmp_length;
+        
+#ifdef _DEBUG_
+            printf("END TRANSPORT_READ_IQ_SET_DEFER \n");
+#endif
+        break;
+
+
+        //------------------------------------------------------
+        // wl_mex_udp_transport('read_iq_set_schedule', max_wait)
+        //   - Arguments:
+        //     - max_wait (int) - Maximum time (in ms) to wait for the node to reach its transmit
+        //                        slot (0 ==> Disabled).
+        //   - Returns:
+        //     - none
+        //
+        //   NOTE:  With scheduling, each node of a 'trigger_and_read' sends the samples of its first
+        //          Read IQ request in its transmit slot at no more than its rate cap (see 'read_iq_schedule'
+        //          in wl_baseband_buffers.m).  The transport waits up to max_wait for the first packet, so
+        //          max_wait must be at least the start of the slot of the node.  A node fails the request
+        //          if its slot starts too late (see WL_READ_IQ_SCHEDULE_MAX_WAIT on the node).  Sequential
+        //          'read_iq' requests are not scheduled.  Scheduling requires node support.
+        //
+        case TRANSPORT_READ_IQ_SET_SCHEDULE :
+#ifdef _DEBUG_
+            printf("Function : TRANSPORT_READ_IQ_SET_SCHEDULE\n");
+#endif
+            // Validate arguments
+            if( nrhs != 2 ) { print_usage(); die(); }
+            if( nlhs != 0 ) { print_usage(); die(); }
+
+            // Get input arguments
+            size = (int) mxGetScalar(prhs[1]);
+
+            if ( size < 0 ) {
+                mexErrMsgTxt("Error:  Read IQ schedule wait must be non-negative");
+            }
+
+            // Set the global variables
+            read_iq_schedule_wait = size * 1000;
+        
+#ifdef _DEBUG_
+            printf("END TRANSPORT_READ_IQ_SET_SCHEDULE \n");
+#endif
+        break;
+
+
+        //------------------------------------------------------
+        // [num_samples, cmds_used, samples] = wl_mex_udp_transport('trigger_and_read', trig_handle, trig_buffer, trig_ip_addr,
+        //                                                          trig_port, wait_time, read_args)
+        //   - Arguments:
+        //     - trig_handle     (int)      - Index to the socket used to send the trigger
+        //     - trig_buffer     (char *)   - Trigger packet
+        //     - trig_ip_addr    (char *)   - IP Address to send the trigger to (ie the broadcast address)
+        //     - trig_port       (int)      - Port to send the trigger to
+        //     - wait_time       (int)      - Time (in us) from the trigger until the captures of all nodes are done
+        //     - read_args       (cell)     - Arguments of 'read_iq' (ie handle through node_id_str) with one row per node
+        //   - Returns:
+        //     - num_samples     (int)      - Number of samples read from each buffer
+        //     - cmds_used       (double)   - Row vector with the number of commands used for each node
+        //     - samples                    - Array of samples with the buffers of each node in consecutive columns
+        //
+        //   NOTE:  This performs a complete trial (ie trigger, wait for the capture and Read IQ of every node) in
+        //          one call.  Once the wait time has elapsed, the Read IQ requests of all nodes are sent and the
+        //          samples of all nodes are received at the same time (see wl_read_iq_nodes()).  All nodes must
+        //          read the same samples with the same data type.  The Read IQ window and compression options
+        //          apply; the requests are not parked or streamed and the capture metadata is not requested.
+        //
+        case TRANSPORT_TRIGGER_AND_READ :
+#ifdef _DEBUG_
+            printf("Function : TRANSPORT_TRIGGER_AND_READ\n");
+#endif
+            // Validate arguments
+            if( nrhs != 7 ) { print_usage(); die(); }
+            if( nlhs != 3 ) { print_usage(); die(); }
+
+            // Get input arguments
+            handle       = (int) mxGetScalar(prhs[1]);
+            port         = (int) mxGetScalar(prhs[4]);
+            wait_time    = (int) mxGetScalar(prhs[5]);
+
+            // Trigger packet must be an array of uint8
+            if ( mxIsUint8( prhs[2] ) != 1 ) { mexErrMsgTxt("Error: Trigger buffer must be an array of uint8"); }
+            if ( mxGetM( prhs[2] ) != 1 ) { mexErrMsgTxt("Error: Trigger buffer must be a row vector."); }
+            buffer = (char *) mxGetData( prhs[2] );
+            if( buffer == NULL ) { mexErrMsgTxt("Error:  Could not convert trigger buffer to array of char."); }
+            length = (int) mxGetN( prhs[2] );
+
+            // IP address input must be a string 
+            if ( mxIsChar( prhs[3] ) != 1 ) { mexErrMsgTxt("Error: Trigger IP address must be a string."); }
+            if ( mxGetM( prhs[3] ) != 1 ) { mexErrMsgTxt("Error: Trigger IP address must be a row vector."); }
+            ip_addr = mxArrayToString( prhs[3] );
+            if( ip_addr == NULL ) { mexErrMsgTxt("Error:  Could not convert trigger IP address to string."); }
+
+            // Read arguments must be a cell array with the 14 'read_iq' arguments of each node in a row
+            if ( mxIsCell( prhs[6] ) != 1 ) { mexErrMsgTxt("Error: Read arguments must be a cell array"); }
+            if ( mxGetN( prhs[6] ) != 14 ) { mexErrMsgTxt("Error: Read arguments must have 14 columns (ie the arguments of 'read_iq')"); }
+            
+            num_nodes   = (int) mxGetM( prhs[6] );
+            
+            if ( num_nodes == 0 ) { mexErrMsgTxt("Error: Read arguments must have at least one node"); }
+            
+            read_nodes  = (wl_read_iq_node *) malloc( sizeof( wl_read_iq_node ) * num_nodes );
+            if( read_nodes == NULL ) { mexErrMsgTxt("Error:  Could not allocate Read IQ node array"); }
+
+            // Get the 'read_iq' arguments of each node
+            //     NOTE:  The number of samples, start sample and data type are the same for all nodes
+            //
+            num_samples  = (int) mxGetScalar( mxGetCell( prhs[6], (5 * num_nodes) ) );
+            start_sample = (int) mxGetScalar( mxGetCell( prhs[6], (7 * num_nodes) ) );
+            data_type    = (int) mxGetScalar( mxGetCell( prhs[6], (10 * num_nodes) ) );
+            num_columns  = 0;
+            
+            for ( i = 0; i < num_nodes; i++ ) {
+                read_node = &read_nodes[i];
+                
+                if ( ( (uint32) mxGetScalar( mxGetCell( prhs[6], (5 * num_nodes) + i ) ) != num_samples ) ||
+                     ( (int) mxGetScalar( mxGetCell( prhs[6], (7 * num_nodes) + i ) ) != (int) start_sample ) ||
+                     ( (uint32) mxGetScalar( mxGetCell( prhs[6], (10 * num_nodes) + i ) ) != data_type ) ) {
+                    mexErrMsgTxt("Error:  All nodes must read the same number of samples with the same data type");
+                }
+                
+                read_node->index      = (int) mxGetScalar( mxGetCell( prhs[6], i ) );
+                read_node->length     = (int) mxGetScalar( mxGetCell( prhs[6], (2 * num_nodes) + i ) );
+                read_node->port       = (int) mxGetScalar( mxGetCell( prhs[6], (4 * num_nodes) + i ) );
+                read_node->max_length = (uint32) mxGetScalar( mxGetCell( prhs[6], (8 * num_nodes) + i ) );
+                read_node->num_pkts   = (uint32) mxGetScalar( mxGetCell( prhs[6], (9 * num_nodes) + i ) );
+
+                // Packet data must be an array of uint8
+                read_arg = mxGetCell( prhs[6], num_nodes + i );
+                if ( mxIsUint8( read_arg ) != 1 ) { mexErrMsgTxt("Error: Input buffer must be an array of uint8"); }
+                if ( mxGetM( read_arg ) != 1 ) { mexErrMsgTxt("Error: Input buffer must be a row vector."); }
+                read_node->buffer = (char *) mxGetData( read_arg );
+                if( read_node->buffer == NULL ) { mexErrMsgTxt("Error:  Could not convert input buffer to array of char."); }
+
+                // IP address (not needed if the socket is connected)
+                read_node->ip_addr = get_ip_addr( read_node->index, mxGetCell( prhs[6], (3 * num_nodes) + i ) );
+
+                // Buffer IDs must be an array of singular buffer IDs
+                read_arg = mxGetCell( prhs[6], (6 * num_nodes) + i );
+                if ( mxIsUint32( read_arg ) != 1 ) { mexErrMsgTxt("Error: Input buffer IDs must be an array of uint32"); }
+                if ( mxGetM( read_arg ) != 1 ) { mexErrMsgTxt("Error: Input buffer IDs must be a row vector."); }
+                read_node->buffer_ids  = (uint32 *) mxGetData( read_arg );
+                if( read_node->buffer_ids == NULL ) { mexErrMsgTxt("Error:  Could not convert input buffer IDs to array of uint32."); }
+                read_node->num_buffers = (uint32) mxGetN( read_arg );
+
+                for ( j = 0; j < read_node->num_buffers; j++ ) {
+                    buffer_id = read_node->buffer_ids[j];
+                    
+                    if ( !((buffer_id == BUFFER_ID_RFA) || (buffer_id == BUFFER_ID_RFB) || (buffer_id == BUFFER_ID_RFC) || (buffer_id == BUFFER_ID_RFD))) {
+                        mexErrMsgTxt("Error:  Buffer selection must be singular.  Use vector notation for reading from multiple buffers e.g. [RFA,RFB]");
+                    }
+                }
+
+                // Sequence tracker must be an array of integers
+                read_arg = mxGetCell( prhs[6], (11 * num_nodes) + i );
+                if ( mxIsUint32( read_arg ) != 1 ) { mexErrMsgTxt("Error: Sequence number tracker must be an array of uint32"); }
+                if ( mxGetM( read_arg ) != 1 ) { mexErrMsgTxt("Error: Sequence number tracker must be a row vector."); }
+                read_node->seq_num_tracker = (uint32 *) mxGetData( read_arg );
+                if( read_node->seq_num_tracker == NULL ) { mexErrMsgTxt("Error:  Could not convert sequence number tracker to array of uint32."); }
+
+                // Sequence number severity must be a string
+                read_arg = mxGetCell( prhs[6], (12 * num_nodes) + i );
+                if ( mxIsChar( read_arg ) != 1 ) { mexErrMsgTxt("Error: Sequence number severity must be a string."); }
+                read_node->seq_num_severity = mxArrayToString( read_arg );
+                if( read_node->seq_num_severity == NULL ) { mexErrMsgTxt("Error:  Could not convert sequence number severity to string."); }
+
+                // Node ID string must be a string
+                read_arg = mxGetCell( prhs[6], (13 * num_nodes) + i );
+                if ( mxIsChar( read_arg ) != 1 ) { mexErrMsgTxt("Error: Node ID string must be a string."); }
+                read_node->node_id_str = mxArrayToString( read_arg );
+                if( read_node->node_id_str == NULL ) { mexErrMsgTxt("Error:  Could not convert node ID string to string."); }
+                
+                num_columns += read_node->num_buffers;
+            }
+            
+            // Allocate the output array with the buffers of each node in consecutive columns
+            switch (data_type) {
+                case IQ_DATA_TYPE_DOUBLE:
+                    plhs[2] = mxCreateDoubleMatrix(num_samples, num_columns, mxCOMPLEX);
+                    if( plhs[2] == NULL ) { mexErrMsgTxt("Error:  Could not allocate return buffer"); }
+
+                    output_array[0]   = (void *) mxGetPr(plhs[2]);
+                    output_array[1]   = (void *) mxGetPi(plhs[2]);
+                    data_size         = sizeof(double);
+                break;
+                
+                case IQ_DATA_TYPE_SINGLE:
+                case IQ_DATA_TYPE_INT16:
+                    mex_data_type     = ( data_type == IQ_DATA_TYPE_SINGLE ) ? mxSINGLE_CLASS : mxINT16_CLASS;
+                    data_size         = ( data_type == IQ_DATA_TYPE_SINGLE ) ? sizeof(float)  : sizeof(int16);
+                    
+                    dims[0] = (mwSize) num_samples;
+                    dims[1] = (mwSize) num_columns;
+
+                    plhs[2] = mxCreateNumericArray(ndim, dims, mex_data_type, mxCOMPLEX);
+                    if( plhs[2] == NULL ) { mexErrMsgTxt("Error:  Could not allocate return buffer"); }
+
+                    output_array[0]   = mxGetData(plhs[2]);
+                    output_array[1]   = mxGetImagData(plhs[2]);
+                break;
+                
+                case IQ_DATA_TYPE_RAW:
+                    dims[0] = (mwSize) num_samples;
+                    dims[1] = (mwSize) num_columns;
+
+                    plhs[2] = mxCreateNumericArray(ndim, dims, mxUINT32_CLASS, mxREAL);
+                    if( plhs[2] == NULL ) { mexErrMsgTxt("Error:  Could not allocate return buffer"); }            
+
+                    output_array[0]   = mxGetData(plhs[2]);
+                    output_array[1]   = NULL;
+                    data_size         = sizeof(uint32);
+                break;
+                
+                default:
+                    mexErrMsgTxt("Error:  Unsupported output data type");
+                break;
+            }
+            
+            // Set the first output column of each node
+            k = 0;
+            
+            for ( i = 0; i < num_nodes; i++ ) {
+                for ( j = 0; j < 2; j++ ) {
+                    if ( output_array[j] != NULL ) {
+                        read_nodes[i].output_array[j] = (void *)(((long long)(output_array[j])) + (long long)(k * num_samples * data_size));
+                    } else {
+                        read_nodes[i].output_array[j] = NULL;
+                    }
+                }
+                
+                k += read_nodes[i].num_buffers;
+            }
+
+            // Send the trigger
+            trigger_time = wl_timestamp;
+            size         = send_socket( handle, buffer, length, ip_addr, port );
+            
+            mxFree( ip_addr );
+            
+            if ( size != length ) {
+                mexErrMsgTxt("Error:  Could not send the trigger");
+            }
+
+            // Wait for the captures to complete
+            //     NOTE:  The time to send the trigger is part of the wait.  Without a usec timestamp (ie wl_timestamp
+            //            is 0), the full wait time is used.
+            //
+            elapsed_time = ( wl_timestamp - trigger_time ) & 0x7FFFFFFF;
+            
+            if ( elapsed_time < (uint32) wait_time ) {
+                wl_usleep( wait_time - elapsed_time );
+            }
+
+            // Read the buffers of all nodes
+            wl_read_iq_nodes( read_nodes, num_nodes, num_samples, start_sample, data_type, (num_samples * data_size) );
+            
+            // Return values to MABLAB
+            plhs[0]    = mxCreateDoubleMatrix(1, 1, mxREAL);
+            plhs[1]    = mxCreateDoubleMatrix(1, num_nodes, mxREAL);
+            cmds_array = mxGetPr(plhs[1]);
+            
+            *mxGetPr(plhs[0]) = num_samples;
+            
+            for ( i = 0; i < num_nodes; i++ ) {
+                cmds_array[i] = read_nodes[i].num_cmds;
+                
+                free( read_nodes[i].ip_addr );
+            }
+            
+            // Free allocated memory
+            free( read_nodes );
+
+#ifdef _DEBUG_
+            printf("END TRANSPORT_TRIGGER_AND_READ \n");
+#endif
+        break;
+
+        //------------------------------------------------------
+        // resp = wl_mex_udp_transport('send_cmd', handle, ip_addr, port, hdr_fields, payload, robust, max_attempts, timeout)
+        //   - Arguments:
+        //     - handle (int)          - index to the requested socket
+        //     - ip_addr               - IP Address of the node
+        //     - port                  - Port of the node
+        //     - hdr_fields (double *) - Transport header fields:  [dest_id, src_id, pkt_type, seq_num]
+        //     - payload (uint32 *)    - Command (command header and arguments) to be sent
+        //     - robust (int)          - Wait for the response of the node
+        //     - max_attempts (int)    - Maximum number of times the command is sent without a response
+        //     - timeout (double)      - Time (in sec) to wait for the response before the command is sent again
+        //   - Returns:
+        //     - resp (uint32 *)       - Response (response header and arguments) of the node; empty if robust
+        //                               is 0
+        //
+        //   NOTE:  This function builds the transport header, sends the command and matches the response so
+        //       that the M code does not need to serialize the transport header and byte swap each packet.
+        //
+        case TRANSPORT_SEND_CMD :
+#ifdef _DEBUG_
+            printf("Function : TRANSPORT_SEND_CMD\n");
+#endif
+            // Validate arguments
+            if( nrhs != 9 ) { print_usage(); die(); }
+            if( nlhs != 1 ) { print_usage(); die(); }
+            
+            // Get input arguments
+            handle       = (int) mxGetScalar(prhs[1]);
+            port         = (int) mxGetScalar(prhs[3]);
+            robust       = (uint32) mxGetScalar(prhs[6]);
+            max_attempts = (uint32) mxGetScalar(prhs[7]);
+            resp_timeout = mxGetScalar(prhs[8]);
+
+            // IP address (not needed if the socket is connected)
+            ip_addr = get_ip_addr( handle, prhs[2] );
+
+            // Header fields must be an array of doubles
+            if ( mxIsDouble( prhs[4] ) != 1 ) { mexErrMsgTxt("Error: Header fields must be an array of doubles"); }
+            if ( ( mxGetM( prhs[4] ) * mxGetN( prhs[4] ) ) != TRANSPORT_HDR_NUM_FIELDS ) { mexErrMsgTxt("Error: Header fields must have 4 elements"); }
+            
+            for ( i = 0; i < TRANSPORT_HDR_NUM_FIELDS; i++ ) {
+                hdr_fields[i] = (uint32) mxGetPr( prhs[4] )[i];
+            }
+            
+            // Payload must be an array of uint32
+            if ( mxIsUint32( prhs[5] ) != 1 ) { mexErrMsgTxt("Error: Payload must be an array of uint32"); }
+            payload       = (uint32 *) mxGetData( prhs[5] );
+            payload_words = (uint32) ( mxGetM( prhs[5] ) * mxGetN( prhs[5] ) );
+
+            // Call function
+            resp_words = wl_send_cmd( handle, ip_addr, port, hdr_fields, payload, payload_words, robust, max_attempts,
+                                      resp_timeout, resp, (sizeof(resp) / sizeof(uint32)) );
+
+            mxFree( ip_addr );
+
+            // Return value to MABLAB
+            plhs[0] = mxCreateNumericMatrix(1, resp_words, mxUINT32_CLASS, mxREAL);
+            memcpy( mxGetData( plhs[0] ), resp, ( resp_words * sizeof(uint32) ) );
+
+#ifdef _DEBUG_
+            printf("END TRANSPORT_SEND_CMD \n");
+#endif
+        break;
+
+        //------------------------------------------------------
+        // resp = wl_mex_udp_transport('receive_resp', handle, hdr_fields)
+        //   - Arguments:
+        //     - handle (int)          - index to the requested socket
+        //     - hdr_fields (double *) - Transport header fields of the last command:  [dest_id, src_id, pkt_type, seq_num]
+        //   - Returns:
+        //     - resp (uint32 *)       - Response (response header and arguments) of the node; empty if no
+        //                               response is available
+        //
+        //   NOTE:  This function is non-blocking.  Packets that are not a response to the last command are
+        //       discarded with a warning.  Like the M transport, a response with the node not ready flag is
+        //       returned to the caller.
+        //
+        case TRANSPORT_RECEIVE_RESP :
+#ifdef _DEBUG_
+            printf("Function : TRANSPORT_RECEIVE_RESP\n");
+#endif
+            // Validate arguments
+            if( nrhs != 3 ) { print_usage(); die(); }
+            if( nlhs != 1 ) { print_usage(); die(); }
+            
+            // Get input arguments
+            handle  = (int) mxGetScalar(prhs[1]);
+
+            // Header fields must be an array of doubles
+            if ( mxIsDouble( prhs[2] ) != 1 ) { mexErrMsgTxt("Error: Header fields must be an array of doubles"); }
+            if ( ( mxGetM( prhs[2] ) * mxGetN( prhs[2] ) ) != TRANSPORT_HDR_NUM_FIELDS ) { mexErrMsgTxt("Error: Header fields must have 4 elements"); }
+            
+            for ( i = 0; i < TRANSPORT_HDR_NUM_FIELDS; i++ ) {
+                hdr_fields[i] = (uint32) mxGetPr( prhs[2] )[i];
+            }
+            
+            // Call function
+            buffer     = (char *) malloc( sizeof(char) * TRANSPORT_MAX_PKT_LENGTH );
+            if( buffer == NULL ) { mexErrMsgTxt("Error:  Could not allocate receive buffer"); }
+            
+            resp_words = 0;
+
+            while ( ( size = receive_socket( handle, TRANSPORT_MAX_PKT_LENGTH, buffer ) ) > 0 ) {
+                resp_words = wl_decode_resp( buffer, size, hdr_fields, 1, resp, (sizeof(resp) / sizeof(uint32)) );
+                
+                if ( resp_words >= 0 ) { break; }
+                
+                if ( size >= (int) sizeof( wl_transport_header ) ) {
+                    printf("WARNING:  transport_header mismatch: [%d %d] [%d %d] [%d %d]\n",
+                           endian_swap_16( ((wl_transport_header *) buffer)->src_id ),  hdr_fields[TRANSPORT_HDR_FIELD_DEST_ID],
+                           endian_swap_16( ((wl_transport_header *) buffer)->dest_id ), hdr_fields[TRANSPORT_HDR_FIELD_SRC_ID],
+                           endian_swap_16( ((wl_transport_header *) buffer)->seq_num ), hdr_fields[TRANSPORT_HDR_FIELD_SEQ_NUM]);
+                }
+                
+                resp_words = 0;
+            }
+            
+            free( buffer );
+
+            // Return value to MABLAB
+            plhs[0] = mxCreateNumericMatrix(1, resp_words, mxUINT32_CLASS, mxREAL);
+            memcpy( mxGetData( plhs[0] ), resp, ( resp_words * sizeof(uint32) ) );
+
+#ifdef _DEBUG_
+            printf("END TRANSPORT_RECEIVE_RESP \n");
+#endif
+        break;
+
+
+        //------------------------------------------------------
+        //  Default
+        //
+        //  Print error message
+        //
+        default:
+            printf("Error:  Function %s not supported.", func);
+            mexErrMsgTxt("Error:  Function not supported.");
+        break; 
+    }
+
+    // Free allocated memory
+    mxFree( func );
+    
+#ifdef _DEBUG_
+    printf("DONE \n");
+#endif
+
+    // if ( function == TRANSPORT_READ_IQ) {
+    //     wl_usleep(5000000);
+    // }
+
+    // Return back to MATLAB
+    return;
+}
+
+
+
+
+/*****************************************************************************/
+//           Additional WL Mex UDP Transport functionality
+/*****************************************************************************/
+
+
+/*****************************************************************************/
+/**
+*
+* This function will adapt the Read IQ request size of a node
+*
+* @param	index          - Index in to socket structure of the node
+* @param    max_length     - Maximum number of bytes of samples in a packet
+* @param    num_retrys     - Number of requests sent again because packets were missing during the request
+* @param    rx_drops       - Number of packets dropped by the OS during the request
+*
+* @return	size           - New Read IQ request size (in bytes)
+*
+* @note		If the OS dropped packets (or, when the OS does not report drops, requests
+*           had to be sent again because packets were missing), then the request size is 
+*           halved.  Otherwise, it grows by 1/8 back up to 80% of the receive buffer.  The 
+*           request size is never less than one packet.  Requests sent again because the
+*           node was not ready (SAMPLE_IQ_NOT_READY) do not count since no packets were lost.
+*
+******************************************************************************/
+uint32 wl_read_iq_adapt_req_size( int index, uint32 max_length, uint32 num_retrys, uint32 rx_drops ) {
+
+    uint32  max_size  = 8 * ( sockets[index].rx_buffer_size / 10 );
+    uint32  size      = sockets[index].read_iq_req_size;
+
+    if ( ( rx_drops > 0 ) || ( num_retrys > 0 ) ) {
+        size = size >> 1;
+    } else {
+        size = size + ( size >> 3 );
+    }
+    
+    if ( size > max_size ) {
+        size = max_size;
+    }
+
+    if ( size < max_length ) {
+        size = max_length;
+    }
+    
+#ifdef _DEBUG_
+    printf("Read IQ request size = %d (drops = %d, retrys = %d)\n", size, rx_drops, num_retrys);
+#endif
+
+    sockets[index].read_iq_req_size = size;
+    
+    return size;
+}
+
+
+
+/*****************************************************************************/
+/**
+*
+* This function will return the host time used by the packet trace
+*
+* @param	None
+*
+* @return	time           - Current time (in sec)
+*
+* @note		On Unix, this uses the same clock as the OS packet timestamps (SO_TIMESTAMPNS)
+*           so that the host processing lag is the difference of the two times.  On Windows,
+*           there are no OS packet timestamps and the time is relative to an arbitrary start.
+*
+******************************************************************************/
+double wl_trace_host_time( void ) {
+#ifdef WIN32
+    return ( (double) wl_mex_udp_transport_usec_timestamp() * 1e-6 );
+#else
+    struct timespec ts;
+
+    clock_gettime( CLOCK_REALTIME, &ts );
+    
+    return ( (double) ts.tv_sec + ( (double) ts.tv_nsec * 1e-9 ) );
+#endif
+}
+
+
+
+/*****************************************************************************/
+/**
+*
+* This function will set the size of the packet trace ring
+*
+* @param	size           - Number of packets in the ring (0 ==> Disabled)
+*
+* @return	None
+*
+* @note		The ring is allocated once so that recording a packet does not allocate memory.
+*
+******************************************************************************/
+void wl_trace_set_size( uint32 size ) {
+    int i;
+
+    if ( trace_ring != NULL ) {
+        free( trace_ring );
+        trace_ring = NULL;
+    }
+
+    trace_size  = 0;
+    trace_count = 0;
+
+    if ( size != 0 ) {
+        trace_ring = (wl_trace_entry *) malloc( sizeof(wl_trace_entry) * size );
+        
+        if ( trace_ring == NULL ) {
+            die_with_error("Error:  Cannot allocate memory for packet trace.");
+        }
+        
+        make_persistent( trace_ring );
+        
+        trace_size = size;
+    }
+    
+    // Update the OS timestamps on all open sockets
+    for ( i = 0; i < TRANSPORT_MAX_SOCKETS; i++ ) {
+        if ( sockets[i].status == TRANSPORT_SOCKET_IN_USE ) {
+            set_rx_timestamp( i, ( ( trace_size != 0 ) || ( capture_fp != NULL ) ) );
+        }
+    }
+}
+
+
+
+/*****************************************************************************/
+/**
+*
+* This function will record a packet in the packet trace
+*
+* @param	index          - Index in to socket structure
+* @param    direction      - TRANSPORT_TRACE_TX / TRANSPORT_TRACE_RX
+* @param    length         - Length of the packet (in bytes)
+* @param    kernel_time    - Time the OS received the packet (in sec; 0 if not available)
+*
+* @return	None
+*
+* @note		The sample and retry count are set by wl_trace_annotate() once the packet is decoded.
+*
+******************************************************************************/
+void wl_trace_record( int index, uint32 direction, uint32 length, double kernel_time ) {
+
+    wl_trace_entry * entry = &(trace_ring[trace_count % trace_size]);
+
+    entry->direction   = direction;
+    entry->socket      = index;
+    entry->retry       = 0;
+    entry->length      = length;
+    entry->sample      = TRANSPORT_TRACE_NO_SAMPLE;
+    entry->kernel_time = kernel_time;
+    entry->host_time   = wl_trace_host_time();
+
+    trace_count++;
+}
+
+
+
+/*****************************************************************************/
+/**
+*
+* This function will add the sample information to the last packet in the packet trace
+*
+* @param	sample         - Starting sample of the packet
+* @param    retry          - Retry count of the transfer
+*
+* @return	None
+*
+******************************************************************************/
+void wl_trace_annotate( uint32 sample, uint32 retry ) {
+
+    wl_trace_entry * entry;
+
+    if ( ( trace_size == 0 ) || ( trace_count == 0 ) ) {
+        return;
+    }
+    
+    entry = &(trace_ring[(trace_count - 1) % trace_size]);
+
+    entry->sample = sample;
+    entry->retry  = ( retry > 0xFFFF ) ? 0xFFFF : retry;
+}
+
+
+
+/*****************************************************************************/
+/**
+*
+* This function will return the packet trace and clear it
+*
+* @param	filename       - File to write the trace to (NULL ==> Do not write a file)
+*
+* @return	trace          - TRANSPORT_TRACE_NUM_FIELDS x N matrix of doubles (oldest packet first)
+*
+******************************************************************************/
+mxArray * wl_trace_get( char *filename ) {
+
+    mxArray         * trace;
+    double          * values;
+    wl_trace_entry  * entry;
+    FILE            * fp;
+    uint32            num_entries;
+    uint32            first;
+    uint32            i;
+
+    num_entries = ( trace_count < trace_size ) ? trace_count : trace_size;
+    first       = trace_count - num_entries;
+
+    trace  = mxCreateDoubleMatrix( TRANSPORT_TRACE_NUM_FIELDS, num_entries, mxREAL );
+    values = mxGetPr( trace );
+
+    for ( i = 0; i < num_entries; i++ ) {
+        entry = &(trace_ring[(first + i) % trace_size]);
+
+        values[TRANSPORT_TRACE_FIELD_DIRECTION]   = entry->direction;
+        values[TRANSPORT_TRACE_FIELD_SOCKET]      = entry->socket;
+        values[TRANSPORT_TRACE_FIELD_KERNEL_TIME] = entry->kernel_time;
+        values[TRANSPORT_TRACE_FIELD_HOST_TIME]   = entry->host_time;
+        values[TRANSPORT_TRACE_FIELD_LENGTH]      = entry->length;
+        values[TRANSPORT_TRACE_FIELD_SAMPLE]      = ( entry->sample == TRANSPORT_TRACE_NO_SAMPLE ) ? -1 : (double) entry->sample;
+        values[TRANSPORT_TRACE_FIELD_RETRY]       = entry->retry;
+
+        values += TRANSPORT_TRACE_NUM_FIELDS;
+    }
+
+    if ( trace_count > trace_size ) {
+        printf("WARNING:  Packet trace overflowed.  Lost the oldest %d packets.\n", ( trace_count - trace_size ));
+    }
+    
+    // Write the trace to the file
+    if ( filename != NULL ) {
+        fp = fopen( filename, "wb" );
+        
+        if ( fp == NULL ) {
+            printf("Error:  Cannot open file %s\n", filename);
+            die();
+        }
+        
+        fwrite( mxGetPr( trace ), sizeof(double), ( TRANSPORT_TRACE_NUM_FIELDS * num_entries ), fp );
+        fclose( fp );
+    }
+
+    // Clear the trace
+    trace_count = 0;
+
+    return trace;
+}
+
+
+
+/*****************************************************************************/
+/**
+*
+* This function will start / stop the packet capture
+*
+* @param	filename       - pcap file to capture to (empty string ==> Stop the capture)
+*
+* @return	None
+*
+* @note		The pcap headers are written in host byte order (the magic number tells readers
+*           the byte order) and each packet uses the raw IP link type.
+*
+******************************************************************************/
+void wl_capture_open( char *filename ) {
+    int    i;
+    uint32 file_hdr[6];
+
+    if ( capture_fp != NULL ) {
+        fclose( capture_fp );
+        capture_fp = NULL;
+    }
+
+    if ( ( filename != NULL ) && ( filename[0] != 0 ) ) {
+        capture_fp = fopen( filename, "wb" );
+        
+        if ( capture_fp == NULL ) {
+            printf("Error:  Cannot open file %s\n", filename);
+            die();
+        }
+        
+        file_hdr[0] = TRANSPORT_CAPTURE_MAGIC;
+        file_hdr[1] = ( TRANSPORT_CAPTURE_VERSION_MINOR << 16 ) | TRANSPORT_CAPTURE_VERSION_MAJOR;    // Major version is the first uint16
+        file_hdr[2] = 0;                                                                              // Timezone offset
+        file_hdr[3] = 0;                                                                              // Timestamp accuracy
+        file_hdr[4] = TRANSPORT_CAPTURE_SNAPLEN;
+        file_hdr[5] = TRANSPORT_CAPTURE_LINKTYPE_RAW;
+        
+        fwrite( file_hdr, sizeof(uint32), 6, capture_fp );
+    }
+    
+    // Update the OS timestamps on all open sockets
+    for ( i = 0; i < TRANSPORT_MAX_SOCKETS; i++ ) {
+        if ( sockets[i].status == TRANSPORT_SOCKET_IN_USE ) {
+            set_rx_timestamp( i, ( ( trace_size != 0 ) || ( capture_fp != NULL ) ) );
+        }
+    }
+}
+
+
+
+/*****************************************************************************/
+/**
+*
+* This function will write a datagram to the packet capture
+*
+* @param	index          - Index in to socket structure
+* @param    direction      - TRANSPORT_TRACE_TX / TRANSPORT_TRACE_RX
+* @param    buffer         - Datagram
+* @param    length         - Length of the datagram (in bytes)
+* @param    remote         - Address of the node (NULL ==> Use the address the socket is connected to)
+* @param    time           - Time the datagram was sent / received (in sec)
+*
+* @return	None
+*
+******************************************************************************/
+void wl_capture_record( int index, uint32 direction, char *buffer, int length, struct sockaddr_in *remote, double time ) {
+
+    struct sockaddr_in  local;
+    struct sockaddr_in  peer;
+    struct sockaddr_in *src;
+    struct sockaddr_in *dest;
+    int                 addr_size;
+    uint32              pkt_hdr[4];
+    uint8               hdr[TRANSPORT_CAPTURE_IP_HDR_LENGTH + TRANSPORT_CAPTURE_UDP_HDR_LENGTH];
+    uint32              total_length;
+    uint32              checksum;
+    int                 i;
+
+    // Get the addresses of the datagram
+    memset( &local, 0, sizeof(local) );
+    addr_size = sizeof(local);
+    getsockname( sockets[index].handle, (struct sockaddr *) &local, (socklen_t *) &addr_size );
+    
+    if ( remote == NULL ) {
+        memset( &peer, 0, sizeof(peer) );
+        addr_size = sizeof(peer);
+        getpeername( sockets[index].handle, (struct sockaddr *) &peer, (socklen_t *) &addr_size );
+        remote = &peer;
+    }
+    
+    if ( direction == TRANSPORT_TRACE_TX ) {
+        src  = &local;
+        dest = remote;
+    } else {
+        src  = remote;
+        dest = &local;
+    }
+    
+    total_length = TRANSPORT_CAPTURE_IP_HDR_LENGTH + TRANSPORT_CAPTURE_UDP_HDR_LENGTH + length;
+
+    // Packet record header
+    pkt_hdr[0] = (uint32) time;
+    pkt_hdr[1] = (uint32) ( ( time - (double) pkt_hdr[0] ) * 1e6 );
+    pkt_hdr[2] = total_length;
+    pkt_hdr[3] = total_length;
+
+    // IPv4 header (no options, do not fragment, TTL = 64, protocol = UDP)
+    memset( hdr, 0, sizeof(hdr) );
+    
+    hdr[0]  = 0x45;
+    hdr[2]  = ( total_length >> 8 ) & 0xFF;
+    hdr[3]  = total_length & 0xFF;
+    hdr[6]  = 0x40;
+    hdr[8]  = 64;
+    hdr[9]  = IPPROTO_UDP;
+    memcpy( &hdr[12], &(src->sin_addr.s_addr), 4 );
+    memcpy( &hdr[16], &(dest->sin_addr.s_addr), 4 );
+
+    checksum = 0;
+    for ( i = 0; i < TRANSPORT_CAPTURE_IP_HDR_LENGTH; i += 2 ) {
+        checksum += ( hdr[i] << 8 ) | hdr[i + 1];
+    }
+    while ( checksum >> 16 ) {
+        checksum = ( checksum & 0xFFFF ) + ( checksum >> 16 );
+    }
+    checksum = ~checksum & 0xFFFF;
+    
+    hdr[10] = ( checksum >> 8 ) & 0xFF;
+    hdr[11] = checksum & 0xFF;
+
+    // UDP header (no checksum)
+    memcpy( &hdr[20], &(src->sin_port), 2 );
+    memcpy( &hdr[22], &(dest->sin_port), 2 );
+    hdr[24] = ( ( length + TRANSPORT_CAPTURE_UDP_HDR_LENGTH ) >> 8 ) & 0xFF;
+    hdr[25] = ( length + TRANSPORT_CAPTURE_UDP_HDR_LENGTH ) & 0xFF;
+
+    fwrite( pkt_hdr, sizeof(uint32), 4, capture_fp );
+    fwrite( hdr, sizeof(uint8), sizeof(hdr), capture_fp );
+    fwrite( buffer, sizeof(char), length, capture_fp );
+}
+
+
+
+/*****************************************************************************/
+/**
+*
+* This function will set the impairments of the transport
+*
+* @param	direction      - TRANSPORT_IMPAIR_TX / TRANSPORT_IMPAIR_RX (0 ==> Disabled)
+* @param    loss           - Loss parameters (1 element - Bernoulli; 4 elements - Gilbert-Elliott)
+* @param    reorder        - Reorder parameters (1 element - Disabled; 2 elements - [probability, depth])
+* @param    duplicate      - Probability a packet is duplicated
+* @param    delay          - Latency (in usec) added to received packets
+* @param    seed           - Seed of the random number generator (0 ==> Default seed)
+*
+* @return	None
+*
+******************************************************************************/
+void wl_impair_set( uint32 direction, const mxArray *loss, const mxArray *reorder, double duplicate, double delay, uint32 seed ) {
+
+    uint32   i;
+    double  *values;
+
+    // Set the parameters
+    values = mxGetPr( loss );
+    
+    if ( mxGetNumberOfElements( loss ) == 4 ) {
+        impair_loss_model = TRANSPORT_IMPAIR_LOSS_GILBERT_ELLIOTT;
+        for ( i = 0; i < 4; i++ ) { impair_loss[i] = values[i]; }
+    } else {
+        impair_loss_model = TRANSPORT_IMPAIR_LOSS_BERNOULLI;
+        for ( i = 0; i < 4; i++ ) { impair_loss[i] = 0; }
+        impair_loss[0]    = values[0];
+    }
+
+    values = mxGetPr( reorder );
+    
+    if ( mxGetNumberOfElements( reorder ) == 2 ) {
+        impair_reorder_prob  = values[0];
+        impair_reorder_depth = (uint32) values[1];
+    } else {
+        impair_reorder_prob  = 0;
+        impair_reorder_depth = 0;
+    }
+    
+    impair_duplicate     = duplicate;
+    impair_delay         = delay * 1e-6;
+    impair_rng_state     = ( seed != 0 ) ? seed : TRANSPORT_IMPAIR_DEFAULT_SEED;
+    impair_seq           = 0;
+    impair_loss_state[0] = TRANSPORT_IMPAIR_STATE_GOOD;
+    impair_loss_state[1] = TRANSPORT_IMPAIR_STATE_GOOD;
+    
+    for ( i = 0; i < TRANSPORT_IMPAIR_NUM_STATS; i++ ) { impair_stats[i] = 0; }
+
+    // Allocate the queue for received packets
+    if ( ( direction & TRANSPORT_IMPAIR_RX ) && ( impair_queue == NULL ) ) {
+        impair_queue = (wl_impair_entry *) malloc( sizeof(wl_impair_entry) * TRANSPORT_IMPAIR_QUEUE_SIZE );
+        
+        if ( impair_queue == NULL ) {
+            die_with_error("Error:  Cannot allocate memory for impairment queue.");
+        }
+        
+        make_persistent( impair_queue );
+    }
+    
+    if ( impair_queue != NULL ) {
+        for ( i = 0; i < TRANSPORT_IMPAIR_QUEUE_SIZE; i++ ) { impair_queue[i].socket = -1; }
+    }
+
+    impair_direction = direction & ( TRANSPORT_IMPAIR_TX | TRANSPORT_IMPAIR_RX );
+}
+
+
+
+/*****************************************************************************/
+/**
+*
+* This function will return the impairment statistics
+*
+* @param	None
+*
+* @return	stats          - Struct of impairment statistics
+*
+******************************************************************************/
+mxArray * wl_impair_get_stats( void ) {
+
+    mxArray   *output;
+    
+    const char *field_names[] = { "tx_lost", "rx_lost", "duplicated", "reordered", "delayed", "overflow" };
+    
+    output = mxCreateStructMatrix( 1, 1, ( sizeof( field_names ) / sizeof( field_names[0] ) ), field_names );
+    
+    mxSetField( output, 0, "tx_lost",    mxCreateDoubleScalar( impair_stats[TRANSPORT_IMPAIR_STAT_TX_LOST] ) );
+    mxSetField( output, 0, "rx_lost",    mxCreateDoubleScalar( impair_stats[TRANSPORT_IMPAIR_STAT_RX_LOST] ) );
+    mxSetField( output, 0, "duplicated", mxCreateDoubleScalar( impair_stats[TRANSPORT_IMPAIR_STAT_DUPLICATED] ) );
+    mxSetField( output, 0, "reordered",  mxCreateDoubleScalar( impair_stats[TRANSPORT_IMPAIR_STAT_REORDERED] ) );
+    mxSetField( output, 0, "delayed",    mxCreateDoubleScalar( impair_stats[TRANSPORT_IMPAIR_STAT_DELAYED] ) );
+    mxSetField( output, 0, "overflow",   mxCreateDoubleScalar( impair_stats[TRANSPORT_IMPAIR_STAT_OVERFLOW] ) );
+    
+    return output;
+}
+
+
+
+/*****************************************************************************/
+/**
+*
+* This function will return a uniform random number in [0, 1)
+*
+* @param	None
+*
+* @return	value          - Random number
+*
+* @note		This uses a xorshift generator so that the impairments only depend on the seed
+*           (and not on the C library or other users of rand()).
+*
+******************************************************************************/
+double wl_impair_rand( void ) {
+
+    impair_rng_state ^= impair_rng_state << 13;
+    impair_rng_state ^= impair_rng_state >> 17;
+    impair_rng_state ^= impair_rng_state << 5;
+
+    return ( (double) ( impair_rng_state >> 8 ) / 16777216.0 );
+}
+
+
+
+/*****************************************************************************/
+/**
+*
+* This function will determine if a packet is lost
+*
+* @param	direction      - TRANSPORT_IMPAIR_TX / TRANSPORT_IMPAIR_RX
+*
+* @return	lost           - 1 if the packet is lost; 0 otherwise
+*
+* @note		For Gilbert-Elliott loss, each direction has its own channel state which is updated
+*           for every packet before the loss is drawn.
+*
+******************************************************************************/
+uint32 wl_impair_lose( uint32 direction ) {
+
+    uint32  *state = &(impair_loss_state[( direction == TRANSPORT_IMPAIR_TX ) ? 0 : 1]);
+
+    if ( impair_loss_model == TRANSPORT_IMPAIR_LOSS_BERNOULLI ) {
+        return ( wl_impair_rand() < impair_loss[0] );
+    }
+    
+    if ( *state == TRANSPORT_IMPAIR_STATE_GOOD ) {
+        if ( wl_impair_rand() < impair_loss[0] ) { *state = TRANSPORT_IMPAIR_STATE_BAD; }
+    } else {
+        if ( wl_impair_rand() < impair_loss[1] ) { *state = TRANSPORT_IMPAIR_STATE_GOOD; }
+    }
+
+    return ( wl_impair_rand() < impair_loss[( *state == TRANSPORT_IMPAIR_STATE_GOOD ) ? 2 : 3] );
+}
+
+
+
+/*****************************************************************************/
+/**
+*
+* This function will apply the impairments to a packet that is sent
+*
+* @param	None
+*
+* @return	num_copies     - Number of copies of the packet to send (0 - lost; 1 - normal; 2 - duplicated)
+*
+******************************************************************************/
+uint32 wl_impair_tx( void ) {
+
+    if ( wl_impair_lose( TRANSPORT_IMPAIR_TX ) ) {
+        impair_stats[TRANSPORT_IMPAIR_STAT_TX_LOST]++;
+        return 0;
+    }
+    
+    if ( wl_impair_rand() < impair_duplicate ) {
+        impair_stats[TRANSPORT_IMPAIR_STAT_DUPLICATED]++;
+        return 2;
+    }
+
+    return 1;
+}
+
+
+
+/*****************************************************************************/
+/**
+*
+* This function will apply the impairments to a packet that is received
+*
+* @param	index          - Index in to socket structure
+* @param    buffer         - Buffer with the received packet / for the packet to return
+* @param    size           - Size of the received packet (<= 0 if no packet was received)
+* @param    length         - Length of the buffer
+* @param    address        - Address of the received packet / of the packet to return
+* @param    kernel_time    - OS time of the received packet / of the packet to return
+*
+* @return	size           - Size of the packet to return (or the size argument if no packet is due)
+*
+* @note		The received packet is copied in to the impairment queue (or lost) and the oldest
+*           packet of the socket that is due is returned:
+*               - A delayed packet is due once the latency has passed
+*               - A reordered packet is due once 'skip' later packets were returned (or after
+*                 TRANSPORT_IMPAIR_REORDER_TIMEOUT so the last packets of a transfer are not held
+*                 until the next transfer)
+*
+******************************************************************************/
+int wl_impair_rx( int index, char *buffer, int size, int length, struct sockaddr_in *address, double *kernel_time ) {
+
+    uint32            i;
+    uint32            num_copies;
+    wl_impair_entry * entry;
+    wl_impair_entry * next;
+    double            now;
+
+    now = wl_trace_host_time();
+
+    // Queue the received packet
+    if ( size > 0 ) {
+        num_copies = 1;
+        
+        if ( wl_impair_lose( TRANSPORT_IMPAIR_RX ) ) {
+            impair_stats[TRANSPORT_IMPAIR_STAT_RX_LOST]++;
+            num_copies = 0;
+        } else if ( wl_impair_rand() < impair_duplicate ) {
+            impair_stats[TRANSPORT_IMPAIR_STAT_DUPLICATED]++;
+            num_copies = 2;
+        }
+        
+        for ( i = 0; ( i < TRANSPORT_IMPAIR_QUEUE_SIZE ) && ( num_copies > 0 ); i++ ) {
+            entry = &(impair_queue[i]);
+            
+            if ( entry->socket != -1 ) { continue; }
+            
+            entry->socket       = index;
+            entry->seq          = impair_seq++;
+            entry->skip         = 0;
+            entry->release_time = now + impair_delay;
+            entry->kernel_time  = *kernel_time;
+            entry->address      = *address;
+            entry->length       = size;
+            
+            memcpy( entry->data, buffer, size );
+            
+            if ( ( impair_reorder_depth != 0 ) && ( wl_impair_rand() < impair_reorder_prob ) ) {
+                entry->skip = 1 + (uint32) ( wl_impair_rand() * impair_reorder_depth );
+                impair_stats[TRANSPORT_IMPAIR_STAT_REORDERED]++;
+            }
+            
+            if ( impair_delay > 0 ) {
+                impair_stats[TRANSPORT_IMPAIR_STAT_DELAYED]++;
+            }
+            
+            num_copies--;
+        }
+        
+        if ( num_copies > 0 ) {
+            impair_stats[TRANSPORT_IMPAIR_STAT_OVERFLOW]++;
+        }
+        
+        size = 0;
+    }
+
+    // Find the oldest packet of the socket that is due
+    next = NULL;
+    
+    for ( i = 0; i < TRANSPORT_IMPAIR_QUEUE_SIZE; i++ ) {
+        entry = &(impair_queue[i]);
+        
+        if ( ( entry->socket != index ) || ( entry->release_time > now ) ) { continue; }
+        
+        if ( ( entry->skip != 0 ) && ( entry->release_time + TRANSPORT_IMPAIR_REORDER_TIMEOUT > now ) ) { continue; }
+        
+        if ( ( next == NULL ) || ( entry->seq < next->seq ) ) { next = entry; }
+    }
+    
+    if ( next == NULL ) {
+        return size;
+    }
+    
+    // Older reordered packets of the socket are now one packet closer to being due
+    for ( i = 0; i < TRANSPORT_IMPAIR_QUEUE_SIZE; i++ ) {
+        entry = &(impair_queue[i]);
+        
+        if ( ( entry->socket == index ) && ( entry->skip != 0 ) && ( entry->seq < next->seq ) ) { entry->skip--; }
+    }
+
+    // Return the packet
+    size         = ( next->length < length ) ? next->length : length;
+    *address     = next->address;
+    *kernel_time = next->kernel_time;
+    
+    memcpy( buffer, next->data, size );
+    
+    next->socket = -1;
+
+    return size;
+}
+
+
+
+/*****************************************************************************/
+/**
+*
+* This function will send a WARPLab command and wait for the response
+*
+* @param	index          - Index in to socket structure used to send the command
+* @param    ip_addr        - IP Address of node
+* @param    port           - Port of node
+* @param    hdr_fields     - Transport header fields (TRANSPORT_HDR_FIELD_*)
+* @param    payload        - Command (command header and arguments) in host byte order
+* @param    payload_words  - Number of words in the payload
+* @param    robust         - Wait for the response of the node
+* @param    max_attempts   - Maximum number of times the command is sent without a response
+* @param    timeout        - Time (in sec) to wait for the response before the command is sent again
+* @param    resp           - Return parameter - Response (response header and arguments) in host byte order
+* @param    max_resp_words - Size of resp (in words)
+*
+* @return	resp_words     - Number of words in the response
+*
+* @note		The command is sent again after timeout seconds (ie the 'timeout' property of the M 
+*           transport) without a response.  Responses with the TRANSPORT_HDR_NODE_NOT_READY_FLAG 
+*           cause the command to be sent again after TRANSPORT_NOT_READY_WAIT_TIME.
+*
+******************************************************************************/
+int wl_send_cmd( int index, char *ip_addr, int port, uint32 *hdr_fields, uint32 *payload, uint32 payload_words,
+                 uint32 robust, uint32 max_attempts, double timeout, uint32 *resp, uint32 max_resp_words ) {
+
+    char                     cmd_buffer[TRANSPORT_MAX_PKT_LENGTH];
+    char                     resp_buffer[TRANSPORT_MAX_PKT_LENGTH];
+    wl_transport_header     *transport_hdr;
+    uint32                  *cmd_payload;
+    int                      length;
+    int                      rcvd_size;
+    int                      resp_words          = 0;
+    double                   deadline            = 0;
+    uint32                   num_tx              = 0;
+    uint32                   num_wait_retries    = 0;
+    uint32                   i;
+
+    length = sizeof(wl_transport_header) + ( payload_words * sizeof(uint32) );
+    
+    if ( length > TRANSPORT_MAX_PKT_LENGTH ) {
+        die_with_error("Error:  Command is larger than the maximum packet length.");
+    }
+    
+    // Build the packet
+    //     NOTE:  The transport header starts with the padding so the payload is 32 bit aligned w/ Eth header
+    //
+    transport_hdr            = (wl_transport_header *) cmd_buffer;
+    cmd_payload              = (uint32 *) ( cmd_buffer + sizeof(wl_transport_header) );
+
+    transport_hdr->padding   = 0;
+    transport_hdr->dest_id   = endian_swap_16( (uint16) hdr_fields[TRANSPORT_HDR_FIELD_DEST_ID] );
+    transport_hdr->src_id    = endian_swap_16( (uint16) hdr_fields[TRANSPORT_HDR_FIELD_SRC_ID] );
+    transport_hdr->rsvd      = 0;
+    transport_hdr->pkt_type  = (uint8) hdr_fields[TRANSPORT_HDR_FIELD_PKT_TYPE];
+    transport_hdr->length    = endian_swap_16( (uint16) ( payload_words * sizeof(uint32) ) );
+    transport_hdr->seq_num   = endian_swap_16( (uint16) hdr_fields[TRANSPORT_HDR_FIELD_SEQ_NUM] );
+    transport_hdr->flags     = endian_swap_16( (uint16) ( robust ? TRANSPORT_FLAG_ROBUST : 0 ) );
+
+    for ( i = 0; i < payload_words; i++ ) {
+        cmd_payload[i] = endian_swap_32( payload[i] );
+    }
+
+    // Send the packet
+    send_socket( index, cmd_buffer, length, ip_addr, port );
+    num_tx  += 1;
+
+    if ( robust == 0 ) {
+        return 0;
+    }
+    
+    deadline = wl_trace_host_time() + timeout;
+    
+    // Wait for the response
+    while ( 1 ) {
+        rcvd_size = receive_socket( index, TRANSPORT_MAX_PKT_LENGTH, resp_buffer );
+        
+        if ( rcvd_size > 0 ) {
+            resp_words = wl_decode_resp( resp_buffer, rcvd_size, hdr_fields, 0, resp, max_resp_words );
+
+            if ( resp_words >= 0 ) {
+                break;
+            }
+            
+            if ( resp_words == TRANSPORT_RESP_NOT_READY ) {
+                // Node is not ready; Wait and try again
+                wl_usleep( TRANSPORT_NOT_READY_WAIT_TIME );
+                num_wait_retries += 1;
+
+                // Check that we have not spent a "long time" waiting for the node to be ready
+                if ( num_wait_retries > TRANSPORT_NOT_READY_MAX_RETRY ) {
+                    die_with_error("Error:  Timeout waiting for node to be ready.  Please check the node operation.");
+                }
+                
+                send_socket( index, cmd_buffer, length, ip_addr, port );
+                deadline = wl_trace_host_time() + timeout;
+            }
+        }
+        
+        // Send the command again after the timeout
+        if ( wl_trace_host_time() >= deadline ) {
+        
+            if ( num_tx >= max_attempts ) {
+                die_with_error("Error:  Maximum number of retransmissions met without reply from node.");
+            }
+            
+            send_socket( index, cmd_buffer, length, ip_addr, port );
+            num_tx  += 1;
+            deadline = wl_trace_host_time() + timeout;
+        }
+    }
+    
+    return resp_words;
+}
+
+
+
+/*****************************************************************************/
+/**
+*
+* This function will decode a response to a WARPLab command
+*
+* @param	buffer         - Received packet
+* @param    length         - Length (in bytes) of the received packet
+* @param    hdr_fields     - Transport header fields (TRANSPORT_HDR_FIELD_*) of the command
+* @param    accept_not_ready - Return a response with the TRANSPORT_HDR_NODE_NOT_READY_FLAG like any other response
+* @param    resp           - Return parameter - Response (response header and arguments) in host byte order
+* @param    max_resp_words - Size of resp (in words)
+*
+* @return	resp_words     - Number of words in the response; or
+*                                TRANSPORT_RESP_NO_MATCH  - Packet is not a response to the command
+*                                TRANSPORT_RESP_NOT_READY - Node is not ready to respond to the command
+*
+******************************************************************************/
+int wl_decode_resp( char *buffer, int length, uint32 *hdr_fields, uint32 accept_not_ready, uint32 *resp, uint32 max_resp_words ) {
+
+    wl_transport_header     *transport_hdr       = (wl_transport_header *) buffer;
+    uint32                  *resp_payload        = (uint32 *) ( buffer + sizeof(wl_transport_header) );
+    uint32                   resp_words;
+    uint32                   i;
+
+    if ( length < (int) sizeof(wl_transport_header) ) {
+        return TRANSPORT_RESP_NO_MATCH;
+    }
+
+    // The response is sent from the destination of the command to the source of the command
+    if ( ( endian_swap_16( transport_hdr->src_id  ) != (uint16) hdr_fields[TRANSPORT_HDR_FIELD_DEST_ID] ) ||
+         ( endian_swap_16( transport_hdr->dest_id ) != (uint16) hdr_fields[TRANSPORT_HDR_FIELD_SRC_ID]  ) ||
+         ( endian_swap_16( transport_hdr->seq_num ) != (uint16) hdr_fields[TRANSPORT_HDR_FIELD_SEQ_NUM] ) ) {
+        return TRANSPORT_RESP_NO_MATCH;
+    }
+    
+    if ( ( accept_not_ready == 0 ) &&
+         ( ( endian_swap_16( transport_hdr->flags ) & TRANSPORT_HDR_NODE_NOT_READY_FLAG ) == TRANSPORT_HDR_NODE_NOT_READY_FLAG ) ) {
+        return TRANSPORT_RESP_NOT_READY;
+    }
+    
+    resp_words = ( length - sizeof(wl_transport_header) ) / sizeof(uint32);
+    
+    if ( resp_words > max_resp_words ) {
+        resp_words = max_resp_words;
+    }
+    
+    for ( i = 0; i < resp_words; i++ ) {
+        resp[i] = endian_swap_32( resp_payload[i] );
+    }
+    
+    return resp_words;
+}
+
+
+/*****************************************************************************/
+/**
+*
+* This function will receive a packet
+*
+* @param	index          - Index in to socket structure which will receive samples
+* @param	buffer         - WARPLab command to request samples
+* @param	length         - Length (in bytes) of buffer
+* @param    ip_addr        - IP Address of node to retrieve samples
+* @param    port           - Port of node to retrieve samples
+* @param    num_samples    - Number of samples to process (should be the same as the argument in the WARPLab command)
+* @param    start_sample   - Index of starting sample (should be the same as the agrument in the WARPLab command)
+* @param    buffer_id      - Which buffer(s) do we need to retrieve samples from
+* @param    output_array   - Return parameter - array of samples to return
+* @param    num_cmds       - Return parameter - number of ethernet send commands used to request packets 
+*                                (could be > 1 if there are transmission errors)
+*
+* @return	size           - Number of samples processed (also size of output_array)
+*
+* @note		This function requires the following pointers:
+*   Input:
+*       - Buffer containing command to request samples (char *)
+*       - IP Address (char *)
+*       - Array of buffer IDs (uint32 *)
+*       - Allocated memory to return samples (uint32 *)
+*       - Location to return the number of send commands used to generate the samples (uint32 *)
+*
+*   Output:
+*       - Number of samples processed 
+*
+******************************************************************************/
+int wl_receive_response( int index, 
+                         char *resp_buffer, int resp_buffer_size, uint32 *resp_time, 
+                         char *cmd_buffer,  int cmd_buffer_size, char *ip_addr, int port, wl_function_ptr_t cmd_update_callback
+                       ) {
+
+    int                      done                = 0;
+    uint32                   timeout             = 0;
+    uint32                   num_retries         = 0;
+    uint32                   num_wait_retries    = 0;
+    int                      sent_size           = 0;
+    int                      rcvd_size           = 0;
+    uint32                   total_cmds          = 0;
+
+    wl_transport_header     *rcvd_transport_hdr;
+    
+
+    // Try to process the return packet
+    while ( !done ) {
+
+        // If we hit the timeout, then resend the command
+        if ( timeout >= TRANSPORT_TIMEOUT ) {
+        
+            // If we hit the max number of retrys, then abort
+            if ( num_retries >= TRANSPORT_MAX_RETRY ) {
+
+                printf("ERROR:  Exceeded %d retries for current command request\n", TRANSPORT_MAX_RETRY);
+                die_with_error("Error:  Reached maximum number of retries without a response... aborting.");
+                
+            } else {            
+                // Retransmit the command packet
+
+                // See if there are any updates required                
+                cmd_update_callback( cmd_buffer, cmd_buffer_size, ip_addr, port );
+                
+                // Send the packet
+                sent_size    = send_socket( index, cmd_buffer, cmd_buffer_size, ip_addr, port );
+                total_cmds  += 1;
+                
+                // Update control variables
+                timeout      = 0;
+                num_retries += 1;
+            }
+        }
+        
+        // Receive packet
+        rcvd_size = receive_socket( index, resp_buffer_size, resp_buffer );
+
+        // receive_socket() handles all socket related errors and will only return:
+        //   - zero if no packet is available
+        //   - non-zero if packet is available
+        if ( rcvd_size > 0 ) {
+            // Decode the ethernet packet
+            rcvd_transport_hdr  = (wl_transport_header *) resp_buffer;
+            
+            // Record the response timeout value
+            *resp_time   = timeout;
+
+            // Reset the timeout regardless of the contents of the packet
+            timeout      = 0;
+
+            // Check the transport header to see if we should wait
+            if ( (rcvd_transport_hdr->flags & TRANSPORT_HDR_NODE_NOT_READY_FLAG) == TRANSPORT_HDR_NODE_NOT_READY_FLAG ) {
+            
+                // Node is not ready; Wait and try again
+                wl_usleep( TRANSPORT_NOT_READY_WAIT_TIME );                
+                num_wait_retries += 1;
+
+                // Send packet to request samples
+                sent_size   = send_socket( index, cmd_buffer, cmd_buffer_size, ip_addr, port );
+                total_cmds += 1;
+
+                // Check that we have not spent a "long time" waiting for samples to be ready                
+                if ( num_wait_retries > TRANSPORT_NOT_READY_MAX_RETRY ) {
+                    die_with_error("Error:  Timeout waiting for node to be ready.  Please check the node operation.");
+                }            
+            } else {
+                done = 1;
+            }
+        }
+    }
+    
+    return total_cmds;
+}
+
+
+
+/*****************************************************************************/
+/**
+*
+* This function will read the baseband buffers and construct the sample array
+*
+* @param	index          - Index in to socket structure which will receive samples
 * @param	buffer         - WARPLab command to request samples
 * @param	length         - Length (in bytes) of buffer
 * @param    ip_addr        - IP Address of node to retrieve samples
@@ -2266,7 +4981,8 @@ int wl_receive_response( int index,
 * @param    initial_offset - Initial offset of the Read IQ request
 * @param    num_samples    - Number of samples to process (should be the same as the argument in the WARPLab command)
 * @param    start_sample   - Index of starting sample (this changes when "chunking")
-* @param    buffer_id      - Which buffer(s) do we need to retrieve samples from
+* @param    buffer_ids     - Array of singular buffer IDs to retrieve samples from in this request
+* @param    num_buffers    - Number of buffer IDs in buffer_ids
 * @param    function       - Function that we are reading data for:
 *                                Values = [TRANSPORT_READ_IQ, TRANSPORT_READ_RSSI]
 * @param    data_type      - Type of the output array:
@@ -2274,591 +4990,1996 @@ int wl_receive_response( int index,
                                  IQ_DATA_TYPE_SINGLE ==> float  / mxSINGLE_CLASS
                                  IQ_DATA_TYPE_INT16  ==> short  / mxINT16_CLASS
                                  IQ_DATA_TYPE_RAW    ==> uint32 / mxUINT32_CLASS
-* @param    output_array   - Return parameter - array of samples to return
+* @param    column_size    - Size (in bytes) of a column of the output array
+* @param    output_array   - Return parameter - array of samples to return (samples for buffer_ids[i] are
+*                                placed in column i)
 * @param    num_cmds       - Return parameter - number of ethernet send commands used to request packets 
 *                                (could be > 1 if there are transmission errors)
+* @param    seq_num        - Return parameter - array of sequence numbers (one per buffer ID)
+*
+* @return	size           - Number of samples processed (also size of output_array)
+*
+* @note		This function requires the following pointers:
+*   Input:
+*       - Buffer containing command to request samples (char *)
+*       - IP Address (char *)
+*       - Array of buffer IDs (uint32 *)
+*       - Allocated memory to return samples (uint32 *)
+*       - Location to return the number of send commands used to generate the samples (uint32 *)
+*
+*   Output:
+*       - Number of samples processed 
+*
+*
+* @note    BB_READ_IQ / BB_READ_RSSI Packet Format:
+*
+* Command Packet
+*    - cmd_args_32[0]      - Buffer selection
+*                                [31]   - Interleave buffers (READ_IQ_FLAG_INTERLEAVE)
+*                                [30]   - Stream samples during a reception (READ_IQ_FLAG_STREAM)
+*                                [29:28]- Sample format (READ_IQ_COMPRESSION_* << READ_IQ_FORMAT_SHIFT)
+*                                [27:26]- Start sample reference (READ_IQ_WINDOW_* << READ_IQ_WINDOW_SHIFT)
+*                                [25]   - Send capture metadata (READ_IQ_FLAG_METADATA)
+*                                [24]   - Park the request until the reception is done (READ_IQ_FLAG_DEFER)
+*                                [23:16]- Deadline of a parked request (READ_IQ_DEFER_TIMEOUT_UNIT usec)
+*                                [15]   - Wait for the transmit slot of the node (READ_IQ_FLAG_SCHEDULE)
+*                                [3:0]  - Mask of buffers to read
+*    - cmd_args_32[1]      - Start sample
+*    - cmd_args_32[2]      - Total samples in transfer (per buffer)
+*    - cmd_args_32[3]      - Maximum number of samples per packet
+*    - cmd_args_32[4]      - Number of packets in transfer (per buffer)
+*    - cmd_args_32[5]      - IQ ID (uint 8) - Populated at the lower level
+*
+* Response Packet
+*    - resp_args           - Samples:  wl_bb_samp_hdr followed by appropriate samples
+*
+*    NOTE:  The buffer ID in the sample header is the single buffer the samples were read 
+*        from.  This is used to place the samples in the correct column of the output array.
+*
+*    NOTE:  If the sample header flags contain SAMPLE_IQ_METADATA, then the packet contains the
+*        capture metadata of the request (see wl_read_iq_merge_metadata()) instead of samples.
+*        The metadata packet is not counted as one of the packets of the request.
+*
+*    NOTE:  If the sample header flags == SAMPLE_HDR_FLAG_IQ_NOT_READY, then the "samples"
+*        after the sample header need to be interpreted in the following manner:
+*
+*        - sample[0]       - Tx status
+*        - sample[1]       - Current Tx read pointer
+*        - sample[2]       - Tx length
+*        - sample[3]       - Rx status
+*        - sample[4]       - Current Rx write pointer
+*        - sample[5]       - Rx length
+*
+******************************************************************************/
+int wl_read_baseband_buffer( int index, char *buffer, int length, char *ip_addr, int port,
+                             uint32 initial_offset, uint32 num_samples, uint32 start_sample, uint32 *buffer_ids, uint32 num_buffers,
+                             uint32 function, uint32 data_type, uint32 column_size,
+                             void **output_array, uint32 *num_cmds, uint32 *seq_num) {
+
+    // Variable declaration
+    uint32                   i, tmp;
+    int                      done                = 0;
+    
+    uint32                   buffer_id           = 0;
+    uint32                   buffer_id_cmd       = 0;
+    uint32                   start_sample_cmd    = 0;
+    uint32                   total_sample_cmd    = 0;
+    uint32                   bytes_per_pkt       = 0;
+    uint32                   num_pkts            = 0;
+    
+    uint32                   tmp_eth_buffer_size = 0;
+    uint32                   samples_per_pkt     = 0;
+
+    int                      sent_size           = 0;
+
+    uint32                   rcvd_pkts[TRANSPORT_WARP_RF_BUFFER_MAX];
+    uint32                   buffers_done        = 0;
+    uint32                   all_buffers_done    = 0;
+    uint32                   retry_columns       = 0;
+    uint32                   column              = 0;
+    int                      rcvd_size           = 0;
+    uint32                   sample_num          = 0;
+    uint32                   sample_size         = 0;
+    uint32                   sample_buffer_id    = 0;
+    uint8                    sample_flags        = 0;
+    uint8                    sample_iq_id        = 0;
+    
+    uint32                   timeout             = 0;
+    uint32                   num_retrys          = 0;
+    uint32                   num_iq_retrys       = 0;
+
+    uint32                   total_cmds          = 0;
+    
+    uint32                   err_start_sample    = 0;
+    uint32                   err_num_samples     = 0;
+    uint32                   err_num_pkts        = 0;
+    
+    uint32                   iq_busy_warn        = 1;
+    uint32                   wait_time           = 0;
+    uint32                   metadata_rcvd       = 0;
+    uint32                   defer_wait_time     = 0;
+    
+    char                    *tmp_eth_buffer;
+    char                    *eth_buffer;
+    uint8                   *decompress_buffer   = NULL;
+    uint8                   *samples;
+    void                    *column_array[2];
+    
+    wl_decode_slot          *decode_slots        = NULL;
+    uint8                   *decode_buffers      = NULL;
+    uint32                   num_decode_slots    = 0;
+    uint32                   decode_slot_size    = 0;
+    int                      decode_slot         = -1;
+
+    wl_transport_header     *transport_hdr;
+    wl_transport_header     *rcvd_transport_hdr;
+    wl_command_header       *command_hdr;
+    uint32                  *command_args;
+    wl_sample_header        *sample_hdr;
+    wl_sample_tracker       *sample_tracker;
+
+    // Read statistics
+    uint32                   total_rcvd_pkts   = 0;
+    uint32                   total_timeout     = 0;
+    uint32                   init_timeout      = 0;
+    uint32                   avg_timeout       = 0;
+    
+    // Compute some constants to be used later
+    uint32                   tport_hdr_size    = sizeof( wl_transport_header );
+    uint32                   cmd_hdr_size      = sizeof( wl_transport_header ) + sizeof( wl_command_header );
+    uint32                   all_hdr_size      = sizeof( wl_transport_header ) + sizeof( wl_command_header ) + sizeof( wl_sample_header );
+
+    // Initialization
+    transport_hdr       = (wl_transport_header *) buffer;
+    command_hdr         = (wl_command_header   *) ( buffer + tport_hdr_size );
+    command_args        = (uint32              *) ( buffer + cmd_hdr_size );
+    
+    buffer_id_cmd       = endian_swap_32( command_args[0] );
+    start_sample_cmd    = endian_swap_32( command_args[1] );
+    total_sample_cmd    = endian_swap_32( command_args[2] );
+    bytes_per_pkt       = endian_swap_32( command_args[3] );         // Command contains payload size; add room for header
+    num_pkts            = endian_swap_32( command_args[4] );
+    
+    tmp_eth_buffer_size = bytes_per_pkt + 100;                       // Command contains payload size; add room for header
+    samples_per_pkt     = ( bytes_per_pkt >> 2 );                    // Each WARPLab sample is 4 bytes
+    
+    // Replace IQ ID with value maintained by the transport
+    sample_iq_id        = (sample_read_iq_id & 0xFF);
+    command_args[5]     = endian_swap_32( sample_iq_id );
+    
+    // Increment read IQ ID (explicitly maintain as a uint8)
+    sample_read_iq_id   = (sample_read_iq_id + 1) % 0x100;
+    
+    // Compute the buffer selection for all buffers in the request
+    //     NOTE:  Each buffer in the request is placed in its own column of the output array (ie column_size
+    //            bytes apart) in the order given by buffer_ids
+    //
+    if ( num_buffers > TRANSPORT_WARP_RF_BUFFER_MAX ) {
+        die_with_error("Error:  Too many buffers in a single Read IQ / Read RSSI request.");
+    }
+    
+    for ( i = 0; i < num_buffers; i++ ) {
+        buffer_id        |= buffer_ids[i];
+        rcvd_pkts[i]      = 0;
+        all_buffers_done |= (1 << i);
+    }
+    
+#ifdef _DEBUG_
+    // Print command arguments    
+    printf("Read IQ / Read RSSI command\n");
+    printf("    index = %d, length = %d, port = %d, ip_addr = %s \n", index, length, port, ip_addr);
+    printf("    num_sample = %d, start_sample = %d, buffer_id = %d, num_buffers = %d \n", num_samples, start_sample, buffer_id, num_buffers);
+    printf("    bytes_per_pkt = %d;  num_pkts = %d \n", bytes_per_pkt, num_pkts );
+    // print_buffer( buffer, length );
+#endif
+
+    // Perform a consistency check to make sure parameters are correct
+    if ( ( buffer_id_cmd & READ_IQ_BUFFER_ID_MASK ) != buffer_id ) {
+        printf("WARNING:  Buffer ID in command (%d) does not match function parameter (%d)\n", (buffer_id_cmd & READ_IQ_BUFFER_ID_MASK), buffer_id);
+    }
+    if ( start_sample_cmd != start_sample ) {
+        printf("WARNING:  Starting sample in command (%d) does not match function parameter (%d)\n", start_sample_cmd, start_sample);
+    }
+    if ( total_sample_cmd != num_samples ) {
+        printf("WARNING:  Number of samples requested in command (%d) does not match function parameter (%d)\n", total_sample_cmd, num_samples);
+    }
+    
+    // Malloc temporary buffer to process ethernet packets
+    tmp_eth_buffer  = (char *) malloc( sizeof( char ) * tmp_eth_buffer_size );
+    if( tmp_eth_buffer == NULL ) { die_with_error("Error:  Could not allocate temporary Ethernet packet buffer"); }
+    
+    eth_buffer      = tmp_eth_buffer;
+    
+    // Set up the decode slots if the packets are decoded by the decode threads
+    //     NOTE:  Each slot has a packet buffer followed by a buffer to expand compressed samples
+    //
+    if ( ( num_pkts * num_buffers ) >= TRANSPORT_DECODE_MIN_PKTS ) {
+        num_decode_slots = wl_decode_pool_start() * TRANSPORT_DECODE_SLOTS_PER_THREAD;
+    }
+    
+    if ( num_decode_slots != 0 ) {
+        decode_slot_size = tmp_eth_buffer_size + ( samples_per_pkt << 2 );
+        decode_slots     = (wl_decode_slot *) malloc( sizeof( wl_decode_slot ) * num_decode_slots );
+        decode_buffers   = (uint8 *) malloc( decode_slot_size * num_decode_slots );
+        
+        if( ( decode_slots == NULL ) || ( decode_buffers == NULL ) ) { die_with_error("Error:  Could not allocate decode slots"); }
+        
+        for ( i = 0; i < num_decode_slots; i++ ) {
+            decode_slots[i].state   = TRANSPORT_DECODE_SLOT_FREE;
+            decode_slots[i].data    = &decode_buffers[i * decode_slot_size];
+            decode_slots[i].scratch = &decode_buffers[( i * decode_slot_size ) + tmp_eth_buffer_size];
+        }
+        
+        wl_decode_pool_attach( decode_slots, num_decode_slots, function, data_type );
+    }
+    
+    // Malloc temporary array to track samples that have been received and initialize
+    //     NOTE:  The tracker for the buffer in column i starts at sample_tracker[i * num_pkts]
+    //
+    sample_tracker = (wl_sample_tracker *) malloc( sizeof( wl_sample_tracker ) * num_pkts * num_buffers );
+    if( sample_tracker == NULL ) { die_with_error("Error:  Could not allocate sample tracker buffer"); }
+    for ( i = 0; i < (num_pkts * num_buffers); i++ ) { sample_tracker[i].start_sample = 0;  sample_tracker[i].num_samples = 0; }
+    
+    // Send packet to request samples
+    sent_size   = send_socket( index, buffer, length, ip_addr, port );
+    total_cmds += 1;
+    
+    wl_trace_annotate( start_sample, 0 );
+
+    // Initialize loop variables
+    timeout   = 0;
+    
+    // If the request can be parked on the node, then wait up to the deadline for the first packet
+    if ( buffer_id_cmd & READ_IQ_FLAG_DEFER ) {
+        defer_wait_time = ( ( buffer_id_cmd & READ_IQ_DEFER_TIMEOUT_MASK ) >> READ_IQ_DEFER_TIMEOUT_SHIFT ) * READ_IQ_DEFER_TIMEOUT_UNIT;
+    }
+    
+    // If the node streams the samples of an ongoing reception, then also wait up to the capture time of
+    // the requested samples for the first packet
+    //     NOTE:  With READ_IQ_WINDOW_AGC_DONE, the start sample is relative to the AGC done sample, so only
+    //            the samples of the request are counted.
+    //
+    if ( buffer_id_cmd & READ_IQ_FLAG_STREAM ) {
+        if ( ( ( buffer_id_cmd >> READ_IQ_WINDOW_SHIFT ) & 0x3 ) == READ_IQ_WINDOW_ABSOLUTE ) {
+            tmp = ( start_sample_cmd + total_sample_cmd ) / READ_IQ_STREAM_SAMPLES_PER_USEC;
+        } else {
+            tmp = total_sample_cmd / READ_IQ_STREAM_SAMPLES_PER_USEC;
+        }
+        
+        if ( tmp > defer_wait_time ) {
+            defer_wait_time = tmp;
+        }
+    }
+    
+    // Process each return packet
+    while ( !done ) {
+        
+        // If we hit the timeout, then try to re-request the remaining samples
+        if ( timeout >= TRANSPORT_TIMEOUT ) {
+        
+            // Request the remaining samples for all buffers that are not done
+            //     NOTE:  If all buffers are done, then only the metadata packet is missing
+            retry_columns   = all_buffers_done & ~buffers_done;
+            
+            // If we hit the max number of retrys, then abort
+            //     NOTE:  A missing metadata packet does not invalidate the samples, so the read finishes
+            //            without the metadata (eg the node does not support READ_IQ_FLAG_METADATA).
+            //
+            if ( ( num_retrys >= TRANSPORT_MAX_RETRY ) && ( retry_columns == 0 ) ) {
+
+                printf("WARNING:  Exceeded %d retrys for the Read IQ capture metadata.  Metadata is not valid. \n", TRANSPORT_MAX_RETRY);
+                
+                buffer_id_cmd &= ~READ_IQ_FLAG_METADATA;
+                done           = 1;
+                continue;
+            
+            } else if ( num_retrys >= TRANSPORT_MAX_RETRY ) {
+
+                printf("ERROR:  Exceeded %d retrys for current Read IQ / Read RSSI request \n", TRANSPORT_MAX_RETRY);
+                printf("    Requested %d samples from buffer(s) 0x%x starting from sample number %d \n", num_samples, buffer_id, start_sample);
+                for ( i = 0; i < num_buffers; i++ ) {
+                    printf("    Received %d out of %d packets from node for buffer 0x%x before timeout.\n", rcvd_pkts[i], num_pkts, buffer_ids[i]);
+                }
+                printf("    Please check the node and look at the ethernet traffic to isolate the issue. \n");                
+            
+                die_with_error("Error:  Reached maximum number of retrys without a response... aborting.");
+                
+            } else {
+
+                // NOTE:  We print a warning here because the Read IQ / Read RSSI case in the mex function above
+                //        will split Read IQ / Read RSSI requests based on the receive buffer size.  Therefore,
+                //        any timeouts we receive here should be legitimate issues that should be explored.
+                //
+                if ( suppress_iq_warnings == 0 ) {
+                    printf("WARNING:  Read IQ / Read RSSI request timed out.  Retrying remaining samples. \n");
+                    printf("          If this message occurs frequently, please adjust the Read IQ \n");
+                    printf("          maximum request size (in bytes) for the transport using the \n");
+                    printf("          M code function:  \n");
+                    printf("              wl_mex_udp_transport('read_iq_set_max_request_size', size)  \n");
+                    printf("          Defaults to 80 percent of the receive buffer allocated by the OS. \n");
+                    printf("\n          To suppress all IQ warnings for the transport use the M code function: \n");
+                    printf("              wl_mex_udp_transport('suppress_iq_warnings')\n");
+                }
+            
+                if ( retry_columns != 0 ) {
+                    tmp = wl_read_iq_setup_retry( sample_tracker, rcvd_pkts, buffer_ids, num_buffers, retry_columns,
+                                                  num_samples, start_sample, num_pkts, samples_per_pkt,
+                                                  &err_num_samples, &err_start_sample, &err_num_pkts );
+                    
+                    command_args[0] = endian_swap_32( ( buffer_id_cmd & ~READ_IQ_BUFFER_ID_MASK ) | tmp );
+                    command_args[1] = endian_swap_32( err_start_sample );
+                    command_args[2] = endian_swap_32( err_num_samples );
+                    command_args[4] = endian_swap_32( err_num_pkts );
+                } else {
+                    wl_read_iq_setup_metadata_retry( command_args, buffer_id_cmd, start_sample_cmd, total_sample_cmd );
+                    
+                    err_start_sample = start_sample;
+                }
+
+                // Retransmit the read IQ request packet
+                sent_size   = send_socket( index, buffer, length, ip_addr, port );
+                total_cmds += 1;
+                
+                wl_trace_annotate( err_start_sample, ( num_retrys + 1 ) );
+                
+                // Update control variables
+                timeout     = 0;
+                num_retrys += 1;
+            }
+        }
+        
+        // Receive packet
+        //     NOTE:  With the decode threads, the packet is received in to a free decode slot
+        //
+        if ( decode_slots != NULL ) {
+            if ( decode_slot == -1 ) {
+                decode_slot = wl_decode_pool_get_slot();
+            }
+            
+            tmp_eth_buffer = (char *) decode_slots[decode_slot].data;
+        }
+        
+        rcvd_size = receive_socket( index, tmp_eth_buffer_size, tmp_eth_buffer );
+
+        // receive_socket() handles all socket related errors and will only return:
+        //   - zero if no packet is available
+        //   - non-zero if packet is available
+        if ( rcvd_size > 0 ) {
+            // Decode the Ethernet packet
+            rcvd_transport_hdr  = (wl_transport_header *) tmp_eth_buffer;
+            sample_hdr          = (wl_sample_header    *) (tmp_eth_buffer + cmd_hdr_size);
+
+            // Decode the sample header
+            sample_num          = endian_swap_32( sample_hdr->start ) - initial_offset;
+            sample_size         = endian_swap_32( sample_hdr->num_samples );
+            sample_buffer_id    = endian_swap_16( sample_hdr->buffer_id );
+            sample_flags        = sample_hdr->flags;
+            
+            wl_trace_annotate( sample_num, num_retrys );
+            
+#ifdef _DEBUG_
+            // Record the timeout value for statistics
+            if ( total_rcvd_pkts == 0 ) {
+                init_timeout   = timeout;
+            } else {
+                total_timeout += timeout;
+            }
+            
+            // Print information about the last 10 packets
+            if ((total_rcvd_pkts > ((num_pkts * num_buffers) - 10)) || ((num_pkts * num_buffers) < 10 )) {
+                printf("buffer_id = %d, num_sample = %d, start_sample = %d   %08x  %08x %08x %08x\n", sample_buffer_id, sample_size, sample_num, sample_hdr->num_samples, sample_size, sample_hdr->start, sample_num);
+            }
+#endif
+
+            // Reset the timeout regardless of the contents of the packet
+            timeout         = 0;
+            defer_wait_time = 0;
+
+            // Check the sample header flags
+            if ((sample_flags & SAMPLE_IQ_ERROR) == SAMPLE_IQ_ERROR) {
+                // Error in samples print error message and return
+                die_with_error("Error:  Node returned 'SAMPLE_IQ_ERROR'.  Check that node is not currently transmitting in continuous TX mode.");
+            
+            } else if ((sample_flags & SAMPLE_IQ_NOT_READY) == SAMPLE_IQ_NOT_READY) {
+                if ( iq_busy_warn ) {
+                    printf("WARNING:  Node was not ready to process Read IQ request.  Waiting to request again.\n");
+                    printf("    This warning can be removed by waiting until the node is not busy with a TX or RX \n");
+                    printf("    operation.  To do this, please add 'pause(1.5 * NUM_SAMPLES * 1/(40e6));' after\n");
+                    printf("    any triggers and before the Read IQ request.\n\n");
+                    iq_busy_warn = 0;
+                }
+                
+                wait_time = wl_compute_sample_wait_time((uint32 *)(tmp_eth_buffer + all_hdr_size));
+                
+                // Wait until the samples should be done
+                if ( wait_time != 0 ) {
+                    wl_usleep( wait_time + 100 );
+                }
+                
+                num_iq_retrys += 1;
+                
+                // Send packet to request samples
+                sent_size   = send_socket( index, buffer, length, ip_addr, port );
+                total_cmds += 1;
+                
+                wl_trace_annotate( start_sample, num_iq_retrys );
+
+                if ( sent_size != length ) {
+                    die_with_error("Error:  Size of packet sent to request samples does not match length of packet.");
+                }
+                
+                // The request can be parked again (eg if the node already had a parked request)
+                if ( buffer_id_cmd & READ_IQ_FLAG_DEFER ) {
+                    defer_wait_time = ( ( buffer_id_cmd & READ_IQ_DEFER_TIMEOUT_MASK ) >> READ_IQ_DEFER_TIMEOUT_SHIFT ) * READ_IQ_DEFER_TIMEOUT_UNIT;
+                }
+
+                // Check that we have not spent a "long time" waiting for samples to be ready                
+                if ( num_iq_retrys > SAMPLE_IQ_MAX_RETRY ) {
+                    die_with_error("Error:  Timeout waiting for node to return samples.  Please check the node operation.");
+                }
+            } else if ((sample_flags & SAMPLE_IQ_METADATA) == SAMPLE_IQ_METADATA) {
+                // Capture metadata
+                //     NOTE:  Ignore duplicate metadata packets (eg from a request that was sent again)
+                //
+                if ( metadata_rcvd == 0 ) {
+                    wl_read_iq_merge_metadata( (uint8 *)(tmp_eth_buffer + all_hdr_size), (rcvd_size - all_hdr_size) );
+                    metadata_rcvd = 1;
+                    
+                    // Do not request the metadata again when retrying samples so the RSSI statistics
+                    // do not count the retried samples twice
+                    buffer_id_cmd &= ~READ_IQ_FLAG_METADATA;
+                    
+                    // If the metadata was requested again, then the samples are already done
+                    if ( buffers_done == all_buffers_done ) {
+                        done = 1;
+                    }
+                }
+            } else {
+                // Normal IQ data
+                
+                // Find the output column for the buffer in the sample header
+                column = num_buffers;
+                
+                for ( i = 0; i < num_buffers; i++ ) {
+                    if ( buffer_ids[i] == sample_buffer_id ) { column = i; }
+                }
+                
+                // Ignore packets that are not part of this request (eg packets from a previous request) or 
+                // that are duplicates of packets for a buffer that already has all of its packets
+                if ( ( column == num_buffers ) || ( rcvd_pkts[column] == num_pkts ) ) {
+                    continue;
+                }
+                
+                // Set a pointer to the sample data
+                samples      = (uint8 *) ( tmp_eth_buffer + all_hdr_size );
+                
+                // Track the compression ratio
+                read_iq_raw_bytes  += (double) ( sample_size << 2 );
+                read_iq_wire_bytes += (double) ( rcvd_size - all_hdr_size );
+                
+                // Check the compressed samples fit in the buffer used to expand them
+                if ( ( sample_flags & ( SAMPLE_IQ_FORMAT_12BIT | SAMPLE_IQ_FORMAT_BFP ) ) && ( sample_size > samples_per_pkt ) ) {
+                    die_with_error("Error:  Node returned more compressed samples than fit in a packet.");
+                }
+                
+                // Set the pointers to the output column
+                for ( i = 0; i < 2; i++ ) {
+                    if ( output_array[i] != NULL ) {
+                        column_array[i] = (void *)(((long long)(output_array[i])) + (long long)(column * column_size));
+                    } else {
+                        column_array[i] = NULL;
+                    }
+                }
+                
+                // If we are tracking packets, record which samples have been received
+                sample_tracker[(column * num_pkts) + rcvd_pkts[column]].start_sample = sample_num + initial_offset;
+                sample_tracker[(column * num_pkts) + rcvd_pkts[column]].num_samples  = sample_size;
+                
+                // Place samples in the array (see wl_read_iq_decode())
+                //     NOTE:  With the decode threads, the packet slot is handed to a thread and the next packet is
+                //            received in to a new slot.  The packets of a request are in disjoint sample ranges of
+                //            the output array, so the threads do not need to coordinate (duplicate packets write
+                //            the same values).
+                //
+                if ( decode_slots != NULL ) {
+                    decode_slots[decode_slot].samples         = samples;
+                    decode_slots[decode_slot].sample_flags    = sample_flags;
+                    decode_slots[decode_slot].sample_num      = sample_num;
+                    decode_slots[decode_slot].sample_size     = sample_size;
+                    decode_slots[decode_slot].column_array[0] = column_array[0];
+                    decode_slots[decode_slot].column_array[1] = column_array[1];
+                    
+                    wl_decode_pool_submit( decode_slot );
+                    
+                    decode_slot = -1;
+                } else {
+                    if ( ( sample_flags & ( SAMPLE_IQ_FORMAT_12BIT | SAMPLE_IQ_FORMAT_BFP ) ) && ( decompress_buffer == NULL ) ) {
+                        decompress_buffer = (uint8 *) malloc( samples_per_pkt << 2 );
+                        if( decompress_buffer == NULL ) { die_with_error("Error:  Could not allocate decompression buffer"); }
+                    }
+                    
+                    wl_read_iq_decode_check( wl_read_iq_decode( function, data_type, sample_flags, samples, sample_num, sample_size,
+                                                                column_array, decompress_buffer ) );
+                }
+    
+                rcvd_pkts[column] += 1;
+                total_rcvd_pkts   += 1;
+                num_iq_retrys      = 0;
+                
+                // Record the sequence number of the buffer
+                seq_num[column]    = sample_hdr->sample_iq_id;
+                
+                // Check the buffer when we have enough packets
+                if ( rcvd_pkts[column] == num_pkts ) {
+                
+                    // Check to see if we have any packet errors
+                    //     NOTE:  This check will detect duplicate packets or sample indexing errors
+                    if ( wl_read_iq_sample_error( &sample_tracker[column * num_pkts], num_samples, start_sample, num_pkts, samples_per_pkt ) ) {
+
+                        // In this case, there is probably some issue in the transmitting node not getting the
+                        // correct number of samples or messing up the indexing of the transmit packets.  
+                        // The wl_read_iq_sample_error() printed debug information, so we need to retry the packets
+                        
+                        if ( num_retrys >= TRANSPORT_MAX_RETRY ) {
+                        
+                            die_with_error("Error:  Errors in sample request from board.  Max number of re-transmissions reached.  See above for debug information.");
+                            
+                        } else {
+
+                            // Request the remaining samples for this buffer
+                            //     NOTE:  Other buffers in the request may still have packets in flight, so only
+                            //            the buffer with the error is requested again.
+                            //
+                            tmp = wl_read_iq_setup_retry( sample_tracker, rcvd_pkts, buffer_ids, num_buffers, (1 << column),
+                                                          num_samples, start_sample, num_pkts, samples_per_pkt,
+                                                          &err_num_samples, &err_start_sample, &err_num_pkts );
+
+                            command_args[0] = endian_swap_32( ( buffer_id_cmd & ~READ_IQ_BUFFER_ID_MASK ) | tmp );
+                            command_args[1] = endian_swap_32( err_start_sample );
+                            command_args[2] = endian_swap_32( err_num_samples );
+                            command_args[4] = endian_swap_32( err_num_pkts );
+
+                            // Retransmit the read IQ request packet
+                            sent_size   = send_socket( index, buffer, length, ip_addr, port );
+                            
+                            if ( sent_size != length ) {
+                                die_with_error("Error:  Size of packet sent to request samples does not match length of packet.");
+                            }
+                            
+                            wl_trace_annotate( err_start_sample, ( num_retrys + 1 ) );
+
+                            // Update control variables
+                            timeout     = 0;
+                            total_cmds += 1;
+                            num_retrys += 1;
+                        }
+                    } else {
+                        // There are no errors, so this buffer is done
+                        buffers_done |= (1 << column);
+                    }
+                }
+                
+                // If all buffers are done, but the metadata packet was lost, then request only the metadata
+                //     NOTE:  The metadata packet is sent before the samples, so it will not arrive later.
+                //
+                if ( ( buffers_done == all_buffers_done ) && ( buffer_id_cmd & READ_IQ_FLAG_METADATA ) ) {
+                
+                    if ( num_retrys >= TRANSPORT_MAX_RETRY ) {
+                        printf("WARNING:  Exceeded %d retrys for the Read IQ capture metadata.  Metadata is not valid. \n", TRANSPORT_MAX_RETRY);
+                        
+                        buffer_id_cmd &= ~READ_IQ_FLAG_METADATA;
+                        
+                    } else {
+                        wl_read_iq_setup_metadata_retry( command_args, buffer_id_cmd, start_sample_cmd, total_sample_cmd );
+                        
+                        // Retransmit the read IQ request packet
+                        sent_size   = send_socket( index, buffer, length, ip_addr, port );
+                        
+                        if ( sent_size != length ) {
+                            die_with_error("Error:  Size of packet sent to request samples does not match length of packet.");
+                        }
+                        
+                        wl_trace_annotate( start_sample, ( num_retrys + 1 ) );
+                        
+                        // Update control variables
+                        timeout     = 0;
+                        total_cmds += 1;
+                        num_retrys += 1;
+                    }
+                }
+                
+                // Exit the loop when all buffers (and the metadata) are done
+                if ( ( buffers_done == all_buffers_done ) && ( ( buffer_id_cmd & READ_IQ_FLAG_METADATA ) == 0 ) ) {
+                
+#ifdef _DEBUG_
+                    // Calculate statistics
+                    if (total_rcvd_pkts > 1) {
+                        avg_timeout = total_timeout / (total_rcvd_pkts - 1);
+                    } else {
+                        avg_timeout = init_timeout;
+                    }
+                    
+                    // Print statistics
+                    printf("Initial Timeout = %10d\n", init_timeout);
+                    printf("Avg Timeout     = %10d  (%10d packets)\n", avg_timeout, (total_rcvd_pkts - 1));
+#endif
+                    done = 1;
+                }
+            }  // END if (sample_flags)
+        } else if ( defer_wait_time > 0 ) {
+            // The request is parked on the node; sleep instead of counting the timeout until the deadline
+            wl_usleep( READ_IQ_DEFER_POLL_TIME );
+            
+            defer_wait_time = ( defer_wait_time > READ_IQ_DEFER_POLL_TIME ) ? ( defer_wait_time - READ_IQ_DEFER_POLL_TIME ) : 0;
+            
+        } else {       
+            // Increment the timeout counter; Note this counter does not reflect real-time
+            timeout += 1;            
+            
+        }  // END if ( rcvd_size > 0 )
+        
+    }  // END while( !done )
+
+    // Wait for the decode threads to finish the packets of the request
+    if ( decode_slots != NULL ) {
+        wl_read_iq_decode_check( wl_decode_pool_finish() );
+        
+        free( decode_slots );
+        free( decode_buffers );
+    }
+
+    // Restore the command arguments that could have been modified by a retry
+    //     NOTE:  The caller will re-use the command buffer for the next "chunk" of the request
+    //
+    command_args[0] = endian_swap_32( buffer_id_cmd );
+    
+    // Free locally allocated memory    
+    free( eth_buffer );    
+    free( sample_tracker ); 
+    free( decompress_buffer );
+
+    // Finalize outputs   
+    *num_cmds          += total_cmds;
+    read_iq_num_retrys += num_retrys;
+    
+    return num_samples;
+}
+
+
+
+/*****************************************************************************/
+/**
+*  Function:  Read IQ nodes
+*
+*  Function to read the buffers of many nodes at the same time.  The first Read IQ
+*  request of every node is sent before any packet is received.  The packets of all
+*  nodes are then received with select() and the samples are placed directly in the
+*  output columns of each node.
+*
+* @param    nodes          - Array of nodes to read (see wl_read_iq_node)
+* @param    num_nodes      - Number of nodes
+* @param    num_samples    - Number of samples to read from each buffer
+* @param    start_sample   - Starting sample of each buffer
+* @param    data_type      - Type of the output array (IQ_DATA_TYPE_*)
+* @param    column_size    - Size of an output column (in bytes)
+*
+* @note     Each request reads one buffer of a node.  The request size of each node is 
+*           limited by the receive buffer of its socket (see 'read_iq'), so the nodes 
+*           can send at the same time without the OS dropping packets.  When a request
+*           is done, the next request of the node is sent right away.
+*
+* @note     If a node does not send a packet for TRANSPORT_READ_IQ_NODE_TIMEOUT seconds,
+*           then the missing packets of its request are requested again.
+*
+******************************************************************************/
+void wl_read_iq_nodes( wl_read_iq_node *nodes, uint32 num_nodes, uint32 num_samples, uint32 start_sample,
+                       uint32 data_type, uint32 column_size ) {
+
+    // Variable declaration
+    uint32                   i, j;
+    uint32                   flags               = 0;
+    uint32                   nodes_done          = 0;
+    uint32                   poll_all            = 0;
+    int                      max_handle          = 0;
+    int                      rcvd_size           = 0;
+    
+    uint32                   sample_num          = 0;
+    uint32                   sample_size         = 0;
+    uint32                   sample_buffer_id    = 0;
+    uint8                    sample_flags        = 0;
+    uint32                   wait_time           = 0;
+    
+    char                    *eth_buffer;
+    uint8                   *decompress_buffer   = NULL;
+    uint8                   *samples;
+    void                    *column_array[2];
+    
+    wl_sample_header        *sample_hdr;
+    wl_read_iq_node         *node;
+    
+    fd_set                   read_fds;
+    struct timeval           poll_time;
+
+    uint32                   eth_buffer_size     = 0;
+    uint32                   samples_per_pkt     = 0;
+
+    // Compute some constants to be used later
+    uint32                   cmd_hdr_size        = sizeof( wl_transport_header ) + sizeof( wl_command_header );
+    uint32                   all_hdr_size        = sizeof( wl_transport_header ) + sizeof( wl_command_header ) + sizeof( wl_sample_header );
+
+    // Set the Read IQ options of the requests
+    //     NOTE:  The captures of the nodes are done before the requests are sent, so the requests are not parked
+    //            or streamed.  The capture metadata is only kept for one node, so it is not requested.
+    //
+    flags = ( read_iq_window << READ_IQ_WINDOW_SHIFT );
+    
+    // Request that the nodes wait for their transmit slots before sending the samples of their first request
+    //     NOTE:  The first requests of all nodes are sent at once, so without the slots all nodes would send at 
+    //            the same time.  The later requests of the nodes are sent as the nodes finish, so they are not
+    //            scheduled (see wl_read_iq_node_request()).
+    //
+    if ( read_iq_schedule_wait ) {
+        flags |= READ_IQ_FLAG_SCHEDULE;
+    }
+    
+    // Size the packets of each node by the compressed bytes (see 'read_iq')
+    //     NOTE:  The packets must be sized before the trackers are allocated and the Ethernet buffer is sized
+    //
+    for ( i = 0; i < num_nodes; i++ ) {
+        nodes[i].flags      = flags;
+        nodes[i].pkt_length = nodes[i].max_length;
+        
+        if ( ( read_iq_compression != READ_IQ_COMPRESSION_NONE ) && ( data_type != IQ_DATA_TYPE_RAW ) ) {
+            if ( wl_read_iq_compress_size( read_iq_compression, num_samples, &(nodes[i].max_length), &(nodes[i].num_pkts) ) ) {
+                nodes[i].flags |= ( read_iq_compression << READ_IQ_FORMAT_SHIFT );
+            }
+        }
+    }
+
+    // Malloc temporary buffers to process ethernet packets of any node
+    //     NOTE:  The buffers are sized for the largest packet of all nodes
+    //
+    for ( i = 0; i < num_nodes; i++ ) {
+        if ( nodes[i].max_length > ( samples_per_pkt << 2 ) ) {
+            samples_per_pkt = ( nodes[i].max_length >> 2 );                 // Each WARPLab sample is 4 bytes
+        }
+    }
+    
+    eth_buffer_size = ( samples_per_pkt << 2 ) + 100;                       // Add room for the headers
+    
+    eth_buffer = (char *) malloc( sizeof( char ) * eth_buffer_size );
+    if( eth_buffer == NULL ) { die_with_error("Error:  Could not allocate temporary Ethernet packet buffer"); }
+
+    // Send the first request of every node
+    for ( i = 0; i < num_nodes; i++ ) {
+        node = &nodes[i];
+        
+        node->tracker = (wl_sample_tracker *) malloc( sizeof( wl_sample_tracker ) * node->num_pkts );
+        if( node->tracker == NULL ) { die_with_error("Error:  Could not allocate sample tracker buffer"); }
+        
+        node->column      = 0;
+        node->next_sample = start_sample;
+        node->num_cmds    = 0;
+        node->done        = 0;
+        
+        wl_read_iq_node_request( node, num_samples, start_sample );
+    }
+    
+    // Process each return packet
+    while ( 1 ) {
+
+        // Wait for a packet from any node that is not done
+        //     NOTE:  Packets held back by the impairment layer (see wl_impair_rx()) are not seen by select(), so
+        //            all sockets are polled when receive impairments are enabled.
+        //
+        FD_ZERO( &read_fds );
+        
+        nodes_done = 0;
+        max_handle = 0;
+        
+        for ( i = 0; i < num_nodes; i++ ) {
+            if ( nodes[i].done ) {
+                nodes_done += 1;
+            } else {
+                FD_SET( sockets[nodes[i].index].handle, &read_fds );
+                
+                if ( (int) sockets[nodes[i].index].handle > max_handle ) {
+                    max_handle = (int) sockets[nodes[i].index].handle;
+                }
+            }
+        }
+        
+        if ( nodes_done == num_nodes ) {
+            break;
+        }
+        
+        poll_time.tv_sec  = 0;
+        poll_time.tv_usec = TRANSPORT_READ_IQ_NODE_POLL_TIME;
+        
+        poll_all = ( select( ( max_handle + 1 ), &read_fds, NULL, NULL, &poll_time ) < 0 ) || ( impair_direction & TRANSPORT_IMPAIR_RX );
+
+        for ( i = 0; i < num_nodes; i++ ) {
+            node = &nodes[i];
+            
+            if ( node->done ) {
+                continue;
+            }
+            
+            // Receive all packets of the node
+            //     NOTE:  receive_socket() handles all socket related errors and will only return:
+            //                - zero if no packet is available
+            //                - non-zero if packet is available
+            //
+            while ( ( node->done == 0 ) && ( poll_all || FD_ISSET( sockets[node->index].handle, &read_fds ) ) &&
+                    ( ( rcvd_size = receive_socket( node->index, eth_buffer_size, eth_buffer ) ) > 0 ) ) {
+
+                // Decode the sample header
+                sample_hdr          = (wl_sample_header *) ( eth_buffer + cmd_hdr_size );
+                sample_num          = endian_swap_32( sample_hdr->start );
+                sample_size         = endian_swap_32( sample_hdr->num_samples );
+                sample_buffer_id    = endian_swap_16( sample_hdr->buffer_id );
+                sample_flags        = sample_hdr->flags;
+
+                // Check the sample header flags
+                if ((sample_flags & SAMPLE_IQ_ERROR) == SAMPLE_IQ_ERROR) {
+                    printf("ERROR:  Node %s returned 'SAMPLE_IQ_ERROR' \n", node->node_id_str);
+                    die_with_error("Error:  Node returned 'SAMPLE_IQ_ERROR'.  Check that node is not currently transmitting in continuous TX mode and that its Read IQ slot wait is not too long (see 'read_iq_schedule').");
+                
+                } else if ((sample_flags & SAMPLE_IQ_NOT_READY) == SAMPLE_IQ_NOT_READY) {
+                    // Send the request again when the node should be done (see the timeout below)
+                    wait_time = wl_compute_sample_wait_time((uint32 *)(eth_buffer + all_hdr_size));
+                    
+                    node->num_iq_retrys += 1;
+                    node->not_ready      = 1;
+                    node->deadline       = wl_trace_host_time() + ( (double) ( wait_time + 100 ) * 1e-6 );
+
+                    // Check that we have not spent a "long time" waiting for samples to be ready
+                    if ( node->num_iq_retrys > SAMPLE_IQ_MAX_RETRY ) {
+                        die_with_error("Error:  Timeout waiting for node to return samples.  Please check the node operation.");
+                    }
+                    
+                } else if ((sample_flags & SAMPLE_IQ_METADATA) == SAMPLE_IQ_METADATA) {
+                    // Capture metadata is not requested
+                    continue;
+                    
+                } else {
+                    // Ignore packets that are not part of the current request (eg packets from a previous request)
+                    // or that are duplicates once all packets of the request are received
+                    if ( ( sample_buffer_id != node->buffer_ids[node->column] ) || ( node->rcvd_pkts == node->req_pkts ) ||
+                         ( ( sample_num - node->req_start ) >= node->req_samples ) ) {
+                        continue;
+                    }
+                    
+                    // Set a pointer to the sample data
+                    samples = (uint8 *) ( eth_buffer + all_hdr_size );
+                    
+                    // Track the compression ratio
+                    read_iq_raw_bytes  += (double) ( sample_size << 2 );
+                    read_iq_wire_bytes += (double) ( rcvd_size - all_hdr_size );
+                    
+                    // Check the compressed samples fit in the buffer used to expand them
+                    if ( sample_flags & ( SAMPLE_IQ_FORMAT_12BIT | SAMPLE_IQ_FORMAT_BFP ) ) {
+                        if ( sample_size > ( node->max_length >> 2 ) ) {
+                            die_with_error("Error:  Node returned more compressed samples than fit in a packet.");
+                        }
+                        
+                        if ( decompress_buffer == NULL ) {
+                            decompress_buffer = (uint8 *) malloc( samples_per_pkt << 2 );
+                            if( decompress_buffer == NULL ) { die_with_error("Error:  Could not allocate decompression buffer"); }
+                        }
+                    }
+                    
+                    // Set the pointers to the output column
+                    for ( j = 0; j < 2; j++ ) {
+                        if ( node->output_array[j] != NULL ) {
+                            column_array[j] = (void *)(((long long)(node->output_array[j])) + (long long)(node->column * column_size));
+                        } else {
+                            column_array[j] = NULL;
+                        }
+                    }
+                    
+                    // Record which samples have been received
+                    node->tracker[node->rcvd_pkts].start_sample = sample_num;
+                    node->tracker[node->rcvd_pkts].num_samples  = sample_size;
+                    
+                    // Place samples in the array (see wl_read_iq_decode())
+                    wl_read_iq_decode_check( wl_read_iq_decode( TRANSPORT_READ_IQ, data_type, sample_flags, samples, ( sample_num - start_sample ),
+                                                                sample_size, column_array, decompress_buffer ) );
+                    
+                    node->rcvd_pkts     += 1;
+                    node->num_iq_retrys  = 0;
+                    node->seq_num        = sample_hdr->sample_iq_id;
+                    node->deadline       = wl_trace_host_time() + TRANSPORT_READ_IQ_NODE_TIMEOUT;
+                    
+                    // Check the request when we have enough packets
+                    if ( node->rcvd_pkts == node->req_pkts ) {
+                        
+                        // Check to see if we have any packet errors
+                        //     NOTE:  This check will detect duplicate packets or sample indexing errors
+                        if ( wl_read_iq_sample_error( node->tracker, node->req_samples, node->req_start, node->req_pkts, ( node->max_length >> 2 ) ) ) {
+                            wl_read_iq_node_retry( node );
+                        } else {
+                            wl_read_iq_node_request( node, num_samples, start_sample );
+                        }
+                    }
+                }
+            }
+            
+            // If we hit the timeout, then send the request again
+            if ( ( node->done == 0 ) && ( wl_trace_host_time() >= node->deadline ) ) {
+            
+                if ( node->not_ready ) {
+                    node->not_ready = 0;
+                    
+                    wl_read_iq_node_send( node );
+                    
+                } else {
+                    if ( suppress_iq_warnings == 0 ) {
+                        printf("WARNING:  Read IQ request of node %s timed out.  Retrying remaining samples. \n", node->node_id_str);
+                    }
+                    
+                    wl_read_iq_node_retry( node );
+                }
+            }
+        }
+    }  // END while( 1 )
+
+    // Free locally allocated memory    
+    for ( i = 0; i < num_nodes; i++ ) {
+        free( nodes[i].tracker );
+    }
+    
+    free( eth_buffer );    
+    free( decompress_buffer );
+}
+
+
+
+/*****************************************************************************/
+/**
+*  Function:  Read IQ node request
 *
-* @return	size           - Number of samples processed (also size of output_array)
+*  Function to send the next Read IQ request of a node in a multi-node read (see 
+*  wl_read_iq_nodes()).  The request reads the next samples of the current buffer 
+*  of the node, or the first samples of the next buffer once all samples of the 
+*  current buffer are read.  The node is done when all of its buffers are read.
 *
-* @note		This function requires the following pointers:
-*   Input:
-*       - Buffer containing command to request samples (char *)
-*       - IP Address (char *)
-*       - Array of buffer IDs (uint32 *)
-*       - Allocated memory to return samples (uint32 *)
-*       - Location to return the number of send commands used to generate the samples (uint32 *)
+******************************************************************************/
+void wl_read_iq_node_request( wl_read_iq_node *node, uint32 num_samples, uint32 start_sample ) {
+
+    uint32                   buffer_id;
+    uint32                   req_size;
+    uint32                   req_pkts;
+    uint32                   done_pkts;
+    uint32                   max_length          = node->max_length;
+    uint32                   num_pkts            = node->num_pkts;
+    uint32                   samples_per_pkt     = ( max_length >> 2 );
+    uint32                  *command_args        = (uint32 *) ( node->buffer + sizeof( wl_transport_header ) + sizeof( wl_command_header ) );
+
+    // Move to the next buffer when all samples of the current buffer are read
+    if ( ( node->next_sample - start_sample ) >= num_samples ) {
+        buffer_id = node->buffer_ids[node->column];
+        
+        // Check and update the sequence number
+        wl_check_seq_num( TRANSPORT_READ_IQ, node->node_id_str, buffer_id, node->seq_num, node->seq_num_tracker, node->seq_num_severity );
+        wl_update_seq_num( TRANSPORT_READ_IQ, buffer_id, node->seq_num, node->seq_num_tracker );
+        
+        node->column     += 1;
+        node->next_sample = start_sample;
+        
+        if ( node->column == node->num_buffers ) {
+            node->done = 1;
+            return;
+        }
+    }
+    
+    // Compute the request size (see 'read_iq')
+    //     NOTE:  The request size adapts to the packets dropped by the OS during the last request of the node
+    //
+    if ( use_user_read_iq_max_req_size == 1 ) {
+        req_size = ( user_read_iq_max_req_size < node->pkt_length ) ? node->pkt_length : user_read_iq_max_req_size;
+        
+    } else if ( sockets[node->index].read_iq_req_size == 0 ) {
+        sockets[node->index].read_iq_req_size = 8 * ( sockets[node->index].rx_buffer_size / 10 );
+        req_size = sockets[node->index].read_iq_req_size;
+        
+    } else if ( node->num_cmds != 0 ) {
+        req_size = wl_read_iq_adapt_req_size( node->index, node->pkt_length, node->num_retrys, ( sockets[node->index].rx_drops - node->rx_drops ) );
+        
+    } else {
+        req_size = sockets[node->index].read_iq_req_size;
+    }
+    
+    req_pkts  = req_size / node->pkt_length;
+    
+    if ( req_pkts == 0 ) {
+        req_pkts = 1;
+    }
+    
+    // If we are requesting the last set of packets, then just request the remaining samples
+    done_pkts = ( node->next_sample - start_sample ) / samples_per_pkt;
+    
+    if ( ( done_pkts + req_pkts ) >= num_pkts ) {
+        node->req_pkts    = num_pkts - done_pkts;
+        node->req_samples = num_samples - ( node->next_sample - start_sample );
+    } else {
+        node->req_pkts    = req_pkts;
+        node->req_samples = req_pkts * samples_per_pkt;
+    }
+    
+    node->req_start      = node->next_sample;
+    node->next_sample   += node->req_samples;
+    node->rcvd_pkts      = 0;
+    node->num_retrys     = 0;
+    node->num_iq_retrys  = 0;
+    node->not_ready      = 0;
+    node->rx_drops       = sockets[node->index].rx_drops;
+    
+    // Update the buffer with the command arguments of the request
+    command_args[0] = endian_swap_32( node->buffer_ids[node->column] | node->flags );
+    command_args[1] = endian_swap_32( node->req_start );
+    command_args[2] = endian_swap_32( node->req_samples );
+    command_args[3] = endian_swap_32( max_length );
+    command_args[4] = endian_swap_32( node->req_pkts );
+    
+    // Replace IQ ID with value maintained by the transport
+    command_args[5] = endian_swap_32( sample_read_iq_id & 0xFF );
+    
+    // Increment read IQ ID (explicitly maintain as a uint8)
+    sample_read_iq_id = (sample_read_iq_id + 1) % 0x100;
+    
+    wl_read_iq_node_send( node );
+    
+    // Only the first request of the node waits for its transmit slot
+    node->flags &= ~READ_IQ_FLAG_SCHEDULE;
+}
+
+
+
+/*****************************************************************************/
+/**
+*  Function:  Read IQ node retry
 *
-*   Output:
-*       - Number of samples processed 
+*  Function to request the missing packets of the current Read IQ request of a node
+*  in a multi-node read (see wl_read_iq_nodes()).
 *
+******************************************************************************/
+void wl_read_iq_node_retry( wl_read_iq_node *node ) {
+
+    uint32                   buffer_sel;
+    uint32                   err_start_sample    = 0;
+    uint32                   err_num_samples     = 0;
+    uint32                   err_num_pkts        = 0;
+    uint32                  *command_args        = (uint32 *) ( node->buffer + sizeof( wl_transport_header ) + sizeof( wl_command_header ) );
+
+    // If we hit the max number of retrys, then abort
+    if ( node->num_retrys >= TRANSPORT_MAX_RETRY ) {
+        printf("ERROR:  Exceeded %d retrys for current Read IQ request of node %s \n", TRANSPORT_MAX_RETRY, node->node_id_str);
+        printf("    Requested %d samples from buffer 0x%x starting from sample number %d \n", node->req_samples, node->buffer_ids[node->column], node->req_start);
+        printf("    Received %d out of %d packets from node before timeout.\n", node->rcvd_pkts, node->req_pkts);
+        printf("    Please check the node and look at the ethernet traffic to isolate the issue. \n");                
+        
+        die_with_error("Error:  Reached maximum number of retrys without a response... aborting.");
+    }
+
+    // Request the remaining samples of the request
+    buffer_sel = wl_read_iq_setup_retry( node->tracker, &(node->rcvd_pkts), &(node->buffer_ids[node->column]), 1, 1,
+                                         node->req_samples, node->req_start, node->req_pkts, ( node->max_length >> 2 ),
+                                         &err_num_samples, &err_start_sample, &err_num_pkts );
+    
+    //     NOTE:  The missing packets are sent right away instead of waiting for the transmit slot again
+    //
+    command_args[0] = endian_swap_32( ( endian_swap_32( command_args[0] ) & ~( READ_IQ_BUFFER_ID_MASK | READ_IQ_FLAG_SCHEDULE ) ) | buffer_sel );
+    command_args[1] = endian_swap_32( err_start_sample );
+    command_args[2] = endian_swap_32( err_num_samples );
+    command_args[4] = endian_swap_32( err_num_pkts );
+    
+    wl_trace_annotate( err_start_sample, ( node->num_retrys + 1 ) );
+    
+    // Update control variables
+    node->num_retrys   += 1;
+    read_iq_num_retrys += 1;
+    
+    wl_read_iq_node_send( node );
+}
+
+
+
+/*****************************************************************************/
+/**
+*  Function:  Read IQ node send
 *
-* @note    BB_READ_IQ / BB_READ_RSSI Packet Format:
+*  Function to send the Read IQ request packet of a node in a multi-node read (see
+*  wl_read_iq_nodes()) and to set the time the request is sent again without a packet.
 *
-* Command Packet
-*    - cmd_args_32[0]      - Buffer selection (guaranteed to be singular) (uint16)
-*    - cmd_args_32[1]      - Start sample
-*    - cmd_args_32[2]      - Total samples in transfer
-*    - cmd_args_32[3]      - Maximum number of samples per packet
-*    - cmd_args_32[4]      - Number of packets in transfer
-*    - cmd_args_32[5]      - IQ ID (uint 8) - Populated at the lower level
+******************************************************************************/
+void wl_read_iq_node_send( wl_read_iq_node *node ) {
+
+    int                      sent_size;
+
+    sent_size = send_socket( node->index, node->buffer, node->length, node->ip_addr, node->port );
+    
+    if ( sent_size != node->length ) {
+        die_with_error("Error:  Size of packet sent to request samples does not match length of packet.");
+    }
+    
+    node->num_cmds += 1;
+    node->deadline  = wl_trace_host_time() + TRANSPORT_READ_IQ_NODE_TIMEOUT;
+    
+    // If the node waits for its transmit slot, then also wait up to the maximum slot wait for the first packet
+    if ( endian_swap_32( ((uint32 *) ( node->buffer + sizeof( wl_transport_header ) + sizeof( wl_command_header ) ))[0] ) & READ_IQ_FLAG_SCHEDULE ) {
+        node->deadline += ( (double) read_iq_schedule_wait * 1e-6 );
+    }
+}
+
+
+
+/*****************************************************************************/
+/**
+*  Function:  Read IQ decode
 *
-* Response Packet
-*    - resp_args           - Samples:  wl_bb_samp_hdr followed by appropriate samples
+*  Function to place the samples of a Read IQ / Read RSSI packet in the output 
+*  column(s).  Compressed samples are expanded in to scratch first.
+*
+*  This function is called by the receive thread or by the decode threads, so it
+*  must not call any MATLAB API functions (including printf / malloc).
+*
+*  Returns:  TRANSPORT_DECODE_SUCCESS or the TRANSPORT_DECODE_* error
+*
+******************************************************************************/
+int wl_read_iq_decode( uint32 function, uint32 data_type, uint8 sample_flags, uint8 *samples, uint32 sample_num,
+                       uint32 sample_size, void **column_array, uint8 *scratch ) {
+
+    uint32                   i, tmp;
+
+    // Variables for the different output types    
+    double                  *tmp_double_array_0;
+    double                  *tmp_double_array_1;
+    double                   tmp_double_val;
+
+    float                   *tmp_single_array_0;
+    float                   *tmp_single_array_1;
+    float                    tmp_single_val;
+    
+    int16                   *tmp_int16_array_0;
+    int16                   *tmp_int16_array_1;
+    
+    uint32                  *tmp_uint32_array_0;
+    uint32                   msb_0, lsb_0, msb_1, lsb_1;
+
+    // Expand compressed samples in to 32-bit samples so they can be processed below
+    if ( sample_flags & ( SAMPLE_IQ_FORMAT_12BIT | SAMPLE_IQ_FORMAT_BFP ) ) {
+        wl_read_iq_decompress( sample_flags, samples, sample_size, scratch );
+        
+        samples  = scratch;
+    }
+    
+    // Locate the bytes of the two 16-bit halves of each sample
+    //     NOTE:  Compressed samples are always expanded to big endian samples
+    //
+    if ( ( sample_flags & SAMPLE_IQ_LITTLE_ENDIAN ) && !( sample_flags & ( SAMPLE_IQ_FORMAT_12BIT | SAMPLE_IQ_FORMAT_BFP ) ) ) {
+        msb_0 = 3;   lsb_0 = 2;   msb_1 = 1;   lsb_1 = 0;
+    } else {
+        msb_0 = 0;   lsb_0 = 1;   msb_1 = 2;   lsb_1 = 3;
+    }
+    
+    // Place samples in the array (Ethernet packet is uint8 big or little endian, output array is various types little endian) 
+    //   NOTE: Need to process samples in the correct order
+    //   NOTE: Need to process differently based on the data type
+    
+    switch (data_type) {
+        // ------------------------------------------------------------------------------------------------
+        case IQ_DATA_TYPE_DOUBLE:
+            // Need to process the Ethernet packet into a double precision floating point array
+            //    NOTE:  This performs an endian swap (big to little) on both IQ and RSSI data
+            //    NOTE:  This will convert IQ data from a UFix_16_0 to a Fix_16_15
+            //    NOTE:  This will unpack the RSSI sample
+            // 
+            switch ( function ) {
+                case TRANSPORT_READ_IQ:
+                    tmp_double_array_0 = (double *) column_array[0];
+                    tmp_double_array_1 = (double *) column_array[1];
+                    
+                    for( i = 0; i < (4 * sample_size); i += 4 ) {
+                        tmp = sample_num + (i / 4);
+                        
+                        // Unpack the WARPLab IQ sample
+                        //   NOTE:  This performs a conversion from an UFix_16_0 to a Fix_16_15
+                        //      Process:
+                        //          1) Treat the 16 bit unsigned value as a 16 bit two's compliment signed value
+                        //          2) Divide by range / 2 to move the decimal point so resulting value is between +/- 1
+                        
+                        // I samples
+                        tmp_double_val = (double) ((int16)((samples[i + msb_0] << 8) | (samples[i + lsb_0])));
+                        tmp_double_array_0[tmp] = ( tmp_double_val / 0x8000 );
+                        
+                        // Q samples
+                        tmp_double_val = (double) ((int16)((samples[i + msb_1] << 8) | (samples[i + lsb_1])));
+                        tmp_double_array_1[tmp] = ( tmp_double_val / 0x8000 );
+                    }
+                break;
+                
+                case TRANSPORT_READ_RSSI:
+                    tmp_double_array_0 = (double *) column_array[0];
+                    
+                    for( i = 0; i < (4 * sample_size); i += 4 ) {
+                        tmp = (sample_num + (i / 4)) * 2;
+                        
+                        // Unpack the WARPLab RSSI sample
+                        //   NOTE:  This will place the packed 12 bit RSSI samples in the output array
+                        tmp_double_array_0[tmp    ] = (double)(((samples[i + msb_0] << 8) | (samples[i + lsb_0])) & 0x03FF);
+                        tmp_double_array_0[tmp + 1] = (double)(((samples[i + msb_1] << 8) | (samples[i + lsb_1])) & 0x03FF);
+                    }
+                break;
+                
+                default:
+                    return TRANSPORT_DECODE_BAD_FUNCTION;
+            }
+        break;
+        
+        // ------------------------------------------------------------------------------------------------
+        case IQ_DATA_TYPE_SINGLE:
+            // Need to process the Ethernet packet into a single precision floating point array
+            //     NOTE:  This is exactly the same processing as the 'double' case but using float 
+            //            instead of double for the output type
+            //
+            switch ( function ) {
+                case TRANSPORT_READ_IQ:
+                    tmp_single_array_0 = (float *) column_array[0];
+                    tmp_single_array_1 = (float *) column_array[1];
+                    
+                    for( i = 0; i < (4 * sample_size); i += 4 ) {
+                        tmp = sample_num + (i / 4);
+                        
+                        // Unpack the WARPLab IQ sample
+                        //   NOTE:  This performs a conversion from an UFix_16_0 to a Fix_16_15 
+                        //      Process:
+                        //          1) Treat the 16 bit unsigned value as a 16 bit two's compliment signed value
+                        //          2) Divide by range / 2 to move the decimal point so resulting value is between +/- 1
+                        
+                        // I samples
+                        tmp_single_val = (float) ((int16)((samples[i + msb_0] << 8) | (samples[i + lsb_0])));
+                        tmp_single_array_0[tmp] = ( tmp_single_val / 0x8000 );
+                        
+                        // Q samples
+                        tmp_single_val = (float) ((int16)((samples[i + msb_1] << 8) | (samples[i + lsb_1])));
+                        tmp_single_array_1[tmp] = ( tmp_single_val / 0x8000 );
+                    }
+                break;
+                
+                case TRANSPORT_READ_RSSI:
+                    tmp_single_array_0 = (float *) column_array[0];
+                    
+                    for( i = 0; i < (4 * sample_size); i += 4 ) {
+                        tmp = (sample_num + (i / 4)) * 2;
+                        
+                        // Unpack the WARPLab RSSI sample
+                        //   NOTE:  This will place the packed 12 bit RSSI samples in the output array
+                        tmp_single_array_0[tmp    ] = (float)(((samples[i + msb_0] << 8) | (samples[i + lsb_0])) & 0x03FF);
+                        tmp_single_array_0[tmp + 1] = (float)(((samples[i + msb_1] << 8) | (samples[i + lsb_1])) & 0x03FF);
+                    }
+                break;
+                
+                default:
+                    return TRANSPORT_DECODE_BAD_FUNCTION;
+            }
+        break;
+        
+        // ------------------------------------------------------------------------------------------------
+        case IQ_DATA_TYPE_INT16:
+            // Need to process the Ethernet packet into a int16 array
+            //    NOTE:  This performs an endian swap (big to little) on both IQ and RSSI data
+            //    NOTE:  This will convert IQ data from a UFix_16_0 to a Fix_16_0
+            //    NOTE:  This will unpack the RSSI sample
+            //
+            switch ( function ) {
+                case TRANSPORT_READ_IQ:
+                    tmp_int16_array_0 = (int16 *) column_array[0];
+                    tmp_int16_array_1 = (int16 *) column_array[1];
+                    
+                    for( i = 0; i < (4 * sample_size); i += 4 ) {
+                        tmp = sample_num + (i / 4);
+                        
+                        // Unpack the WARPLab IQ sample
+                        //   NOTE:  This performs a conversion from an UFix_16_0 to a Fix_16_0 
+                        //      Process:
+                        //          1) Treat the 16 bit unsigned value as a 16 bit two's compliment signed value
+                        
+                        // I samples
+                        tmp_int16_array_0[tmp] = (int16)((samples[i + msb_0] << 8) | (samples[i + lsb_0]));
+                        
+                        // Q samples
+                        tmp_int16_array_1[tmp] = (int16)((samples[i + msb_1] << 8) | (samples[i + lsb_1]));
+                    }
+                break;
+                
+                case TRANSPORT_READ_RSSI:
+                    tmp_int16_array_0 = (int16 *) column_array[0];
+                    
+                    for( i = 0; i < (4 * sample_size); i += 4 ) {
+                        tmp = (sample_num + (i / 4)) * 2;
+                        
+                        // Unpack the WARPLab RSSI sample
+                        //   NOTE:  This will place the packed 12 bit RSSI samples in the output array
+                        tmp_int16_array_0[tmp    ] = (int16)(((samples[i + msb_0] << 8) | (samples[i + lsb_0])) & 0x03FF);
+                        tmp_int16_array_0[tmp + 1] = (int16)(((samples[i + msb_1] << 8) | (samples[i + lsb_1])) & 0x03FF);
+                    }
+                break;
+                
+                default:
+                    return TRANSPORT_DECODE_BAD_FUNCTION;
+            }
+        break;
+        
+        // ------------------------------------------------------------------------------------------------
+        case IQ_DATA_TYPE_RAW:
+            // Need to process the Ethernet packet into a uint32 array
+            //    NOTE:  This performs an endian swap (big to little) on both IQ and RSSI data
+            //    NOTE:  No other processing is done on the data
+            //
+            switch ( function ) {
+                case TRANSPORT_READ_IQ:
+                case TRANSPORT_READ_RSSI:
+                    tmp_uint32_array_0 = (uint32 *) column_array[0];
+                    
+                    if ( msb_0 == 3 ) {
+                        // Little endian samples are already in the byte order of the host
+                        memcpy( &tmp_uint32_array_0[ sample_num ], samples, ( 4 * sample_size ) );
+                    } else {
+                        for( i = 0; i < (4 * sample_size); i += 4 ) {
+                            tmp_uint32_array_0[ sample_num + (i / 4) ] = (uint32) ( (samples[i] << 24) | (samples[i + 1] << 16) | (samples[i + 2] << 8) | (samples[i + 3]) );
+                        }
+                    }
+                break;
+                
+                default:
+                    return TRANSPORT_DECODE_BAD_FUNCTION;
+            }
+        break;
+        
+        // ------------------------------------------------------------------------------------------------
+        default:
+            return TRANSPORT_DECODE_BAD_DATA_TYPE;
+    }
+    
+    return TRANSPORT_DECODE_SUCCESS;
+}
+
+
+
+/*****************************************************************************/
+/**
+*  Function:  Read IQ decode check
+*
+*  Function to report the error of wl_read_iq_decode() on the MATLAB thread
+*
+******************************************************************************/
+void wl_read_iq_decode_check( int status ) {
+
+    switch ( status ) {
+        case TRANSPORT_DECODE_BAD_FUNCTION:
+            printf("ERROR:  Unsupported function for read_buffers in MEX transport\n");
+        break;
+        
+        case TRANSPORT_DECODE_BAD_DATA_TYPE:
+            mexErrMsgTxt("Error:  Unsupported output data type");
+        break;
+    }
+}
+
+
+
+/*****************************************************************************/
+/**
+*  Function:  Number of cores
+*
+*  Function to return the number of cores of the host
+*
+******************************************************************************/
+uint32 wl_num_cores( void ) {
+#ifdef WIN32
+    SYSTEM_INFO  info;
+
+    GetSystemInfo( &info );
+    
+    return info.dwNumberOfProcessors;
+#else
+    long         num_cores = sysconf( _SC_NPROCESSORS_ONLN );
+    
+    return ( num_cores > 0 ) ? (uint32) num_cores : 1;
+#endif
+}
+
+
+
+/*****************************************************************************/
+/**
+*  Function:  Read IQ decode thread
+*
+*  Function run by each decode thread:  decodes the slots that are ready until 
+*  the thread pool is stopped
+*
+******************************************************************************/
+wl_thread_return_t wl_decode_thread( void *arg ) {
+
+    uint32            i;
+    int               status;
+    wl_decode_slot   *slot;
+
+    (void) arg;
+
+    wl_mutex_lock( &decode_pool.lock );
+
+    while ( !decode_pool.stop ) {
+    
+        // Find a slot that is ready
+        slot = NULL;
+        
+        for ( i = 0; i < decode_pool.num_slots; i++ ) {
+            if ( decode_pool.slots[i].state == TRANSPORT_DECODE_SLOT_READY ) {
+                slot = &(decode_pool.slots[i]);
+                break;
+            }
+        }
+        
+        if ( slot == NULL ) {
+            wl_cond_wait( &decode_pool.work, &decode_pool.lock );
+            continue;
+        }
+        
+        // Decode the slot without holding the lock
+        slot->state = TRANSPORT_DECODE_SLOT_BUSY;
+        
+        wl_mutex_unlock( &decode_pool.lock );
+        
+        status = wl_read_iq_decode( decode_pool.function, decode_pool.data_type, slot->sample_flags, slot->samples,
+                                    slot->sample_num, slot->sample_size, slot->column_array, slot->scratch );
+        
+        wl_mutex_lock( &decode_pool.lock );
+        
+        if ( ( status != TRANSPORT_DECODE_SUCCESS ) && ( decode_pool.status == TRANSPORT_DECODE_SUCCESS ) ) {
+            decode_pool.status = status;
+        }
+        
+        slot->state              = TRANSPORT_DECODE_SLOT_FREE;
+        decode_pool.num_pending -= 1;
+        
+        wl_cond_broadcast( &decode_pool.done );
+    }
+
+    wl_mutex_unlock( &decode_pool.lock );
+    
+    return 0;
+}
+
+
+
+/*****************************************************************************/
+/**
+*  Function:  Read IQ decode pool start
 *
-*    NOTE:  If the sample header flags == SAMPLE_HDR_FLAG_IQ_NOT_READY, then the "samples"
-*        after the sample header need to be interpreted in the following manner:
+*  Function to start the number of decode threads selected by 
+*  wl_mex_udp_transport('read_iq_set_decode_threads', ...).  The threads are kept
+*  between calls and are only re-started if the number of threads changes.
 *
-*        - sample[0]       - Tx status
-*        - sample[1]       - Current Tx read pointer
-*        - sample[2]       - Tx length
-*        - sample[3]       - Rx status
-*        - sample[4]       - Current Rx write pointer
-*        - sample[5]       - Rx length
+*  Returns:  Number of decode threads running (0 ==> decode on the receive thread)
 *
 ******************************************************************************/
-int wl_read_baseband_buffer( int index, char *buffer, int length, char *ip_addr, int port,
-                             uint32 initial_offset, uint32 num_samples, uint32 start_sample, uint32 buffer_id, 
-                             uint32 function, uint32 data_type,
-                             void **output_array, uint32 *num_cmds, uint32 *seq_num) {
+uint32 wl_decode_pool_start( void ) {
 
-    // Variable declaration
-    uint32                   i, tmp;
-    int                      done                = 0;
+    uint32 num_threads = read_iq_decode_threads;
     
-    uint32                   buffer_id_cmd       = 0;
-    uint32                   start_sample_cmd    = 0;
-    uint32                   total_sample_cmd    = 0;
-    uint32                   bytes_per_pkt       = 0;
-    uint32                   num_pkts            = 0;
+    // By default, use one thread per core that is not used by the receive thread
+    if ( num_threads == TRANSPORT_DECODE_THREADS_AUTO ) {
+        num_threads = wl_num_cores() - 1;
+    }
     
-    uint32                   tmp_eth_buffer_size = 0;
-    uint32                   samples_per_pkt     = 0;
-
-    int                      sent_size           = 0;
-
-    uint32                   rcvd_pkts           = 0;
-    int                      rcvd_size           = 0;
-    uint32                   num_rcvd_samples    = 0;
-    uint32                   sample_num          = 0;
-    uint32                   sample_size         = 0;
-    uint8                    sample_flags        = 0;
-    uint8                    sample_iq_id        = 0;
+    if ( num_threads > TRANSPORT_DECODE_MAX_THREADS ) {
+        num_threads = TRANSPORT_DECODE_MAX_THREADS;
+    }
     
-    uint32                   timeout             = 0;
-    uint32                   num_retrys          = 0;
-    uint32                   num_iq_retrys       = 0;
-
-    uint32                   total_cmds          = 0;
+    if ( num_threads == decode_pool.num_threads ) {
+        return num_threads;
+    }
     
-    uint32                   err_start_sample    = 0;
-    uint32                   err_num_samples     = 0;
-    uint32                   err_num_pkts        = 0;
+    wl_decode_pool_stop();
     
-    uint32                   iq_busy_warn        = 1;
-    uint32                   wait_time           = 0;
+    if ( !decode_pool.initialized ) {
+        wl_mutex_init( &decode_pool.lock );
+        wl_cond_init( &decode_pool.work );
+        wl_cond_init( &decode_pool.done );
+        
+        decode_pool.slots       = NULL;
+        decode_pool.num_slots   = 0;
+        decode_pool.num_pending = 0;
+        decode_pool.status      = TRANSPORT_DECODE_SUCCESS;
+        decode_pool.initialized = 1;
+    }
     
-    char                    *tmp_eth_buffer;
-    uint8                   *samples;
+    // Start the threads
+    //     NOTE:  If a thread cannot be created, the pool uses the threads that were created
+    //
+    while ( decode_pool.num_threads < num_threads ) {
+        if ( !wl_thread_create( &(decode_pool.threads[decode_pool.num_threads]), wl_decode_thread ) ) {
+            break;
+        }
+        
+        decode_pool.num_threads += 1;
+    }
+    
+    return decode_pool.num_threads;
+}
 
-    // Variables for the different output types    
-    double                  *tmp_double_array_0;
-    double                  *tmp_double_array_1;
-    double                   tmp_double_val;
 
-    float                   *tmp_single_array_0;
-    float                   *tmp_single_array_1;
-    float                    tmp_single_val;
+
+/*****************************************************************************/
+/**
+*  Function:  Read IQ decode pool stop
+*
+*  Function to stop all decode threads
+*
+******************************************************************************/
+void wl_decode_pool_stop( void ) {
+
+    uint32 i;
+
+    if ( decode_pool.num_threads == 0 ) {
+        return;
+    }
     
-    int16                   *tmp_int16_array_0;
-    int16                   *tmp_int16_array_1;
+    wl_mutex_lock( &decode_pool.lock );
+    decode_pool.stop = 1;
+    wl_cond_broadcast( &decode_pool.work );
+    wl_mutex_unlock( &decode_pool.lock );
     
-    uint32                  *tmp_uint32_array_0;
+    for ( i = 0; i < decode_pool.num_threads; i++ ) {
+        wl_thread_join( decode_pool.threads[i] );
+    }
+    
+    decode_pool.stop        = 0;
+    decode_pool.num_threads = 0;
+}
 
-    wl_transport_header     *transport_hdr;
-    wl_transport_header     *rcvd_transport_hdr;
-    wl_command_header       *command_hdr;
-    uint32                  *command_args;
-    wl_sample_header        *sample_hdr;
-    wl_sample_tracker       *sample_tracker;
 
-    // Read statistics
-    uint32                   total_timeout     = 0;
-    uint32                   init_timeout      = 0;
-    uint32                   avg_timeout       = 0;
-    
-    // Compute some constants to be used later
-    uint32                   tport_hdr_size    = sizeof( wl_transport_header );
-    uint32                   cmd_hdr_size      = sizeof( wl_transport_header ) + sizeof( wl_command_header );
-    uint32                   all_hdr_size      = sizeof( wl_transport_header ) + sizeof( wl_command_header ) + sizeof( wl_sample_header );
 
-    // Initialization
-    transport_hdr       = (wl_transport_header *) buffer;
-    command_hdr         = (wl_command_header   *) ( buffer + tport_hdr_size );
-    command_args        = (uint32              *) ( buffer + cmd_hdr_size );
+/*****************************************************************************/
+/**
+*  Function:  Read IQ decode pool attach
+*
+*  Function to give the decode slots of a Read IQ / Read RSSI request to the 
+*  decode threads
+*
+******************************************************************************/
+void wl_decode_pool_attach( wl_decode_slot *slots, uint32 num_slots, uint32 function, uint32 data_type ) {
+
+    wl_mutex_lock( &decode_pool.lock );
     
-    buffer_id_cmd       = endian_swap_32( command_args[0] );
-    start_sample_cmd    = endian_swap_32( command_args[1] );
-    total_sample_cmd    = endian_swap_32( command_args[2] );
-    bytes_per_pkt       = endian_swap_32( command_args[3] );         // Command contains payload size; add room for header
-    num_pkts            = endian_swap_32( command_args[4] );
+    decode_pool.slots       = slots;
+    decode_pool.num_slots   = num_slots;
+    decode_pool.num_pending = 0;
+    decode_pool.function    = function;
+    decode_pool.data_type   = data_type;
+    decode_pool.status      = TRANSPORT_DECODE_SUCCESS;
     
-    tmp_eth_buffer_size = bytes_per_pkt + 100;                       // Command contains payload size; add room for header
-    samples_per_pkt     = ( bytes_per_pkt >> 2 );                    // Each WARPLab sample is 4 bytes
+    wl_mutex_unlock( &decode_pool.lock );
+}
+
+
+
+/*****************************************************************************/
+/**
+*  Function:  Read IQ decode pool get slot
+*
+*  Function to get a free slot to receive a packet in to.  If all slots are in
+*  use, this waits for a decode thread to finish a slot.
+*
+*  Returns:  Index of the slot
+*
+******************************************************************************/
+int wl_decode_pool_get_slot( void ) {
+
+    uint32 i;
+
+    wl_mutex_lock( &decode_pool.lock );
     
-    // Replace IQ ID with value maintained by the transport
-    sample_iq_id        = (sample_read_iq_id & 0xFF);
-    command_args[5]     = endian_swap_32( sample_iq_id );
+    while ( 1 ) {
+        for ( i = 0; i < decode_pool.num_slots; i++ ) {
+            if ( decode_pool.slots[i].state == TRANSPORT_DECODE_SLOT_FREE ) {
+                decode_pool.slots[i].state = TRANSPORT_DECODE_SLOT_RECEIVE;
+                
+                wl_mutex_unlock( &decode_pool.lock );
+                
+                return i;
+            }
+        }
+        
+        wl_cond_wait( &decode_pool.done, &decode_pool.lock );
+    }
+}
+
+
+
+/*****************************************************************************/
+/**
+*  Function:  Read IQ decode pool submit
+*
+*  Function to hand a received slot to the decode threads
+*
+******************************************************************************/
+void wl_decode_pool_submit( int slot ) {
+
+    wl_mutex_lock( &decode_pool.lock );
     
-    // Increment read IQ ID (explicitly maintain as a uint8)
-    sample_read_iq_id   = (sample_read_iq_id + 1) % 0x100;
+    decode_pool.slots[slot].state  = TRANSPORT_DECODE_SLOT_READY;
+    decode_pool.num_pending       += 1;
     
-#ifdef _DEBUG_
-    // Print command arguments    
-    printf("Read IQ / Read RSSI command\n");
-    printf("    index = %d, length = %d, port = %d, ip_addr = %s \n", index, length, port, ip_addr);
-    printf("    num_sample = %d, start_sample = %d, buffer_id = %d \n", num_samples, start_sample, buffer_id);
-    printf("    bytes_per_pkt = %d;  num_pkts = %d \n", bytes_per_pkt, num_pkts );
-    // print_buffer( buffer, length );
-#endif
+    wl_cond_broadcast( &decode_pool.work );
+    wl_mutex_unlock( &decode_pool.lock );
+}
 
-    // Perform a consistency check to make sure parameters are correct
-    if ( buffer_id_cmd != buffer_id ) {
-        printf("WARNING:  Buffer ID in command (%d) does not match function parameter (%d)\n", buffer_id_cmd, buffer_id);
-    }
-    if ( start_sample_cmd != start_sample ) {
-        printf("WARNING:  Starting sample in command (%d) does not match function parameter (%d)\n", start_sample_cmd, start_sample);
-    }
-    if ( total_sample_cmd != num_samples ) {
-        printf("WARNING:  Number of samples requested in command (%d) does not match function parameter (%d)\n", total_sample_cmd, num_samples);
+
+
+/*****************************************************************************/
+/**
+*  Function:  Read IQ decode pool finish
+*
+*  Function to wait until all slots of the current request are decoded and to 
+*  take the slots back from the decode threads.  This is safe to call when no
+*  request is in progress.
+*
+*  Returns:  TRANSPORT_DECODE_SUCCESS or the first TRANSPORT_DECODE_* error
+*
+******************************************************************************/
+int wl_decode_pool_finish( void ) {
+
+    int status;
+
+    if ( !decode_pool.initialized ) {
+        return TRANSPORT_DECODE_SUCCESS;
     }
     
-    // Malloc temporary buffer to process ethernet packets
-    tmp_eth_buffer  = (char *) malloc( sizeof( char ) * tmp_eth_buffer_size );
-    if( tmp_eth_buffer == NULL ) { die_with_error("Error:  Could not allocate temporary Ethernet packet buffer"); }
+    wl_mutex_lock( &decode_pool.lock );
     
-    // Malloc temporary array to track samples that have been received and initialize
-    sample_tracker = (wl_sample_tracker *) malloc( sizeof( wl_sample_tracker ) * num_pkts );
-    if( sample_tracker == NULL ) { die_with_error("Error:  Could not allocate sample tracker buffer"); }
-    for ( i = 0; i < num_pkts; i++ ) { sample_tracker[i].start_sample = 0;  sample_tracker[i].num_samples = 0; }
+    while ( decode_pool.num_pending > 0 ) {
+        wl_cond_wait( &decode_pool.done, &decode_pool.lock );
+    }
     
-    // Send packet to request samples
-    sent_size   = send_socket( index, buffer, length, ip_addr, port );
-    total_cmds += 1;
-
-    // Initialize loop variables
-    rcvd_pkts = 0;
-    timeout   = 0;
+    status                  = decode_pool.status;
+    decode_pool.slots       = NULL;
+    decode_pool.num_slots   = 0;
+    decode_pool.status      = TRANSPORT_DECODE_SUCCESS;
     
-    // Process each return packet
-    while ( !done ) {
-        
-        // If we hit the timeout, then try to re-request the remaining samples
-        if ( timeout >= TRANSPORT_TIMEOUT ) {
-        
-            // If we hit the max number of retrys, then abort
-            if ( num_retrys >= TRANSPORT_MAX_RETRY ) {
-
-                printf("ERROR:  Exceeded %d retrys for current Read IQ / Read RSSI request \n", TRANSPORT_MAX_RETRY);
-                printf("    Requested %d samples from buffer %d starting from sample number %d \n", num_samples, buffer_id, start_sample);
-                printf("    Received %d out of %d packets from node before timeout.\n", rcvd_pkts, num_pkts);
-                printf("    Please check the node and look at the ethernet traffic to isolate the issue. \n");                
-            
-                die_with_error("Error:  Reached maximum number of retrys without a response... aborting.");
-                
-            } else {
+    wl_mutex_unlock( &decode_pool.lock );
+    
+    return status;
+}
 
-                // NOTE:  We print a warning here because the Read IQ / Read RSSI case in the mex function above
-                //        will split Read IQ / Read RSSI requests based on the receive buffer size.  Therefore,
-                //        any timeouts we receive here should be legitimate issues that should be explored.
-                //
-                if ( suppress_iq_warnings == 0 ) {
-                    printf("WARNING:  Read IQ / Read RSSI request timed out.  Retrying remaining samples. \n");
-                    printf("          If this message occurs frequently, please adjust the Read IQ \n");
-                    printf("          maximum request size (in bytes) for the transport using the \n");
-                    printf("          M code function:  \n");
-                    printf("              wl_mex_udp_transport('read_iq_set_max_request_size', size)  \n");
-                    printf("          Defaults to 80 percent of the receive buffer allocated by the OS. \n");
-                    printf("\n          To suppress all IQ warnings for the transport use the M code function: \n");
-                    printf("              wl_mex_udp_transport('suppress_iq_warnings')\n");
-                }
-            
-                // Find the first packet error and request the remaining samples
-                if ( wl_read_iq_find_error( sample_tracker, num_samples, start_sample, rcvd_pkts, samples_per_pkt,
-                                            &err_num_samples, &err_start_sample, &err_num_pkts ) ) {
-                    
-                    command_args[1] = endian_swap_32( err_start_sample );
-                    command_args[2] = endian_swap_32( err_num_samples );
-                    command_args[4] = endian_swap_32( num_pkts - ( rcvd_pkts - err_num_pkts ) );
 
-                    // Since there was an error in the packets we have already received, then we need to adjust rcvd_pkts
-                    rcvd_pkts        -= err_num_pkts;
-                    num_rcvd_samples  = num_samples - err_num_samples;
 
-                } else {
-                    // If we did not find an error, then the first rcvd_pkts are correct and we should request
-                    //   the remaining packets
-                    command_args[1] = endian_swap_32( err_start_sample );
-                    command_args[2] = endian_swap_32( err_num_samples );
-                    command_args[4] = endian_swap_32( num_pkts - rcvd_pkts );
-                }
+/*****************************************************************************/
+/**
+*  Function:  Read IQ retry setup
+*
+*  Function to set up the retry of a Read IQ / Read RSSI request for the buffers 
+*  in retry_columns (bit i corresponds to buffer_ids[i]).  The first missing packet
+*  is found for each buffer and the sample tracker of each buffer is reset to the 
+*  packets before the earliest missing packet.  The ret_* parameters are updated 
+*  with the values to use when requesting the remaining packets.
+*
+*  Returns:  Buffer selection of the buffers to request
+*
+******************************************************************************/
+uint32 wl_read_iq_setup_retry( wl_sample_tracker *tracker, uint32 *rcvd_pkts, uint32 *buffer_ids, uint32 num_buffers, uint32 retry_columns,
+                               uint32 num_samples, uint32 start_sample, uint32 num_pkts, uint32 max_sample_size,
+                               uint32 *ret_num_samples, uint32 *ret_start_sample, uint32 *ret_num_pkts ) {
 
-                // Retransmit the read IQ request packet
-                sent_size   = send_socket( index, buffer, length, ip_addr, port );
-                total_cmds += 1;
-                
-                // Update control variables
-                timeout     = 0;
-                num_retrys += 1;
+    uint32 i, j;
+    uint32 err_start_sample;
+    uint32 err_num_samples;
+    uint32 err_num_pkts;
+    
+    uint32 buffer_sel              = 0;
+    uint32 start_sample_to_request = start_sample + num_samples;
+    uint32 num_pkts_received       = 0;
+
+    // Find the earliest missing packet of all the buffers
+    for ( i = 0; i < num_buffers; i++ ) {
+        if ( retry_columns & (1 << i) ) {
+            wl_read_iq_find_error( &tracker[i * num_pkts], num_samples, start_sample, rcvd_pkts[i], max_sample_size,
+                                   &err_num_samples, &err_start_sample, &err_num_pkts );
+                                   
+            if ( ( err_start_sample - start_sample ) < ( start_sample_to_request - start_sample ) ) {
+                start_sample_to_request = err_start_sample;
+            }
+        }
+    }
+    
+    // If all packets were found (ie the error is in the packet contents), then request all of the packets again
+    //     NOTE:  Sample indexes are compared relative to the start sample since a windowed request can
+    //            start at a "negative" sample (see READ_IQ_WINDOW_AGC_DONE).
+    //
+    if ( ( start_sample_to_request - start_sample ) >= num_samples ) {
+        start_sample_to_request = start_sample;
+    }
+    
+    num_pkts_received = ( start_sample_to_request - start_sample ) / max_sample_size;
+    
+    // Reset the tracker of each buffer to the packets received before the earliest missing packet
+    for ( i = 0; i < num_buffers; i++ ) {
+        if ( retry_columns & (1 << i) ) {
+            for ( j = 0; j < num_pkts_received; j++ ) {
+                tracker[(i * num_pkts) + j].start_sample = start_sample + ( j * max_sample_size );
+                tracker[(i * num_pkts) + j].num_samples  = max_sample_size;
             }
+            
+            rcvd_pkts[i] = num_pkts_received;
+            buffer_sel  |= buffer_ids[i];
         }
-        
-        // Receive packet
-        rcvd_size = receive_socket( index, tmp_eth_buffer_size, tmp_eth_buffer );
+    }
+    
+    // Return parameters
+    *ret_start_sample = start_sample_to_request;
+    *ret_num_samples  = ( start_sample + num_samples ) - start_sample_to_request;
+    *ret_num_pkts     = num_pkts - num_pkts_received;
+    
+    return buffer_sel;
+}
 
-        // receive_socket() handles all socket related errors and will only return:
-        //   - zero if no packet is available
-        //   - non-zero if packet is available
-        if ( rcvd_size > 0 ) {
-            // Decode the Ethernet packet
-            rcvd_transport_hdr  = (wl_transport_header *) tmp_eth_buffer;
-            sample_hdr          = (wl_sample_header    *) (tmp_eth_buffer + cmd_hdr_size);
 
-            // Decode the sample header
-            sample_num          = endian_swap_32( sample_hdr->start ) - initial_offset;
-            sample_size         = endian_swap_32( sample_hdr->num_samples );
-            sample_flags        = sample_hdr->flags;
-            
-#ifdef _DEBUG_
-            // Record the timeout value for statistics
-            if ( rcvd_pkts == 0 ) {
-                init_timeout   = timeout;
-            } else {
-                total_timeout += timeout;
-            }
-            
-            // Print information about the last 10 packets
-            if ((rcvd_pkts > (num_pkts - 10)) || (num_pkts < 10 )) {
-                printf("num_sample = %d, start_sample = %d   %08x  %08x %08x %08x\n", sample_size, sample_num, sample_hdr->num_samples, sample_size, sample_hdr->start, sample_num);
-            }
-#endif
 
-            // Reset the timeout regardless of the contents of the packet
-            timeout = 0;
+/*****************************************************************************/
+/**
+*  Function:  Read IQ metadata retry setup
+*
+*  Function to set up the command arguments of a Read IQ request for only the 
+*  capture metadata of the original request (ie the original buffers and samples 
+*  with zero packets).  The node then sends only the metadata packet, so the 
+*  samples that were already received are not sent again.
+*
+*  Returns:  None
+*
+******************************************************************************/
+void wl_read_iq_setup_metadata_retry( uint32 *command_args, uint32 buffer_id_cmd, uint32 start_sample, uint32 num_samples ) {
 
-            // Check the sample header flags
-            if ((sample_flags & SAMPLE_IQ_ERROR) == SAMPLE_IQ_ERROR) {
-                // Error in samples print error message and return
-                die_with_error("Error:  Node returned 'SAMPLE_IQ_ERROR'.  Check that node is not currently transmitting in continuous TX mode.");
-            
-            } else if ((sample_flags & SAMPLE_IQ_NOT_READY) == SAMPLE_IQ_NOT_READY) {
-                if ( iq_busy_warn ) {
-                    printf("WARNING:  Node was not ready to process Read IQ request.  Waiting to request again.\n");
-                    printf("    This warning can be removed by waiting until the node is not busy with a TX or RX \n");
-                    printf("    operation.  To do this, please add 'pause(1.5 * NUM_SAMPLES * 1/(40e6));' after\n");
-                    printf("    any triggers and before the Read IQ request.\n\n");
-                    iq_busy_warn = 0;
-                }
-                
-                wait_time = wl_compute_sample_wait_time((uint32 *)(tmp_eth_buffer + all_hdr_size));
-                
-                // Wait until the samples should be done
-                if ( wait_time != 0 ) {
-                    wl_usleep( wait_time + 100 );
-                }
-                
-                num_iq_retrys += 1;
-                
-                // Send packet to request samples
-                sent_size   = send_socket( index, buffer, length, ip_addr, port );
-                total_cmds += 1;
+    command_args[0] = endian_swap_32( buffer_id_cmd | READ_IQ_FLAG_METADATA );
+    command_args[1] = endian_swap_32( start_sample );
+    command_args[2] = endian_swap_32( num_samples );
+    command_args[4] = endian_swap_32( 0 );
+}
 
-                if ( sent_size != length ) {
-                    die_with_error("Error:  Size of packet sent to request samples does not match length of packet.");
-                }
 
-                // Check that we have not spent a "long time" waiting for samples to be ready                
-                if ( num_iq_retrys > SAMPLE_IQ_MAX_RETRY ) {
-                    die_with_error("Error:  Timeout waiting for node to return samples.  Please check the node operation.");
-                }
-            } else {
-                // Normal IQ data
-                
-                // Set a pointer to the sample data
-                samples      = (uint8 *) ( tmp_eth_buffer + all_hdr_size );
-                
-                // If we are tracking packets, record which samples have been received
-                sample_tracker[rcvd_pkts].start_sample = sample_num + initial_offset;
-                sample_tracker[rcvd_pkts].num_samples  = sample_size;
-                
-                // Place samples in the array (Ethernet packet is uint8 big endian, output array is various types little endian) 
-                //   NOTE: Need to process samples in the correct order
-                //   NOTE: Need to process differently based on the data type
-                
-                switch (data_type) {
-                    // ------------------------------------------------------------------------------------------------
-                    case IQ_DATA_TYPE_DOUBLE:
-                        // Need to process the Ethernet packet into a double precision floating point array
-                        //    NOTE:  This performs an endian swap (big to little) on both IQ and RSSI data
-                        //    NOTE:  This will convert IQ data from a UFix_16_0 to a Fix_16_15
-                        //    NOTE:  This will unpack the RSSI sample
-                        // 
-                        switch ( function ) {
-                            case TRANSPORT_READ_IQ:
-                                tmp_double_array_0 = (double *) output_array[0];
-                                tmp_double_array_1 = (double *) output_array[1];
-                                
-                                for( i = 0; i < (4 * sample_size); i += 4 ) {
-                                    tmp = sample_num + (i / 4);
-                                    
-                                    // Unpack the WARPLab IQ sample
-                                    //   NOTE:  This performs a conversion from an UFix_16_0 to a Fix_16_15
-                                    //      Process:
-                                    //          1) Treat the 16 bit unsigned value as a 16 bit two's compliment signed value
-                                    //          2) Divide by range / 2 to move the decimal point so resulting value is between +/- 1
-                                    
-                                    // I samples
-                                    tmp_double_val = (double) ((int16)((samples[i    ] << 8) | (samples[i + 1])));
-                                    tmp_double_array_0[tmp] = ( tmp_double_val / 0x8000 );
-                                    
-                                    // Q samples
-                                    tmp_double_val = (double) ((int16)((samples[i + 2] << 8) | (samples[i + 3])));
-                                    tmp_double_array_1[tmp] = ( tmp_double_val / 0x8000 );
-                                }
-                            break;
-                            
-                            case TRANSPORT_READ_RSSI:
-                                tmp_double_array_0 = (double *) output_array[0];
-                                
-                                for( i = 0; i < (4 * sample_size); i += 4 ) {
-                                    tmp = (sample_num + (i / 4)) * 2;
-                                    
-                                    // Unpack the WARPLab RSSI sample
-                                    //   NOTE:  This will place the packed 12 bit RSSI samples in the output array
-                                    tmp_double_array_0[tmp    ] = (double)(((samples[i    ] << 8) | (samples[i + 1])) & 0x03FF);
-                                    tmp_double_array_0[tmp + 1] = (double)(((samples[i + 2] << 8) | (samples[i + 3])) & 0x03FF);
-                                }
-                            break;
-                            
-                            default:
-                                printf("ERROR:  Unsupported function for read_buffers in MEX transport\n");
-                            break;
-                        }
-                    break;
-                    
-                    // ------------------------------------------------------------------------------------------------
-                    case IQ_DATA_TYPE_SINGLE:
-                        // Need to process the Ethernet packet into a single precision floating point array
-                        //     NOTE:  This is exactly the same processing as the 'double' case but using float 
-                        //            instead of double for the output type
-                        //
-                        switch ( function ) {
-                            case TRANSPORT_READ_IQ:
-                                tmp_single_array_0 = (float *) output_array[0];
-                                tmp_single_array_1 = (float *) output_array[1];
-                                
-                                for( i = 0; i < (4 * sample_size); i += 4 ) {
-                                    tmp = sample_num + (i / 4);
-                                    
-                                    // Unpack the WARPLab IQ sample
-                                    //   NOTE:  This performs a conversion from an UFix_16_0 to a Fix_16_15 
-                                    //      Process:
-                                    //          1) Treat the 16 bit unsigned value as a 16 bit two's compliment signed value
-                                    //          2) Divide by range / 2 to move the decimal point so resulting value is between +/- 1
-                                    
-                                    // I samples
-                                    tmp_single_val = (float) ((int16)((samples[i    ] << 8) | (samples[i + 1])));
-                                    tmp_single_array_0[tmp] = ( tmp_single_val / 0x8000 );
-                                    
-                                    // Q samples
-                                    tmp_single_val = (float) ((int16)((samples[i + 2] << 8) | (samples[i + 3])));
-                                    tmp_single_array_1[tmp] = ( tmp_single_val / 0x8000 );
-                                }
-                            break;
-                            
-                            case TRANSPORT_READ_RSSI:
-                                tmp_single_array_0 = (float *) output_array[0];
-                                
-                                for( i = 0; i < (4 * sample_size); i += 4 ) {
-                                    tmp = (sample_num + (i / 4)) * 2;
-                                    
-                                    // Unpack the WARPLab RSSI sample
-                                    //   NOTE:  This will place the packed 12 bit RSSI samples in the output array
-                                    tmp_single_array_0[tmp    ] = (float)(((samples[i    ] << 8) | (samples[i + 1])) & 0x03FF);
-                                    tmp_single_array_0[tmp + 1] = (float)(((samples[i + 2] << 8) | (samples[i + 3])) & 0x03FF);
-                                }
-                            break;
-                            
-                            default:
-                                printf("ERROR:  Unsupported function for read_buffers in MEX transport\n");
-                            break;
-                        }
-                    break;
-                    
-                    // ------------------------------------------------------------------------------------------------
-                    case IQ_DATA_TYPE_INT16:
-                        // Need to process the Ethernet packet into a int16 array
-                        //    NOTE:  This performs an endian swap (big to little) on both IQ and RSSI data
-                        //    NOTE:  This will convert IQ data from a UFix_16_0 to a Fix_16_0
-                        //    NOTE:  This will unpack the RSSI sample
-                        //
-                        switch ( function ) {
-                            case TRANSPORT_READ_IQ:
-                                tmp_int16_array_0 = (int16 *) output_array[0];
-                                tmp_int16_array_1 = (int16 *) output_array[1];
-                                
-                                for( i = 0; i < (4 * sample_size); i += 4 ) {
-                                    tmp = sample_num + (i / 4);
-                                    
-                                    // Unpack the WARPLab IQ sample
-                                    //   NOTE:  This performs a conversion from an UFix_16_0 to a Fix_16_0 
-                                    //      Process:
-                                    //          1) Treat the 16 bit unsigned value as a 16 bit two's compliment signed value
-                                    
-                                    // I samples
-                                    tmp_int16_array_0[tmp] = (int16)((samples[i    ] << 8) | (samples[i + 1]));
-                                    
-                                    // Q samples
-                                    tmp_int16_array_1[tmp] = (int16)((samples[i + 2] << 8) | (samples[i + 3]));
-                                }
-                            break;
-                            
-                            case TRANSPORT_READ_RSSI:
-                                tmp_int16_array_0 = (int16 *) output_array[0];
-                                
-                                for( i = 0; i < (4 * sample_size); i += 4 ) {
-                                    tmp = (sample_num + (i / 4)) * 2;
-                                    
-                                    // Unpack the WARPLab RSSI sample
-                                    //   NOTE:  This will place the packed 12 bit RSSI samples in the output array
-                                    tmp_int16_array_0[tmp    ] = (int16)(((samples[i    ] << 8) | (samples[i + 1])) & 0x03FF);
-                                    tmp_int16_array_0[tmp + 1] = (int16)(((samples[i + 2] << 8) | (samples[i + 3])) & 0x03FF);
-                                }
-                            break;
-                            
-                            default:
-                                printf("ERROR:  Unsupported function for read_buffers in MEX transport\n");
-                            break;
-                        }
-                    break;
-                    
-                    // ------------------------------------------------------------------------------------------------
-                    case IQ_DATA_TYPE_RAW:
-                        // Need to process the Ethernet packet into a uint32 array
-                        //    NOTE:  This performs an endian swap (big to little) on both IQ and RSSI data
-                        //    NOTE:  No other processing is done on the data
-                        //
-                        switch ( function ) {
-                            case TRANSPORT_READ_IQ:
-                            case TRANSPORT_READ_RSSI:
-                                tmp_uint32_array_0 = (uint32 *) output_array[0];
-                                
-                                for( i = 0; i < (4 * sample_size); i += 4 ) {
-                                    tmp_uint32_array_0[ sample_num + (i / 4) ] = (uint32) ( (samples[i] << 24) | (samples[i + 1] << 16) | (samples[i + 2] << 8) | (samples[i + 3]) );
-                                }
-                            break;
-                            
-                            default:
-                                printf("ERROR:  Unsupported function for read_buffers in MEX transport\n");
-                            break;
-                        }
-                    break;
-                    
-                    // ------------------------------------------------------------------------------------------------
-                    default:
-                        mexErrMsgTxt("Error:  Unsupported output data type");
-                    break;
-                }
+
+/*****************************************************************************/
+/**
+*  Function:  Read IQ compress size
+*
+*  Function to size the packets of a compressed Read IQ request by the compressed
+*  bytes so that each packet carries more samples and fewer packets are sent.  The
+*  compressed samples of a packet must fit in the max_length bytes of the raw packet
+*  and in the node compression buffer (READ_IQ_COMPRESS_MAX_LENGTH):
+*
+*      12-bit:  3 bytes / sample; the samples are a multiple of 4 so there is no padding
+*      BFP:     (4 + (2 * READ_IQ_BFP_BLOCK_SAMPLES)) bytes / block of samples
+*
+*  max_length is then the number of bytes of the samples of a packet as 32-bit samples
+*  (ie the value of the Read IQ request) and num_pkts is the number of packets of a
+*  buffer.  Both are left unchanged if compression would not reduce the number of
+*  packets.
+*
+*  Returns:  1 if the compressed format should be requested; 0 otherwise
+*
+******************************************************************************/
+uint32 wl_read_iq_compress_size( uint32 compression, uint32 num_samples, uint32 *max_length, uint32 *num_pkts ) {
+
+    uint32 length;
+    uint32 samples;
     
-                num_rcvd_samples += sample_size;
-                rcvd_pkts        += 1;
-                num_iq_retrys     = 0;
-                
-                // Exit the loop when we have enough packets
-                if ( rcvd_pkts == num_pkts ) {
+    length = ( *max_length < READ_IQ_COMPRESS_MAX_LENGTH ) ? *max_length : READ_IQ_COMPRESS_MAX_LENGTH;
+    
+    if ( compression == READ_IQ_COMPRESSION_12BIT ) {
+        samples = ( length / 12 ) * 4;
+    } else {
+        samples = ( length / ( 4 + ( 2 * READ_IQ_BFP_BLOCK_SAMPLES ) ) ) * READ_IQ_BFP_BLOCK_SAMPLES;
+    }
+    
+    if ( samples <= ( *max_length >> 2 ) ) {
+        return 0;
+    }
+    
+    *max_length = samples << 2;
+    *num_pkts   = ( num_samples + samples - 1 ) / samples;
+    
+    return 1;
+}
+
+
+
+/*****************************************************************************/
+/**
+*  Function:  Read IQ decompress
+*
+*  Function to expand compressed Read IQ samples in to 32-bit samples in the
+*  same (big endian) format as an uncompressed Read IQ packet:
+*
+*      12-bit:  3 bytes / sample - [ I[15:8] | I[7:4],Q[15:12] | Q[11:4] ]
+*      BFP:     Blocks of READ_IQ_BFP_BLOCK_SAMPLES samples.  Each block is a
+*               4 byte header (byte 0 is the exponent) followed by an 8-bit
+*               I and Q for each sample.  Sample = (int8) mantissa << exponent
+*
+*  Returns:  None
+*
+******************************************************************************/
+void wl_read_iq_decompress( uint8 sample_flags, uint8 *src, uint32 num_samples, uint8 *dest ) {
+
+    uint32 i, j;
+    uint32 block_samples;
+    uint32 exponent;
+    uint16 tmp_i, tmp_q;
+
+    if ( sample_flags & SAMPLE_IQ_FORMAT_12BIT ) {
+        for( i = 0; i < num_samples; i++ ) {
+            dest[0] = src[0];
+            dest[1] = src[1] & 0xF0;
+            dest[2] = ( src[1] << 4 ) | ( src[2] >> 4 );
+            dest[3] = src[2] << 4;
+            
+            src    += 3;
+            dest   += 4;
+        }
+    } else if ( sample_flags & SAMPLE_IQ_FORMAT_BFP ) {
+        for( i = 0; i < num_samples; i += READ_IQ_BFP_BLOCK_SAMPLES ) {
+            block_samples = ( ( num_samples - i ) < READ_IQ_BFP_BLOCK_SAMPLES ) ? ( num_samples - i ) : READ_IQ_BFP_BLOCK_SAMPLES;
+            exponent      = src[0];
+            src          += 4;
+            
+            for( j = 0; j < block_samples; j++ ) {
+                tmp_i   = (uint16) ( ( (int16) ( (int8) src[0] ) ) << exponent );
+                tmp_q   = (uint16) ( ( (int16) ( (int8) src[1] ) ) << exponent );
                 
-#ifdef _DEBUG_
-                    // Calculate statistics
-                    if (num_pkts > 1) {
-                        avg_timeout = total_timeout / (num_pkts - 1);
-                    } else {
-                        avg_timeout = init_timeout;
-                    }
-                    
-                    // Print statistics
-                    printf("Initial Timeout = %10d\n", init_timeout);
-                    printf("Avg Timeout     = %10d  (%10d packets)\n", avg_timeout, (num_pkts - 1));
-#endif
+                dest[0] = tmp_i >> 8;
+                dest[1] = tmp_i & 0xFF;
+                dest[2] = tmp_q >> 8;
+                dest[3] = tmp_q & 0xFF;
                 
-                    // Check to see if we have any packet errors
-                    //     NOTE:  This check will detect duplicate packets or sample indexing errors
-                    if ( wl_read_iq_sample_error( sample_tracker, num_samples, start_sample, rcvd_pkts, samples_per_pkt ) ) {
+                src    += 2;
+                dest   += 4;
+            }
+        }
+    }
+}
 
-                        // In this case, there is probably some issue in the transmitting node not getting the
-                        // correct number of samples or messing up the indexing of the transmit packets.  
-                        // The wl_read_iq_sample_error() printed debug information, so we need to retry the packets
-                        
-                        if ( num_retrys >= TRANSPORT_MAX_RETRY ) {
-                        
-                            die_with_error("Error:  Errors in sample request from board.  Max number of re-transmissions reached.  See above for debug information.");
-                            
-                        } else {
 
-                            // Find the first packet error and request the remaining samples
-                            if ( wl_read_iq_find_error( sample_tracker, num_samples, start_sample, rcvd_pkts, samples_per_pkt,
-                                                        &err_num_samples, &err_start_sample, &err_num_pkts ) ) {
 
-                                command_args[1] = endian_swap_32( err_start_sample );
-                                command_args[2] = endian_swap_32( err_num_samples );
-                                command_args[4] = endian_swap_32( num_pkts - ( rcvd_pkts - err_num_pkts ) );
-                                // command_args[4] = endian_swap_32( err_num_pkts );
+/*****************************************************************************/
+/**
+*  Function:  Read IQ merge metadata
+*
+*  Function to add the capture metadata of a Read IQ request to the metadata of
+*  the current Read IQ call.  The metadata packet contains READ_IQ_METADATA_WORDS
+*  big endian words for each buffer of the request.  Since a Read IQ call can be
+*  split in to multiple requests, the RSSI statistics are combined using the
+*  number of RSSI values of each request.  All other fields are taken from the
+*  most recent request.
+*
+*  Returns:  None
+*
+******************************************************************************/
+void wl_read_iq_merge_metadata( uint8 *src, uint32 num_bytes ) {
 
-                                // Retransmit the read IQ request packet
-                                sent_size   = send_socket( index, buffer, length, ip_addr, port );
-                                
-                                if ( sent_size != length ) {
-                                    die_with_error("Error:  Size of packet sent to request samples does not match length of packet.");
-                                }
-                                
-                                // We are re-requesting err_num_pkts, so we need to subtract err_num_pkts from what we have already recieved
-                                rcvd_pkts        -= err_num_pkts;
-                                num_rcvd_samples  = num_samples - err_num_samples;
-
-                                // Update control variables
-                                timeout     = 0;
-                                total_cmds += 1;
-                                num_retrys += 1;
-                                
-                            } else {
-                                // Die since we could not find the error
-                                die_with_error("Error:  Encountered error in sample packets but could not determine the error.  See above for debug information.");
-                            }
-                        }
-                    } else {
-                        // There are no errors, so we are done
-                        //     Record sequence number and exit the function
-                        *seq_num = sample_hdr->sample_iq_id;
-                        
-                        done = 1;
+    uint32 i, j;
+    uint32 index;
+    uint32 words[READ_IQ_METADATA_WORDS];
+    uint32 *metadata;
+    uint32 count_0, count_1;
+    
+    for ( i = 0; ( i + ( READ_IQ_METADATA_WORDS * sizeof( uint32 ) ) ) <= num_bytes; i += ( READ_IQ_METADATA_WORDS * sizeof( uint32 ) ) ) {
+    
+        for ( j = 0; j < READ_IQ_METADATA_WORDS; j++ ) {
+            words[j] = ( src[i + (4 * j)] << 24 ) | ( src[i + (4 * j) + 1] << 16 ) | ( src[i + (4 * j) + 2] << 8 ) | src[i + (4 * j) + 3];
+        }
+        
+        // Find the index of the buffer
+        switch ( words[READ_IQ_METADATA_BUFF_SEL] ) {
+            case BUFFER_ID_RFA:  index = 0;  break;
+            case BUFFER_ID_RFB:  index = 1;  break;
+            case BUFFER_ID_RFC:  index = 2;  break;
+            case BUFFER_ID_RFD:  index = 3;  break;
+            default:             continue;
+        }
+        
+        metadata = read_iq_metadata[index];
+        
+        // Combine the RSSI statistics with the previous requests
+        if ( read_iq_metadata_valid & ( 1 << index ) ) {
+            count_0 = metadata[READ_IQ_METADATA_RSSI_COUNT];
+            count_1 = words[READ_IQ_METADATA_RSSI_COUNT];
+            
+            if ( count_0 != 0 ) {
+                if ( count_1 == 0 ) {
+                    words[READ_IQ_METADATA_RSSI_MIN]  = metadata[READ_IQ_METADATA_RSSI_MIN];
+                    words[READ_IQ_METADATA_RSSI_MAX]  = metadata[READ_IQ_METADATA_RSSI_MAX];
+                } else {
+                    if ( metadata[READ_IQ_METADATA_RSSI_MIN] < words[READ_IQ_METADATA_RSSI_MIN] ) {
+                        words[READ_IQ_METADATA_RSSI_MIN] = metadata[READ_IQ_METADATA_RSSI_MIN];
+                    }
+                    if ( metadata[READ_IQ_METADATA_RSSI_MAX] > words[READ_IQ_METADATA_RSSI_MAX] ) {
+                        words[READ_IQ_METADATA_RSSI_MAX] = metadata[READ_IQ_METADATA_RSSI_MAX];
                     }
                 }
-            }  // END if (sample_flags)
-        } else {       
-            // Increment the timeout counter; Note this counter does not reflect real-time
-            timeout += 1;            
-            
-        }  // END if ( rcvd_size > 0 )
+                
+                words[READ_IQ_METADATA_RSSI_MEAN]  = (uint32)( ( ( (double) metadata[READ_IQ_METADATA_RSSI_MEAN] * count_0 ) + 
+                                                                 ( (double) words[READ_IQ_METADATA_RSSI_MEAN] * count_1 ) ) / ( count_0 + count_1 ) );
+                words[READ_IQ_METADATA_RSSI_COUNT] = count_0 + count_1;
+            }
+        }
         
-    }  // END while( !done )
+        for ( j = 0; j < READ_IQ_METADATA_WORDS; j++ ) {
+            metadata[j] = words[j];
+        }
+        
+        read_iq_metadata_valid |= ( 1 << index );
+    }
+}
 
-    
-    // Free locally allocated memory    
-    free( tmp_eth_buffer );    
-    free( sample_tracker ); 
 
-    // Finalize outputs   
-    *num_cmds  += total_cmds;
+
+/*****************************************************************************/
+/**
+*  Function:  Read IQ get metadata
+*
+*  Function to convert the capture metadata of the last Read IQ call in to a
+*  MATLAB struct array with one element per buffer that has metadata.
+*
+*  Returns:  mxArray *  - Struct array (1 x number of buffers)
+*
+******************************************************************************/
+mxArray * wl_read_iq_get_metadata( void ) {
+
+    uint32     i;
+    uint32     index               = 0;
+    uint32     num_buffers         = 0;
+    uint32    *metadata;
+    mxArray   *output;
+    
+    const char *field_names[] = { "buffer_id", "rx_count", "capture_timestamp", "read_timestamp",
+                                  "agc_rf_gain", "agc_bb_gain", "agc_rxhp", "agc_done_rssi", "agc_done_addr",
+                                  "rssi_min", "rssi_mean", "rssi_max", "rssi_count",
+                                  "tx_status", "rx_status", "tx_buffer_en", "rx_buffer_en", "rx_length" };
+    
+    for ( i = 0; i < TRANSPORT_WARP_RF_BUFFER_MAX; i++ ) {
+        if ( read_iq_metadata_valid & ( 1 << i ) ) { num_buffers++; }
+    }
+    
+    output = mxCreateStructMatrix( 1, num_buffers, ( sizeof( field_names ) / sizeof( field_names[0] ) ), field_names );
+    
+    for ( i = 0; i < TRANSPORT_WARP_RF_BUFFER_MAX; i++ ) {
+        if ( ( read_iq_metadata_valid & ( 1 << i ) ) == 0 ) { continue; }
+        
+        metadata = read_iq_metadata[i];
+        
+        mxSetField( output, index, "buffer_id",         mxCreateDoubleScalar( metadata[READ_IQ_METADATA_BUFF_SEL] ) );
+        mxSetField( output, index, "rx_count",          mxCreateDoubleScalar( metadata[READ_IQ_METADATA_RX_COUNT] ) );
+        mxSetField( output, index, "capture_timestamp", mxCreateDoubleScalar( ( (double) metadata[READ_IQ_METADATA_CAPTURE_TIME_MSB] * 4294967296.0 ) + metadata[READ_IQ_METADATA_CAPTURE_TIME_LSB] ) );
+        mxSetField( output, index, "read_timestamp",    mxCreateDoubleScalar( ( (double) metadata[READ_IQ_METADATA_READ_TIME_MSB] * 4294967296.0 ) + metadata[READ_IQ_METADATA_READ_TIME_LSB] ) );
+        mxSetField( output, index, "agc_rf_gain",       mxCreateDoubleScalar( ( metadata[READ_IQ_METADATA_AGC_GAINS] >> 5 ) & 0x3 ) );
+        mxSetField( output, index, "agc_bb_gain",       mxCreateDoubleScalar( metadata[READ_IQ_METADATA_AGC_GAINS] & 0x1F ) );
+        mxSetField( output, index, "agc_rxhp",          mxCreateDoubleScalar( ( metadata[READ_IQ_METADATA_AGC_GAINS] >> 7 ) & 0x1 ) );
+        mxSetField( output, index, "agc_done_rssi",     mxCreateDoubleScalar( metadata[READ_IQ_METADATA_AGC_DONE_RSSI] ) );
+        mxSetField( output, index, "agc_done_addr",     mxCreateDoubleScalar( metadata[READ_IQ_METADATA_AGC_DONE_ADDR] ) );
+        mxSetField( output, index, "rssi_min",          mxCreateDoubleScalar( metadata[READ_IQ_METADATA_RSSI_MIN] ) );
+        mxSetField( output, index, "rssi_mean",         mxCreateDoubleScalar( metadata[READ_IQ_METADATA_RSSI_MEAN] ) );
+        mxSetField( output, index, "rssi_max",          mxCreateDoubleScalar( metadata[READ_IQ_METADATA_RSSI_MAX] ) );
+        mxSetField( output, index, "rssi_count",        mxCreateDoubleScalar( metadata[READ_IQ_METADATA_RSSI_COUNT] ) );
+        mxSetField( output, index, "tx_status",         mxCreateDoubleScalar( metadata[READ_IQ_METADATA_STATUS] & 0xFF ) );
+        mxSetField( output, index, "rx_status",         mxCreateDoubleScalar( ( metadata[READ_IQ_METADATA_STATUS] >> 8 ) & 0xFF ) );
+        mxSetField( output, index, "tx_buffer_en",      mxCreateDoubleScalar( metadata[READ_IQ_METADATA_BUFFER_EN] & 0xFF ) );
+        mxSetField( output, index, "rx_buffer_en",      mxCreateDoubleScalar( ( metadata[READ_IQ_METADATA_BUFFER_EN] >> 8 ) & 0xFF ) );
+        mxSetField( output, index, "rx_length",         mxCreateDoubleScalar( metadata[READ_IQ_METADATA_RX_LENGTH] ) );
+        
+        index++;
+    }
     
-    return num_rcvd_samples;
+    return output;
 }
 
 
@@ -2963,7 +7084,7 @@ int wl_read_iq_find_error( wl_sample_tracker *tracker, uint32 num_samples, uint3
     
         // Find element in the array   
         for ( j = 0; j < num_pkts; j ++ ) {
-            if ( start_sample_to_request == tracker[i].start_sample ) {
+            if ( start_sample_to_request == tracker[j].start_sample ) {
                 value_found = 1;
             }            
         }
@@ -3112,6 +7233,7 @@ void wl_check_seq_num(uint32 function, char * node_id_str, uint32 buffer_id, uin
 * @param    hw_ver         - Hardware version of node
 * @param    check_chksum   - Perform the robustness check of transmission in this function or assume the WriteIQ was successful.
 * @param    data_type      - Data type of IQ samples to be sent
+* @param    byte_order     - Byte order of the samples on the wire (SAMPLE_BYTE_ORDER_*)
 * @param    iteration      - Variable to help with indexing into samples array
 * @param    num_cmds       - Return parameter - number of ethernet send commands used to request packets 
 *                                (could be > 1 if there are transmission errors)
@@ -3157,8 +7279,8 @@ void wl_check_seq_num(uint32 function, char * node_id_str, uint32 buffer_id, uin
 ******************************************************************************/
 int wl_write_baseband_buffer( int index, char *buffer, int max_length, char *ip_addr, int port,
                               uint32 num_samples, uint32 start_sample, const void *samples, uint32 buffer_id, uint32 num_pkts, 
-                              uint32 max_samples, uint32 hw_ver, uint32 check_chksum, uint32 data_type, uint32 iteration,
-                              uint32 *num_cmds, uint32 *checksum ) {
+                              uint32 max_samples, uint32 hw_ver, uint32 check_chksum, uint32 data_type, uint32 byte_order,
+                              uint32 iteration, uint32 *num_cmds, uint32 *checksum ) {
 
     // Variable declaration
     uint32                i, j;
@@ -3501,10 +7623,10 @@ int wl_write_baseband_buffer( int index, char *buffer, int max_length, char *ip_
                         if (tmp_double_imag < -1.0) { tmp_int16_imag = (int16)(0x8000); } // Adjust any values that are less than Fix_16_15
                     
                         // Populate the sample payload
-                        sample_payload[j] = endian_swap_32((tmp_int16_real << 16) | (tmp_int16_imag & 0xFFFF));
+                        sample_payload[j] = wl_sample_to_wire( byte_order, (tmp_int16_real << 16) | (tmp_int16_imag & 0xFFFF) );
                     } else {
                         // Populate the sample payload
-                        sample_payload[j] = endian_swap_32((tmp_int16_real << 16));
+                        sample_payload[j] = wl_sample_to_wire( byte_order, (tmp_int16_real << 16) );
                     }
                 }                
             break;
@@ -3532,10 +7654,10 @@ int wl_write_baseband_buffer( int index, char *buffer, int max_length, char *ip_
                         if (tmp_single_imag < -1.0) { tmp_int16_imag = (int16)(0x8000); } // Adjust any values that are less than Fix_16_15
                         
                         // Populate the sample payload
-                        sample_payload[j] = endian_swap_32((tmp_int16_real << 16) | (tmp_int16_imag & 0xFFFF));
+                        sample_payload[j] = wl_sample_to_wire( byte_order, (tmp_int16_real << 16) | (tmp_int16_imag & 0xFFFF) );
                     } else {
                         // Populate the sample payload
-                        sample_payload[j] = endian_swap_32((tmp_int16_real << 16));                    
+                        sample_payload[j] = wl_sample_to_wire( byte_order, (tmp_int16_real << 16) );                    
                     }
                 }
             break;
@@ -3553,10 +7675,10 @@ int wl_write_baseband_buffer( int index, char *buffer, int max_length, char *ip_
                         tmp_int16_imag = tmp_int16_array_imag[j + offset];
                     
                         // Populate the sample payload
-                        sample_payload[j] = endian_swap_32((tmp_int16_real << 16) | (tmp_int16_imag & 0xFFFF));
+                        sample_payload[j] = wl_sample_to_wire( byte_order, (tmp_int16_real << 16) | (tmp_int16_imag & 0xFFFF) );
                     } else {
                         // Populate the sample payload
-                        sample_payload[j] = endian_swap_32((tmp_int16_real << 16));
+                        sample_payload[j] = wl_sample_to_wire( byte_order, (tmp_int16_real << 16) );
                     }
                 }
             break;
@@ -3564,18 +7686,21 @@ int wl_write_baseband_buffer( int index, char *buffer, int max_length, char *ip_
             // ------------------------------------------------------------------------------------------------
             case IQ_DATA_TYPE_RAW:
                 // Need to process the Ethernet packet into a uint32 array
-                //    NOTE:  This performs an endian swap (little big) on IQ data
+                //    NOTE:  This performs an endian swap (little big) on IQ data unless the node uses little endian samples
                 //    NOTE:  No other processing is done on the data
                 //
-                for( j = 0; j < sample_num; j++ ) {
-                    sample_payload[j] = endian_swap_32(tmp_uint32_array[j + offset]);
-                    
-                    // Populate variables for the checksum
-                    if (j == (sample_num - 1)) {
-                        tmp_int16_real = (tmp_uint32_array[j + offset] >> 16);
-                        tmp_int16_imag = (tmp_uint32_array[j + offset] & 0xFFFF);
+                if ( byte_order == SAMPLE_BYTE_ORDER_LITTLE ) {
+                    // Samples are already in the byte order of the wire
+                    memcpy( sample_payload, &tmp_uint32_array[offset], ( sample_num * sizeof(uint32) ) );
+                } else {
+                    for( j = 0; j < sample_num; j++ ) {
+                        sample_payload[j] = wl_sample_to_wire( byte_order, tmp_uint32_array[j + offset] );
                     }
                 }
+                
+                // Populate variables for the checksum
+                tmp_int16_real = (tmp_uint32_array[offset + sample_num - 1] >> 16);
+                tmp_int16_imag = (tmp_uint32_array[offset + sample_num - 1] & 0xFFFF);
             break;
             
             // ------------------------------------------------------------------------------------------------
@@ -3594,6 +7719,8 @@ int wl_write_baseband_buffer( int index, char *buffer, int max_length, char *ip_
             die_with_error("Error:  Size of packet sent to with samples does not match length of packet.");
         }
         
+        wl_trace_annotate( offset, num_retrys );
+        
         // Update loop variables
         offset   += sample_num;
         seq_num  += 1;
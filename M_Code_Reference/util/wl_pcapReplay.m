@@ -0,0 +1,272 @@
+%==============================================================================
+% Function wl_pcapReplay()
+%
+% Usage:
+%     - stats = wl_pcapReplay( filename )                           - Replay at the recorded timing
+%     - stats = wl_pcapReplay( filename, speed )                    - Replay at speed x the recorded timing (Inf ==> no pacing)
+%     - stats = wl_pcapReplay( filename, speed, port )              - Replay the node on the given local port
+%
+% Plays back the node side of a packet capture so that the host side (MEX transport, M code)
+% can be benchmarked without a WARP node.  The capture is recorded by the MEX transport:
+%
+%     wl_mex_udp_transport('set_capture', 'session.pcap');
+%     ... WARPLab session with the node ...
+%     wl_mex_udp_transport('set_capture', '');
+%
+% The replay takes the place of the node on 127.0.0.1 (node port from the capture unless
+% specified).  For each packet the host sends, the replay finds the matching recorded host
+% packet and sends back the node packets that followed it in the capture with the recorded
+% timing (scaled by speed).  Packets lost or reordered in the capture are replayed the same
+% way.  The sequence number of each response is set to that of the host packet so the
+% transport accepts it.
+%
+% The host must use 127.0.0.1 as the IP address of the node (eg obj.transport.setAddress('127.0.0.1')).
+% The replay runs in a separate MATLAB session (or from a script before the benchmark is
+% started in another session) and stops when the host has not sent a packet for 10 seconds.
+%
+% NOTE:  Only captures with one node are supported (the node is the destination of the first
+%        packet).  Captures from other tools are supported if they use the raw IP or Ethernet
+%        link type.
+%
+% Output:
+%     - Struct with the number of host packets received, host packets that did not match the
+%       capture and node packets sent
+%
+%==============================================================================
+
+function stats = wl_pcapReplay(varargin)
+    LINKTYPE_ETHERNET  = 1;
+    LINKTYPE_RAW       = 101;
+    IDLE_TIMEOUT       = 10;                % Stop the replay after IDLE_TIMEOUT seconds without a host packet
+    MAX_PKT_LENGTH     = 9050;
+    SEQ_NUM_OFFSET     = 11;                % Index (1-based) of the sequence number in the transport header
+    HDR_LENGTH         = 14;                % Length of the transport header (including padding)
+
+    speed              = 1;
+    port               = [];
+
+    import java.net.DatagramSocket
+    import java.net.DatagramPacket
+    import java.net.InetAddress
+    import java.net.InetSocketAddress
+
+
+    %--------------------------------------------------------------------------
+    % Get inputs
+    %
+    if ((nargin < 1) || (nargin > 3))
+        fprintf('Usage wl_pcapReplay:\n');
+        fprintf('    stats = wl_pcapReplay( filename [, speed [, port]] ) \n');
+        error('Incorrect number of arguments');
+    end
+
+    filename = varargin{1};
+
+    if (nargin > 1)
+        speed = varargin{2};
+    end
+
+    if (nargin > 2)
+        port  = varargin{3};
+    end
+
+
+    %--------------------------------------------------------------------------
+    % Read the capture
+    %
+    fid = fopen(filename, 'r', 'l');
+
+    if (fid == -1)
+        error('Cannot open capture file "%s"', filename);
+    end
+
+    magic = fread(fid, 1, 'uint32=>uint32');
+
+    if (magic == hex2dec('D4C3B2A1'))
+        fclose(fid);
+        fid   = fopen(filename, 'r', 'b');
+        magic = fread(fid, 1, 'uint32=>uint32');
+    end
+
+    if (magic ~= hex2dec('A1B2C3D4'))
+        fclose(fid);
+        error('"%s" is not a pcap file', filename);
+    end
+
+    fread(fid, 4, 'uint32');                                % Version, timezone, accuracy, snaplen
+    linktype = fread(fid, 1, 'uint32');
+
+    switch (linktype)
+        case LINKTYPE_RAW
+            link_hdr_length = 0;
+        case LINKTYPE_ETHERNET
+            link_hdr_length = 14;
+        otherwise
+            fclose(fid);
+            error('Unsupported pcap link type %d', linktype);
+    end
+
+    pkt_time = [];
+    pkt_src  = [];
+    pkt_dest = [];
+    pkt_data = {};
+
+    while (true)
+        pkt_hdr = fread(fid, 4, 'uint32');
+
+        if (length(pkt_hdr) < 4)
+            break;
+        end
+
+        data = fread(fid, pkt_hdr(3), 'uint8=>uint8')';
+
+        if (length(data) < pkt_hdr(3))
+            break;
+        end
+
+        data = data((link_hdr_length + 1):end);
+
+        % Only keep IPv4 / UDP packets
+        if ((length(data) < 28) || (bitshift(data(1), -4) ~= 4) || (data(10) ~= 17))
+            continue;
+        end
+
+        ip_hdr_length = 4 * double(bitand(data(1), 15));
+        udp           = data((ip_hdr_length + 1):end);
+
+        % Source / destination are [IP address, port] as doubles
+        pkt_time(end + 1)    = pkt_hdr(1) + (pkt_hdr(2) * 1e-6);
+        pkt_src(end + 1, :)  = [double(typecast(fliplr(data(13:16)), 'uint32')), (256 * double(udp(1))) + double(udp(2))];
+        pkt_dest(end + 1, :) = [double(typecast(fliplr(data(17:20)), 'uint32')), (256 * double(udp(3))) + double(udp(4))];
+        pkt_data{end + 1}    = udp(9:end);
+    end
+
+    fclose(fid);
+
+    if (isempty(pkt_time))
+        error('Capture "%s" does not contain any UDP packets', filename);
+    end
+
+    % The node is the destination of the first packet
+    node    = pkt_dest(1, :);
+    is_host = (pkt_dest(:, 1) == node(1)) & (pkt_dest(:, 2) == node(2));
+    is_node = (pkt_src(:, 1)  == node(1)) & (pkt_src(:, 2)  == node(2));
+    host    = find(is_host)';
+
+    if (isempty(port))
+        port = node(2);
+    end
+
+    fprintf('Capture:  %d host packets, %d node packets (node %d.%d.%d.%d:%d)\n', sum(is_host), sum(is_node), ...
+            bitshift(node(1), -24), bitand(bitshift(node(1), -16), 255), bitand(bitshift(node(1), -8), 255), bitand(node(1), 255), node(2));
+
+
+    %--------------------------------------------------------------------------
+    % Replay the node
+    %
+    sock = DatagramSocket(InetSocketAddress(InetAddress.getByName('127.0.0.1'), port));
+    sock.setSoTimeout(1);
+    sock.setSendBufferSize(2^22);
+    sock.setReceiveBufferSize(2^22);
+
+    recv_pkt = DatagramPacket(zeros(1, MAX_PKT_LENGTH, 'int8'), MAX_PKT_LENGTH);
+
+    results.host_pkts     = 0;
+    results.unmatched     = 0;
+    results.node_pkts     = 0;
+
+    next_host             = 1;                              % Index in to host of the next recorded host packet
+    idle_time             = tic;
+
+    fprintf('Replaying node on 127.0.0.1:%d at %gx ...\n', port, speed);
+
+    while (toc(idle_time) < IDLE_TIMEOUT)
+        try
+            sock.receive(recv_pkt);
+        catch receiveError
+            if ~isempty(strfind(receiveError.message, 'java.net.SocketTimeoutException'))
+                continue;
+            else
+                sock.close();
+                error('%s.m -- Failed to receive UDP packet.\nJava error message follows:\n%s', mfilename, receiveError.message);
+            end
+        end
+
+        idle_time = tic;
+        rcvd_time = tic;
+        rcvd      = typecast(recv_pkt.getData(), 'uint8');
+        rcvd      = reshape(rcvd(1:recv_pkt.getLength()), 1, []);       % Row vector like the recorded packets
+
+        results.host_pkts = results.host_pkts + 1;
+
+        % Find the recorded host packet with the same contents (ignoring the sequence number)
+        match = [];
+
+        for k = next_host:length(host)
+            data = pkt_data{host(k)};
+
+            if ((length(data) == length(rcvd)) && isequal(data([1:(SEQ_NUM_OFFSET - 1), (SEQ_NUM_OFFSET + 2):end]), ...
+                                                          rcvd([1:(SEQ_NUM_OFFSET - 1), (SEQ_NUM_OFFSET + 2):end])))
+                match = k;
+                break;
+            end
+        end
+
+        if (isempty(match))
+            % Fall back to the next recorded host packet
+            results.unmatched = results.unmatched + 1;
+            match             = next_host;
+        end
+
+        if (match > length(host))
+            continue;
+        end
+
+        next_host = match + 1;
+
+        % Send the node packets recorded between this host packet and the next one
+        if (match < length(host))
+            last = host(match + 1) - 1;
+        else
+            last = length(pkt_time);
+        end
+
+        for i = find(is_node((host(match) + 1):last))' + host(match)
+            data = pkt_data{i};
+
+            if (length(data) >= HDR_LENGTH)
+                data(SEQ_NUM_OFFSET:(SEQ_NUM_OFFSET + 1)) = rcvd(SEQ_NUM_OFFSET:(SEQ_NUM_OFFSET + 1));
+            end
+
+            % Wait until the recorded time of the packet
+            if (~isinf(speed))
+                wait_time = (pkt_time(i) - pkt_time(host(match))) / speed;
+
+                while (toc(rcvd_time) < wait_time)
+                end
+            end
+
+            sock.send(DatagramPacket(typecast(data, 'int8'), length(data), recv_pkt.getAddress(), recv_pkt.getPort()));
+
+            results.node_pkts = results.node_pkts + 1;
+        end
+    end
+
+    sock.close();
+
+    fprintf('Replay done:  %d host packets (%d did not match the capture), %d node packets\n', ...
+            results.host_pkts, results.unmatched, results.node_pkts);
+
+
+    %--------------------------------------------------------------------------
+    % Set outputs
+    %
+    if nargout == 0
+        return
+    elseif nargout == 1
+        stats = results;
+    else
+        error('Too many output arguments provided');
+    end
+
+end
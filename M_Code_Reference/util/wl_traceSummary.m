@@ -0,0 +1,162 @@
+%==============================================================================
+% Function wl_traceSummary()
+%
+% Usage:
+%     - summary = wl_traceSummary( trace )                - Summary of a trace matrix
+%     - summary = wl_traceSummary( filename )             - Summary of a trace file
+%
+% NOTE:  The trace is recorded by the MEX transport:
+%            wl_mex_udp_transport('set_trace', num_entries);     % Enable the trace
+%            ... Read IQ / Write IQ / commands ...
+%            trace = wl_mex_udp_transport('get_trace');          % Get the trace (or 'get_trace', filename)
+%            wl_mex_udp_transport('set_trace', 0);               % Disable the trace
+%
+% NOTE:  Kernel receive times are only available on Linux (SO_TIMESTAMPNS).  Otherwise, the
+%        inter-arrival times use the host times and the host processing lag is not reported.
+%
+% NOTE:  If no output arguments are specified, then the function just prints the summary
+%
+% Output:
+%     - Pretty print of the summary for each socket
+%     - Array of summary structs, one per socket (if the number of output arguments is 1)
+%
+%==============================================================================
+
+function summary = wl_traceSummary(varargin)
+    TRACE_NUM_FIELDS   = 7;
+    GAP_THRESHOLD      = 10;                % Gap is an inter-arrival time of more than GAP_THRESHOLD x the median
+
+
+    %--------------------------------------------------------------------------
+    % Get inputs
+    %
+    if (nargin ~= 1)
+        fprintf('Usage wl_traceSummary:\n');
+        fprintf('    summary = wl_traceSummary( trace )      - trace from wl_mex_udp_transport(''get_trace'') \n');
+        fprintf('    summary = wl_traceSummary( filename )   - file from wl_mex_udp_transport(''get_trace'', filename) \n');
+        error('Incorrect number of arguments');
+    end
+
+    if (ischar(varargin{1}))
+        fid = fopen(varargin{1}, 'r', 'l');
+
+        if (fid == -1)
+            error('Cannot open trace file "%s"', varargin{1});
+        end
+
+        trace = fread(fid, [TRACE_NUM_FIELDS, Inf], 'double');
+        fclose(fid);
+    else
+        trace = varargin{1};
+    end
+
+    if (size(trace, 1) ~= TRACE_NUM_FIELDS)
+        error('Trace must have %d rows', TRACE_NUM_FIELDS);
+    end
+
+    direction   = trace(1, :);
+    sock        = trace(2, :);
+    kernel_time = trace(3, :);
+    host_time   = trace(4, :);
+    len         = trace(5, :);
+    sample      = trace(6, :);
+    retry       = trace(7, :);
+
+
+    %--------------------------------------------------------------------------
+    % Summarize each socket
+    %
+    results = [];
+
+    for index = unique(sock)
+        tx = (sock == index) & (direction == 0);
+        rx = (sock == index) & (direction == 1);
+
+        s.socket            = index;
+        s.tx_pkts           = sum(tx);
+        s.tx_bytes          = sum(len(tx));
+        s.tx_retry_pkts     = sum(tx & (retry > 0));
+        s.rx_pkts           = sum(rx);
+        s.rx_bytes          = sum(len(rx));
+        s.rx_sample_pkts    = sum(rx & (sample >= 0));
+        s.rx_pkt_rate       = 0;
+        s.rx_byte_rate      = 0;
+        s.interarrival_mean = 0;
+        s.interarrival_std  = 0;
+        s.num_gaps          = 0;
+        s.max_gap           = 0;
+        s.host_lag_mean     = NaN;
+        s.host_lag_max      = NaN;
+
+        % Use the kernel receive times if they are available for all packets
+        rx_time = kernel_time(rx);
+
+        if (any(rx_time == 0))
+            rx_time = host_time(rx);
+        else
+            lag             = host_time(rx) - rx_time;
+            s.host_lag_mean = mean(lag);
+            s.host_lag_max  = max(lag);
+        end
+
+        if (s.rx_pkts > 1)
+            interarrival        = diff(rx_time);
+            duration            = rx_time(end) - rx_time(1);
+
+            if (duration > 0)
+                s.rx_pkt_rate   = (s.rx_pkts - 1) / duration;
+                s.rx_byte_rate  = sum(len(rx)) / duration;
+            end
+
+            s.interarrival_mean = mean(interarrival);
+            s.interarrival_std  = std(interarrival);
+
+            gaps                = interarrival(interarrival > (GAP_THRESHOLD * median(interarrival)));
+            s.num_gaps          = length(gaps);
+
+            if (~isempty(gaps))
+                s.max_gap       = max(gaps);
+            end
+        end
+
+        results = [results, s];
+    end
+
+
+    %--------------------------------------------------------------------------
+    % Print summary
+    %
+    if (nargout == 0)
+        fprintf('Packet trace:  %d packets\n', size(trace, 2));
+
+        for s = results
+            fprintf('\nSocket %d:\n', s.socket);
+            fprintf('    TX:  %8d packets  %12d bytes  (%d retransmissions)\n', s.tx_pkts, s.tx_bytes, s.tx_retry_pkts);
+            fprintf('    RX:  %8d packets  %12d bytes  (%d sample packets)\n', s.rx_pkts, s.rx_bytes, s.rx_sample_pkts);
+            fprintf('    RX rate:             %10.1f packets/sec  (%.2f MB/sec)\n', s.rx_pkt_rate, (s.rx_byte_rate / 2^20));
+            fprintf('    RX inter-arrival:    %10.2f usec mean   %10.2f usec std dev\n', (s.interarrival_mean * 1e6), (s.interarrival_std * 1e6));
+            fprintf('    RX gaps (> %dx med): %10d          %10.2f usec max\n', GAP_THRESHOLD, s.num_gaps, (s.max_gap * 1e6));
+
+            if (isnan(s.host_lag_mean))
+                fprintf('    Host lag:            not available (no kernel receive times)\n');
+            else
+                fprintf('    Host lag:            %10.2f usec mean   %10.2f usec max\n', (s.host_lag_mean * 1e6), (s.host_lag_max * 1e6));
+            end
+        end
+
+        fprintf('\n');
+    end
+
+
+    %--------------------------------------------------------------------------
+    % Set outputs
+    %
+    if nargout == 0
+        return
+    elseif nargout == 1
+        summary = results;
+    else
+        error('Too many output arguments provided');
+    end
+
+end